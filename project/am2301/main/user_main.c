@@ -8,6 +8,8 @@
  * 测试:
  * 连接 GPIO4 至 AM2301 黄线 SDA
  * 控制 GPIO4 发送和接收指定时序的波形，转化为数据，然后处理成温度湿度值
+ * 时序由公共组件 am2301 实现
+ * 读数同时加入 stats_window 组件，每分钟输出一次最近 1 分钟的统计，每 5 分钟输出一次最近 1 小时的统计
  */
 
 #include <stdio.h>
@@ -19,156 +21,98 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 
-/* GPIO 驱动 */
-#include "driver/gpio.h"
-
 /* ESP 日志打印输出 */
 #include "esp_log.h"
 /* ESP 头文件 */
 #include "esp_system.h"
 
+/* 公共组件：AM2301 单总线驱动 */
+#include "am2301.h"
+/* 公共组件：滚动统计 */
+#include "stats_window.h"
+
 #define AM2301_CTRL_PIN		(GPIO_NUM_4)
 
 static const char *s_tag = "AS2301";
 
-static void gpio_init(void)
-{
-	gpio_config_t io_conf;
-	
-	// 设置 GPIO15/16 为输出模式
-	// 禁止中断
-	io_conf.intr_type = GPIO_INTR_DISABLE;
-	// 设置为输出模式
-	io_conf.mode = GPIO_MODE_OUTPUT;
-	// 位掩码选择 GPIO15/16，置1
-	io_conf.pin_bit_mask = GPIO_Pin_4;
-	// 禁止下拉
-	io_conf.pull_down_en = 0;
-	// 禁止上拉
-	io_conf.pull_up_en = 0;
-
-	gpio_config(&io_conf);
-
-    gpio_set_level(AM2301_CTRL_PIN, 1);
-}
+/* 通道 0 湿度、通道 1 温度，单位 0.1 */
+static const stats_window_spec_t s_stats_specs[] = {
+	{ 60 * 1000, 0 },
+	{ 60 * 60 * 1000, 5 * 60 * 1000 },
+};
 
-static uint8_t am2301_read_bit(void)
-{ 
-	int retry = 0;
+/* 0.1 单位 x STATS_WINDOW_SCALE -> "-12.34" */
+static const char *stats_str(int32_t value, char *buf, size_t len)
+{
+	value /= 10;
+	snprintf(buf, len, "%s%d.%02d", (0 > value) ? "-" : "", abs(value) / 100, abs(value) % 100);
 
-	// 等待低电平
-	while(1 == gpio_get_level(AM2301_CTRL_PIN) && retry < 200)
-	{
-		++retry;
-		os_delay_us(1);
-	}
-	// 等待高电平
-	while(0 == gpio_get_level(AM2301_CTRL_PIN) && retry < 200)
-	{
-		++retry;
-		os_delay_us(1);
-	}
-	os_delay_us(35);	// 等待 35us
+	return buf;
+}
 
-	if(1 == gpio_get_level(AM2301_CTRL_PIN))
-	{
-		return 1;
-	}
-	else
+static void stats_record(const stats_window_record_t *record, void *arg)
+{
+	static const char *units[] = { "%RH", "Centigrade" };
+	char min[16];
+	char max[16];
+	char mean[16];
+	char std[16];
+	uint8_t i = 0;
+
+	ESP_LOGI(s_tag, "stats %u min (%u ~ %u s): %u samples", s_stats_specs[record->window].length_ms / 60000,
+			 record->start_ms / 1000, record->end_ms / 1000, record->count);
+	for(i = 0; i < record->num; ++i)
 	{
-		return 0;
+		ESP_LOGI(s_tag, "  min %s max %s mean %s std %s %s",
+				 stats_str(record->stats[i].min * STATS_WINDOW_SCALE, min, sizeof(min)),
+				 stats_str(record->stats[i].max * STATS_WINDOW_SCALE, max, sizeof(max)),
+				 stats_str(record->stats[i].mean, mean, sizeof(mean)),
+				 stats_str(record->stats[i].std, std, sizeof(std)), units[i]);
 	}
 }
 
 void app_main(void)
 {
-	int i = 0;
-	int j = 0;
-	uint8_t recv_byte[5] = {0};
-	int retry = 0;
-	int hum = 0;
+	am2301_data_t data;
+	esp_err_t ret = ESP_OK;
 	int temp = 0;
 	uint8_t minus_temp_flag = ' ';
+	stats_window_handle_t stats = NULL;
+	int32_t values[2];
+	uint32_t now_ms = 0;
 
-	gpio_init();
+	am2301_init(AM2301_CTRL_PIN);
+	ESP_ERROR_CHECK(stats_window_create(2, s_stats_specs, sizeof(s_stats_specs) / sizeof(s_stats_specs[0]),
+										stats_record, NULL, &stats));
 
 	for(;;)
 	{
-        // 每分钟读取 1 次温湿度
+		// 每 5 秒读取 1 次温湿度
 		vTaskDelay(5 * 1000 / portTICK_RATE_MS);
-		minus_temp_flag = ' ';
-		memset(recv_byte, 0, 5);
-
-		// 发送起始信号
-		// 输出拉低 1ms
-		gpio_set_level(AM2301_CTRL_PIN, 0);
-		os_delay_us(1000);
-		// 输出拉高，立刻转为输入模式
-		gpio_set_level(AM2301_CTRL_PIN, 1);
-		gpio_set_direction(AM2301_CTRL_PIN, GPIO_MODE_INPUT);
-
-		// 监听输入信号，等待 AM2301 应答低电平 80us
-		// 此时输入应该为高
-		while(1 == gpio_get_level(AM2301_CTRL_PIN) && retry < 1000)
-		{
-			++retry;
-			os_delay_us(1);
-		}
-		// 如果应答低电平超过 1000us，错误，放弃本次读取
-		if(1000 == retry)
-		{
-			ESP_LOGI(s_tag, "AM2301 ACK Error");
-			gpio_set_direction(AM2301_CTRL_PIN, GPIO_MODE_OUTPUT);
-			gpio_set_level(AM2301_CTRL_PIN, 1);
-			continue;
-		}
 
-		// 接收到答低电平 80us，之后还有高电平 80us
-		// 监听等其变成高电平
-		retry = 0;
-		while(0 == gpio_get_level(AM2301_CTRL_PIN) && retry < 1000)
-		{
-			++retry;
-			os_delay_us(1);
-		}
-		// 如果应答低电平超过 1000us，错误，放弃本次读取
-		if(1000 == retry)
+		ret = am2301_read(AM2301_CTRL_PIN, &data);
+		now_ms = xTaskGetTickCount() * portTICK_RATE_MS;
+		if(ESP_ERR_TIMEOUT == ret)
 		{
-			ESP_LOGI(s_tag, "AM2301 ACK Error 2");
-			gpio_set_direction(AM2301_CTRL_PIN, GPIO_MODE_OUTPUT);
-			gpio_set_level(AM2301_CTRL_PIN, 1);
+			ESP_LOGI(s_tag, "AM2301 ACK Error");
+			// 读取失败时窗口照常结束
+			stats_window_advance(stats, now_ms);
 			continue;
 		}
-
-		for(i = 0; i < 5; ++i)
-		{
-			for(j = 0; j < 8; ++j)
-			{
-				recv_byte[i] <<= 1;
-				recv_byte[i] |= am2301_read_bit();
-			}
-		}
-
-		// 等待结束信号拉低
-		while(0 == gpio_get_level(AM2301_CTRL_PIN));
-
-		gpio_set_direction(AM2301_CTRL_PIN, GPIO_MODE_OUTPUT);
-		gpio_set_level(AM2301_CTRL_PIN, 1);
-
-		if(recv_byte[4] != (uint8_t)(recv_byte[0] + recv_byte[1] + recv_byte[2] + recv_byte[3]))
+		else if(ESP_ERR_INVALID_CRC == ret)
 		{
 			ESP_LOGI(s_tag, "Receive Data CRC Error");
+			stats_window_advance(stats, now_ms);
 			continue;
 		}
 
-		hum = (recv_byte[0] << 8) | recv_byte[1];
-		if(0 != (recv_byte[2] & 0x80))
-		{
-			minus_temp_flag = '-';
-			recv_byte[2] &= 0x7F;
-		}
-		temp = (recv_byte[2] << 8) | recv_byte[3];
-		ESP_LOGI(s_tag, "%d.%d %%RH, %c%d.%d Centigrade", hum / 10, hum % 10,
+		values[0] = data.humidity;
+		values[1] = data.temp;
+		stats_window_add(stats, now_ms, values);
+
+		minus_temp_flag = (0 > data.temp) ? '-' : ' ';
+		temp = abs(data.temp);
+		ESP_LOGI(s_tag, "%d.%d %%RH, %c%d.%d Centigrade", data.humidity / 10, data.humidity % 10,
 														  minus_temp_flag,
 														  temp / 10, temp % 10);
 	}
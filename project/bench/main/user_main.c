@@ -0,0 +1,462 @@
+/**
+ * 说明:
+ * 本实例用 bench 组件测量各驱动热点路径的 CPU 周期数与分配次数
+ *
+ * GPIO 配置状态:
+ * GPIO14 作为主机 SDA，GPIO2 作为主机 SCL，连接 MPU6050 (0x68) 与 DS3231 模块上的 AT24C32 (0x57)
+ * GPIO4  连接 AM2301 数据线
+ * GPIO12 作为 PWM 输出
+ * GPIO0/5/13/15 作为 4 位并行输出，不需要连接
+ *
+ * 测试:
+ * 记录一段 MPU6050 采样，输出按日志文本、原始数据与 sample_codec 编码的长度，
+ * 编码与姿态解算用例使用这段记录，再比较 MPU6050 零偏冷启动标定与热启动恢复的时间，
+ * 然后依次运行各用例，按 CSV 输出结果表 (以 "bench," 开头的行)，
+ * 保存日志后用 tools/bench_compare 与之前的结果比较
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_err.h"
+
+#include "driver/i2c.h"
+#include "driver/pwm.h"
+
+#include "i2c_bus.h"
+#include "mpu6050.h"
+#include "at24c32.h"
+#include "am2301.h"
+#include "sample_codec.h"
+#include "imu_fusion.h"
+#include "mpu6050_calib.h"
+#include "filter_bank.h"
+#include "gpio_port.h"
+#include "bench.h"
+#include "ccount.h"
+
+
+static const char *TAG = "bench";
+
+#define AM2301_CTRL_PIN				(GPIO_NUM_4)
+#define PWM_PIN						(12)
+#define PWM_PERIOD					(1000)
+
+/* 4 位并行输出，比较逐个引脚写入与按端口一次写入 */
+#define NIBBLE_MASK					(GPIO_Pin_0 | GPIO_Pin_5 | GPIO_Pin_13 | GPIO_Pin_15)
+
+/* AM2301 两次读取至少间隔 2s */
+#define AM2301_GAP_MS				(2000)
+
+/* 编码用例使用的 MPU6050 采样记录：32 个采样，间隔 10ms，7 个通道，编码成 128 字节 (AT24C32 的 4 页) 的块 */
+#define TRACE_SAMPLES				(32)
+#define TRACE_PERIOD_MS				(10)
+#define TRACE_CHANNELS				(7)
+#define TRACE_BLOCK_SIZE			(128)
+/* 最坏情况每个采样单独一块 */
+#define TRACE_STREAM_SIZE			(TRACE_SAMPLES * (SAMPLE_CODEC_BLOCK_HEADER + 2 + SAMPLE_CODEC_SAMPLE_MAX(TRACE_CHANNELS) \
+										+ SAMPLE_CODEC_BLOCK_CRC))
+
+/* 比较冷启动标定与热启动恢复的时间，冷启动用较少的采样以缩短运行时间 */
+#define CALIB_SAMPLES				(32)
+
+static i2c_bus_dev_handle_t mpu6050_dev = NULL;
+static i2c_bus_dev_handle_t at24c32_dev = NULL;
+/* 同一片 AT24C32 再按 SDK 驱动注册一次，测量命令连接缓存的效果 */
+static i2c_bus_dev_handle_t e2p_drv_dev = NULL;
+
+static sample_codec_schema_t s_trace_schema = {
+	.num = TRACE_CHANNELS,
+	.channels = {
+		{ "accel_x", 0 }, { "accel_y", 0 }, { "accel_z", 0 }, { "temp", 2 },
+		{ "gyro_x", 0 }, { "gyro_y", 0 }, { "gyro_z", 0 },
+	},
+};
+static uint32_t s_trace_ms[TRACE_SAMPLES];
+static int32_t s_trace[TRACE_SAMPLES][TRACE_CHANNELS];
+static uint8_t s_trace_stream[TRACE_STREAM_SIZE];
+static size_t s_trace_len = 0;
+/* 姿态解算用例按记录的顺序循环输入采样 */
+static int16_t s_trace_accel[TRACE_SAMPLES][3];
+static int16_t s_trace_gyro[TRACE_SAMPLES][3];
+static imu_fusion_t s_fusion[3];
+
+/* 滤波用例每次处理一块 (MPU6050 FIFO 1kHz 时 40ms 的数据)，由记录的采样循环填充 */
+#define FILTER_BLOCK				(40)
+#define FILTER_CIC_RATIO			(10)
+
+/* 低通 fs = 1000 Hz, fc = 40 Hz, Q = 0.7071 (tools/filter_sim -d) */
+static const filter_biquad_coef_t s_lowpass = FILTER_BIQUAD_LOWPASS(0.01335920, -1.64745998, 0.70089678);
+static filter_frame_t s_filter_in[FILTER_BLOCK];
+static filter_frame_t s_filter_out[FILTER_BLOCK];
+static filter_cic_t s_cic;
+static filter_biquad_t s_biquad;
+static filter_mavg_t s_mavg;
+static filter_median_t s_median;
+
+static esp_err_t bench_i2c_cmd_link(void *arg)
+{
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+
+	if(NULL == cmd)
+	{
+		return ESP_ERR_NO_MEM;
+	}
+	i2c_cmd_link_delete(cmd);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_mpu6050_burst(void *arg)
+{
+	static uint8_t sensor_data[MPU6050_RAW_LEN];
+
+	return mpu6050_read_raw(mpu6050_dev, sensor_data);
+}
+
+static esp_err_t bench_i2c_bus_drv_read(void *arg)
+{
+	static uint8_t data[MPU6050_RAW_LEN];
+
+	return i2c_bus_read(e2p_drv_dev, 0, data, sizeof(data));
+}
+
+static esp_err_t bench_at24c32_page(void *arg)
+{
+	static uint8_t page[AT24C32_PAGE_SIZE];
+	static uint8_t seq = 0;
+	int i = 0;
+
+	for(i = 0; i < AT24C32_PAGE_SIZE; ++i)
+	{
+		page[i] = seq++;
+	}
+
+	// 页对齐地址，一次页写
+	return at24c32_write(at24c32_dev, AT24C32_PAGE_SIZE, page, AT24C32_PAGE_SIZE);
+}
+
+static esp_err_t bench_am2301(void *arg)
+{
+	am2301_data_t data;
+
+	return am2301_read(AM2301_CTRL_PIN, &data);
+}
+
+static esp_err_t bench_sample_codec(void *arg)
+{
+	sample_codec_enc_t enc;
+	size_t len = 0;
+	esp_err_t ret = sample_codec_enc_begin(&enc, &s_trace_schema, s_trace_stream, TRACE_BLOCK_SIZE);
+	int i = 0;
+
+	for(i = 0; i < TRACE_SAMPLES && ESP_OK == ret; ++i)
+	{
+		// 块满时结束本块，在下一块中重新加入
+		if(ESP_ERR_NO_MEM == sample_codec_enc_add(&enc, s_trace_ms[i], s_trace[i]))
+		{
+			len += sample_codec_enc_finish(&enc);
+			ret = sample_codec_enc_begin(&enc, &s_trace_schema, &s_trace_stream[len], TRACE_BLOCK_SIZE);
+			if(ESP_OK == ret)
+			{
+				ret = sample_codec_enc_add(&enc, s_trace_ms[i], s_trace[i]);
+			}
+		}
+	}
+	s_trace_len = len + sample_codec_enc_finish(&enc);
+
+	return ret;
+}
+
+static esp_err_t bench_imu_fusion_update(void *arg)
+{
+	static uint32_t index = 0;
+	imu_fusion_t *fusion = arg;
+
+	imu_fusion_update(fusion, s_trace_accel[index], s_trace_gyro[index]);
+	index = (index + 1) % TRACE_SAMPLES;
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_imu_fusion_get(void *arg)
+{
+	imu_fusion_attitude_t att;
+
+	imu_fusion_get(arg, &att);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_filter_cic(void *arg)
+{
+	filter_cic_process(&s_cic, s_filter_in, FILTER_BLOCK, s_filter_out);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_filter_biquad(void *arg)
+{
+	filter_biquad_process(&s_biquad, s_filter_in, FILTER_BLOCK, s_filter_out);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_filter_mavg(void *arg)
+{
+	filter_mavg_process(&s_mavg, s_filter_in, FILTER_BLOCK, s_filter_out);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_filter_median(void *arg)
+{
+	filter_median_process(&s_median, s_filter_in, FILTER_BLOCK, s_filter_out);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_mpu6050_calib_warm(void *arg)
+{
+	mpu6050_calib_t calib;
+	esp_err_t ret = mpu6050_calib_load(at24c32_dev, MPU6050_CALIB_E2P_ADDR, &calib);
+
+	if(ESP_OK == ret)
+	{
+		ret = mpu6050_calib_apply(mpu6050_dev, &calib);
+	}
+
+	return ret;
+}
+
+static esp_err_t bench_pwm(void *arg)
+{
+	static uint32_t duty = 0;
+	esp_err_t ret = ESP_OK;
+
+	duty = (duty + 100) % PWM_PERIOD;
+	ret = pwm_set_duty(0, duty);
+	if(ESP_OK == ret)
+	{
+		ret = pwm_start();
+	}
+
+	return ret;
+}
+
+/* 数据位 n 输出到 s_nibble_pins[n]，按端口写入时换算成引脚掩码 */
+static const gpio_num_t s_nibble_pins[4] = { GPIO_NUM_0, GPIO_NUM_5, GPIO_NUM_13, GPIO_NUM_15 };
+static uint32_t s_nibble_mask[16];
+
+static esp_err_t bench_gpio_set_level(void *arg)
+{
+	static uint32_t value = 0;
+	int i = 0;
+
+	value = (value + 1) & 0x0F;
+	for(i = 0; i < 4; ++i)
+	{
+		gpio_set_level(s_nibble_pins[i], (value >> i) & 1);
+	}
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_gpio_port_write(void *arg)
+{
+	static uint32_t value = 0;
+
+	value = (value + 1) & 0x0F;
+	gpio_port_write(NIBBLE_MASK, s_nibble_mask[value]);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_gpio_port_write_atomic(void *arg)
+{
+	static uint32_t value = 0;
+
+	value = (value + 1) & 0x0F;
+	gpio_port_write_atomic(NIBBLE_MASK, s_nibble_mask[value]);
+
+	return ESP_OK;
+}
+
+static esp_err_t bench_log(void *arg)
+{
+	static uint32_t count = 0;
+
+	ESP_LOGI(TAG, "log line %u", ++count);
+
+	return ESP_OK;
+}
+
+static const bench_case_t s_cases[] = {
+	{ "i2c_cmd_link",      bench_i2c_cmd_link,  NULL, 100, 0 },
+	{ "mpu6050_burst14",   bench_mpu6050_burst, NULL, 100, 0 },
+	{ "i2c_bus_drv_read14", bench_i2c_bus_drv_read, NULL, 100, 0 },
+	{ "at24c32_page",      bench_at24c32_page,  NULL, 20,  0 },
+	{ "am2301_read",       bench_am2301,        NULL, 4,   AM2301_GAP_MS },
+	{ "sample_codec_mpu6050x32", bench_sample_codec, NULL, 20, 0 },
+	{ "imu_fusion_complementary", bench_imu_fusion_update, &s_fusion[IMU_FUSION_COMPLEMENTARY], 100, 0 },
+	{ "imu_fusion_mahony", bench_imu_fusion_update, &s_fusion[IMU_FUSION_MAHONY], 100, 0 },
+	{ "imu_fusion_madgwick", bench_imu_fusion_update, &s_fusion[IMU_FUSION_MADGWICK], 100, 0 },
+	{ "imu_fusion_get_euler", bench_imu_fusion_get, &s_fusion[IMU_FUSION_MADGWICK], 100, 0 },
+	{ "filter_cic3_r10_x40", bench_filter_cic, NULL, 100, 0 },
+	{ "filter_biquad_x40", bench_filter_biquad, NULL, 100, 0 },
+	{ "filter_mavg8_x40",  bench_filter_mavg,   NULL, 100, 0 },
+	{ "filter_median5_x40", bench_filter_median, NULL, 100, 0 },
+	{ "mpu6050_calib_warm", bench_mpu6050_calib_warm, NULL, 20, 0 },
+	{ "pwm_duty_start",    bench_pwm,           NULL, 100, 0 },
+	{ "gpio_set_level_x4", bench_gpio_set_level, NULL, 100, 0 },
+	{ "gpio_port_write_x4", bench_gpio_port_write, NULL, 100, 0 },
+	{ "gpio_port_write_atomic_x4", bench_gpio_port_write_atomic, NULL, 100, 0 },
+	{ "esp_logi",          bench_log,           NULL, 20,  0 },
+};
+
+/* 记录 MPU6050 采样，与按日志文本输出的长度比较 */
+static void record_trace(void)
+{
+	uint8_t data[MPU6050_RAW_LEN];
+	mpu6050_raw_t raw;
+	uint32_t text = 0;
+	char line[96];
+	int i = 0;
+
+	for(i = 0; i < TRACE_SAMPLES; ++i)
+	{
+		ESP_ERROR_CHECK(mpu6050_read_raw(mpu6050_dev, data));
+		mpu6050_decode(data, &raw);
+		s_trace_ms[i] = i * TRACE_PERIOD_MS;
+		s_trace[i][0] = raw.accel_x;
+		s_trace[i][1] = raw.accel_y;
+		s_trace[i][2] = raw.accel_z;
+		s_trace[i][3] = mpu6050_temp_centi(raw.temp);
+		s_trace[i][4] = raw.gyro_x;
+		s_trace[i][5] = raw.gyro_y;
+		s_trace[i][6] = raw.gyro_z;
+		s_trace_accel[i][0] = raw.accel_x;
+		s_trace_accel[i][1] = raw.accel_y;
+		s_trace_accel[i][2] = raw.accel_z;
+		s_trace_gyro[i][0] = raw.gyro_x;
+		s_trace_gyro[i][1] = raw.gyro_y;
+		s_trace_gyro[i][2] = raw.gyro_z;
+		memcpy(&s_filter_in[i][0], s_trace_accel[i], sizeof(s_trace_accel[i]));
+		memcpy(&s_filter_in[i][3], s_trace_gyro[i], sizeof(s_trace_gyro[i]));
+		text += snprintf(line, sizeof(line), "accel: %6d %6d %6d  gyro: %6d %6d %6d  temp: %d.%02d\n",
+						 raw.accel_x, raw.accel_y, raw.accel_z, raw.gyro_x, raw.gyro_y, raw.gyro_z,
+						 s_trace[i][3] / 100, abs(s_trace[i][3]) % 100);
+		vTaskDelay(TRACE_PERIOD_MS / portTICK_RATE_MS);
+	}
+
+	// 滤波数据块比记录长，从头重复
+	for(i = TRACE_SAMPLES; i < FILTER_BLOCK; ++i)
+	{
+		memcpy(s_filter_in[i], s_filter_in[i - TRACE_SAMPLES], sizeof(filter_frame_t));
+	}
+
+	s_trace_len = 0;
+	if(0 != sample_codec_schema_pack(&s_trace_schema, s_trace_stream, sizeof(s_trace_stream))
+	   && ESP_OK == bench_sample_codec(NULL))
+	{
+		ESP_LOGI(TAG, "sample_codec mpu6050 trace: %d samples, text %u bytes, raw %u bytes, encoded %u bytes (%u-byte blocks)",
+				 TRACE_SAMPLES, text, (unsigned)sizeof(s_trace_ms) + (unsigned)sizeof(s_trace), (unsigned)s_trace_len,
+				 TRACE_BLOCK_SIZE);
+	}
+}
+
+/* 冷启动：静止标定并保存；热启动：读取保存的结果并写入偏移寄存器 */
+static void compare_calib(void)
+{
+	mpu6050_calib_t calib;
+	uint32_t start = 0;
+	uint32_t cold = 0;
+	uint32_t warm = 0;
+
+	start = ccount_get();
+	ESP_ERROR_CHECK(mpu6050_calib_run(mpu6050_dev, CALIB_SAMPLES, &calib));
+	ESP_ERROR_CHECK(mpu6050_calib_save(at24c32_dev, MPU6050_CALIB_E2P_ADDR, &calib));
+	cold = ccount_get() - start;
+
+	start = ccount_get();
+	ESP_ERROR_CHECK(bench_mpu6050_calib_warm(NULL));
+	warm = ccount_get() - start;
+
+	ESP_LOGI(TAG, "mpu6050_calib: cold %u samples + save %u us, warm load + apply %u us", CALIB_SAMPLES,
+			 cold / CCOUNT_CPU_MHZ, warm / CCOUNT_CPU_MHZ);
+}
+
+void app_main(void)
+{
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
+	i2c_bus_dev_config_t e2p_drv_config = {
+		.name = "e2p_drv",
+		.addr = AT24C32_ADDR_DS3231_MODULE,
+		.reg_addr_len = 2,
+		.prio = I2C_BUS_PRIO_NORMAL,
+		.init = NULL,
+		.scl_hz = I2C_BUS_SCL_DRIVER,
+	};
+	i2c_bus_cache_stats_t cache_stats;
+	imu_fusion_config_t fusion_config;
+	imu_fusion_algo_t algo = IMU_FUSION_COMPLEMENTARY;
+	uint32_t pin_num[1] = { PWM_PIN };
+	uint32_t duties[1] = { 0 };
+	uint32_t value = 0;
+	int i = 0;
+	int failed = 0;
+
+	// SDK 驱动设备的读写复用缓存的命令连接
+	bus_config.cache_num = 4;
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(mpu6050_add(MPU6050_ADDR, &mpu6050_dev));
+	ESP_ERROR_CHECK(mpu6050_init(mpu6050_dev));
+	ESP_ERROR_CHECK(at24c32_add(AT24C32_ADDR_DS3231_MODULE, &at24c32_dev));
+	ESP_ERROR_CHECK(i2c_bus_add_device(&e2p_drv_config, &e2p_drv_dev));
+	ESP_ERROR_CHECK(am2301_init(AM2301_CTRL_PIN));
+	ESP_ERROR_CHECK(pwm_init(PWM_PERIOD, duties, 1, pin_num));
+	ESP_ERROR_CHECK(gpio_port_config(NIBBLE_MASK, GPIO_MODE_OUTPUT, 0));
+	for(value = 0; value < 16; ++value)
+	{
+		for(i = 0; i < 4; ++i)
+		{
+			if(0 != (value & (1 << i)))
+			{
+				s_nibble_mask[value] |= (1UL << s_nibble_pins[i]);
+			}
+		}
+	}
+
+	for(algo = IMU_FUSION_COMPLEMENTARY; algo <= IMU_FUSION_MADGWICK; ++algo)
+	{
+		fusion_config = (imu_fusion_config_t)IMU_FUSION_DEFAULT_CONFIG(algo);
+		fusion_config.gyro_scale = IMU_FUSION_GYRO_SCALE(MPU6050_GYRO_LSB_PER_DPS);
+		ESP_ERROR_CHECK(imu_fusion_init(&s_fusion[algo], &fusion_config));
+	}
+
+	ESP_ERROR_CHECK(filter_cic_init(&s_cic, 3, FILTER_CIC_RATIO));
+	ESP_ERROR_CHECK(filter_biquad_init(&s_biquad, &s_lowpass));
+	ESP_ERROR_CHECK(filter_mavg_init(&s_mavg, 8));
+	ESP_ERROR_CHECK(filter_median_init(&s_median, 5));
+
+	// 传感器上电后等待稳定
+	vTaskDelay(AM2301_GAP_MS / portTICK_RATE_MS);
+	record_trace();
+	compare_calib();
+
+	failed = bench_run_all(s_cases, sizeof(s_cases) / sizeof(s_cases[0]));
+	ESP_LOGI(TAG, "%d case(s), %d failed, free heap: %u", (int)(sizeof(s_cases) / sizeof(s_cases[0])), failed,
+			 esp_get_free_heap_size());
+
+	if(ESP_OK == i2c_bus_get_cache_stats(&cache_stats))
+	{
+		ESP_LOGI(TAG, "i2c_bus cache hits: %u, misses: %u, bypass: %u, pool used: %u/%u, peak: %u",
+				 cache_stats.hits, cache_stats.misses, cache_stats.bypass,
+				 cache_stats.pool.used, cache_stats.pool.block_num, cache_stats.pool.peak);
+	}
+}
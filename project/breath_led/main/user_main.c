@@ -26,67 +26,56 @@
 /* pwm 驱动 */
 #include "driver/pwm.h"
 
+#include "pwm_batch.h"
+#include "pwm_dither.h"
+#include "pwm_fade.h"
+
 #define PWM_CH_NUM          (1)
 #define PWM_PERIOD          (500)
 
 /**
- * 呼吸灯占空比步长计算
- * 实例：实现 2 秒/次的呼吸灯效果 
- * 假设每 20 ms 调整一次占空比参数
- * 每次呼吸会改变占空比次数：2000ms / 20ms = 100 次
- * 因此：增加占空比 50 次，减小占空比 50 次
- * PWM 周期为 500 us
- * 占空比变化步长： 500us / 50 = 10us
- * (此时占空比范围：0% ~ 100%)
- * 注意：占空比应该为高电平时长占整个周期时长的百分比，而实际设置的却是高电平工作时长，可能不太好理解。
+ * 呼吸灯参数
+ * 实例：实现 2 秒/次的呼吸灯效果，亮 1 秒，暗 1 秒
+ * 原来由任务每 20 ms 线性调整一次占空比，平滑度受系统 tick 和任务调度影响，
+ * 而且人眼对亮度的感知是非线性的，只好把亮度限制在 30% 左右。
+ * 现在交给 pwm_fade 渐变引擎：sdkconfig.defaults 把节拍频率提高到 1000Hz，渐变任务每个节拍更新一次，
+ * 使用正弦缓入缓出曲线 (已做 CIE 1931 亮度校正)，渐变期间应用任务不需要唤醒。
+ * 同时开启高分辨率模式：1000Hz 更新时可以抖动 3 位而不产生可见闪烁，
+ * 占空比单位为 1/8 us，500us 周期下约 12 位有效分辨率，低亮度时看不出台阶。
+ * (PWM 与 hw_timer 共用 FRC1，不能按 PWM 周期抖动，更多的位数需要更高的更新频率)
  */
-// #define BREATH_LEN_STEP     (10)
-/* 占空比范围：0% ~ 50% */
-// #define BREATH_LEN_STEP     (5)
-/* 占空比范围：0% ~ 30% */
-/* 30% 占空比的呼吸灯效果，个人感觉最好看，步长 10 和 5 都太亮，对比起来暗灯的时间就变短了，效果不明显，还刺眼 */
-#define BREATH_LEN_STEP     (3)
+#define BREATH_HALF_MS      (1000)
+#define BREATH_RATE_HZ      (1000)
+
+static const char *s_tag = "breath_led";
 
-// static const char *s_tag = "breath_led";
+/* 高分辨率模式的小数位数与最大占空比 (单位 1/2^小数位数 us) */
+static uint8_t s_frac_bits = 0;
+#define BREATH_MAX_DUTY     (PWM_PERIOD << s_frac_bits)
 
 const uint32_t pwm_chs[PWM_CH_NUM] = { GPIO_NUM_4 };
 uint32_t pwm_duties[PWM_CH_NUM] = { 0 };
-int16_t pwm_phases[PWM_CH_NUM] = { 0 };
 
-void app_main(void)
+/* 渐变完成回调 (渐变任务中执行)：变亮完成后变暗，变暗完成后变亮 */
+static void breath_fade_done(uint8_t channel, void *arg)
 {
-    int16_t i = 0;
+    uint32_t target = (0 == (uint32_t)arg) ? BREATH_MAX_DUTY : 0;
 
-    // 初始化 PWM ，1 个通道，输出至 GPIO4，初始占空比为 0
-    pwm_init(PWM_PERIOD, pwm_duties, PWM_CH_NUM, pwm_chs);
-    // 设置通道 0 的相位为 0
-    pwm_set_phase(0, 0);
-    pwm_start();
+    pwm_fade_start(channel, target, BREATH_HALF_MS, PWM_FADE_CURVE_EASE, breath_fade_done, (void *)target);
+}
 
-    for(;;)
-    {
-        vTaskDelay(20 / portTICK_RATE_MS);
+void app_main(void)
+{
+    // 初始化 PWM ，1 个通道，输出至 GPIO4，初始占空比为 0，相位为 0
+    pwm_batch_init(PWM_PERIOD, pwm_duties, PWM_CH_NUM, pwm_chs);
+    pwm_start();
 
-        // 0 到 49，共 50 次，占空比增加
-        if(50 > i)
-        {
-            pwm_duties[0] += BREATH_LEN_STEP;
-        }
-        // 50 到 99，共 50 次，占空比减少
-        else if(100 > i)
-        {
-            pwm_duties[0] -= BREATH_LEN_STEP;
-        }
-        // ESP_LOGI(s_tag, "%d -> %d", i, pwm_duties[0]);
-        pwm_set_duty(0, pwm_duties[0]);
-        // 一定要在此处加 pwm_start()，让设置生效
-        pwm_start();
-        ++i;
+    // 启动渐变引擎，开始第一次变亮
+    pwm_fade_init(BREATH_RATE_HZ);
+    s_frac_bits = pwm_dither_max_frac_bits(BREATH_RATE_HZ);
+    pwm_fade_set_resolution(s_frac_bits);
+    ESP_LOGI(s_tag, "fade %d Hz, dither %d bits", BREATH_RATE_HZ, s_frac_bits);
+    breath_fade_done(0, (void *)0);
 
-        // 复位，重新开始增加/减少占空比
-        if(100 == i)
-        {
-            i = 0;
-        }
-    }
+    // 之后的呼吸效果全部在渐变任务中完成，app_main 可以直接返回
 }
@@ -0,0 +1,107 @@
+/**
+ * 说明:
+ * 本实例展示用 DS3231 的方波校准 ESP8266 的时钟 (clock_calib 组件)
+ * DS3231 的 INT/SQW 输出 1Hz 方波，每个上升沿中断中读取 CCOUNT，最近 16 秒的 CPU 周期数与标称值之比即为晶振误差
+ *
+ * GPIO 配置状态:
+ * GPIO14 作为主机 SDA 连接至 DS3231 SDA
+ * GPIO2  作为主机 SCL 连接到 DS3231 SCL
+ * GPIO12 作为输入连接到 DS3231 INT/SQW (开漏，使能内部上拉)
+ *
+ * 测试:
+ * 每 10 秒输出当前误差 (ppm)、窗口秒数、单秒周期数的离散 (中断延迟抖动) 与丢弃的间隔数，
+ * 以及按节拍计时的运行时间修正前后的值、1 秒真实周期对应的 hw_timer 标称周期、DS3231 的温度 (晶振误差随温度变化)；
+ * 总线恢复后 ds3231 驱动重新打开 1Hz 方波，不需要实例处理
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+#include "ds3231.h"
+#include "clock_calib.h"
+
+
+static const char *TAG = "main";
+
+#define SQW_GPIO					(GPIO_NUM_12)
+#define REPORT_PERIOD_MS			(10000)
+#define TIMER_PERIOD_US				(1000000)
+
+static i2c_bus_dev_handle_t ds3231_dev = NULL;
+
+/* ppb -> "+12.345" ppm */
+static const char *ppm_str(int32_t ppb, char *buf, size_t len)
+{
+	snprintf(buf, len, "%s%d.%03d", (0 > ppb) ? "-" : "+", abs(ppb) / 1000, abs(ppb) % 1000);
+
+	return buf;
+}
+
+static void clock_task(void *arg)
+{
+	clock_calib_config_t calib_config = CLOCK_CALIB_DEFAULT_CONFIG();
+	clock_calib_status_t status;
+	TickType_t last_wake = 0;
+	TickType_t start = 0;
+	uint32_t uptime_ms = 0;
+	int32_t temp = 0;
+	uint8_t regs[DS3231_REG_NUM];
+	char ppm[16];
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
+
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(ds3231_add(&ds3231_dev));
+	// 失败时继续运行，出错的寄存器已在日志中输出
+	if(ESP_OK != ds3231_init(ds3231_dev))
+	{
+		ESP_LOGW(TAG, "ds3231 init failed");
+	}
+
+	// INT/SQW 改为 1Hz 方波，闹钟中断不再从该引脚输出
+	ESP_ERROR_CHECK(ds3231_set_sqw(ds3231_dev, DS3231_SQW_1HZ));
+	calib_config.gpio_num = SQW_GPIO;
+	ESP_ERROR_CHECK(clock_calib_start(&calib_config));
+
+	start = xTaskGetTickCount();
+	last_wake = start;
+	while(1)
+	{
+		vTaskDelayUntil(&last_wake, REPORT_PERIOD_MS / portTICK_RATE_MS);
+
+		if(ESP_OK == ds3231_read_all(ds3231_dev, regs))
+		{
+			temp = ds3231_temp_centi(regs[DS3231_REG_TEMP_MSB], regs[DS3231_REG_TEMP_LSB]);
+			ESP_LOGI(TAG, "ds3231 temp:%c%d.%02d", temp < 0 ? '-' : ' ', abs(temp) / 100, abs(temp) % 100);
+		}
+
+		clock_calib_get(&status);
+		if(!status.valid)
+		{
+			ESP_LOGW(TAG, "clock: no reference edges on GPIO%d", SQW_GPIO);
+			continue;
+		}
+
+		uptime_ms = (last_wake - start) * portTICK_RATE_MS;
+		ESP_LOGI(TAG, "clock: %s ppm, window %u s, spread %u cycles, rejected %u", ppm_str(status.ppb, ppm, sizeof(ppm)),
+				 status.seconds, status.spread, status.rejected);
+		// 按节拍计时的运行时间比真实时间多出 uptime x ppb / 10^9
+		ESP_LOGI(TAG, "uptime: %u ms by ticks, %u ms real, ticks ahead %d us; %u us timer period -> %u us nominal",
+				 uptime_ms, clock_calib_to_real(uptime_ms), (int)((int64_t)uptime_ms * status.ppb / 1000000),
+				 TIMER_PERIOD_US, clock_calib_to_nominal(TIMER_PERIOD_US));
+	}
+
+	vTaskDelete(NULL);
+}
+
+void app_main(void)
+{
+	xTaskCreate(clock_task, "clock_task", 2048, NULL, 10, NULL);
+}
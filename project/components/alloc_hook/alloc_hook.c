@@ -0,0 +1,61 @@
+#include <stddef.h>
+
+#include "alloc_hook.h"
+
+static volatile uint32_t s_alloc_count = 0;
+static alloc_hook_fn_t s_hook = NULL;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t num, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static inline void alloc_hook_alloc(size_t size)
+{
+    alloc_hook_fn_t hook = s_hook;
+
+    ++s_alloc_count;
+    if(NULL != hook)
+    {
+        hook(size, false);
+    }
+}
+
+void *__wrap_malloc(size_t size)
+{
+    alloc_hook_alloc(size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t num, size_t size)
+{
+    alloc_hook_alloc(num * size);
+    return __real_calloc(num, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    alloc_hook_alloc(size);
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+    alloc_hook_fn_t hook = s_hook;
+
+    if(NULL != ptr && NULL != hook)
+    {
+        hook(0, true);
+    }
+    __real_free(ptr);
+}
+
+void alloc_hook_set(alloc_hook_fn_t fn)
+{
+    s_hook = fn;
+}
+
+uint32_t alloc_hook_count(void)
+{
+    return s_alloc_count;
+}
@@ -0,0 +1,10 @@
+#
+# alloc_hook 组件
+#
+# malloc/calloc/realloc/free 链接包装：分配计数与回调
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
+
+# 链接时把 malloc/calloc/realloc/free 换成包装函数，工程中只要包含本组件就对全部代码生效
+COMPONENT_ADD_LDFLAGS += -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc -Wl,--wrap=free
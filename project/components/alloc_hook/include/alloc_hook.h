@@ -0,0 +1,45 @@
+/**
+ * 分配钩子
+ *
+ * 通过链接选项 -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free (见 component.mk)
+ * 把这四个函数换成包装函数：统计分配次数，并在每次分配/释放时调用注册的回调。
+ *
+ * 只统计经过这四个符号的调用，SDK 内部直接调用 pvPortMalloc/heap_caps_malloc 的分配不计入，
+ * 这部分可以从空闲堆的变化看出。
+ */
+#ifndef _ALLOC_HOOK_H_
+#define _ALLOC_HOOK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 分配回调
+ *
+ * @param  size  分配时为请求的字节数 (calloc 为两参数之积)，释放时为 0
+ * @param  is_free  true 为释放
+ *
+ * 在调用 malloc/free 的上下文中执行，不能再分配内存
+ */
+typedef void (*alloc_hook_fn_t)(size_t size, bool is_free);
+
+/**
+ * @brief  注册回调，NULL 取消
+ */
+void alloc_hook_set(alloc_hook_fn_t fn);
+
+/**
+ * @brief  到目前为止经过 malloc/calloc/realloc 的分配次数
+ */
+uint32_t alloc_hook_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ALLOC_HOOK_H_ */
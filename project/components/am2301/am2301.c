@@ -0,0 +1,138 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "esp_system.h"
+
+#include "am2301.h"
+
+/* 起始信号低电平时间 */
+#define AM2301_START_US             (1000)
+/* 等待应答的最长时间 */
+#define AM2301_ACK_TIMEOUT_US       (1000)
+/* 等待每一位电平变化的最长时间 */
+#define AM2301_BIT_TIMEOUT_US       (200)
+/* 每一位上升沿之后的采样时刻，高电平 26us 为 0、70us 为 1 */
+#define AM2301_BIT_SAMPLE_US        (35)
+
+/* 等待数据线离开 level，超时返回 false */
+static bool am2301_wait(gpio_num_t gpio_num, int level, int timeout_us)
+{
+    int retry = 0;
+
+    while(level == gpio_get_level(gpio_num))
+    {
+        if(++retry >= timeout_us)
+        {
+            return false;
+        }
+        os_delay_us(1);
+    }
+
+    return true;
+}
+
+static esp_err_t am2301_read_bit(gpio_num_t gpio_num, uint8_t *bit)
+{
+    // 等待低电平，再等待高电平
+    if(!am2301_wait(gpio_num, 1, AM2301_BIT_TIMEOUT_US) || !am2301_wait(gpio_num, 0, AM2301_BIT_TIMEOUT_US))
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    os_delay_us(AM2301_BIT_SAMPLE_US);
+
+    *bit = (1 == gpio_get_level(gpio_num)) ? 1 : 0;
+
+    return ESP_OK;
+}
+
+static esp_err_t am2301_receive(gpio_num_t gpio_num, uint8_t recv_byte[5])
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t bit = 0;
+    int i = 0;
+    int j = 0;
+
+    // 发送起始信号：输出拉低 1ms，输出拉高，立刻转为输入模式
+    gpio_set_level(gpio_num, 0);
+    os_delay_us(AM2301_START_US);
+    gpio_set_level(gpio_num, 1);
+    gpio_set_direction(gpio_num, GPIO_MODE_INPUT);
+
+    // 等待应答低电平 80us，之后还有高电平 80us
+    if(!am2301_wait(gpio_num, 1, AM2301_ACK_TIMEOUT_US) || !am2301_wait(gpio_num, 0, AM2301_ACK_TIMEOUT_US))
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    for(i = 0; i < 5 && ESP_OK == ret; ++i)
+    {
+        for(j = 0; j < 8 && ESP_OK == ret; ++j)
+        {
+            ret = am2301_read_bit(gpio_num, &bit);
+            recv_byte[i] = (recv_byte[i] << 1) | bit;
+        }
+    }
+
+    // 最后一位为 1 时采样时刻还在高电平内，先等待结束信号拉低，再等待其结束
+    if(ESP_OK == ret && (!am2301_wait(gpio_num, 1, AM2301_BIT_TIMEOUT_US) || !am2301_wait(gpio_num, 0, AM2301_BIT_TIMEOUT_US)))
+    {
+        ret = ESP_ERR_TIMEOUT;
+    }
+
+    return ret;
+}
+
+esp_err_t am2301_init(gpio_num_t gpio_num)
+{
+    gpio_config_t io_conf;
+
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.mode = GPIO_MODE_OUTPUT;
+    io_conf.pin_bit_mask = 1UL << gpio_num;
+    io_conf.pull_down_en = 0;
+    io_conf.pull_up_en = 0;
+
+    if(ESP_OK != gpio_config(&io_conf))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return gpio_set_level(gpio_num, 1);
+}
+
+esp_err_t am2301_read(gpio_num_t gpio_num, am2301_data_t *data)
+{
+    uint8_t recv_byte[5] = { 0 };
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == data)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ret = am2301_receive(gpio_num, recv_byte);
+
+    // 无论成功与否，数据线恢复为输出高电平
+    gpio_set_direction(gpio_num, GPIO_MODE_OUTPUT);
+    gpio_set_level(gpio_num, 1);
+
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+    if(recv_byte[4] != (uint8_t)(recv_byte[0] + recv_byte[1] + recv_byte[2] + recv_byte[3]))
+    {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    data->humidity = (recv_byte[0] << 8) | recv_byte[1];
+    // 温度最高位为符号位，其余为绝对值
+    data->temp = ((recv_byte[2] & 0x7F) << 8) | recv_byte[3];
+    if(0 != (recv_byte[2] & 0x80))
+    {
+        data->temp = -data->temp;
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,7 @@
+#
+# am2301 组件
+#
+# AM2301 (DHT21) 温湿度传感器单总线驱动
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,42 @@
+/**
+ * AM2301 (DHT21) 温湿度传感器驱动
+ *
+ * 单总线：主机拉低 1ms 作为起始信号后释放，传感器应答低 80us、高 80us，
+ * 然后发送 40 位数据 (湿度 16 位、温度 16 位、校验和 8 位)，每位低 50us 后高 26us 为 0、高 70us 为 1。
+ * 读取过程为忙等待，约 5ms，两次读取至少间隔 2s
+ */
+#ifndef _AM2301_H_
+#define _AM2301_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t humidity;              /*!< 湿度，单位 0.1%RH */
+    int16_t temp;                   /*!< 温度，单位 0.1°C */
+} am2301_data_t;
+
+/**
+ * @brief  数据线配置为输出并保持高电平 (空闲)
+ */
+esp_err_t am2301_init(gpio_num_t gpio_num);
+
+/**
+ * @brief  发送起始信号并读取一次测量值，结束后数据线恢复为输出高电平
+ *
+ * @return ESP_OK / ESP_ERR_TIMEOUT (传感器未应答或时序超时) / ESP_ERR_INVALID_CRC (校验和错误)
+ */
+esp_err_t am2301_read(gpio_num_t gpio_num, am2301_data_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AM2301_H_ */
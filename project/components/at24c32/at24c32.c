@@ -0,0 +1,66 @@
+#include <stddef.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "at24c32.h"
+
+esp_err_t at24c32_add(uint8_t addr, i2c_bus_dev_handle_t *dev)
+{
+    i2c_bus_dev_config_t config = {
+        .name = "at24c32",
+        .addr = addr,
+        .reg_addr_len = 2,
+        .prio = I2C_BUS_PRIO_LOW,
+        // 数据手册保证 5V 供电时 400kHz，3.3V 供电读写校验出错时改为 I2C_BUS_SCL_STANDARD
+        .scl_hz = I2C_BUS_SCL_FAST,
+    };
+
+    return i2c_bus_add_device(&config, dev);
+}
+
+esp_err_t at24c32_write(i2c_bus_dev_handle_t dev, uint16_t mem_addr, const uint8_t *data, size_t data_len)
+{
+    esp_err_t ret = ESP_OK;
+    size_t cur_len = 0;
+
+    if(NULL == data || AT24C32_SIZE < (size_t)mem_addr + data_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    while(0 < data_len)
+    {
+        // 本页剩余空间
+        cur_len = AT24C32_PAGE_SIZE - (mem_addr % AT24C32_PAGE_SIZE);
+        if(cur_len > data_len)
+        {
+            cur_len = data_len;
+        }
+
+        ret = i2c_bus_write(dev, mem_addr, data, cur_len);
+        if(ESP_OK != ret)
+        {
+            return ret;
+        }
+
+        mem_addr += cur_len;
+        data += cur_len;
+        data_len -= cur_len;
+
+        // 当前页写完后，需要增加适当的延时，让写入执行完成，再继续写下一页或读取
+        vTaskDelay(AT24C32_WRITE_CYCLE_MS / portTICK_RATE_MS);
+    }
+
+    return ret;
+}
+
+esp_err_t at24c32_read(i2c_bus_dev_handle_t dev, uint16_t mem_addr, uint8_t *data, size_t data_len)
+{
+    if(NULL == data || AT24C32_SIZE < (size_t)mem_addr + data_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return i2c_bus_read(dev, mem_addr, data, data_len);
+}
@@ -0,0 +1,7 @@
+#
+# at24c32 组件
+#
+# AT24C32 EEPROM 驱动，基于 i2c_bus 组件
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
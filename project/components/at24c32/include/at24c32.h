@@ -0,0 +1,53 @@
+/**
+ * AT24C32 EEPROM 驱动
+ *
+ * 4KB，每页 32 字节，16 位存储地址。写操作自动按页拆分，读操作可以跨页连续读取。
+ */
+#ifndef _AT24C32_H_
+#define _AT24C32_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+默认 AT24C32 芯片上 A0，A1，A2 引脚为低电平，地址为 0x50
+DS3231 模块上的 AT24C32 芯片 A0，A1，A2 引脚都为高电平，所以地址为 0x57 (8 位写地址 0xAE)
+*/
+#define AT24C32_ADDR                0x50
+#define AT24C32_ADDR_DS3231_MODULE  0x57
+
+#define AT24C32_SIZE                (4096)
+#define AT24C32_PAGE_SIZE           (32)
+/* 页写周期最长 10ms */
+#define AT24C32_WRITE_CYCLE_MS      (20)
+
+/**
+ * @brief  把 AT24C32 注册到总线上
+ *
+ * @param  addr  7 位地址，A0 ~ A2 决定：0x50 ~ 0x57
+ */
+esp_err_t at24c32_add(uint8_t addr, i2c_bus_dev_handle_t *dev);
+
+/**
+ * @brief  写数据，支持跨页，每页写完等待写周期完成
+ */
+esp_err_t at24c32_write(i2c_bus_dev_handle_t dev, uint16_t mem_addr, const uint8_t *data, size_t data_len);
+
+/**
+ * @brief  读数据，是否跨页，都不需要增加延时
+ */
+esp_err_t at24c32_read(i2c_bus_dev_handle_t dev, uint16_t mem_addr, uint8_t *data, size_t data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AT24C32_H_ */
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_system.h"
+
+#include "ccount.h"
+#include "alloc_hook.h"
+#include "bench.h"
+
+/* 测量计时开销的次数，取最小值 */
+#define BENCH_OVERHEAD_RUNS         (16)
+
+static uint32_t s_samples[BENCH_SAMPLES_MAX];
+
+/* 连续两次读取 CCOUNT 之差，从每个样本中扣除 */
+static uint32_t bench_overhead(void)
+{
+    uint32_t overhead = UINT32_MAX;
+    uint32_t start = 0;
+    uint32_t cycles = 0;
+    int i = 0;
+
+    for(i = 0; i < BENCH_OVERHEAD_RUNS; ++i)
+    {
+        start = ccount_get();
+        cycles = ccount_get() - start;
+        if(cycles < overhead)
+        {
+            overhead = cycles;
+        }
+    }
+
+    return overhead;
+}
+
+/* 样本最多 128 个，插入排序足够 */
+static void bench_sort(uint32_t *samples, int num)
+{
+    uint32_t value = 0;
+    int i = 0;
+    int j = 0;
+
+    for(i = 1; i < num; ++i)
+    {
+        value = samples[i];
+        for(j = i; j > 0 && samples[j - 1] > value; --j)
+        {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = value;
+    }
+}
+
+esp_err_t bench_run(const bench_case_t *bench_case, bench_result_t *result)
+{
+    uint32_t overhead = 0;
+    uint32_t allocs = 0;
+    uint32_t heap = 0;
+    uint32_t start = 0;
+    uint32_t cycles = 0;
+    int num = 0;
+    int i = 0;
+
+    if(NULL == bench_case || NULL == bench_case->fn || NULL == result
+       || 0 == bench_case->iterations || BENCH_SAMPLES_MAX < bench_case->iterations)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(result, 0, sizeof(bench_result_t));
+    result->name = bench_case->name;
+    result->iterations = bench_case->iterations;
+    num = bench_case->iterations;
+
+    overhead = bench_overhead();
+
+    // 预热：首次执行的延迟初始化、缓存未命中不计入
+    bench_case->fn(bench_case->arg);
+
+    allocs = alloc_hook_count();
+    heap = esp_get_free_heap_size();
+    for(i = 0; i < num; ++i)
+    {
+        if(0 != bench_case->gap_ms)
+        {
+            vTaskDelay(bench_case->gap_ms / portTICK_RATE_MS);
+        }
+
+        start = ccount_get();
+        if(ESP_OK != bench_case->fn(bench_case->arg))
+        {
+            ++result->errors;
+        }
+        cycles = ccount_get() - start;
+        s_samples[i] = (cycles > overhead) ? cycles - overhead : 0;
+    }
+    result->allocs_x100 = (alloc_hook_count() - allocs) * 100 / num;
+    result->heap_delta = (int32_t)(heap - esp_get_free_heap_size());
+
+    // 最近秩法：p99 为第 ceil(0.99 * n) 个样本
+    bench_sort(s_samples, num);
+    result->min = s_samples[0];
+    result->median = s_samples[num / 2];
+    result->p99 = s_samples[(num * 99 + 99) / 100 - 1];
+    result->max = s_samples[num - 1];
+
+    return ESP_OK;
+}
+
+void bench_report_header(void)
+{
+    printf("#bench cpu_mhz=%d unit=cycles\n", CCOUNT_CPU_MHZ);
+    printf("bench,name,iterations,errors,min,median,p99,max,allocs,heap_delta\n");
+}
+
+void bench_report(const bench_result_t *result)
+{
+    printf("bench,%s,%u,%u,%u,%u,%u,%u,%u.%02u,%d\n", result->name,
+           result->iterations, result->errors,
+           result->min, result->median, result->p99, result->max,
+           result->allocs_x100 / 100, result->allocs_x100 % 100, result->heap_delta);
+}
+
+int bench_run_all(const bench_case_t *cases, int num)
+{
+    bench_result_t result;
+    int failed = 0;
+    int i = 0;
+
+    bench_report_header();
+    for(i = 0; i < num; ++i)
+    {
+        if(ESP_OK != bench_run(&cases[i], &result))
+        {
+            ++failed;
+            continue;
+        }
+        if(0 != result.errors)
+        {
+            ++failed;
+        }
+        bench_report(&result);
+    }
+
+    return failed;
+}
@@ -0,0 +1,7 @@
+#
+# bench 组件
+#
+# 驱动热点路径的 CCOUNT 微基准：中位数、p99 与分配次数
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,77 @@
+/**
+ * 微基准
+ *
+ * 用 CPU 周期计数器 CCOUNT 测量一个操作的执行时间，主机仿真时为虚拟时钟，结果可以重复。
+ * 每个用例先执行一次预热 (不计入)，再连续执行 iterations 次，每次单独计时，
+ * 扣除读取 CCOUNT 本身的开销后排序，得到最小值、中位数、p99 与最大值。
+ *
+ * 分配次数由 alloc_hook 组件统计，只包括经过 malloc/calloc/realloc 的调用，
+ * 直接调用 pvPortMalloc/heap_caps_malloc 的分配如果没有释放，会体现在空闲堆的变化 heap_delta 上。
+ *
+ * 结果按 CSV 输出，每行以 "bench," 开头，便于从日志中提取并用 tools/bench_compare 比较：
+ *   #bench cpu_mhz=80 unit=cycles
+ *   bench,name,iterations,errors,min,median,p99,max,allocs,heap_delta
+ *   bench,mpu6050_burst14,100,0,...
+ */
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 每个用例最多的计时次数，采样缓冲区为静态数组，bench_run() 不可重入 */
+#define BENCH_SAMPLES_MAX           (128)
+
+/* 被测操作，返回值不是 ESP_OK 时计入 errors */
+typedef esp_err_t (*bench_fn_t)(void *arg);
+
+typedef struct {
+    const char *name;               /*!< 用例名，不能包含逗号 */
+    bench_fn_t fn;                  /*!< 被测操作 */
+    void *arg;                      /*!< 传给 fn 的参数 */
+    uint16_t iterations;            /*!< 计时次数，1 ~ BENCH_SAMPLES_MAX */
+    uint16_t gap_ms;                /*!< 两次执行之间的间隔 (不计时)，用于有最小采样间隔的设备 */
+} bench_case_t;
+
+typedef struct {
+    const char *name;
+    uint16_t iterations;
+    uint16_t errors;
+    uint32_t min;                   /*!< 周期数，已扣除计时开销 */
+    uint32_t median;
+    uint32_t p99;
+    uint32_t max;
+    uint32_t allocs_x100;           /*!< 平均每次的分配次数 x 100 */
+    int32_t heap_delta;             /*!< 计时期间空闲堆减少的字节数，非 0 表示泄漏 */
+} bench_result_t;
+
+/**
+ * @brief  运行一个用例
+ */
+esp_err_t bench_run(const bench_case_t *bench_case, bench_result_t *result);
+
+/**
+ * @brief  输出结果表头
+ */
+void bench_report_header(void);
+
+/**
+ * @brief  输出一行结果
+ */
+void bench_report(const bench_result_t *result);
+
+/**
+ * @brief  依次运行并输出一组用例，返回出错的用例数
+ */
+int bench_run_all(const bench_case_t *cases, int num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BENCH_H_ */
@@ -0,0 +1,10 @@
+#include "ccount.h"
+
+void ccount_delay(uint32_t cycles)
+{
+    uint32_t start = ccount_get();
+
+    while((ccount_get() - start) < cycles)
+    {
+    }
+}
@@ -0,0 +1,7 @@
+#
+# ccount 组件
+#
+# CPU 周期计数器 CCOUNT 读取与换算
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,61 @@
+/**
+ * CPU 周期计数器 CCOUNT
+ *
+ * Xtensa 内核每个 CPU 时钟周期 CCOUNT 加 1，80MHz 时约 53.7s 回绕一次，
+ * 用两次读数之差 (无符号减法) 计算间隔即可正确处理回绕。
+ * 主机仿真时由 tools/host_sim 提供虚拟时钟 sim_ccount()。
+ */
+#ifndef _CCOUNT_H_
+#define _CCOUNT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CPU 主频，默认 80MHz，运行在 160MHz 时通过 CFLAGS 覆盖 */
+#ifndef CCOUNT_CPU_MHZ
+#define CCOUNT_CPU_MHZ              (80)
+#endif
+
+#if defined(__XTENSA__)
+static inline uint32_t ccount_get(void)
+{
+    uint32_t ccount;
+
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+
+    return ccount;
+}
+#else
+uint32_t sim_ccount(void);
+
+static inline uint32_t ccount_get(void)
+{
+    return sim_ccount();
+}
+#endif
+
+/* 周期数 -> 微秒 */
+static inline uint32_t ccount_to_us(uint32_t cycles)
+{
+    return cycles / CCOUNT_CPU_MHZ;
+}
+
+/* 从 start 到现在经过的微秒数 */
+static inline uint32_t ccount_elapsed_us(uint32_t start)
+{
+    return (ccount_get() - start) / CCOUNT_CPU_MHZ;
+}
+
+/**
+ * @brief  忙等待指定的 CPU 周期数
+ */
+void ccount_delay(uint32_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CCOUNT_H_ */
@@ -0,0 +1,227 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ccount.h"
+#include "clock_calib.h"
+
+#define CLOCK_CALIB_PPB             (1000000000LL)
+/* 参考时钟 1 秒的标称 CPU 周期数 */
+#define CLOCK_CALIB_NOMINAL         ((uint32_t)CCOUNT_CPU_MHZ * 1000000)
+#define CLOCK_CALIB_REJECT_CYCLES   ((uint32_t)CCOUNT_CPU_MHZ * CLOCK_CALIB_REJECT_PPM)
+
+typedef struct {
+    bool running;
+    gpio_num_t gpio_num;
+    uint32_t ref_hz;
+    uint8_t window_s;
+    uint32_t period;                /*!< 参考周期的标称 CPU 周期数 */
+    /* 以下由中断修改 */
+    uint32_t edges;                 /*!< 当前 1 秒内的边沿数 */
+    bool stamped;                   /*!< last 有效 */
+    bool glitch;                    /*!< 当前 1 秒内丢失或多出边沿 */
+    uint32_t last;                  /*!< 上一个整秒边沿的 CCOUNT */
+    uint32_t prev;                  /*!< 上一个边沿的 CCOUNT */
+    TickType_t edge_tick;           /*!< 上一个边沿的节拍数 */
+    uint32_t cycles[CLOCK_CALIB_WINDOW_MAX];
+    uint8_t head;                   /*!< 下一个写入位置 */
+    uint8_t count;
+    uint64_t sum;                   /*!< cycles[] 中 count 项之和 */
+    uint32_t total;
+    uint32_t rejected;
+} clock_calib_t;
+
+static clock_calib_t s_calib;
+
+static void clock_calib_isr(void *arg)
+{
+    uint32_t now = ccount_get();
+    uint32_t cycles = now - s_calib.prev;
+
+    s_calib.prev = now;
+    s_calib.edge_tick = xTaskGetTickCountFromISR();
+
+    // 与上一个边沿的间隔偏离参考周期超过半个周期：丢失或多出边沿
+    if(s_calib.stamped && (cycles > s_calib.period + s_calib.period / 2 || cycles < s_calib.period / 2))
+    {
+        s_calib.glitch = true;
+    }
+
+    if(++s_calib.edges < s_calib.ref_hz && s_calib.stamped)
+    {
+        return;
+    }
+    s_calib.edges = 0;
+
+    // 第一个边沿只记录起点
+    if(!s_calib.stamped)
+    {
+        s_calib.stamped = true;
+        s_calib.last = now;
+        return;
+    }
+
+    cycles = now - s_calib.last;
+    s_calib.last = now;
+    if(s_calib.glitch || cycles > CLOCK_CALIB_NOMINAL + CLOCK_CALIB_REJECT_CYCLES
+       || cycles < CLOCK_CALIB_NOMINAL - CLOCK_CALIB_REJECT_CYCLES)
+    {
+        s_calib.glitch = false;
+        ++s_calib.rejected;
+        return;
+    }
+
+    // 窗口满时移出最老的一秒
+    if(s_calib.count == s_calib.window_s)
+    {
+        s_calib.sum -= s_calib.cycles[s_calib.head];
+    }
+    else
+    {
+        ++s_calib.count;
+    }
+    s_calib.cycles[s_calib.head] = cycles;
+    s_calib.sum += cycles;
+    s_calib.head = (s_calib.head + 1) % s_calib.window_s;
+    ++s_calib.total;
+}
+
+static int32_t clock_calib_calc_ppb(uint64_t sum, uint8_t count)
+{
+    int64_t nominal = (int64_t)CLOCK_CALIB_NOMINAL * count;
+
+    if(0 == count)
+    {
+        return 0;
+    }
+
+    // 差值不超过 count x CLOCK_CALIB_REJECT_CYCLES，乘 10^9 不会溢出
+    return (int32_t)(((int64_t)sum - nominal) * CLOCK_CALIB_PPB / nominal);
+}
+
+esp_err_t clock_calib_start(const clock_calib_config_t *config)
+{
+    gpio_config_t io_conf;
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == config || !GPIO_IS_VALID_GPIO(config->gpio_num) || GPIO_NUM_16 == config->gpio_num
+       || 0 == config->ref_hz || 0 == config->window_s || CLOCK_CALIB_WINDOW_MAX < config->window_s)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(s_calib.running)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(&s_calib, 0, sizeof(s_calib));
+    s_calib.gpio_num = config->gpio_num;
+    s_calib.ref_hz = config->ref_hz;
+    s_calib.window_s = config->window_s;
+    s_calib.period = CLOCK_CALIB_NOMINAL / config->ref_hz;
+
+    // SQW 与 32K 都是开漏输出
+    io_conf.intr_type = GPIO_INTR_POSEDGE;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = 1 << config->gpio_num;
+    io_conf.pull_down_en = 0;
+    io_conf.pull_up_en = 1;
+    ret = gpio_config(&io_conf);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    // 其它模块可能已经安装了中断服务，重复安装的错误忽略
+    gpio_install_isr_service(0);
+    ret = gpio_isr_handler_add(config->gpio_num, clock_calib_isr, NULL);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+    s_calib.running = true;
+
+    return ESP_OK;
+}
+
+void clock_calib_stop(void)
+{
+    if(!s_calib.running)
+    {
+        return;
+    }
+
+    // 窗口中的数据保留，停止后按最后的误差换算
+    gpio_set_intr_type(s_calib.gpio_num, GPIO_INTR_DISABLE);
+    gpio_isr_handler_remove(s_calib.gpio_num);
+    s_calib.running = false;
+}
+
+void clock_calib_get(clock_calib_status_t *status)
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint64_t sum = 0;
+    bool fresh = false;
+    uint8_t i = 0;
+
+    memset(status, 0, sizeof(clock_calib_status_t));
+
+    portENTER_CRITICAL();
+    fresh = s_calib.running && xTaskGetTickCount() - s_calib.edge_tick <= CLOCK_CALIB_STALE_S * configTICK_RATE_HZ;
+    sum = s_calib.sum;
+    status->seconds = s_calib.count;
+    status->total = s_calib.total;
+    status->rejected = s_calib.rejected;
+    if(0 < s_calib.count)
+    {
+        status->cycles_last = s_calib.cycles[(s_calib.head + s_calib.window_s - 1) % s_calib.window_s];
+    }
+    for(i = 0; i < s_calib.count; ++i)
+    {
+        min = (s_calib.cycles[i] < min) ? s_calib.cycles[i] : min;
+        max = (s_calib.cycles[i] > max) ? s_calib.cycles[i] : max;
+    }
+    portEXIT_CRITICAL();
+
+    status->valid = (0 < status->seconds && fresh);
+    status->ppb = clock_calib_calc_ppb(sum, status->seconds);
+    status->spread = (0 < status->seconds) ? max - min : 0;
+}
+
+int32_t clock_calib_ppb(void)
+{
+    uint64_t sum = 0;
+    uint8_t count = 0;
+
+    portENTER_CRITICAL();
+    sum = s_calib.sum;
+    count = s_calib.count;
+    portEXIT_CRITICAL();
+
+    return clock_calib_calc_ppb(sum, count);
+}
+
+uint32_t clock_calib_to_real(uint32_t nominal)
+{
+    int64_t scale = CLOCK_CALIB_PPB + clock_calib_ppb();
+
+    // CPU 快 ppb 时，同样的周期数对应的真实时间短 1 / (1 + ppb / 10^9)
+    return (uint32_t)(((int64_t)nominal * CLOCK_CALIB_PPB + scale / 2) / scale);
+}
+
+uint32_t clock_calib_to_nominal(uint32_t real)
+{
+    int64_t nominal = ((int64_t)real * (CLOCK_CALIB_PPB + clock_calib_ppb()) + CLOCK_CALIB_PPB / 2) / CLOCK_CALIB_PPB;
+
+    return (UINT32_MAX < nominal) ? UINT32_MAX : (uint32_t)nominal;
+}
+
+void clock_calib_delay_us(uint32_t us)
+{
+    uint64_t cycles = (uint64_t)clock_calib_to_nominal(us) * CCOUNT_CPU_MHZ;
+
+    ccount_delay((UINT32_MAX < cycles) ? UINT32_MAX : (uint32_t)cycles);
+}
@@ -0,0 +1,7 @@
+#
+# clock_calib 组件
+#
+# 用 DS3231 的 SQW/32K 方波校准 CPU 时钟：GPIO 中断按 CCOUNT 计时，持续更新 ppm 修正
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,110 @@
+/**
+ * CPU 时钟校准
+ *
+ * ESP8266 的 CPU 时钟、FreeRTOS 节拍、hw_timer 与 PWM 都来自同一个 26MHz 晶振，误差通常为 +/-10 ~ 20ppm，
+ * 并随温度变化；os_delay_us、节拍换算的时间与定时器周期都带有同样的误差。
+ * DS3231 的温补晶振为 +/-2ppm：INT/SQW 输出方波 (ds3231_set_sqw()) 或 32K 引脚输出 32.768kHz 时，
+ * 本组件在上升沿中断中读取 CCOUNT，每数满 ref_hz 个边沿 (参考时钟的 1 秒) 记录一次这 1 秒的 CPU 周期数，
+ * 最近 window_s 秒的周期数之和与标称值 (CCOUNT_CPU_MHZ x 10^6 x 秒数) 之比即为 CPU 时钟的误差。
+ * 窗口两端的中断延迟抖动除以窗口长度：16 秒窗口、几微秒的抖动对应零点几 ppm。
+ *
+ * 误差每秒更新一次，换算函数按当前误差修正：
+ * - clock_calib_to_real()：CCOUNT 或节拍测得的时长 -> 真实时长
+ * - clock_calib_to_nominal()：要求的真实时长 -> 传给 os_delay_us/hw_timer/PWM 周期的标称值
+ * - clock_calib_delay_us()：按真实时间忙等待
+ * ppm 级的修正只对长时间的计时有意义 (每小时 20ppm 为 72ms)；单总线等几十微秒的时序窗口误差远小于 1 个周期，
+ * 不需要修正。
+ *
+ * 1Hz 方波每秒只有一次中断，推荐使用；参考频率越高中断越多 (32.768kHz 时每个中断几微秒，占用约 10% 的 CPU)，
+ * 但丢失边沿后恢复更快。
+ * 丢失或多出一个边沿只让 1 秒的周期数变化 1/ref_hz (32.768kHz 时约 30ppm，与晶振误差相当)，按整秒的周期数判断不出来；
+ * 因此每个边沿检查与上一个边沿的间隔，偏离参考周期超过半个周期时丢弃当前的 1 秒。
+ * 整秒的周期数与标称值相差超过 CLOCK_CALIB_REJECT_PPM 时 (参考频率配置错误、中断停止后恢复) 同样丢弃。
+ * 超过 CLOCK_CALIB_STALE_S 秒没有参考边沿时 (例如 DS3231 被重新初始化关闭了方波) 状态为无效，误差保持最后的值。
+ * 全局只有一个实例。
+ */
+#ifndef _CLOCK_CALIB_H_
+#define _CLOCK_CALIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLOCK_CALIB_WINDOW_MAX      (64)
+/* 单个 1 秒间隔的误差上限，超出时丢弃 */
+#define CLOCK_CALIB_REJECT_PPM      (500)
+/* 超过此秒数没有参考边沿时测量结果无效 */
+#define CLOCK_CALIB_STALE_S         (3)
+
+#define CLOCK_CALIB_DEFAULT_CONFIG() {  \
+    .gpio_num = GPIO_NUM_12,            \
+    .ref_hz = 1,                        \
+    .window_s = 16,                     \
+}
+
+typedef struct {
+    gpio_num_t gpio_num;            /*!< 连接 INT/SQW 或 32K 的引脚 (开漏输出，打开内部上拉) */
+    uint32_t ref_hz;                /*!< 参考频率：1/1024/4096/8192 (SQW) 或 32768 (32K) */
+    uint8_t window_s;               /*!< 平均的秒数，1 ~ CLOCK_CALIB_WINDOW_MAX */
+} clock_calib_config_t;
+
+typedef struct {
+    bool valid;                     /*!< 已测得至少 1 秒，且最近 CLOCK_CALIB_STALE_S 秒内有参考边沿 */
+    int32_t ppb;                    /*!< CPU 时钟相对参考的误差，十亿分之一，正值为 CPU 快 */
+    uint8_t seconds;                /*!< 窗口内的秒数 */
+    uint32_t cycles_last;           /*!< 最近 1 秒的 CPU 周期数 */
+    uint32_t spread;                /*!< 窗口内单秒周期数的最大值 - 最小值 (中断延迟抖动) */
+    uint32_t total;                 /*!< 测得的秒数 */
+    uint32_t rejected;              /*!< 丢弃的间隔数 */
+} clock_calib_status_t;
+
+/**
+ * @brief  配置引脚，登记上升沿中断，开始测量
+ *
+ * 需要先打开参考时钟 (ds3231_set_sqw() 或 ds3231_set_32k())，第一个完整的 1 秒之后误差才有效
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE (已启动) / GPIO 驱动错误码
+ */
+esp_err_t clock_calib_start(const clock_calib_config_t *config);
+
+/**
+ * @brief  停止测量，删除中断服务程序；窗口中的数据保留，之后按最后的误差换算，clock_calib_get() 的 valid 为 false
+ */
+void clock_calib_stop(void);
+
+/**
+ * @brief  读取测量状态
+ */
+void clock_calib_get(clock_calib_status_t *status);
+
+/**
+ * @brief  当前的误差 (ppb)，还没有测得时为 0
+ */
+int32_t clock_calib_ppb(void);
+
+/**
+ * @brief  按 CPU 时钟测得的时长 (CCOUNT 换算的微秒、节拍换算的毫秒等) -> 真实时长，单位不变
+ */
+uint32_t clock_calib_to_real(uint32_t nominal);
+
+/**
+ * @brief  真实时长 -> 按 CPU 时钟计时的标称值，用于 os_delay_us、hw_timer 与 PWM 的周期
+ */
+uint32_t clock_calib_to_nominal(uint32_t real);
+
+/**
+ * @brief  按真实时间忙等待，最长约 53 秒 (CCOUNT 回绕)
+ */
+void clock_calib_delay_us(uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOCK_CALIB_H_ */
@@ -0,0 +1,7 @@
+#
+# ds3231 组件
+#
+# DS3231 RTC 驱动，基于 i2c_bus 组件
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
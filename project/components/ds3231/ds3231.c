@@ -0,0 +1,168 @@
+#include <stddef.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ds3231.h"
+
+#define DS3231_BCD(v)               ((((v) / 10) << 4) | ((v) % 10))
+
+#define DS3231_CTRL_RS_SHIFT        (3)
+#define DS3231_CTRL_RS_MASK         (0x18)
+#define DS3231_CTRL_INTCN           (0x04)
+#define DS3231_CTRL_ALARM_IE        (0x03)
+#define DS3231_STATUS_OSF           (0x80)
+#define DS3231_STATUS_EN32KHZ       (0x08)
+
+/* ds3231_set_sqw()/ds3231_set_32k() 设置的输出，ds3231_init() 按此写入，总线恢复后不会丢失 */
+static ds3231_sqw_t s_ds3231_sqw = DS3231_SQW_OFF;
+static bool s_ds3231_32k = true;
+
+/* INTCN 置位时 RS 为 8kHz (不输出)，闹钟 1 和 2 中断使能 */
+static uint8_t ds3231_ctrl_value(void)
+{
+    if(DS3231_SQW_OFF == s_ds3231_sqw)
+    {
+        return DS3231_CTRL_RS_MASK | DS3231_CTRL_INTCN | DS3231_CTRL_ALARM_IE;
+    }
+
+    return (uint8_t)(s_ds3231_sqw << DS3231_CTRL_RS_SHIFT) | DS3231_CTRL_ALARM_IE;
+}
+
+/* A1F、A2F 写 0 清除闹钟标志，OSF 写 1 不改变 */
+static uint8_t ds3231_status_value(void)
+{
+    return DS3231_STATUS_OSF | (s_ds3231_32k ? DS3231_STATUS_EN32KHZ : 0);
+}
+
+esp_err_t ds3231_add(i2c_bus_dev_handle_t *dev)
+{
+    i2c_bus_dev_config_t config = {
+        .name = "ds3231",
+        .addr = DS3231_ADDR,
+        .reg_addr_len = 1,
+        .prio = I2C_BUS_PRIO_NORMAL,
+        .init = ds3231_init,
+        // 支持 400kHz 快速模式
+        .scl_hz = I2C_BUS_SCL_FAST,
+    };
+
+    return i2c_bus_add_device(&config, dev);
+}
+
+esp_err_t ds3231_init(i2c_bus_dev_handle_t dev)
+{
+    // CTRL 与 CTRL_STATUS 地址连续，合并为一次写入
+    i2c_bus_reg_t table[] = {
+        I2C_BUS_REG(DS3231_REG_CTRL, ds3231_ctrl_value()),
+        I2C_BUS_REG(DS3231_REG_CTRL_STATUS, ds3231_status_value()),
+    };
+
+    return i2c_bus_write_table(dev, table, sizeof(table) / sizeof(table[0]), I2C_BUS_TABLE_RETRY, NULL);
+}
+
+esp_err_t ds3231_read_all(i2c_bus_dev_handle_t dev, uint8_t regs[DS3231_REG_NUM])
+{
+    return i2c_bus_read(dev, DS3231_REG_SEC, regs, DS3231_REG_NUM);
+}
+
+esp_err_t ds3231_set_datetime(i2c_bus_dev_handle_t dev, uint8_t year, uint8_t mon, uint8_t day,
+                              uint8_t weekday, uint8_t hour, uint8_t min, uint8_t sec)
+{
+    uint8_t datetime[7];
+
+    datetime[0] = DS3231_BCD(sec);
+    datetime[1] = DS3231_BCD(min);
+    datetime[2] = DS3231_BCD(hour);
+    datetime[3] = DS3231_BCD(weekday);
+    datetime[4] = DS3231_BCD(day);
+    datetime[5] = DS3231_BCD(mon);
+    datetime[6] = DS3231_BCD(year);
+
+    return i2c_bus_write(dev, DS3231_REG_SEC, datetime, 7);
+}
+
+esp_err_t ds3231_set_alarm1(i2c_bus_dev_handle_t dev, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec,
+                            uint8_t is_by_weekday)
+{
+    uint8_t datetime[4];
+
+    datetime[0] = DS3231_BCD(sec);
+    datetime[1] = DS3231_BCD(min);
+    datetime[2] = DS3231_BCD(hour);
+    datetime[3] = DS3231_BCD(day);
+
+    if(1 == is_by_weekday)
+    {
+        datetime[3] |= 0x40;
+    }
+
+    return i2c_bus_write(dev, DS3231_REG_A1_SEC, datetime, 4);
+}
+
+esp_err_t ds3231_set_alarm2(i2c_bus_dev_handle_t dev, uint8_t day, uint8_t hour, uint8_t min,
+                            uint8_t is_by_weekday)
+{
+    uint8_t datetime[3];
+
+    datetime[0] = DS3231_BCD(min);
+    datetime[1] = DS3231_BCD(hour);
+    datetime[2] = DS3231_BCD(day);
+
+    if(1 == is_by_weekday)
+    {
+        datetime[2] |= 0x40;
+    }
+
+    return i2c_bus_write(dev, DS3231_REG_A2_MIN, datetime, 3);
+}
+
+esp_err_t ds3231_set_alarm1_sec(i2c_bus_dev_handle_t dev, uint8_t sec)
+{
+    uint8_t alarm[4];
+
+    // A1M2 ~ A1M4 置位：分、时、日不参与匹配
+    alarm[0] = DS3231_BCD(sec % 60);
+    alarm[1] = 0x80;
+    alarm[2] = 0x80;
+    alarm[3] = 0x80;
+
+    return i2c_bus_write(dev, DS3231_REG_A1_SEC, alarm, 4);
+}
+
+esp_err_t ds3231_clear_alarms(i2c_bus_dev_handle_t dev)
+{
+    // 与 ds3231_init() 写入的值相同：A1F、A2F 写 0 清除，INT/SQW 释放，32K 输出不变
+    uint8_t cmd_data = ds3231_status_value();
+
+    return i2c_bus_write(dev, DS3231_REG_CTRL_STATUS, &cmd_data, 1);
+}
+
+esp_err_t ds3231_set_sqw(i2c_bus_dev_handle_t dev, ds3231_sqw_t sqw)
+{
+    i2c_bus_reg_t reg = { DS3231_REG_CTRL, DS3231_CTRL_INTCN, DS3231_CTRL_RS_MASK | DS3231_CTRL_INTCN, 0 };
+
+    if(DS3231_SQW_OFF < sqw)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(DS3231_SQW_OFF != sqw)
+    {
+        reg.value = (uint8_t)(sqw << DS3231_CTRL_RS_SHIFT);
+    }
+    // 写入失败时总线恢复会重新执行 ds3231_init()，先记录
+    s_ds3231_sqw = sqw;
+
+    // 读-改-写，保留 EOSC、BBSQW、CONV 与闹钟中断使能，重复执行结果相同
+    return i2c_bus_write_table(dev, &reg, 1, I2C_BUS_TABLE_RETRY, NULL);
+}
+
+esp_err_t ds3231_set_32k(i2c_bus_dev_handle_t dev, bool enable)
+{
+    // A1F、A2F、OSF 写 1 不改变，只有 EN32kHz 按 mask 写入
+    i2c_bus_reg_t reg = { DS3231_REG_CTRL_STATUS, enable ? DS3231_STATUS_EN32KHZ : 0, DS3231_STATUS_EN32KHZ, 0 };
+
+    s_ds3231_32k = enable;
+
+    return i2c_bus_write_table(dev, &reg, 1, I2C_BUS_TABLE_RETRY, NULL);
+}
@@ -0,0 +1,136 @@
+/**
+ * DS3231 RTC 驱动
+ *
+ * 通过 i2c_bus 组件访问，可以与同一总线上的其它设备 (如模块上的 AT24C32) 同时使用
+ */
+#ifndef _DS3231_H_
+#define _DS3231_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DS3231_ADDR                 0x68             /*!< 从机 DS3231 地址 */
+
+/**
+ * DS3231 寄存器地址
+ */
+#define DS3231_REG_SEC              0x00
+#define DS3231_REG_MIN              0x01
+#define DS3231_REG_HOUR             0x02
+#define DS3231_REG_DAY              0x03
+#define DS3231_REG_DATE             0x04
+#define DS3231_REG_MONTH            0x05
+#define DS3231_REG_YEAR             0x06
+#define DS3231_REG_A1_SEC           0x07
+#define DS3231_REG_A1_MIN           0x08
+#define DS3231_REG_A1_HOUR          0x09
+#define DS3231_REG_A1_DATE          0x0A
+#define DS3231_REG_A2_MIN           0x0B
+#define DS3231_REG_A2_HOUR          0x0C
+#define DS3231_REG_A2_DATE          0x0D
+#define DS3231_REG_CTRL             0x0E
+#define DS3231_REG_CTRL_STATUS      0x0F
+#define DS3231_REG_AGING_OFFSET     0x10
+#define DS3231_REG_TEMP_MSB         0x11
+#define DS3231_REG_TEMP_LSB         0x12
+
+/* 0x00 ~ 0x12 全部寄存器 */
+#define DS3231_REG_NUM              (19)
+
+/**
+ * INT/SQW 引脚输出的方波频率 (CTRL 的 RS2:RS1)，由 DS3231 的 +/-2ppm 温补晶振分频
+ */
+typedef enum {
+    DS3231_SQW_1HZ = 0,
+    DS3231_SQW_1024HZ,
+    DS3231_SQW_4096HZ,
+    DS3231_SQW_8192HZ,
+    DS3231_SQW_OFF,                                 /*!< INTCN 置位：不输出方波，引脚用于闹钟中断 */
+} ds3231_sqw_t;
+
+/**
+ * @brief  把 DS3231 注册到总线上
+ */
+esp_err_t ds3231_add(i2c_bus_dev_handle_t *dev);
+
+/**
+ * @brief  配置 DS3231：闹钟 1 和 2 中断使能，清除闹钟标志；INT/SQW 与 32K 引脚按
+ *         ds3231_set_sqw()/ds3231_set_32k() 最近一次的设置，默认为中断输出 (INTCN，不输出方波) 与 32K 输出
+ *
+ * 同时注册为设备初始化回调，总线恢复后自动重新执行，方波与 32K 输出保持不变
+ */
+esp_err_t ds3231_init(i2c_bus_dev_handle_t dev);
+
+/**
+ * @brief  读取全部 19 个寄存器
+ */
+esp_err_t ds3231_read_all(i2c_bus_dev_handle_t dev, uint8_t regs[DS3231_REG_NUM]);
+
+/**
+ * @brief  设置日期时间，参数为十进制
+ */
+esp_err_t ds3231_set_datetime(i2c_bus_dev_handle_t dev, uint8_t year, uint8_t mon, uint8_t day,
+                              uint8_t weekday, uint8_t hour, uint8_t min, uint8_t sec);
+
+/**
+ * @brief  设置闹钟 1，日/星期，时，分，秒均匹配时触发
+ *
+ * @param  is_by_weekday  0 - 每月这天; 1 - 每周这天
+ */
+esp_err_t ds3231_set_alarm1(i2c_bus_dev_handle_t dev, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec,
+                            uint8_t is_by_weekday);
+
+/**
+ * @brief  设置闹钟 2，日/星期，时，分均匹配时触发
+ *
+ * @param  is_by_weekday  0 - 每月这天; 1 - 每周这天
+ */
+esp_err_t ds3231_set_alarm2(i2c_bus_dev_handle_t dev, uint8_t day, uint8_t hour, uint8_t min,
+                            uint8_t is_by_weekday);
+
+/**
+ * @brief  设置闹钟 1 每分钟在第 sec 秒触发 (只匹配秒)，用于按秒唤醒
+ *
+ * ds3231_init() 打开了闹钟中断，触发时 INT/SQW 拉低，直到 ds3231_clear_alarms()
+ */
+esp_err_t ds3231_set_alarm1_sec(i2c_bus_dev_handle_t dev, uint8_t sec);
+
+/**
+ * @brief  清除闹钟 1 和 2 的标志，释放 INT/SQW
+ */
+esp_err_t ds3231_clear_alarms(i2c_bus_dev_handle_t dev);
+
+/**
+ * @brief  设置 INT/SQW 引脚的方波，只改变 CTRL 的 RS2:RS1 与 INTCN，其它位不变
+ *
+ * 输出方波时闹钟中断不能从该引脚输出；引脚为开漏，需要上拉。用于 clock_calib 组件校准 CPU 时钟。
+ * 设置由驱动记录，总线恢复后 ds3231_init() 重新写入
+ */
+esp_err_t ds3231_set_sqw(i2c_bus_dev_handle_t dev, ds3231_sqw_t sqw);
+
+/**
+ * @brief  打开/关闭 32K 引脚的 32.768kHz 输出 (状态寄存器 EN32kHz)，不影响闹钟标志，总线恢复后保持
+ */
+esp_err_t ds3231_set_32k(i2c_bus_dev_handle_t dev, bool enable);
+
+/**
+ * @brief  温度寄存器 -> 0.01 摄氏度，分辨率 0.25 度
+ */
+static inline int32_t ds3231_temp_centi(uint8_t msb, uint8_t lsb)
+{
+    return ((int16_t)((msb << 8) | lsb) >> 6) * 25;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DS3231_H_ */
@@ -0,0 +1,7 @@
+#
+# filter_bank 组件
+#
+# 多通道定点数滤波：CIC 抽取、双二阶 IIR、滑动平均、中值，按块处理 6 通道 IMU 数据
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
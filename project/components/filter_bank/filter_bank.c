@@ -0,0 +1,281 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "filter_bank.h"
+
+/* 每帧内各通道的计算展开，ch 为常量，编译器可以把数组下标算成固定偏移 */
+#define FILTER_BANK_EACH_CH(step)   do { step(0); step(1); step(2); step(3); step(4); step(5); } while(0)
+
+#if 6 != FILTER_BANK_CHANNELS
+#error "FILTER_BANK_EACH_CH() is unrolled for 6 channels"
+#endif
+
+static inline int16_t sat16(int32_t value)
+{
+    if(INT16_MAX < value)
+    {
+        return INT16_MAX;
+    }
+    if(INT16_MIN > value)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t)value;
+}
+
+/* 向上取整的 log2 */
+static uint8_t log2_ceil(uint32_t value)
+{
+    uint8_t bits = 0;
+
+    while((1UL << bits) < value)
+    {
+        ++bits;
+    }
+
+    return bits;
+}
+
+esp_err_t filter_cic_init(filter_cic_t *cic, uint8_t stages, uint16_t ratio)
+{
+    uint32_t gain = 1;
+    uint8_t bits = log2_ceil(ratio);
+    int i = 0;
+
+    if(NULL == cic || 0 == stages || FILTER_CIC_STAGES_MAX < stages || 2 > ratio || 32 < 16 + stages * bits)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(cic, 0, sizeof(filter_cic_t));
+    cic->stages = stages;
+    cic->ratio = ratio;
+    cic->phase = ratio;
+
+    // 增益 ratio^stages 不超过 2^16
+    for(i = 0; i < stages; ++i)
+    {
+        gain *= ratio;
+    }
+    if(0 == (gain & (gain - 1)))
+    {
+        cic->shift = log2_ceil(gain);
+    }
+    else
+    {
+        cic->gain = (int32_t)(((1UL << 30) + gain / 2) / gain);
+    }
+
+    return ESP_OK;
+}
+
+size_t filter_cic_process(filter_cic_t *cic, const filter_frame_t *in, size_t n, filter_frame_t *out)
+{
+    uint32_t v[FILTER_BANK_CHANNELS];
+    uint32_t t = 0;
+    size_t num = 0;
+    size_t i = 0;
+    int s = 0;
+
+    for(i = 0; i < n; ++i)
+    {
+        // 积分器：按模 2^32 运算，梳状滤波后的结果不受回绕影响
+#define CIC_INTEG0(ch)  cic->integ[0][ch] += (uint32_t)(int32_t)in[i][ch]
+#define CIC_INTEG(ch)   cic->integ[s][ch] += cic->integ[s - 1][ch]
+        FILTER_BANK_EACH_CH(CIC_INTEG0);
+        for(s = 1; s < cic->stages; ++s)
+        {
+            FILTER_BANK_EACH_CH(CIC_INTEG);
+        }
+
+        if(0 != --cic->phase)
+        {
+            continue;
+        }
+        cic->phase = cic->ratio;
+
+        // 梳状：y = x - x(上一个输出时刻)
+#define CIC_LAST(ch)    v[ch] = cic->integ[cic->stages - 1][ch]
+#define CIC_COMB(ch)    do { t = v[ch]; v[ch] -= cic->comb[s][ch]; cic->comb[s][ch] = t; } while(0)
+        FILTER_BANK_EACH_CH(CIC_LAST);
+        for(s = 0; s < cic->stages; ++s)
+        {
+            FILTER_BANK_EACH_CH(CIC_COMB);
+        }
+
+        // 除以增益，四舍五入
+#define CIC_SHIFT(ch)   out[num][ch] = sat16(((int32_t)v[ch] + (1L << (cic->shift - 1))) >> cic->shift)
+#define CIC_GAIN(ch)    out[num][ch] = sat16((int32_t)(((int64_t)(int32_t)v[ch] * cic->gain + (1L << 29)) >> 30))
+        if(0 != cic->shift)
+        {
+            FILTER_BANK_EACH_CH(CIC_SHIFT);
+        }
+        else
+        {
+            FILTER_BANK_EACH_CH(CIC_GAIN);
+        }
+        ++num;
+    }
+
+    return num;
+}
+
+esp_err_t filter_biquad_init(filter_biquad_t *biquad, const filter_biquad_coef_t *coef)
+{
+    int32_t sum = 0;
+
+    if(NULL == biquad || NULL == coef)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 累加器不溢出：系数绝对值之和 x 32768 + 截断误差 < 2^31
+    sum = abs(coef->b[0]) + abs(coef->b[1]) + abs(coef->b[2]) + abs(coef->a[0]) + abs(coef->a[1]);
+    if(4 << FILTER_BIQUAD_Q <= sum)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(biquad, 0, sizeof(filter_biquad_t));
+    biquad->coef = coef;
+
+    return ESP_OK;
+}
+
+void filter_biquad_process(filter_biquad_t *biquad, const filter_frame_t *in, size_t n, filter_frame_t *out)
+{
+    const int32_t b0 = biquad->coef->b[0];
+    const int32_t b1 = biquad->coef->b[1];
+    const int32_t b2 = biquad->coef->b[2];
+    const int32_t a1 = biquad->coef->a[0];
+    const int32_t a2 = biquad->coef->a[1];
+    int32_t acc = 0;
+    int32_t y = 0;
+    int16_t x = 0;
+    size_t i = 0;
+
+    for(i = 0; i < n; ++i)
+    {
+        // 截断误差加到下一次累加中 (一阶误差反馈)，避免小信号时停在偏离平衡点的值上
+#define BIQUAD_STEP(ch) do {                                                                    \
+            x = in[i][ch];                                                                      \
+            acc = b0 * x + b1 * biquad->x[0][ch] + b2 * biquad->x[1][ch]                        \
+                  - a1 * biquad->y[0][ch] - a2 * biquad->y[1][ch] + biquad->err[ch];            \
+            y = acc >> FILTER_BIQUAD_Q;                                                         \
+            biquad->err[ch] = acc - (y << FILTER_BIQUAD_Q);                                     \
+            if(INT16_MAX < y || INT16_MIN > y)                                                  \
+            {                                                                                   \
+                y = sat16(y);                                                                   \
+                biquad->err[ch] = 0;                                                            \
+            }                                                                                   \
+            biquad->x[1][ch] = biquad->x[0][ch];                                                \
+            biquad->x[0][ch] = x;                                                               \
+            biquad->y[1][ch] = biquad->y[0][ch];                                                \
+            biquad->y[0][ch] = (int16_t)y;                                                      \
+            out[i][ch] = (int16_t)y;                                                            \
+        } while(0)
+        FILTER_BANK_EACH_CH(BIQUAD_STEP);
+    }
+}
+
+esp_err_t filter_mavg_init(filter_mavg_t *mavg, uint8_t window)
+{
+    if(NULL == mavg || 2 > window || FILTER_MAVG_WINDOW_MAX < window || 0 != (window & (window - 1)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(mavg, 0, sizeof(filter_mavg_t));
+    mavg->shift = log2_ceil(window);
+
+    return ESP_OK;
+}
+
+void filter_mavg_process(filter_mavg_t *mavg, const filter_frame_t *in, size_t n, filter_frame_t *out)
+{
+    const uint8_t mask = (1 << mavg->shift) - 1;
+    const int32_t half = 1L << (mavg->shift - 1);
+    int16_t *oldest = NULL;
+    size_t i = 0;
+
+    for(i = 0; i < n; ++i)
+    {
+        oldest = mavg->ring[mavg->pos];
+#define MAVG_STEP(ch) do {                                                  \
+            mavg->sum[ch] += in[i][ch] - oldest[ch];                        \
+            oldest[ch] = in[i][ch];                                         \
+            out[i][ch] = (int16_t)((mavg->sum[ch] + half) >> mavg->shift);  \
+        } while(0)
+        FILTER_BANK_EACH_CH(MAVG_STEP);
+        mavg->pos = (mavg->pos + 1) & mask;
+    }
+}
+
+esp_err_t filter_median_init(filter_median_t *median, uint8_t window)
+{
+    if(NULL == median || (3 != window && 5 != window))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(median, 0, sizeof(filter_median_t));
+    median->window = window;
+
+    return ESP_OK;
+}
+
+#define MEDIAN_SORT(a, b)   do { if((a) > (b)) { t = (a); (a) = (b); (b) = t; } } while(0)
+
+static inline int16_t median3(int16_t a, int16_t b, int16_t c)
+{
+    int16_t t = 0;
+
+    MEDIAN_SORT(a, b);
+    MEDIAN_SORT(b, c);
+    MEDIAN_SORT(a, b);
+
+    return b;
+}
+
+/* 7 次比较的选择网络 */
+static inline int16_t median5(int16_t p0, int16_t p1, int16_t p2, int16_t p3, int16_t p4)
+{
+    int16_t t = 0;
+
+    MEDIAN_SORT(p0, p1);
+    MEDIAN_SORT(p3, p4);
+    MEDIAN_SORT(p0, p3);
+    MEDIAN_SORT(p1, p4);
+    MEDIAN_SORT(p1, p2);
+    MEDIAN_SORT(p2, p3);
+    MEDIAN_SORT(p1, p2);
+
+    return p2;
+}
+
+void filter_median_process(filter_median_t *median, const filter_frame_t *in, size_t n, filter_frame_t *out)
+{
+    int16_t (*r)[FILTER_BANK_CHANNELS] = median->ring;
+    size_t i = 0;
+
+    for(i = 0; i < n; ++i)
+    {
+#define MEDIAN_PUT(ch)  r[median->pos][ch] = in[i][ch]
+#define MEDIAN3(ch)     out[i][ch] = median3(r[0][ch], r[1][ch], r[2][ch])
+#define MEDIAN5(ch)     out[i][ch] = median5(r[0][ch], r[1][ch], r[2][ch], r[3][ch], r[4][ch])
+        FILTER_BANK_EACH_CH(MEDIAN_PUT);
+        if(++median->pos == median->window)
+        {
+            median->pos = 0;
+        }
+        if(3 == median->window)
+        {
+            FILTER_BANK_EACH_CH(MEDIAN3);
+        }
+        else
+        {
+            FILTER_BANK_EACH_CH(MEDIAN5);
+        }
+    }
+}
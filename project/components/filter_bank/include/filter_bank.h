@@ -0,0 +1,149 @@
+/**
+ * 多通道定点数滤波器组
+ *
+ * 高采样率的传感器数据 (例如 MPU6050 FIFO 1kHz) 降到 10 ~ 100Hz 保存或解算时，直接每隔 R 个取一个
+ * 会把高于新奈奎斯特频率的振动混叠到低频。本组件提供几种整数滤波器，可以串联使用：
+ * - CIC 抽取：N 级积分 + 抽取 R + N 级梳状，等效为 N 个长度 R 的滑动平均串联后抽取，
+ *   只有加减法，混叠到通带的频率 (R 倍输出频率附近) 都在零点上；通带有 sinc^N 的下垂
+ * - 双二阶 IIR：直接 I 型，Q14 系数，输出截断误差反馈到下一次累加，
+ *   系数在编译期由 FILTER_BIQUAD_COEF()/FILTER_BIQUAD_LOWPASS() 换算，低通设计用 tools/filter_sim -d 生成。
+ *   截止频率相对采样率很低时 Q14 系数的量化误差变大，先用 CIC 抽取，再在低采样率上滤波
+ * - 滑动平均：窗口为 2 的幂，累加和更新
+ * - 中值：窗口 3 或 5，去除单个采样的尖峰
+ *
+ * 数据为交织的帧，每帧 FILTER_BANK_CHANNELS 个 int16_t (MPU6050：加速度 x/y/z，角速度 x/y/z)，
+ * 每次调用处理一块帧，每帧内对各通道的计算展开，没有通道循环。各函数允许 in 与 out 为同一缓冲区。
+ *
+ * 只做计算，不依赖硬件，可以在主机上运行：与浮点参考的误差与主机吞吐量见 tools/filter_sim，
+ * 目标板上的周期数见 bench 实例的 filter_* 用例。
+ */
+#ifndef _FILTER_BANK_H_
+#define _FILTER_BANK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FILTER_BANK_CHANNELS        (6)
+
+typedef int16_t filter_frame_t[FILTER_BANK_CHANNELS];
+
+/* CIC：积分器为 32 位，按模运算回绕，要求 16 + stages * ceil(log2(ratio)) <= 32 */
+#define FILTER_CIC_STAGES_MAX       (4)
+
+typedef struct {
+    uint8_t stages;
+    uint16_t ratio;
+    uint16_t phase;                 /*!< 距离下一个输出还要输入的帧数 */
+    uint8_t shift;                  /*!< ratio^stages 为 2 的幂时直接右移 */
+    int32_t gain;                   /*!< 否则乘以 2^30 / ratio^stages */
+    uint32_t integ[FILTER_CIC_STAGES_MAX][FILTER_BANK_CHANNELS];
+    uint32_t comb[FILTER_CIC_STAGES_MAX][FILTER_BANK_CHANNELS];  /*!< 各级梳状滤波器上一次的输入 */
+} filter_cic_t;
+
+/* 双二阶系数：y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2 (a0 = 1)，Q14 */
+#define FILTER_BIQUAD_Q             (14)
+#define FILTER_BIQUAD_Q14(x)        ((int16_t)((x) * 16384.0 + (((x) < 0) ? -0.5 : 0.5)))
+#define FILTER_BIQUAD_COEF(b0, b1, b2, a1, a2) {                            \
+    .b = { FILTER_BIQUAD_Q14(b0), FILTER_BIQUAD_Q14(b1), FILTER_BIQUAD_Q14(b2) }, \
+    .a = { FILTER_BIQUAD_Q14(a1), FILTER_BIQUAD_Q14(a2) },                  \
+}
+
+/* 低通 (b2 = b0)：b1 由量化后的其它系数推出，直流增益严格为 1 */
+#define FILTER_BIQUAD_LOWPASS(b0, a1, a2) {                                 \
+    .b = { FILTER_BIQUAD_Q14(b0),                                           \
+           (int16_t)((1 << FILTER_BIQUAD_Q) + FILTER_BIQUAD_Q14(a1)         \
+                     + FILTER_BIQUAD_Q14(a2) - 2 * FILTER_BIQUAD_Q14(b0)),  \
+           FILTER_BIQUAD_Q14(b0) },                                         \
+    .a = { FILTER_BIQUAD_Q14(a1), FILTER_BIQUAD_Q14(a2) },                  \
+}
+
+typedef struct {
+    int16_t b[3];
+    int16_t a[2];
+} filter_biquad_coef_t;
+
+typedef struct {
+    const filter_biquad_coef_t *coef;
+    int16_t x[2][FILTER_BANK_CHANNELS];     /*!< 前两次输入 */
+    int16_t y[2][FILTER_BANK_CHANNELS];     /*!< 前两次输出 */
+    int32_t err[FILTER_BANK_CHANNELS];      /*!< 上一次输出的截断误差 */
+} filter_biquad_t;
+
+#define FILTER_MAVG_WINDOW_MAX      (16)
+
+typedef struct {
+    uint8_t shift;                  /*!< 窗口 = 2^shift */
+    uint8_t pos;
+    int16_t ring[FILTER_MAVG_WINDOW_MAX][FILTER_BANK_CHANNELS];
+    int32_t sum[FILTER_BANK_CHANNELS];
+} filter_mavg_t;
+
+#define FILTER_MEDIAN_WINDOW_MAX    (5)
+
+typedef struct {
+    uint8_t window;
+    uint8_t pos;
+    int16_t ring[FILTER_MEDIAN_WINDOW_MAX][FILTER_BANK_CHANNELS];
+} filter_median_t;
+
+/**
+ * @brief  初始化 CIC 抽取器
+ *
+ * @param  stages  级数，1 ~ FILTER_CIC_STAGES_MAX
+ * @param  ratio   抽取比，2 以上
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG (参数超出范围或积分器位数不够)
+ */
+esp_err_t filter_cic_init(filter_cic_t *cic, uint8_t stages, uint16_t ratio);
+
+/**
+ * @brief  输入 n 帧，输出 0 ~ (n + ratio - 1) / ratio 帧，增益为 1
+ *
+ * @return 输出的帧数
+ */
+size_t filter_cic_process(filter_cic_t *cic, const filter_frame_t *in, size_t n, filter_frame_t *out);
+
+/**
+ * @brief  初始化双二阶滤波器，状态为 0
+ *
+ * 累加器为 32 位，要求 |b0| + |b1| + |b2| + |a1| + |a2| < 4，低通、带通设计都满足；
+ * 高通可以用输入减去同截止频率的低通输出
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t filter_biquad_init(filter_biquad_t *biquad, const filter_biquad_coef_t *coef);
+
+/**
+ * @brief  处理 n 帧，输出饱和到 int16_t
+ */
+void filter_biquad_process(filter_biquad_t *biquad, const filter_frame_t *in, size_t n, filter_frame_t *out);
+
+/**
+ * @brief  初始化滑动平均，窗口为 2 的幂，前 window - 1 个输出按 0 填充的窗口计算
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t filter_mavg_init(filter_mavg_t *mavg, uint8_t window);
+
+void filter_mavg_process(filter_mavg_t *mavg, const filter_frame_t *in, size_t n, filter_frame_t *out);
+
+/**
+ * @brief  初始化中值滤波，窗口 3 或 5，前 window - 1 个输出按 0 填充的窗口计算
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t filter_median_init(filter_median_t *median, uint8_t window);
+
+void filter_median_process(filter_median_t *median, const filter_frame_t *in, size_t n, filter_frame_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FILTER_BANK_H_ */
@@ -0,0 +1,7 @@
+#
+# gpio_counter 组件
+#
+# GPIO 中断计数：边沿计数、周期/占空比测量、正交编码器解码，按快照读取
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,310 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp8266/gpio_struct.h"
+
+#include "ccount.h"
+#include "gpio_counter.h"
+
+/* 正交解码表中的非法转换：两个引脚同时变化 */
+#define GPIO_COUNTER_QUAD_ERR       (2)
+
+/**
+ * 正交解码表，下标为 (上一状态 << 2) | 当前状态，状态为 (A << 1) | B
+ * A 相超前 B 相：00 -> 10 -> 11 -> 01 -> 00 为 +1
+ */
+static const int8_t s_quad_table[16] = {
+    0,  -1, +1, GPIO_COUNTER_QUAD_ERR,
+    +1, 0,  GPIO_COUNTER_QUAD_ERR, -1,
+    -1, GPIO_COUNTER_QUAD_ERR, 0,  +1,
+    GPIO_COUNTER_QUAD_ERR, +1, -1, 0,
+};
+
+typedef struct {
+    uint32_t edges;
+    uint32_t missed;
+    uint32_t periods;
+    uint64_t period_cycles;
+    uint64_t high_cycles;
+    uint32_t period_min;
+    uint32_t period_max;
+    uint32_t errors;
+    uint32_t isr_count;
+    uint32_t isr_cycles;
+    uint32_t isr_max;
+} gpio_counter_acc_t;
+
+struct gpio_counter {
+    bool quad;
+    gpio_num_t gpio_a;
+    gpio_num_t gpio_b;              /*!< 只用于正交通道 */
+    uint32_t mask_a;
+    uint32_t mask_b;
+    /* 以下由中断修改 */
+    uint8_t state;                  /*!< 脉冲通道为电平，正交通道为 (A << 1) | B */
+    bool stamped;                   /*!< last_rise 有效 */
+    bool high_valid;                /*!< high 为本周期的高电平时间 */
+    uint32_t last_rise;
+    uint32_t high;
+    int32_t position;
+    gpio_counter_acc_t acc;
+    /* 以下只由读取快照的任务修改 */
+    int32_t last_position;
+    TickType_t last_read;
+};
+
+static void gpio_counter_isr_done(struct gpio_counter *counter, uint32_t start)
+{
+    uint32_t cycles = ccount_get() - start;
+
+    ++counter->acc.isr_count;
+    counter->acc.isr_cycles += cycles;
+    if(cycles > counter->acc.isr_max)
+    {
+        counter->acc.isr_max = cycles;
+    }
+}
+
+static void gpio_counter_pulse_isr(void *arg)
+{
+    struct gpio_counter *counter = arg;
+    uint32_t now = ccount_get();
+    uint8_t level = (0 != (GPIO.in & counter->mask_a)) ? 1 : 0;
+    uint32_t period = 0;
+
+    // 电平没有变化：两个边沿只产生了一次中断，正在测量的周期作废
+    if(level == counter->state)
+    {
+        ++counter->acc.missed;
+        counter->stamped = false;
+        counter->high_valid = false;
+        gpio_counter_isr_done(counter, now);
+        return;
+    }
+
+    counter->state = level;
+    ++counter->acc.edges;
+    if(0 == level)
+    {
+        if(counter->stamped)
+        {
+            counter->high = now - counter->last_rise;
+            counter->high_valid = true;
+        }
+        gpio_counter_isr_done(counter, now);
+        return;
+    }
+
+    // 上升沿：上一个上升沿以来为一个完整周期
+    if(counter->stamped && counter->high_valid)
+    {
+        period = now - counter->last_rise;
+        ++counter->acc.periods;
+        counter->acc.period_cycles += period;
+        counter->acc.high_cycles += counter->high;
+        if(period < counter->acc.period_min)
+        {
+            counter->acc.period_min = period;
+        }
+        if(period > counter->acc.period_max)
+        {
+            counter->acc.period_max = period;
+        }
+    }
+    counter->last_rise = now;
+    counter->stamped = true;
+    counter->high_valid = false;
+    gpio_counter_isr_done(counter, now);
+}
+
+static void gpio_counter_quad_isr(void *arg)
+{
+    struct gpio_counter *counter = arg;
+    uint32_t now = ccount_get();
+    uint32_t in = GPIO.in;
+    uint8_t state = ((0 != (in & counter->mask_a)) ? 2 : 0) | ((0 != (in & counter->mask_b)) ? 1 : 0);
+    int8_t step = s_quad_table[(counter->state << 2) | state];
+
+    if(state == counter->state)
+    {
+        ++counter->acc.missed;
+    }
+    else if(GPIO_COUNTER_QUAD_ERR == step)
+    {
+        ++counter->acc.errors;
+        counter->acc.edges += 2;
+    }
+    else
+    {
+        counter->position += step;
+        ++counter->acc.edges;
+    }
+    counter->state = state;
+    gpio_counter_isr_done(counter, now);
+}
+
+static void gpio_counter_acc_reset(gpio_counter_acc_t *acc)
+{
+    memset(acc, 0, sizeof(gpio_counter_acc_t));
+    acc->period_min = UINT32_MAX;
+}
+
+static esp_err_t gpio_counter_create(bool quad, gpio_num_t gpio_a, gpio_num_t gpio_b, gpio_counter_handle_t *counter)
+{
+    struct gpio_counter *new_counter = NULL;
+    gpio_config_t io_conf;
+    gpio_isr_t isr = quad ? gpio_counter_quad_isr : gpio_counter_pulse_isr;
+    uint32_t in = 0;
+    esp_err_t ret = ESP_OK;
+
+    new_counter = malloc(sizeof(struct gpio_counter));
+    if(NULL == new_counter)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(new_counter, 0, sizeof(struct gpio_counter));
+    new_counter->quad = quad;
+    new_counter->gpio_a = gpio_a;
+    new_counter->gpio_b = gpio_b;
+    new_counter->mask_a = 1 << gpio_a;
+    new_counter->mask_b = quad ? (1 << gpio_b) : 0;
+    gpio_counter_acc_reset(&new_counter->acc);
+
+    io_conf.intr_type = GPIO_INTR_ANYEDGE;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = new_counter->mask_a | new_counter->mask_b;
+    io_conf.pull_down_en = 0;
+    io_conf.pull_up_en = 1;
+    ret = gpio_config(&io_conf);
+    if(ESP_OK != ret)
+    {
+        free(new_counter);
+        return ret;
+    }
+
+    // 初始状态在打开中断之前读取
+    in = GPIO.in;
+    if(quad)
+    {
+        new_counter->state = ((0 != (in & new_counter->mask_a)) ? 2 : 0) | ((0 != (in & new_counter->mask_b)) ? 1 : 0);
+    }
+    else
+    {
+        new_counter->state = (0 != (in & new_counter->mask_a)) ? 1 : 0;
+    }
+    new_counter->last_read = xTaskGetTickCount();
+
+    // 其它模块可能已经安装了中断服务，重复安装的错误忽略
+    gpio_install_isr_service(0);
+    ret = gpio_isr_handler_add(gpio_a, isr, new_counter);
+    if(ESP_OK == ret && quad)
+    {
+        ret = gpio_isr_handler_add(gpio_b, isr, new_counter);
+        if(ESP_OK != ret)
+        {
+            gpio_isr_handler_remove(gpio_a);
+        }
+    }
+    if(ESP_OK != ret)
+    {
+        gpio_set_intr_type(gpio_a, GPIO_INTR_DISABLE);
+        if(quad)
+        {
+            gpio_set_intr_type(gpio_b, GPIO_INTR_DISABLE);
+        }
+        free(new_counter);
+        return ret;
+    }
+
+    *counter = new_counter;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_counter_pulse_create(gpio_num_t gpio_num, gpio_counter_handle_t *counter)
+{
+    if(NULL == counter || !GPIO_IS_VALID_GPIO(gpio_num) || GPIO_NUM_16 == gpio_num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return gpio_counter_create(false, gpio_num, gpio_num, counter);
+}
+
+esp_err_t gpio_counter_quad_create(gpio_num_t gpio_a, gpio_num_t gpio_b, gpio_counter_handle_t *counter)
+{
+    if(NULL == counter || !GPIO_IS_VALID_GPIO(gpio_a) || GPIO_NUM_16 == gpio_a
+       || !GPIO_IS_VALID_GPIO(gpio_b) || GPIO_NUM_16 == gpio_b || gpio_a == gpio_b)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return gpio_counter_create(true, gpio_a, gpio_b, counter);
+}
+
+void gpio_counter_delete(gpio_counter_handle_t counter)
+{
+    if(NULL == counter)
+    {
+        return;
+    }
+
+    gpio_set_intr_type(counter->gpio_a, GPIO_INTR_DISABLE);
+    gpio_isr_handler_remove(counter->gpio_a);
+    if(counter->quad)
+    {
+        gpio_set_intr_type(counter->gpio_b, GPIO_INTR_DISABLE);
+        gpio_isr_handler_remove(counter->gpio_b);
+    }
+    free(counter);
+}
+
+void gpio_counter_read(gpio_counter_handle_t counter, gpio_counter_snapshot_t *snapshot)
+{
+    gpio_counter_acc_t acc;
+    TickType_t now = xTaskGetTickCount();
+    int32_t position = 0;
+
+    portENTER_CRITICAL();
+    acc = counter->acc;
+    gpio_counter_acc_reset(&counter->acc);
+    position = counter->position;
+    portEXIT_CRITICAL();
+
+    memset(snapshot, 0, sizeof(gpio_counter_snapshot_t));
+    snapshot->interval_ms = (now - counter->last_read) * portTICK_RATE_MS;
+    counter->last_read = now;
+
+    snapshot->edges = acc.edges;
+    snapshot->missed = acc.missed;
+    snapshot->periods = acc.periods;
+    if(0 < acc.periods)
+    {
+        snapshot->freq_mhz = (uint32_t)((uint64_t)acc.periods * CCOUNT_CPU_MHZ * 1000000000ULL / acc.period_cycles);
+        snapshot->duty_x100 = (uint32_t)(acc.high_cycles * 10000 / acc.period_cycles);
+        snapshot->period_min = acc.period_min;
+        snapshot->period_max = acc.period_max;
+    }
+
+    snapshot->position = position;
+    snapshot->delta = position - counter->last_position;
+    counter->last_position = position;
+    snapshot->errors = acc.errors;
+
+    snapshot->isr_count = acc.isr_count;
+    snapshot->isr_cycles = acc.isr_cycles;
+    snapshot->isr_max = acc.isr_max;
+}
+
+void gpio_counter_set_position(gpio_counter_handle_t counter, int32_t position)
+{
+    portENTER_CRITICAL();
+    counter->position = position;
+    portEXIT_CRITICAL();
+    counter->last_position = position;
+}
@@ -0,0 +1,100 @@
+/**
+ * GPIO 中断计数
+ *
+ * 在 GPIO 中断中直接累加结果，应用按固定周期读取快照，不再每个边沿向队列发送一个事件：
+ * - 脉冲通道：一个引脚，双边沿中断，统计边沿数；上升沿读取 CCOUNT，
+ *   相邻上升沿之差为周期，上升沿到下降沿为高电平时间，快照中给出平均频率与占空比
+ * - 正交通道：A/B 两个引脚，双边沿中断，一次读取 GPIO_IN 得到两个引脚的状态，
+ *   按 (上一状态, 当前状态) 查表得到 +1/-1 (4 倍频计数)，两个引脚同时变化 (丢失了中间状态) 计为错误；
+ *   A 相超前 B 相为正方向
+ *
+ * 边沿间隔小于中断响应时间时，两个边沿只产生一次中断：脉冲通道的中断中电平与上次相同，计入 missed，
+ * 并丢弃正在测量的周期；正交通道的状态不变计入 missed，两个引脚都变化计入 errors。
+ * 中断内部的周期数 (不含中断入口与 GPIO 中断服务的分发) 计入快照，
+ * 可由此估计 CPU 占用与能承受的最高边沿频率。
+ *
+ * 周期与高电平时间以 CPU 周期计，按 CCOUNT_CPU_MHZ 换算，单个周期不能超过 CCOUNT 的回绕时间 (80MHz 时约 53s)。
+ * 快照由一个任务读取；读取时在临界区中复制并清零累计值，周期跨过两次读取时计入后一次。
+ * GPIO16 没有中断，不能作为输入。
+ */
+#ifndef _GPIO_COUNTER_H_
+#define _GPIO_COUNTER_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct gpio_counter *gpio_counter_handle_t;
+
+typedef struct {
+    uint32_t interval_ms;           /*!< 与上一次读取 (或创建) 的间隔，按节拍计 */
+    uint32_t edges;                 /*!< 电平变化次数 */
+    uint32_t missed;                /*!< 中断时电平没有变化的次数 (边沿间隔小于中断响应时间) */
+    /* 脉冲通道 */
+    uint32_t periods;               /*!< 测得的完整周期数 */
+    uint32_t freq_mhz;              /*!< 平均频率，单位 0.001Hz，没有完整周期时为 0 */
+    uint32_t duty_x100;             /*!< 平均占空比 x100 (%)，0 ~ 10000 */
+    uint32_t period_min;            /*!< 最短周期 (CPU 周期数) */
+    uint32_t period_max;            /*!< 最长周期 (CPU 周期数) */
+    /* 正交通道 */
+    int32_t position;               /*!< 累计位置 (4 倍频) */
+    int32_t delta;                  /*!< 与上一次读取相比的变化 */
+    uint32_t errors;                /*!< 两个引脚同时变化的次数 */
+    /* 中断统计 */
+    uint32_t isr_count;
+    uint32_t isr_cycles;            /*!< 中断内部的周期数之和 */
+    uint32_t isr_max;               /*!< 单次中断的最大周期数 */
+} gpio_counter_snapshot_t;
+
+/**
+ * @brief  创建脉冲通道：边沿计数、周期与占空比
+ *
+ * @param  gpio_num 输入引脚 (GPIO0 ~ 15)，使能内部上拉
+ * @param  counter 输出：通道句柄
+ *
+ * @return
+ *     - ESP_OK 成功
+ *     - ESP_ERR_INVALID_ARG 参数错误
+ *     - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t gpio_counter_pulse_create(gpio_num_t gpio_num, gpio_counter_handle_t *counter);
+
+/**
+ * @brief  创建正交通道：解码 A/B 两相编码器
+ *
+ * @param  gpio_a A 相引脚 (GPIO0 ~ 15)，使能内部上拉
+ * @param  gpio_b B 相引脚 (GPIO0 ~ 15)，使能内部上拉
+ * @param  counter 输出：通道句柄
+ *
+ * @return
+ *     - ESP_OK 成功
+ *     - ESP_ERR_INVALID_ARG 参数错误
+ *     - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t gpio_counter_quad_create(gpio_num_t gpio_a, gpio_num_t gpio_b, gpio_counter_handle_t *counter);
+
+/**
+ * @brief  关闭中断并删除通道
+ */
+void gpio_counter_delete(gpio_counter_handle_t counter);
+
+/**
+ * @brief  读取快照：上次读取以来的累计值与平均结果，读取后累计值清零 (正交通道的位置保留)
+ */
+void gpio_counter_read(gpio_counter_handle_t counter, gpio_counter_snapshot_t *snapshot);
+
+/**
+ * @brief  设置正交通道的位置，例如回到原点时清零
+ */
+void gpio_counter_set_position(gpio_counter_handle_t counter, int32_t position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GPIO_COUNTER_H_ */
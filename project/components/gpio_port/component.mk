@@ -0,0 +1,7 @@
+#
+# gpio_port 组件
+#
+# 多引脚 GPIO 端口操作：按位掩码一次写入 W1TS/W1TC 寄存器，一次读取全部输入
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,27 @@
+#include <stddef.h>
+
+#include "gpio_port.h"
+
+esp_err_t gpio_port_config(uint32_t mask, gpio_mode_t mode, uint32_t value)
+{
+    gpio_config_t io_conf = {
+        .pin_bit_mask = mask,
+        .mode = mode,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+
+    if(0 == mask || 0 != (mask & ~(GPIO_PORT_MASK | GPIO_Pin_16)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 输出寄存器先写入初始电平，打开输出时引脚直接输出该电平
+    if(GPIO_MODE_OUTPUT == mode || GPIO_MODE_OUTPUT_OD == mode)
+    {
+        gpio_port_write(mask, value);
+    }
+
+    return gpio_config(&io_conf);
+}
@@ -0,0 +1,148 @@
+/**
+ * 多引脚 GPIO 端口操作
+ *
+ * gpio_set_level() 每次只改变一个引脚，每次调用都要检查参数、区分 GPIO16，
+ * 多个引脚依次改变，彼此之间相差一次函数调用的时间。
+ * 本组件按位掩码 (GPIO_Pin_x 的组合，bit n 对应 GPIOn) 操作整个端口：
+ * - 置位/清零直接写 GPIO_OUT_W1TS/W1TC 寄存器，掩码中的 GPIO0~15 在同一次写入中同时改变，
+ *   只影响掩码中的引脚，中断里用同样方式操作其他引脚时不需要加锁
+ * - 写入任意电平时先写 W1TS 再写 W1TC，两次寄存器写入之间只相差几个时钟周期；
+ *   需要同时变为新值 (例如并行总线的数据位) 时用 gpio_port_write_atomic()，在临界区中一次写 GPIO_OUT
+ * - 读取时一次读 GPIO_IN，得到同一时刻的全部引脚电平
+ *
+ * GPIO16 在 RTC 模块中，有单独的输出/输入寄存器，掩码中包含 GPIO_Pin_16 时由驱动另外读写，
+ * 在 GPIO0~15 之后改变，不能与它们同时切换；需要同时切换的引脚应全部选在 GPIO0~15 中。
+ *
+ * 引脚需要先配置为输出 (gpio_port_config() 或 gpio_config())，这里不检查引脚模式。
+ */
+#ifndef _GPIO_PORT_H_
+#define _GPIO_PORT_H_
+
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "esp8266/gpio_struct.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* GPIO_OUT/GPIO_IN 寄存器中的引脚 GPIO0~15 */
+#define GPIO_PORT_MASK              (0xFFFF)
+
+/**
+ * @brief  掩码中的引脚输出高电平
+ */
+static inline void gpio_port_set(uint32_t mask)
+{
+    GPIO.out_w1ts = mask & GPIO_PORT_MASK;
+    if(0 != (mask & GPIO_Pin_16))
+    {
+        gpio_set_level(GPIO_NUM_16, 1);
+    }
+}
+
+/**
+ * @brief  掩码中的引脚输出低电平
+ */
+static inline void gpio_port_clear(uint32_t mask)
+{
+    GPIO.out_w1tc = mask & GPIO_PORT_MASK;
+    if(0 != (mask & GPIO_Pin_16))
+    {
+        gpio_set_level(GPIO_NUM_16, 0);
+    }
+}
+
+/**
+ * @brief  掩码中的引脚输出 value 中对应位的电平，其他引脚不变
+ *
+ * 先写 W1TS 再写 W1TC，不读 GPIO_OUT，与中断中对其他引脚的操作互不影响
+ */
+static inline void gpio_port_write(uint32_t mask, uint32_t value)
+{
+    GPIO.out_w1ts = mask & value & GPIO_PORT_MASK;
+    GPIO.out_w1tc = mask & ~value & GPIO_PORT_MASK;
+    if(0 != (mask & GPIO_Pin_16))
+    {
+        gpio_set_level(GPIO_NUM_16, (0 != (value & GPIO_Pin_16)) ? 1 : 0);
+    }
+}
+
+/**
+ * @brief  与 gpio_port_write() 相同，但掩码中的 GPIO0~15 在同一次写入中同时变为新值
+ *
+ * 在临界区中读取 GPIO_OUT、改变掩码中的位并一次写回，读写之间不会被中断打断
+ */
+static inline void gpio_port_write_atomic(uint32_t mask, uint32_t value)
+{
+    uint32_t port_mask = mask & GPIO_PORT_MASK;
+
+    portENTER_CRITICAL();
+    GPIO.out = (GPIO.out & ~port_mask) | (value & port_mask);
+    portEXIT_CRITICAL();
+
+    if(0 != (mask & GPIO_Pin_16))
+    {
+        gpio_set_level(GPIO_NUM_16, (0 != (value & GPIO_Pin_16)) ? 1 : 0);
+    }
+}
+
+/**
+ * @brief  掩码中的引脚电平翻转
+ *
+ * 在临界区中读取 GPIO_OUT 并一次写回，掩码中的 GPIO0~15 同时翻转，读写之间不会被中断打断
+ */
+static inline void gpio_port_toggle(uint32_t mask)
+{
+    portENTER_CRITICAL();
+    GPIO.out = GPIO.out ^ (mask & GPIO_PORT_MASK);
+    portEXIT_CRITICAL();
+
+    // GPIO16 作为推挽输出时引脚电平即输出值
+    if(0 != (mask & GPIO_Pin_16))
+    {
+        gpio_set_level(GPIO_NUM_16, !gpio_get_level(GPIO_NUM_16));
+    }
+}
+
+/**
+ * @brief  读取全部引脚的电平，GPIO16 在 bit 16
+ *
+ * @param  mask 需要读取的引脚，不包含 GPIO_Pin_16 时不读取 RTC 寄存器
+ *
+ * @return 掩码中各引脚的电平，其他位为 0
+ */
+static inline uint32_t gpio_port_read(uint32_t mask)
+{
+    uint32_t value = GPIO.in & mask & GPIO_PORT_MASK;
+
+    if(0 != (mask & GPIO_Pin_16) && 0 != gpio_get_level(GPIO_NUM_16))
+    {
+        value |= GPIO_Pin_16;
+    }
+
+    return value;
+}
+
+/**
+ * @brief  按掩码配置引脚模式，禁止中断与上下拉
+ *
+ * @param  mask 引脚掩码
+ * @param  mode 引脚模式
+ * @param  value 配置为输出时的初始电平，在引脚开始输出之前写入，避免产生毛刺
+ *
+ * @return
+ *     - ESP_OK 成功
+ *     - ESP_ERR_INVALID_ARG 掩码为 0 或包含不存在的引脚
+ */
+esp_err_t gpio_port_config(uint32_t mask, gpio_mode_t mode, uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GPIO_PORT_H_ */
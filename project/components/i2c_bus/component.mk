@@ -0,0 +1,7 @@
+#
+# i2c_bus 组件
+#
+# IIC 总线管理：独占 IIC 端口，多个任务的多个设备通过优先级队列排队访问
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
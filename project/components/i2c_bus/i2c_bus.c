@@ -0,0 +1,1398 @@
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+
+#include "driver/i2c.h"
+#include "driver/gpio.h"
+
+#include "ccount.h"
+#include "i2c_bus.h"
+#include "i2c_bus_bb.h"
+
+static const char *TAG = "i2c_bus";
+
+#define WRITE_BIT                   I2C_MASTER_WRITE /*!< I2C 主机写操作位 */
+#define READ_BIT                    I2C_MASTER_READ  /*!< I2C 主机读操作位 */
+#define ACK_CHECK_EN                0x1              /*!< I2C 主机确认接收从机 ACK 信号 */
+
+/* 软件 IIC 约 100kHz：每个时钟 10us，每字节 9 个时钟 (含 ACK) */
+#define I2C_BUS_CLOCK_US            (10)
+/* 超时 = 估算传输时间 x 倍数 + 余量 (时钟拉伸、任务调度) */
+#define I2C_BUS_TIMEOUT_MARGIN      (4)
+#define I2C_BUS_TIMEOUT_SLACK_US    (5000)
+/* 1 个节拍的超时可能在下一次节拍中断时就到期 */
+#define I2C_BUS_TIMEOUT_MIN_TICKS   (2)
+
+/* 总线恢复：SCL 半周期 5us，最多 9 个时钟脉冲 */
+#define I2C_BUS_RECOVER_HALF_CYCLES (5 * CCOUNT_CPU_MHZ)
+#define I2C_BUS_RECOVER_PULSES      (9)
+/* 从机拉住 SCL (时钟拉伸) 时，最多等待的半周期数 */
+#define I2C_BUS_RECOVER_SCL_WAIT    (1000)
+
+/* 软件 IIC 时钟拉伸最长等待时间 */
+#define I2C_BUS_BB_STRETCH_US       (1000)
+/* 校准：每轮输出的时钟数，最多修正的轮数，允许的误差 (千分比) */
+#define I2C_BUS_CALIB_CLOCKS        (64)
+#define I2C_BUS_CALIB_ROUNDS        (4)
+#define I2C_BUS_CALIB_TOLERANCE     (10)
+/* SDK 驱动只发送从机地址：起始条件 + 9 个时钟 + 停止条件，约 10 个时钟 */
+#define I2C_BUS_CALIB_DRIVER_CLOCKS (10)
+
+typedef enum {
+    I2C_BUS_REQ_WRITE = 0,
+    I2C_BUS_REQ_READ,
+    I2C_BUS_REQ_TXN,                /*!< 执行预先创建的事务 */
+    I2C_BUS_REQ_CALIB,              /*!< 测量 SCL 频率 */
+    I2C_BUS_REQ_SCAN,               /*!< 扫描总线 */
+    I2C_BUS_REQ_TABLE,              /*!< 执行寄存器表的一段 */
+} i2c_bus_req_type_t;
+
+struct i2c_bus_dev {
+    i2c_bus_dev_config_t config;
+    SemaphoreHandle_t lock;         /*!< 同一设备同时只有一个请求在队列中 */
+    SemaphoreHandle_t done;         /*!< 总线任务完成请求后通知请求任务 */
+    uint32_t count;
+    uint32_t errors;
+    uint32_t bytes;
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+    uint64_t busy_us;
+    uint32_t recoveries;
+    i2c_bus_bb_timing_t timing;     /*!< 软件 IIC 的 SCL 高低电平时间 */
+};
+
+struct i2c_bus_txn {
+    i2c_bus_dev_handle_t dev;
+    i2c_cmd_handle_t addr_cmd;      /*!< 写寄存器地址，软件 IIC 设备为 NULL */
+    i2c_cmd_handle_t data_cmd;      /*!< 读数据，软件 IIC 设备为 NULL */
+    uint16_t reg_addr;
+    uint8_t *data;
+    size_t data_len;
+};
+
+typedef struct {
+    i2c_bus_req_type_t type;
+    i2c_bus_dev_handle_t dev;
+    uint16_t reg_addr;
+    uint8_t *data;
+    size_t data_len;
+    i2c_bus_txn_handle_t txn;
+    i2c_bus_calib_t *calib;
+    const i2c_bus_reg_t *table;     /*!< 寄存器表：data 为每项一个字节的写入缓冲区，data_len 为项数 */
+    uint32_t flags;
+    i2c_bus_table_result_t *result;
+    uint32_t submit_ccount;         /*!< 提交时刻，用于计算延时 */
+    esp_err_t ret;
+} i2c_bus_req_t;
+
+/* 命令连接缓存项，只在总线任务中访问 */
+typedef struct {
+    i2c_bus_dev_handle_t dev;       /*!< NULL 为空项 */
+    uint16_t reg_addr;
+    uint16_t data_len;
+    bool is_read;
+    i2c_cmd_handle_t addr_cmd;      /*!< 读：写寄存器地址；写：整个写传输 */
+    i2c_cmd_handle_t data_cmd;      /*!< 读：读数据；写：NULL */
+    uint8_t *buf;                   /*!< 命令连接中引用的数据缓冲区，从 mem_pool 分配 */
+    uint32_t last_use;              /*!< 最近使用的序号，缓存满时替换最小的 */
+} i2c_bus_cache_t;
+
+typedef struct {
+    i2c_bus_config_t config;
+    QueueHandle_t queue[I2C_BUS_PRIO_MAX];  /*!< 每个优先级一个队列，元素为 i2c_bus_req_t * */
+    SemaphoreHandle_t pending;              /*!< 所有队列中的请求总数 */
+    SemaphoreHandle_t dev_lock;             /*!< 保护设备表 */
+    TaskHandle_t task;                      /*!< 总线任务 */
+    bool bb_ok;                             /*!< 引脚支持软件 IIC */
+    bool recovering;                        /*!< 正在恢复总线，执行设备初始化回调 */
+    uint8_t dev_num;
+    struct i2c_bus_dev dev[I2C_BUS_DEV_MAX];
+    struct i2c_bus_dev probe;               /*!< 扫描与按地址读取使用的内部设备，不在设备表中 */
+    SemaphoreHandle_t probe_lock;           /*!< 保护 probe 的地址配置 */
+    i2c_bus_cache_t *cache;                 /*!< 命令连接缓存，config.cache_num 项 */
+    mem_pool_handle_t cache_pool;           /*!< 缓存项的数据缓冲区 */
+    uint32_t cache_seq;
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t cache_bypass;
+} i2c_bus_t;
+
+static i2c_bus_t *s_bus = NULL;
+
+/* 按传输字节数 (含从机地址与寄存器地址) 计算超时节拍数 */
+static TickType_t i2c_bus_timeout(size_t bytes)
+{
+    uint32_t us = (bytes * 9 + 2) * I2C_BUS_CLOCK_US * I2C_BUS_TIMEOUT_MARGIN + I2C_BUS_TIMEOUT_SLACK_US;
+    TickType_t ticks = (us + portTICK_RATE_MS * 1000 - 1) / (portTICK_RATE_MS * 1000);
+
+    return (I2C_BUS_TIMEOUT_MIN_TICKS > ticks) ? I2C_BUS_TIMEOUT_MIN_TICKS : ticks;
+}
+
+/* 主机模式，不使能内部上拉 */
+static esp_err_t i2c_bus_driver_install(void)
+{
+    i2c_config_t conf;
+    esp_err_t ret = ESP_OK;
+
+    conf.mode = I2C_MODE_MASTER;
+    conf.sda_io_num = s_bus->config.sda_io_num;
+    conf.sda_pullup_en = 0;
+    conf.scl_io_num = s_bus->config.scl_io_num;
+    conf.scl_pullup_en = 0;
+    conf.clk_stretch_tick = s_bus->config.clk_stretch_tick;
+
+    // 设置 IIC 工作模式
+    ret = i2c_driver_install(s_bus->config.port, conf.mode);
+    if(ESP_OK == ret)
+    {
+        // 设置 IIC 引脚配置
+        ret = i2c_param_config(s_bus->config.port, &conf);
+        if(ESP_OK != ret)
+        {
+            i2c_driver_delete(s_bus->config.port);
+        }
+    }
+
+    return ret;
+}
+
+/* 装载从机地址与寄存器地址 (高字节在前) */
+static void i2c_bus_cmd_addr(i2c_cmd_handle_t cmd, i2c_bus_dev_handle_t dev, uint16_t reg_addr)
+{
+    // 装载一个从机地址及写指令，ACK 应答使能
+    i2c_master_write_byte(cmd, dev->config.addr << 1 | WRITE_BIT, ACK_CHECK_EN);
+    // 装载从机寄存器地址，ACK应答使能
+    if(2 == dev->config.reg_addr_len)
+    {
+        i2c_master_write_byte(cmd, (uint8_t)(reg_addr >> 8), ACK_CHECK_EN);
+    }
+    i2c_master_write_byte(cmd, (uint8_t)(reg_addr & 0xFF), ACK_CHECK_EN);
+}
+
+/* 寄存器地址 -> 字节序列 (高字节在前)，返回字节数 */
+static size_t i2c_bus_reg_bytes(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t reg[2])
+{
+    if(2 == dev->config.reg_addr_len)
+    {
+        reg[0] = (uint8_t)(reg_addr >> 8);
+        reg[1] = (uint8_t)(reg_addr & 0xFF);
+        return 2;
+    }
+
+    reg[0] = (uint8_t)(reg_addr & 0xFF);
+    return 1;
+}
+
+/* 软件 IIC 读写 */
+static esp_err_t i2c_bus_bb_rw(i2c_bus_dev_handle_t dev, uint16_t reg_addr, bool is_read, uint8_t *data, size_t data_len)
+{
+    uint8_t reg[2];
+    size_t reg_len = i2c_bus_reg_bytes(dev, reg_addr, reg);
+
+    return i2c_bus_bb_transfer(&dev->timing, dev->config.addr, reg, reg_len,
+                               is_read ? NULL : data, is_read ? 0 : data_len,
+                               is_read ? data : NULL, is_read ? data_len : 0);
+}
+
+/* 创建读寄存器的两组命令连接：写寄存器地址，读数据 */
+static esp_err_t i2c_bus_build_read(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len,
+                                    i2c_cmd_handle_t *addr_cmd, i2c_cmd_handle_t *data_cmd)
+{
+    *addr_cmd = i2c_cmd_link_create();
+    *data_cmd = i2c_cmd_link_create();
+    if(NULL == *addr_cmd || NULL == *data_cmd)
+    {
+        i2c_cmd_link_delete(*addr_cmd);
+        i2c_cmd_link_delete(*data_cmd);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 给从机发送读数据地址，通知其准备数据
+    i2c_master_start(*addr_cmd);
+    i2c_bus_cmd_addr(*addr_cmd, dev, reg_addr);
+    i2c_master_stop(*addr_cmd);
+
+    // 主机读取从机发送的数据，最后一个数据应答 NACK
+    i2c_master_start(*data_cmd);
+    i2c_master_write_byte(*data_cmd, dev->config.addr << 1 | READ_BIT, ACK_CHECK_EN);
+    i2c_master_read(*data_cmd, data, data_len, I2C_MASTER_LAST_NACK);
+    i2c_master_stop(*data_cmd);
+
+    return ESP_OK;
+}
+
+static esp_err_t i2c_bus_run_read(i2c_bus_dev_handle_t dev, i2c_cmd_handle_t addr_cmd, i2c_cmd_handle_t data_cmd,
+                                  size_t data_len)
+{
+    esp_err_t ret = i2c_master_cmd_begin(s_bus->config.port, addr_cmd, i2c_bus_timeout(1 + dev->config.reg_addr_len));
+
+    // 验证读取命令是否发送成功
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    return i2c_master_cmd_begin(s_bus->config.port, data_cmd, i2c_bus_timeout(1 + data_len));
+}
+
+/* 创建写寄存器的命令连接，data 只保存指针，执行时才读取 */
+static esp_err_t i2c_bus_build_write(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len,
+                                     i2c_cmd_handle_t *cmd)
+{
+    *cmd = i2c_cmd_link_create();
+    if(NULL == *cmd)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    i2c_master_start(*cmd);
+    i2c_bus_cmd_addr(*cmd, dev, reg_addr);
+    // 装载写至从机寄存器的数据，ACK应答使能
+    if(0 < data_len)
+    {
+        i2c_master_write(*cmd, data, data_len, ACK_CHECK_EN);
+    }
+    i2c_master_stop(*cmd);
+
+    return ESP_OK;
+}
+
+static void i2c_bus_cache_drop(i2c_bus_cache_t *entry)
+{
+    i2c_cmd_link_delete(entry->addr_cmd);
+    i2c_cmd_link_delete(entry->data_cmd);
+    mem_pool_free(s_bus->cache_pool, entry->buf);
+    memset(entry, 0, sizeof(i2c_bus_cache_t));
+}
+
+/**
+ * 查找或创建请求对应的缓存项，不能缓存时返回 NULL，由调用者按原来的方式创建临时命令连接
+ *
+ * 空项的 last_use 为 0，缓存未满时总是先用空项
+ */
+static i2c_bus_cache_t *i2c_bus_cache_get(const i2c_bus_req_t *req, bool is_read)
+{
+    i2c_bus_cache_t *entry = NULL;
+    i2c_bus_cache_t *victim = NULL;
+    esp_err_t ret = ESP_OK;
+    int i = 0;
+
+    // 探测设备每次的地址不同，不缓存
+    if(NULL == s_bus->cache || &s_bus->probe == req->dev || I2C_BUS_CACHE_BUF_SIZE < req->data_len)
+    {
+        ++s_bus->cache_bypass;
+        return NULL;
+    }
+
+    for(i = 0; i < s_bus->config.cache_num; ++i)
+    {
+        entry = &s_bus->cache[i];
+        if(req->dev == entry->dev && req->reg_addr == entry->reg_addr
+           && req->data_len == entry->data_len && is_read == entry->is_read)
+        {
+            entry->last_use = ++s_bus->cache_seq;
+            ++s_bus->cache_hits;
+            return entry;
+        }
+        if(NULL == victim || entry->last_use < victim->last_use)
+        {
+            victim = entry;
+        }
+    }
+
+    if(NULL != victim->dev)
+    {
+        i2c_bus_cache_drop(victim);
+    }
+    victim->buf = mem_pool_alloc(s_bus->cache_pool);
+    if(NULL == victim->buf)
+    {
+        ++s_bus->cache_bypass;
+        return NULL;
+    }
+    if(is_read)
+    {
+        ret = i2c_bus_build_read(req->dev, req->reg_addr, victim->buf, req->data_len,
+                                 &victim->addr_cmd, &victim->data_cmd);
+    }
+    else
+    {
+        ret = i2c_bus_build_write(req->dev, req->reg_addr, victim->buf, req->data_len, &victim->addr_cmd);
+    }
+    if(ESP_OK != ret)
+    {
+        mem_pool_free(s_bus->cache_pool, victim->buf);
+        victim->buf = NULL;
+        ++s_bus->cache_bypass;
+        return NULL;
+    }
+
+    victim->dev = req->dev;
+    victim->reg_addr = req->reg_addr;
+    victim->data_len = req->data_len;
+    victim->is_read = is_read;
+    victim->last_use = ++s_bus->cache_seq;
+    ++s_bus->cache_misses;
+
+    return victim;
+}
+
+/* 不经过缓存写寄存器，临时创建命令连接 */
+static esp_err_t i2c_bus_write_once(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len)
+{
+    i2c_cmd_handle_t cmd = NULL;
+    esp_err_t ret = ESP_OK;
+
+    if(I2C_BUS_SCL_DRIVER != dev->config.scl_hz)
+    {
+        return i2c_bus_bb_rw(dev, reg_addr, false, data, data_len);
+    }
+
+    ret = i2c_bus_build_write(dev, reg_addr, data, data_len, &cmd);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    ret = i2c_master_cmd_begin(s_bus->config.port, cmd, i2c_bus_timeout(1 + dev->config.reg_addr_len + data_len));
+    i2c_cmd_link_delete(cmd);
+
+    return ret;
+}
+
+/* 不经过缓存读寄存器，临时创建命令连接 */
+static esp_err_t i2c_bus_read_once(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len)
+{
+    i2c_cmd_handle_t addr_cmd = NULL;
+    i2c_cmd_handle_t data_cmd = NULL;
+    esp_err_t ret = ESP_OK;
+
+    if(I2C_BUS_SCL_DRIVER != dev->config.scl_hz)
+    {
+        return i2c_bus_bb_rw(dev, reg_addr, true, data, data_len);
+    }
+
+    ret = i2c_bus_build_read(dev, reg_addr, data, data_len, &addr_cmd, &data_cmd);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    ret = i2c_bus_run_read(dev, addr_cmd, data_cmd, data_len);
+    i2c_cmd_link_delete(addr_cmd);
+    i2c_cmd_link_delete(data_cmd);
+
+    return ret;
+}
+
+static esp_err_t i2c_bus_do_write(const i2c_bus_req_t *req)
+{
+    i2c_bus_cache_t *entry = NULL;
+
+    if(I2C_BUS_SCL_DRIVER != req->dev->config.scl_hz)
+    {
+        return i2c_bus_bb_rw(req->dev, req->reg_addr, false, req->data, req->data_len);
+    }
+
+    // 缓存的命令连接引用固定缓冲区，先把本次的数据复制进去
+    entry = i2c_bus_cache_get(req, false);
+    if(NULL != entry)
+    {
+        if(0 < req->data_len)
+        {
+            memcpy(entry->buf, req->data, req->data_len);
+        }
+        return i2c_master_cmd_begin(s_bus->config.port, entry->addr_cmd,
+                                    i2c_bus_timeout(1 + req->dev->config.reg_addr_len + req->data_len));
+    }
+
+    return i2c_bus_write_once(req->dev, req->reg_addr, req->data, req->data_len);
+}
+
+static esp_err_t i2c_bus_do_read(const i2c_bus_req_t *req)
+{
+    i2c_bus_cache_t *entry = NULL;
+    esp_err_t ret = ESP_OK;
+
+    if(I2C_BUS_SCL_DRIVER != req->dev->config.scl_hz)
+    {
+        return i2c_bus_bb_rw(req->dev, req->reg_addr, true, req->data, req->data_len);
+    }
+
+    entry = i2c_bus_cache_get(req, true);
+    if(NULL != entry)
+    {
+        ret = i2c_bus_run_read(req->dev, entry->addr_cmd, entry->data_cmd, req->data_len);
+        if(ESP_OK == ret)
+        {
+            memcpy(req->data, entry->buf, req->data_len);
+        }
+        return ret;
+    }
+
+    return i2c_bus_read_once(req->dev, req->reg_addr, req->data, req->data_len);
+}
+
+/* 寄存器表中从 start 开始、地址连续的一段，返回段尾 (不含) */
+static size_t i2c_bus_table_run(const i2c_bus_reg_t *table, size_t start, size_t num)
+{
+    size_t end = start + 1;
+
+    while(end < num && table[end].reg == table[end - 1].reg + 1)
+    {
+        ++end;
+    }
+
+    return end;
+}
+
+/* 写入寄存器表各段的数据：SDK 驱动设备各段放在一个命令连接中，用重复起始条件分隔 */
+static esp_err_t i2c_bus_table_write(const i2c_bus_req_t *req)
+{
+    i2c_bus_dev_handle_t dev = req->dev;
+    const i2c_bus_reg_t *table = req->table;
+    i2c_bus_table_result_t *result = req->result;
+    i2c_cmd_handle_t cmd = NULL;
+    size_t num = req->data_len;
+    size_t bytes = 0;
+    size_t start = 0;
+    size_t end = 0;
+    esp_err_t ret = ESP_OK;
+
+    if(I2C_BUS_SCL_DRIVER == dev->config.scl_hz)
+    {
+        cmd = i2c_cmd_link_create();
+        if(NULL == cmd)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        for(start = 0; start < num; start = end)
+        {
+            end = i2c_bus_table_run(table, start, num);
+            i2c_master_start(cmd);
+            i2c_bus_cmd_addr(cmd, dev, table[start].reg);
+            i2c_master_write(cmd, &req->data[start], end - start, ACK_CHECK_EN);
+            bytes += 1 + dev->config.reg_addr_len + end - start;
+        }
+        i2c_master_stop(cmd);
+
+        ret = i2c_master_cmd_begin(s_bus->config.port, cmd, i2c_bus_timeout(bytes));
+        i2c_cmd_link_delete(cmd);
+        ++result->transfers;
+
+        // 不知道停在哪一段，前面的段可能已经写入，不能逐段重写
+        if(ESP_OK != ret)
+        {
+            result->index = I2C_BUS_TABLE_INDEX_UNKNOWN;
+        }
+        return ret;
+    }
+
+    for(start = 0; start < num; start = end)
+    {
+        end = i2c_bus_table_run(table, start, num);
+        ret = i2c_bus_write_once(dev, table[start].reg, &req->data[start], end - start);
+        ++result->transfers;
+        if(ESP_OK != ret)
+        {
+            result->index = start;
+            return ret;
+        }
+    }
+
+    return ESP_OK;
+}
+
+/* 执行寄存器表的一段：先读出读-改-写的寄存器，再一次写入，需要时逐段读回检查 */
+static esp_err_t i2c_bus_do_table(const i2c_bus_req_t *req)
+{
+    const i2c_bus_reg_t *table = req->table;
+    i2c_bus_table_result_t *result = req->result;
+    uint8_t *data = req->data;
+    uint8_t check[I2C_BUS_TABLE_MAX];
+    size_t num = req->data_len;
+    size_t start = 0;
+    size_t end = 0;
+    size_t i = 0;
+    bool rmw = false;
+    esp_err_t ret = ESP_OK;
+
+    result->index = 0;
+    for(start = 0; start < num; start = end)
+    {
+        end = i2c_bus_table_run(table, start, num);
+        rmw = false;
+        for(i = start; i < end; ++i)
+        {
+            data[i] = table[i].value;
+            rmw |= (0xFF != table[i].mask);
+        }
+        if(!rmw)
+        {
+            continue;
+        }
+
+        ret = i2c_bus_read_once(req->dev, table[start].reg, &check[start], end - start);
+        ++result->transfers;
+        if(ESP_OK != ret)
+        {
+            result->index = start;
+            return ret;
+        }
+        for(i = start; i < end; ++i)
+        {
+            data[i] = (check[i] & ~table[i].mask) | (table[i].value & table[i].mask);
+        }
+    }
+
+    ret = i2c_bus_table_write(req);
+    if(ESP_OK != ret || 0 == (req->flags & I2C_BUS_TABLE_VERIFY))
+    {
+        return ret;
+    }
+
+    for(start = 0; start < num; start = end)
+    {
+        end = i2c_bus_table_run(table, start, num);
+        ret = i2c_bus_read_once(req->dev, table[start].reg, &check[start], end - start);
+        ++result->transfers;
+        if(ESP_OK != ret)
+        {
+            result->index = start;
+            return ret;
+        }
+        for(i = start; i < end; ++i)
+        {
+            if(0 != ((check[i] ^ data[i]) & table[i].mask))
+            {
+                result->index = i;
+                result->expect = data[i] & table[i].mask;
+                result->actual = check[i] & table[i].mask;
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+        }
+    }
+
+    return ESP_OK;
+}
+
+/* SDA 与 SCL 都为高电平时总线空闲 */
+static bool i2c_bus_lines_idle(void)
+{
+    return 1 == gpio_get_level(s_bus->config.sda_io_num) && 1 == gpio_get_level(s_bus->config.scl_io_num);
+}
+
+/**
+ * 恢复总线
+ *
+ * 从机在传输中途复位或主机中途放弃传输时，从机可能停在发送数据位上并一直拉低 SDA。
+ * 主机输出 SCL 时钟，从机最多再发送 8 个数据位就会走到 ACK 位并释放 SDA，此时发出 STOP 即可。
+ */
+static void i2c_bus_recover(void)
+{
+    gpio_num_t sda = s_bus->config.sda_io_num;
+    gpio_num_t scl = s_bus->config.scl_io_num;
+    gpio_config_t io_conf;
+    esp_err_t ret = ESP_OK;
+    int i = 0;
+
+    s_bus->recovering = true;
+
+    i2c_driver_delete(s_bus->config.port);
+
+    // SDA、SCL 配置为开漏输出，电平从输入寄存器读取
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.mode = GPIO_MODE_OUTPUT_OD;
+    io_conf.pin_bit_mask = (1 << sda) | (1 << scl);
+    io_conf.pull_down_en = 0;
+    io_conf.pull_up_en = 1;
+    gpio_config(&io_conf);
+    gpio_set_level(sda, 1);
+    gpio_set_level(scl, 1);
+
+    // 等待从机释放 SCL
+    for(i = 0; i < I2C_BUS_RECOVER_SCL_WAIT && 0 == gpio_get_level(scl); ++i)
+    {
+        ccount_delay(I2C_BUS_RECOVER_HALF_CYCLES);
+    }
+
+    // 输出时钟直到 SDA 被释放
+    for(i = 0; i < I2C_BUS_RECOVER_PULSES && 0 == gpio_get_level(sda); ++i)
+    {
+        gpio_set_level(scl, 0);
+        ccount_delay(I2C_BUS_RECOVER_HALF_CYCLES);
+        gpio_set_level(scl, 1);
+        ccount_delay(I2C_BUS_RECOVER_HALF_CYCLES);
+    }
+
+    // STOP：SCL 高电平时 SDA 由低变高
+    gpio_set_level(scl, 0);
+    ccount_delay(I2C_BUS_RECOVER_HALF_CYCLES);
+    gpio_set_level(sda, 0);
+    ccount_delay(I2C_BUS_RECOVER_HALF_CYCLES);
+    gpio_set_level(scl, 1);
+    ccount_delay(I2C_BUS_RECOVER_HALF_CYCLES);
+    gpio_set_level(sda, 1);
+    ccount_delay(I2C_BUS_RECOVER_HALF_CYCLES);
+
+    if(!i2c_bus_lines_idle())
+    {
+        ESP_LOGE(TAG, "bus still stuck after %d clocks: SDA=%d SCL=%d", i,
+                 gpio_get_level(sda), gpio_get_level(scl));
+    }
+
+    // 重新安装驱动
+    ret = i2c_bus_driver_install();
+    if(ESP_OK != ret)
+    {
+        ESP_LOGE(TAG, "driver reinstall failed: %d", ret);
+    }
+
+    // 从机可能已经复位，重新初始化设备；回调中的请求在本任务中直接执行
+    for(i = 0; ESP_OK == ret && i < s_bus->dev_num; ++i)
+    {
+        if(NULL != s_bus->dev[i].config.init && ESP_OK != s_bus->dev[i].config.init(&s_bus->dev[i]))
+        {
+            ESP_LOGW(TAG, "%s: init after recovery failed", i2c_bus_dev_name(&s_bus->dev[i]));
+        }
+    }
+
+    s_bus->recovering = false;
+}
+
+/* 测量 SCL 频率，软件 IIC 按测量结果把周期偏差平均分到高低电平上 */
+static esp_err_t i2c_bus_do_calib(i2c_bus_dev_handle_t dev, i2c_bus_calib_t *calib)
+{
+    uint32_t target = 0;
+    uint32_t period = 0;
+    uint32_t cycles = 0;
+    int32_t diff = 0;
+    int32_t low_diff = 0;
+    i2c_cmd_handle_t cmd = NULL;
+    int round = 0;
+
+    calib->target_hz = dev->config.scl_hz;
+    calib->low_cycles = 0;
+    calib->high_cycles = 0;
+
+    if(!i2c_bus_lines_idle())
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if(I2C_BUS_SCL_DRIVER == dev->config.scl_hz)
+    {
+        cmd = i2c_cmd_link_create();
+        if(NULL == cmd)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, dev->config.addr << 1 | WRITE_BIT, ACK_CHECK_EN);
+        i2c_master_stop(cmd);
+
+        // 从机是否应答不影响时钟个数
+        cycles = ccount_get();
+        i2c_master_cmd_begin(s_bus->config.port, cmd, i2c_bus_timeout(1));
+        cycles = ccount_get() - cycles;
+        i2c_cmd_link_delete(cmd);
+
+        calib->scl_hz = (uint32_t)((uint64_t)CCOUNT_CPU_MHZ * 1000000 * I2C_BUS_CALIB_DRIVER_CLOCKS / cycles);
+        return ESP_OK;
+    }
+
+    target = CCOUNT_CPU_MHZ * 1000000 / dev->config.scl_hz;
+    for(round = 0; round < I2C_BUS_CALIB_ROUNDS; ++round)
+    {
+        cycles = i2c_bus_bb_clock(&dev->timing, I2C_BUS_CALIB_CLOCKS);
+        period = cycles / I2C_BUS_CALIB_CLOCKS;
+        diff = (int32_t)(period - target);
+        if(abs(diff) * 1000 <= (int32_t)target * I2C_BUS_CALIB_TOLERANCE)
+        {
+            break;
+        }
+
+        // 上拉电阻使 SCL 上升变慢时，回读到的低电平会被当作时钟拉伸，周期变长
+        low_diff = diff * (int32_t)dev->timing.low_cycles / (int32_t)(dev->timing.low_cycles + dev->timing.high_cycles);
+        dev->timing.low_cycles = ((int32_t)dev->timing.low_cycles > low_diff) ? dev->timing.low_cycles - low_diff : 1;
+        dev->timing.high_cycles = ((int32_t)dev->timing.high_cycles > diff - low_diff) ?
+                                  dev->timing.high_cycles - (diff - low_diff) : 1;
+    }
+
+    calib->scl_hz = (uint32_t)((uint64_t)CCOUNT_CPU_MHZ * 1000000 * I2C_BUS_CALIB_CLOCKS / cycles);
+    calib->low_cycles = dev->timing.low_cycles;
+    calib->high_cycles = dev->timing.high_cycles;
+
+    return ESP_OK;
+}
+
+/* 只发送从机地址 (START | ADDR+W | STOP)，从机应答即存在 */
+static esp_err_t i2c_bus_do_probe(i2c_bus_dev_handle_t dev, uint8_t addr)
+{
+    esp_err_t ret = ESP_OK;
+    i2c_cmd_handle_t cmd = NULL;
+
+    if(I2C_BUS_SCL_DRIVER != dev->config.scl_hz)
+    {
+        return i2c_bus_bb_transfer(&dev->timing, addr, NULL, 0, NULL, 0, NULL, 0);
+    }
+
+    cmd = i2c_cmd_link_create();
+    if(NULL == cmd)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, addr << 1 | WRITE_BIT, ACK_CHECK_EN);
+    i2c_master_stop(cmd);
+    ret = i2c_master_cmd_begin(s_bus->config.port, cmd, i2c_bus_timeout(1));
+    i2c_cmd_link_delete(cmd);
+
+    return ret;
+}
+
+/* 依次探测所有 7 位地址，跳过保留地址 */
+static esp_err_t i2c_bus_do_scan(i2c_bus_dev_handle_t dev, uint8_t *found)
+{
+    esp_err_t ret = ESP_OK;
+    int addr = 0;
+
+    memset(found, 0, I2C_BUS_SCAN_BYTES);
+    for(addr = I2C_BUS_ADDR_MIN; addr <= I2C_BUS_ADDR_MAX; ++addr)
+    {
+        ret = i2c_bus_do_probe(dev, addr);
+        if(ESP_OK == ret)
+        {
+            found[addr >> 3] |= 1 << (addr & 0x07);
+        }
+        else if(ESP_FAIL != ret)
+        {
+            // 超时：总线卡死，由 i2c_bus_process() 恢复后重新扫描
+            return ret;
+        }
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t i2c_bus_exec(i2c_bus_req_t *req)
+{
+    i2c_bus_txn_handle_t txn = req->txn;
+
+    switch(req->type)
+    {
+        case I2C_BUS_REQ_WRITE:
+            return i2c_bus_do_write(req);
+        case I2C_BUS_REQ_READ:
+            return i2c_bus_do_read(req);
+        case I2C_BUS_REQ_CALIB:
+            return i2c_bus_do_calib(req->dev, req->calib);
+        case I2C_BUS_REQ_SCAN:
+            return i2c_bus_do_scan(req->dev, req->data);
+        case I2C_BUS_REQ_TABLE:
+            return i2c_bus_do_table(req);
+        default:
+            if(NULL == txn->addr_cmd)
+            {
+                return i2c_bus_bb_rw(txn->dev, txn->reg_addr, true, txn->data, txn->data_len);
+            }
+            return i2c_bus_run_read(req->dev, txn->addr_cmd, txn->data_cmd, req->data_len);
+    }
+}
+
+/* 执行请求，失败且总线被拉低时恢复总线并重试一次，更新统计 */
+static void i2c_bus_process(i2c_bus_req_t *req)
+{
+    i2c_bus_dev_handle_t dev = req->dev;
+    uint32_t start = ccount_get();
+    uint32_t busy_us = 0;
+    uint32_t latency_us = 0;
+
+    req->ret = i2c_bus_exec(req);
+
+    // 从机未应答 (NACK) 时总线是空闲的，不需要恢复
+    if(ESP_OK != req->ret && !s_bus->recovering && (ESP_ERR_TIMEOUT == req->ret || !i2c_bus_lines_idle()))
+    {
+        ESP_LOGW(TAG, "%s: error %d, recovering bus", i2c_bus_dev_name(dev), req->ret);
+        ++dev->recoveries;
+        i2c_bus_recover();
+        // 寄存器表只有声明可以重复写入时才从头重新执行
+        if(I2C_BUS_REQ_TABLE != req->type || 0 != (req->flags & I2C_BUS_TABLE_RETRY))
+        {
+            req->ret = i2c_bus_exec(req);
+        }
+    }
+
+    busy_us = ccount_elapsed_us(start);
+    latency_us = ccount_elapsed_us(req->submit_ccount);
+
+    // 统计
+    ++dev->count;
+    if(ESP_OK != req->ret)
+    {
+        ++dev->errors;
+    }
+    else
+    {
+        dev->bytes += req->data_len;
+    }
+    dev->busy_us += busy_us;
+    dev->latency_sum_us += latency_us;
+    if(latency_us > dev->latency_max_us)
+    {
+        dev->latency_max_us = latency_us;
+    }
+}
+
+/* 总线任务：独占 IIC 端口，按优先级连续执行请求 */
+static void i2c_bus_task(void *arg)
+{
+    i2c_bus_req_t *req = NULL;
+    int prio = 0;
+
+    for(;;)
+    {
+        xSemaphoreTake(s_bus->pending, portMAX_DELAY);
+
+        // 从高优先级队列开始取请求
+        req = NULL;
+        for(prio = I2C_BUS_PRIO_MAX - 1; 0 <= prio; --prio)
+        {
+            if(pdTRUE == xQueueReceive(s_bus->queue[prio], &req, 0))
+            {
+                break;
+            }
+        }
+        if(NULL == req)
+        {
+            continue;
+        }
+
+        i2c_bus_process(req);
+
+        // 通知请求任务，req 在请求任务的栈上，通知之后不能再访问
+        xSemaphoreGive(req->dev->done);
+    }
+}
+
+/* 提交请求并等待完成 */
+static esp_err_t i2c_bus_submit(i2c_bus_req_t *req)
+{
+    i2c_bus_dev_handle_t dev = req->dev;
+
+    req->ret = ESP_FAIL;
+    req->submit_ccount = ccount_get();
+
+    // 总线恢复后的设备初始化回调在总线任务中执行，直接执行请求；
+    // 此时发起恢复的请求任务可能持有设备锁，不能再获取
+    if(xTaskGetCurrentTaskHandle() == s_bus->task)
+    {
+        i2c_bus_process(req);
+        return req->ret;
+    }
+
+    xSemaphoreTake(dev->lock, portMAX_DELAY);
+
+    xQueueSend(s_bus->queue[dev->config.prio], &req, portMAX_DELAY);
+    xSemaphoreGive(s_bus->pending);
+    xSemaphoreTake(dev->done, portMAX_DELAY);
+
+    xSemaphoreGive(dev->lock);
+
+    return req->ret;
+}
+
+/* 初始化失败时释放已经创建的资源并卸载驱动，总线回到未初始化状态 */
+static void i2c_bus_free(void)
+{
+    int prio = 0;
+
+    for(prio = 0; prio < I2C_BUS_PRIO_MAX; ++prio)
+    {
+        if(NULL != s_bus->queue[prio])
+        {
+            vQueueDelete(s_bus->queue[prio]);
+        }
+    }
+    if(NULL != s_bus->pending)
+    {
+        vSemaphoreDelete(s_bus->pending);
+    }
+    if(NULL != s_bus->dev_lock)
+    {
+        vSemaphoreDelete(s_bus->dev_lock);
+    }
+    if(NULL != s_bus->probe_lock)
+    {
+        vSemaphoreDelete(s_bus->probe_lock);
+    }
+    if(NULL != s_bus->probe.lock)
+    {
+        vSemaphoreDelete(s_bus->probe.lock);
+    }
+    if(NULL != s_bus->probe.done)
+    {
+        vSemaphoreDelete(s_bus->probe.done);
+    }
+    if(NULL != s_bus->cache_pool)
+    {
+        mem_pool_delete(s_bus->cache_pool);
+    }
+    free(s_bus->cache);
+
+    i2c_driver_delete(s_bus->config.port);
+
+    free(s_bus);
+    s_bus = NULL;
+}
+
+esp_err_t i2c_bus_init(const i2c_bus_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    int prio = 0;
+
+    if(NULL == config || 0 == config->queue_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(NULL != s_bus)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_bus = calloc(1, sizeof(i2c_bus_t));
+    if(NULL == s_bus)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    s_bus->config = *config;
+    s_bus->bb_ok = (ESP_OK == i2c_bus_bb_init(config->sda_io_num, config->scl_io_num, I2C_BUS_BB_STRETCH_US));
+
+    ret = i2c_bus_driver_install();
+    if(ESP_OK != ret)
+    {
+        ESP_LOGE(TAG, "driver install failed: %d", ret);
+        free(s_bus);
+        s_bus = NULL;
+        return ret;
+    }
+
+    s_bus->pending = xSemaphoreCreateCounting(config->queue_len * I2C_BUS_PRIO_MAX, 0);
+    s_bus->dev_lock = xSemaphoreCreateMutex();
+    s_bus->probe_lock = xSemaphoreCreateMutex();
+    s_bus->probe.lock = xSemaphoreCreateMutex();
+    s_bus->probe.done = xSemaphoreCreateBinary();
+    if(NULL == s_bus->pending || NULL == s_bus->dev_lock || NULL == s_bus->probe_lock
+       || NULL == s_bus->probe.lock || NULL == s_bus->probe.done)
+    {
+        ret = ESP_ERR_NO_MEM;
+    }
+
+    // 扫描尽量使用快速模式
+    s_bus->probe.config.name = "probe";
+    s_bus->probe.config.reg_addr_len = 1;
+    s_bus->probe.config.prio = I2C_BUS_PRIO_NORMAL;
+    if(s_bus->bb_ok)
+    {
+        s_bus->probe.config.scl_hz = I2C_BUS_SCL_FAST;
+        i2c_bus_bb_timing(I2C_BUS_SCL_FAST, &s_bus->probe.timing);
+    }
+    for(prio = 0; prio < I2C_BUS_PRIO_MAX; ++prio)
+    {
+        s_bus->queue[prio] = xQueueCreate(config->queue_len, sizeof(i2c_bus_req_t *));
+        if(NULL == s_bus->queue[prio])
+        {
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+
+    // 命令连接缓存与数据缓冲区在初始化时一次分配
+    if(0 < config->cache_num)
+    {
+        s_bus->cache = calloc(config->cache_num, sizeof(i2c_bus_cache_t));
+        if(NULL == s_bus->cache
+           || ESP_OK != mem_pool_create(I2C_BUS_CACHE_BUF_SIZE, config->cache_num, &s_bus->cache_pool))
+        {
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if(ESP_OK != ret
+       || pdPASS != xTaskCreate(i2c_bus_task, "i2c_bus", config->task_stack, NULL, config->task_prio, &s_bus->task))
+    {
+        ESP_LOGE(TAG, "no memory for bus task");
+        i2c_bus_free();
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_add_device(const i2c_bus_dev_config_t *config, i2c_bus_dev_handle_t *dev)
+{
+    i2c_bus_dev_handle_t new_dev = NULL;
+
+    if(NULL == s_bus)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(NULL == config || NULL == dev || 0x7F < config->addr || I2C_BUS_PRIO_MAX <= config->prio
+       || 1 > config->reg_addr_len || 2 < config->reg_addr_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(I2C_BUS_SCL_DRIVER != config->scl_hz && !s_bus->bb_ok)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    xSemaphoreTake(s_bus->dev_lock, portMAX_DELAY);
+    if(I2C_BUS_DEV_MAX > s_bus->dev_num)
+    {
+        new_dev = &s_bus->dev[s_bus->dev_num];
+        new_dev->config = *config;
+        if(I2C_BUS_SCL_DRIVER != config->scl_hz)
+        {
+            i2c_bus_bb_timing(config->scl_hz, &new_dev->timing);
+        }
+        new_dev->lock = xSemaphoreCreateMutex();
+        new_dev->done = xSemaphoreCreateBinary();
+        if(NULL != new_dev->lock && NULL != new_dev->done)
+        {
+            ++s_bus->dev_num;
+        }
+        else
+        {
+            new_dev = NULL;
+        }
+    }
+    xSemaphoreGive(s_bus->dev_lock);
+
+    if(NULL == new_dev)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    *dev = new_dev;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_write(i2c_bus_dev_handle_t dev, uint16_t reg_addr, const uint8_t *data, size_t data_len)
+{
+    i2c_bus_req_t req = {
+        .type = I2C_BUS_REQ_WRITE,
+        .dev = dev,
+        .reg_addr = reg_addr,
+        .data = (uint8_t *)data,
+        .data_len = data_len,
+    };
+
+    if(NULL == dev || (NULL == data && 0 != data_len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return i2c_bus_submit(&req);
+}
+
+esp_err_t i2c_bus_read(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len)
+{
+    i2c_bus_req_t req = {
+        .type = I2C_BUS_REQ_READ,
+        .dev = dev,
+        .reg_addr = reg_addr,
+        .data = data,
+        .data_len = data_len,
+    };
+
+    if(NULL == dev || NULL == data || 0 == data_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return i2c_bus_submit(&req);
+}
+
+esp_err_t i2c_bus_write_table(i2c_bus_dev_handle_t dev, const i2c_bus_reg_t *table, size_t num, uint32_t flags,
+                              i2c_bus_table_result_t *result)
+{
+    uint8_t data[I2C_BUS_TABLE_MAX];
+    i2c_bus_table_result_t part;
+    i2c_bus_table_result_t total;
+    i2c_bus_req_t req = {
+        .type = I2C_BUS_REQ_TABLE,
+        .dev = dev,
+        .data = data,
+        .flags = flags,
+        .result = &part,
+    };
+    const i2c_bus_reg_t *entry = NULL;
+    uint8_t delay_ms = 0;
+    size_t start = 0;
+    size_t end = 0;
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == dev || (NULL == table && 0 < num) || 1 != dev->config.reg_addr_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(&total, 0, sizeof(total));
+    for(start = 0; start < num; start = end)
+    {
+        // 一个请求到有等待的项为止
+        end = start;
+        do
+        {
+            delay_ms = table[end++].delay_ms;
+        } while(0 == delay_ms && end < num && I2C_BUS_TABLE_MAX > end - start);
+
+        memset(&part, 0, sizeof(part));
+        req.table = &table[start];
+        req.data_len = end - start;
+        ret = i2c_bus_submit(&req);
+        ++total.requests;
+        total.transfers += part.transfers;
+        if(ESP_OK != ret && I2C_BUS_TABLE_INDEX_UNKNOWN == part.index)
+        {
+            total.index = I2C_BUS_TABLE_INDEX_UNKNOWN;
+            ESP_LOGE(TAG, "%s: table entries %u ~ %u: error %d",
+                     i2c_bus_dev_name(dev), (unsigned)start, (unsigned)(end - 1), ret);
+            break;
+        }
+        if(ESP_OK != ret)
+        {
+            total.index = start + part.index;
+            total.expect = part.expect;
+            total.actual = part.actual;
+            entry = &table[total.index];
+            if(ESP_ERR_INVALID_RESPONSE == ret)
+            {
+                ESP_LOGE(TAG, "%s: table entry %u, reg 0x%02x: wrote 0x%02x, read back 0x%02x (mask 0x%02x)",
+                         i2c_bus_dev_name(dev), total.index, entry->reg, total.expect, total.actual, entry->mask);
+            }
+            else
+            {
+                ESP_LOGE(TAG, "%s: table entry %u, reg 0x%02x: error %d",
+                         i2c_bus_dev_name(dev), total.index, entry->reg, ret);
+            }
+            break;
+        }
+
+        // 当前节拍已经过去一部分，多等一个节拍保证至少 delay_ms
+        if(0 < delay_ms)
+        {
+            vTaskDelay(delay_ms / portTICK_RATE_MS + 1);
+        }
+    }
+    if(ESP_OK == ret)
+    {
+        total.index = num;
+    }
+    if(NULL != result)
+    {
+        *result = total;
+    }
+
+    return ret;
+}
+
+esp_err_t i2c_bus_prepare_read(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len,
+                               i2c_bus_txn_handle_t *txn)
+{
+    i2c_bus_txn_handle_t new_txn = NULL;
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == dev || NULL == data || 0 == data_len || NULL == txn)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    new_txn = calloc(1, sizeof(struct i2c_bus_txn));
+    if(NULL == new_txn)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 软件 IIC 不需要命令连接
+    if(I2C_BUS_SCL_DRIVER == dev->config.scl_hz)
+    {
+        ret = i2c_bus_build_read(dev, reg_addr, data, data_len, &new_txn->addr_cmd, &new_txn->data_cmd);
+        if(ESP_OK != ret)
+        {
+            free(new_txn);
+            return ret;
+        }
+    }
+    new_txn->dev = dev;
+    new_txn->reg_addr = reg_addr;
+    new_txn->data = data;
+    new_txn->data_len = data_len;
+    *txn = new_txn;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_execute(i2c_bus_txn_handle_t txn)
+{
+    i2c_bus_req_t req = { 0 };
+
+    if(NULL == txn)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    req.type = I2C_BUS_REQ_TXN;
+    req.dev = txn->dev;
+    req.data_len = txn->data_len;
+    req.txn = txn;
+
+    return i2c_bus_submit(&req);
+}
+
+void i2c_bus_release(i2c_bus_txn_handle_t txn)
+{
+    if(NULL == txn)
+    {
+        return;
+    }
+
+    if(NULL != txn->addr_cmd)
+    {
+        i2c_cmd_link_delete(txn->addr_cmd);
+        i2c_cmd_link_delete(txn->data_cmd);
+    }
+    free(txn);
+}
+
+esp_err_t i2c_bus_calibrate(i2c_bus_dev_handle_t dev, i2c_bus_calib_t *calib)
+{
+    i2c_bus_req_t req = { 0 };
+
+    if(NULL == dev || NULL == calib)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    req.type = I2C_BUS_REQ_CALIB;
+    req.dev = dev;
+    req.calib = calib;
+
+    return i2c_bus_submit(&req);
+}
+
+esp_err_t i2c_bus_scan(uint8_t found[I2C_BUS_SCAN_BYTES])
+{
+    i2c_bus_req_t req = { 0 };
+
+    if(NULL == s_bus)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(NULL == found)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    req.type = I2C_BUS_REQ_SCAN;
+    req.dev = &s_bus->probe;
+    req.data = found;
+
+    return i2c_bus_submit(&req);
+}
+
+esp_err_t i2c_bus_read_addr(uint8_t addr, uint8_t reg_addr_len, uint16_t reg_addr, uint8_t *data, size_t data_len)
+{
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == s_bus)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(0x7F < addr || 1 > reg_addr_len || 2 < reg_addr_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_bus->probe_lock, portMAX_DELAY);
+    s_bus->probe.config.addr = addr;
+    s_bus->probe.config.reg_addr_len = reg_addr_len;
+    ret = i2c_bus_read(&s_bus->probe, reg_addr, data, data_len);
+    xSemaphoreGive(s_bus->probe_lock);
+
+    return ret;
+}
+
+esp_err_t i2c_bus_get_stats(i2c_bus_dev_handle_t dev, i2c_bus_dev_stats_t *stats)
+{
+    if(NULL == dev || NULL == stats)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 统计由总线任务更新，这里只读，个别字段可能来自相邻的两次请求，不影响观察
+    stats->count = dev->count;
+    stats->errors = dev->errors;
+    stats->bytes = dev->bytes;
+    stats->latency_avg_us = (0 == dev->count) ? 0 : (uint32_t)(dev->latency_sum_us / dev->count);
+    stats->latency_max_us = dev->latency_max_us;
+    stats->busy_us = (uint32_t)dev->busy_us;
+    stats->throughput_bps = (0 == dev->busy_us) ? 0 : (uint32_t)((uint64_t)dev->bytes * 1000000 / dev->busy_us);
+    stats->recoveries = dev->recoveries;
+
+    return ESP_OK;
+}
+
+void i2c_bus_reset_stats(i2c_bus_dev_handle_t dev)
+{
+    if(NULL == dev)
+    {
+        return;
+    }
+
+    dev->count = 0;
+    dev->errors = 0;
+    dev->bytes = 0;
+    dev->latency_sum_us = 0;
+    dev->latency_max_us = 0;
+    dev->busy_us = 0;
+    dev->recoveries = 0;
+}
+
+const char *i2c_bus_dev_name(i2c_bus_dev_handle_t dev)
+{
+    return (NULL == dev || NULL == dev->config.name) ? "?" : dev->config.name;
+}
+
+esp_err_t i2c_bus_get_cache_stats(i2c_bus_cache_stats_t *stats)
+{
+    if(NULL == stats)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(NULL == s_bus || NULL == s_bus->cache_pool)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    stats->hits = s_bus->cache_hits;
+    stats->misses = s_bus->cache_misses;
+    stats->bypass = s_bus->cache_bypass;
+    mem_pool_get_stats(s_bus->cache_pool, &stats->pool);
+
+    return ESP_OK;
+}
+
+TaskHandle_t i2c_bus_task_handle(void)
+{
+    return (NULL == s_bus) ? NULL : s_bus->task;
+}
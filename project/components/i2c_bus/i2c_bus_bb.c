@@ -0,0 +1,278 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "esp8266/gpio_struct.h"
+
+#include "ccount.h"
+#include "i2c_bus_bb.h"
+
+/* 低电平占一个时钟周期的百分比 */
+#define I2C_BUS_BB_LOW_PERCENT      (55)
+
+static uint32_t s_sda_mask = 0;
+static uint32_t s_scl_mask = 0;
+static uint32_t s_stretch_cycles = 0;
+
+/* 开漏输出：写 1 释放引脚由上拉电阻拉高，写 0 拉低 */
+#define BB_SDA_HIGH()               (GPIO.out_w1ts = s_sda_mask)
+#define BB_SDA_LOW()                (GPIO.out_w1tc = s_sda_mask)
+#define BB_SCL_HIGH()               (GPIO.out_w1ts = s_scl_mask)
+#define BB_SCL_LOW()                (GPIO.out_w1tc = s_scl_mask)
+#define BB_SDA_READ()               (0 != (GPIO.in & s_sda_mask))
+#define BB_SCL_READ()               (0 != (GPIO.in & s_scl_mask))
+
+/**
+ * 等到上一个边沿之后 cycles 个周期
+ *
+ * 按绝对时刻定时，GPIO 写寄存器与循环本身的开销不会累积到时钟周期里；
+ * 被中断推迟超过一个相位时从当前时刻重新计时，保证下一个相位不被缩短
+ */
+static inline void bb_wait(uint32_t *edge, uint32_t cycles)
+{
+    uint32_t now = 0;
+
+    *edge += cycles;
+    while((int32_t)((now = ccount_get()) - *edge) < 0)
+    {
+    }
+
+    if(now - *edge > cycles)
+    {
+        *edge = now;
+    }
+}
+
+/* 释放 SCL，等待从机释放 (时钟拉伸)，然后保持高电平 */
+static inline bool bb_scl_rise(const i2c_bus_bb_timing_t *timing, uint32_t *edge)
+{
+    uint32_t start = 0;
+
+    BB_SCL_HIGH();
+    if(!BB_SCL_READ())
+    {
+        start = ccount_get();
+        while(!BB_SCL_READ())
+        {
+            if(ccount_get() - start > s_stretch_cycles)
+            {
+                return false;
+            }
+        }
+        // 从机释放 SCL 的时刻才是上升沿
+        *edge = ccount_get();
+    }
+    bb_wait(edge, timing->high_cycles);
+
+    return true;
+}
+
+/* 总线空闲 (SCL、SDA 高电平) -> START，结束时 SCL 为低电平 */
+static void bb_start(const i2c_bus_bb_timing_t *timing, uint32_t *edge)
+{
+    *edge = ccount_get();
+    BB_SDA_LOW();
+    bb_wait(edge, timing->high_cycles);
+    BB_SCL_LOW();
+}
+
+/* SCL 低电平 -> 重复起始条件 */
+static bool bb_restart(const i2c_bus_bb_timing_t *timing, uint32_t *edge)
+{
+    BB_SDA_HIGH();
+    bb_wait(edge, timing->low_cycles);
+    if(!bb_scl_rise(timing, edge))
+    {
+        return false;
+    }
+    BB_SDA_LOW();
+    bb_wait(edge, timing->high_cycles);
+    BB_SCL_LOW();
+
+    return true;
+}
+
+/* SCL 低电平 -> STOP，并保持总线空闲时间 */
+static void bb_stop(const i2c_bus_bb_timing_t *timing, uint32_t *edge)
+{
+    BB_SDA_LOW();
+    bb_wait(edge, timing->low_cycles);
+    bb_scl_rise(timing, edge);
+    BB_SDA_HIGH();
+    bb_wait(edge, timing->high_cycles);
+}
+
+/* 发送一个字节并读取 ACK，SCL 低电平进入与退出 */
+static esp_err_t bb_write_byte(const i2c_bus_bb_timing_t *timing, uint32_t *edge, uint8_t data)
+{
+    bool ack = false;
+    int i = 0;
+
+    for(i = 7; 0 <= i; --i)
+    {
+        if(0 != (data & (1 << i)))
+        {
+            BB_SDA_HIGH();
+        }
+        else
+        {
+            BB_SDA_LOW();
+        }
+        bb_wait(edge, timing->low_cycles);
+        if(!bb_scl_rise(timing, edge))
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        BB_SCL_LOW();
+    }
+
+    // 第 9 个时钟：释放 SDA，从机拉低表示 ACK
+    BB_SDA_HIGH();
+    bb_wait(edge, timing->low_cycles);
+    if(!bb_scl_rise(timing, edge))
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    ack = !BB_SDA_READ();
+    BB_SCL_LOW();
+
+    return ack ? ESP_OK : ESP_FAIL;
+}
+
+/* 读取一个字节并发送 ACK/NACK，SCL 低电平进入与退出 */
+static esp_err_t bb_read_byte(const i2c_bus_bb_timing_t *timing, uint32_t *edge, uint8_t *data, bool nack)
+{
+    uint8_t value = 0;
+    int i = 0;
+
+    BB_SDA_HIGH();
+    for(i = 0; i < 8; ++i)
+    {
+        bb_wait(edge, timing->low_cycles);
+        if(!bb_scl_rise(timing, edge))
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        value = (value << 1) | (BB_SDA_READ() ? 1 : 0);
+        BB_SCL_LOW();
+    }
+    *data = value;
+
+    if(!nack)
+    {
+        BB_SDA_LOW();
+    }
+    bb_wait(edge, timing->low_cycles);
+    if(!bb_scl_rise(timing, edge))
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    BB_SCL_LOW();
+    BB_SDA_HIGH();
+
+    return ESP_OK;
+}
+
+static esp_err_t bb_write_bytes(const i2c_bus_bb_timing_t *timing, uint32_t *edge, const uint8_t *data, size_t len)
+{
+    esp_err_t ret = ESP_OK;
+    size_t i = 0;
+
+    for(i = 0; ESP_OK == ret && i < len; ++i)
+    {
+        ret = bb_write_byte(timing, edge, data[i]);
+    }
+
+    return ret;
+}
+
+esp_err_t i2c_bus_bb_init(gpio_num_t sda, gpio_num_t scl, uint32_t stretch_us)
+{
+    if(GPIO_NUM_16 <= sda || GPIO_NUM_16 <= scl)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    s_sda_mask = 1 << sda;
+    s_scl_mask = 1 << scl;
+    s_stretch_cycles = stretch_us * CCOUNT_CPU_MHZ;
+
+    return ESP_OK;
+}
+
+void i2c_bus_bb_timing(uint32_t scl_hz, i2c_bus_bb_timing_t *timing)
+{
+    uint32_t period = CCOUNT_CPU_MHZ * 1000000 / scl_hz;
+
+    timing->low_cycles = period * I2C_BUS_BB_LOW_PERCENT / 100;
+    timing->high_cycles = period - timing->low_cycles;
+}
+
+esp_err_t i2c_bus_bb_transfer(const i2c_bus_bb_timing_t *timing, uint8_t addr,
+                              const uint8_t *reg, size_t reg_len,
+                              const uint8_t *wdata, size_t wdata_len,
+                              uint8_t *rdata, size_t rdata_len)
+{
+    esp_err_t ret = ESP_OK;
+    uint32_t edge = 0;
+    size_t i = 0;
+
+    if(0 == s_scl_mask)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // SDA 或 SCL 被从机拉低时发不出起始条件，不输出时钟，交给总线恢复处理
+    if(!BB_SDA_READ() || !BB_SCL_READ())
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    bb_start(timing, &edge);
+    ret = bb_write_byte(timing, &edge, addr << 1);
+    if(ESP_OK == ret)
+    {
+        ret = bb_write_bytes(timing, &edge, reg, reg_len);
+    }
+    if(ESP_OK == ret)
+    {
+        ret = bb_write_bytes(timing, &edge, wdata, wdata_len);
+    }
+
+    if(ESP_OK == ret && 0 < rdata_len)
+    {
+        ret = bb_restart(timing, &edge) ? bb_write_byte(timing, &edge, addr << 1 | 1) : ESP_ERR_TIMEOUT;
+        for(i = 0; ESP_OK == ret && i < rdata_len; ++i)
+        {
+            ret = bb_read_byte(timing, &edge, &rdata[i], i == rdata_len - 1);
+        }
+    }
+
+    // 超时时 SCL 被从机拉住，STOP 发不出去，交给总线恢复处理
+    if(ESP_ERR_TIMEOUT != ret)
+    {
+        bb_stop(timing, &edge);
+    }
+
+    return ret;
+}
+
+uint32_t i2c_bus_bb_clock(const i2c_bus_bb_timing_t *timing, uint32_t clocks)
+{
+    uint32_t start = 0;
+    uint32_t edge = 0;
+    uint32_t i = 0;
+
+    BB_SDA_HIGH();
+    start = ccount_get();
+    edge = start;
+    for(i = 0; i < clocks; ++i)
+    {
+        BB_SCL_LOW();
+        bb_wait(&edge, timing->low_cycles);
+        if(!bb_scl_rise(timing, &edge))
+        {
+            break;
+        }
+    }
+
+    return ccount_get() - start;
+}
@@ -0,0 +1,64 @@
+/**
+ * IIC 总线管理内部头文件：按 CCOUNT 计时的软件 IIC
+ *
+ * SDK 的 IIC 驱动同样由 GPIO 模拟，但 SCL 高低电平各固定保持 5us (约 100kHz)，没有调整速度的接口。
+ * 这里直接读写 GPIO 寄存器产生波形，每个边沿按 CCOUNT 定时，SCL 频率由设备的速度配置决定。
+ * 引脚的开漏配置沿用 SDK 驱动 i2c_param_config() 的结果，两者可以在同一条总线上交替使用。
+ */
+#ifndef _I2C_BUS_BB_H_
+#define _I2C_BUS_BB_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t low_cycles;            /*!< SCL 低电平保持的 CPU 周期数 */
+    uint32_t high_cycles;           /*!< SCL 高电平保持的 CPU 周期数 */
+} i2c_bus_bb_timing_t;
+
+/**
+ * @brief  设置引脚，GPIO16 不在 GPIO 寄存器中，不支持
+ *
+ * @param  stretch_us  从机拉住 SCL (时钟拉伸) 的最长等待时间
+ */
+esp_err_t i2c_bus_bb_init(gpio_num_t sda, gpio_num_t scl, uint32_t stretch_us);
+
+/**
+ * @brief  由 SCL 频率计算高低电平时间，低电平占 55%，满足 100kHz/400kHz 的 tLOW/tHIGH 最小值
+ */
+void i2c_bus_bb_timing(uint32_t scl_hz, i2c_bus_bb_timing_t *timing);
+
+/**
+ * @brief  一次完整的传输：START | ADDR+W | REG | WDATA | [Sr | ADDR+R | RDATA] | STOP
+ *
+ * rdata_len 为 0 时只写；读数据时用重复起始条件，最后一个字节应答 NACK
+ *
+ * @return ESP_OK / ESP_FAIL (从机未应答) / ESP_ERR_TIMEOUT (时钟拉伸超时，或开始前总线被拉低)
+ */
+esp_err_t i2c_bus_bb_transfer(const i2c_bus_bb_timing_t *timing, uint8_t addr,
+                              const uint8_t *reg, size_t reg_len,
+                              const uint8_t *wdata, size_t wdata_len,
+                              uint8_t *rdata, size_t rdata_len);
+
+/**
+ * @brief  在空闲总线上 (SDA 保持高电平) 输出 clocks 个 SCL 时钟，用于校准
+ *
+ * 没有起始条件，从机会忽略这些时钟
+ *
+ * @return 实际用去的 CPU 周期数
+ */
+uint32_t i2c_bus_bb_clock(const i2c_bus_bb_timing_t *timing, uint32_t clocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _I2C_BUS_BB_H_ */
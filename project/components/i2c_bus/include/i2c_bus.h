@@ -0,0 +1,291 @@
+/**
+ * IIC 总线管理
+ *
+ * IIC 驱动的 API 不是线程安全的，每个实例各自调用 i2c_driver_install() 并认为自己独占端口，
+ * 多个任务同时访问同一条总线时，传输会互相破坏。
+ *
+ * 本组件由一个总线任务独占 IIC 端口：
+ * - 设备先注册到总线上，得到设备句柄
+ * - 各任务的读写请求按优先级进入队列，总线任务按优先级 (同优先级先进先出) 依次连续执行
+ * - 请求任务阻塞等待执行结果，接口用法与原来的 xxx_read()/xxx_write() 相同
+ * - 周期性的读操作可以预先创建事务 (i2c_bus_prepare_read())，重复执行时复用同一组命令连接
+ * - 统计每个设备的请求次数、错误次数、字节数、延时与吞吐量
+ * - 超时按传输长度计算；传输失败后如果 SDA/SCL 被拉低，自动恢复总线：
+ *   SCL 输出最多 9 个时钟脉冲让从机释放 SDA，再发出 STOP，重新安装驱动，
+ *   重新执行各设备的初始化回调，然后重试一次失败的请求
+ * - 每个设备可以单独设置 SCL 频率：SDK 驱动固定约 100kHz，设置了频率的设备改用按 CCOUNT 计时的
+ *   软件 IIC，总线任务在两次传输之间按设备切换，i2c_bus_calibrate() 测量实际达到的 SCL 频率
+ * - i2c_bus_scan() 只发送从机地址探测全部 7 位地址，i2c_bus_read_addr() 按地址读取未注册的设备，
+ *   用于启动时识别设备
+ * - SDK 驱动每次传输都要 malloc 命令连接与每条命令的节点。配置 cache_num 后，总线任务缓存最近使用的
+ *   读写命令连接 (按设备、寄存器地址、长度、读/写区分)，数据经过 mem_pool 分配的固定缓冲区，
+ *   同样的请求重复执行时不再分配内存
+ * - 设备初始化可以写成寄存器表 (i2c_bus_write_table())：地址连续的项合并为多字节写，
+ *   没有等待的连续项作为一个请求执行，出错时报告出错的表项，可选读回检查
+ */
+#ifndef _I2C_BUS_H_
+#define _I2C_BUS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "driver/i2c.h"
+
+#include "mem_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_BUS_DEV_MAX             (8)
+
+/* 可用的 7 位地址，0x00 ~ 0x07 与 0x78 ~ 0x7F 为保留地址 */
+#define I2C_BUS_ADDR_MIN            (0x08)
+#define I2C_BUS_ADDR_MAX            (0x77)
+/* 扫描结果位图：每个地址 1 位 */
+#define I2C_BUS_SCAN_BYTES          (16)
+/* 命令连接缓存的数据缓冲区大小，更长的传输不缓存：AT24C32 一页 */
+#define I2C_BUS_CACHE_BUF_SIZE      (32)
+/* 寄存器表一个请求中最多的表项数，更长的表分多个请求执行 */
+#define I2C_BUS_TABLE_MAX           (32)
+
+/* i2c_bus_write_table() 的选项 */
+#define I2C_BUS_TABLE_VERIFY        (1 << 0)        /*!< 写入后读回，比较 mask 中的位 */
+#define I2C_BUS_TABLE_RETRY         (1 << 1)        /*!< 总线恢复后从请求的第一项重新执行，只用于可以重复写入的表 */
+
+/* i2c_bus_table_result_t.index：无法确定出错的表项 */
+#define I2C_BUS_TABLE_INDEX_UNKNOWN (0xFFFF)
+
+/**
+ * 设备 SCL 频率
+ */
+#define I2C_BUS_SCL_DRIVER          (0)             /*!< 使用 SDK 驱动，约 100kHz */
+#define I2C_BUS_SCL_STANDARD        (100000)        /*!< 标准模式 */
+#define I2C_BUS_SCL_FAST            (400000)        /*!< 快速模式 */
+
+typedef enum {
+    I2C_BUS_PRIO_LOW = 0,
+    I2C_BUS_PRIO_NORMAL,
+    I2C_BUS_PRIO_HIGH,
+    I2C_BUS_PRIO_MAX,
+} i2c_bus_prio_t;
+
+typedef struct {
+    i2c_port_t port;                /*!< IIC 端口号 */
+    gpio_num_t sda_io_num;          /*!< SDA 引脚 */
+    gpio_num_t scl_io_num;          /*!< SCL 引脚 */
+    uint32_t clk_stretch_tick;      /*!< 时钟拉伸节拍 */
+    uint8_t queue_len;              /*!< 每个优先级的队列长度 */
+    uint8_t task_prio;              /*!< 总线任务优先级 */
+    uint16_t task_stack;            /*!< 总线任务栈大小 */
+    uint8_t cache_num;              /*!< SDK 驱动设备的命令连接缓存项数，0 不缓存 */
+} i2c_bus_config_t;
+
+/* 与原实例相同的默认配置：GPIO14 -> SDA，GPIO2 -> SCL */
+#define I2C_BUS_DEFAULT_CONFIG() {  \
+    .port = I2C_NUM_0,              \
+    .sda_io_num = GPIO_NUM_14,      \
+    .scl_io_num = GPIO_NUM_2,       \
+    .clk_stretch_tick = 300,        \
+    .queue_len = 4,                 \
+    .task_prio = 12,                \
+    .task_stack = 2048,             \
+    .cache_num = 0,                 \
+}
+
+typedef struct i2c_bus_dev *i2c_bus_dev_handle_t;
+typedef struct i2c_bus_txn *i2c_bus_txn_handle_t;
+
+typedef struct {
+    uint32_t target_hz;             /*!< 设备配置的 SCL 频率，0 表示 SDK 驱动 */
+    uint32_t scl_hz;                /*!< 测得的 SCL 频率 */
+    uint32_t low_cycles;            /*!< 校准后 SCL 低电平的 CPU 周期数，SDK 驱动为 0 */
+    uint32_t high_cycles;           /*!< 校准后 SCL 高电平的 CPU 周期数，SDK 驱动为 0 */
+} i2c_bus_calib_t;
+
+/**
+ * 设备初始化回调，总线恢复后在总线任务中执行，回调内可以直接调用 i2c_bus_write()/i2c_bus_read()
+ */
+typedef esp_err_t (*i2c_bus_dev_init_t)(i2c_bus_dev_handle_t dev);
+
+typedef struct {
+    const char *name;               /*!< 设备名，用于日志 */
+    uint8_t addr;                   /*!< 7 位从机地址 */
+    uint8_t reg_addr_len;           /*!< 寄存器地址字节数：1 或 2 (EEPROM)，高字节在前 */
+    i2c_bus_prio_t prio;            /*!< 该设备请求的优先级 */
+    i2c_bus_dev_init_t init;        /*!< 总线恢复后重新初始化设备，可以为 NULL */
+    uint32_t scl_hz;                /*!< SCL 频率，I2C_BUS_SCL_DRIVER 表示使用 SDK 驱动 */
+} i2c_bus_dev_config_t;
+
+typedef struct {
+    uint32_t count;                 /*!< 完成的请求数 */
+    uint32_t errors;                /*!< 失败的请求数 */
+    uint32_t bytes;                 /*!< 读写的数据字节数 (不含地址) */
+    uint32_t latency_avg_us;        /*!< 平均延时：提交请求 -> 完成，含排队时间 */
+    uint32_t latency_max_us;        /*!< 最大延时 */
+    uint32_t busy_us;               /*!< 总线执行时间 */
+    uint32_t throughput_bps;        /*!< 吞吐量：字节数 / 总线执行时间，单位 byte/s */
+    uint32_t recoveries;            /*!< 由该设备的请求触发的总线恢复次数 */
+} i2c_bus_dev_stats_t;
+
+typedef struct {
+    uint32_t hits;                  /*!< 复用缓存的命令连接的请求数 */
+    uint32_t misses;                /*!< 创建并缓存新命令连接的请求数 */
+    uint32_t bypass;                /*!< 不能缓存 (超长、缓存未配置或创建失败) 的请求数 */
+    mem_pool_stats_t pool;          /*!< 数据缓冲区池 */
+} i2c_bus_cache_stats_t;
+
+/**
+ * 寄存器表的一项：mask 为 0xFF 时直接写入 value，否则先读出寄存器，只改变 mask 中的位 (读-改-写)；
+ * 写入后等待 delay_ms 再执行下一项，例如复位后等待设备启动
+ */
+typedef struct {
+    uint8_t reg;
+    uint8_t value;
+    uint8_t mask;
+    uint8_t delay_ms;
+} i2c_bus_reg_t;
+
+/* 直接写入整个寄存器的表项 */
+#define I2C_BUS_REG(reg, value)     { (reg), (value), 0xFF, 0 }
+
+typedef struct {
+    uint16_t index;                 /*!< 出错的表项，全部成功时为表项数，无法确定时为 I2C_BUS_TABLE_INDEX_UNKNOWN */
+    uint8_t expect;                 /*!< 读回检查不一致时：期望值与读回的值 (mask 中的位) */
+    uint8_t actual;
+    uint16_t requests;              /*!< 总线请求数 */
+    uint16_t transfers;             /*!< IIC 传输次数，一次传输从起始条件到停止条件 */
+} i2c_bus_table_result_t;
+
+/**
+ * @brief  安装 IIC 驱动并启动总线任务
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_STATE (已初始化) / ESP_ERR_NO_MEM / IIC 驱动错误码，失败时已创建的资源全部释放并卸载驱动，可以再次调用
+ */
+esp_err_t i2c_bus_init(const i2c_bus_config_t *config);
+
+/**
+ * @brief  在总线上注册设备
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_NO_MEM
+ */
+esp_err_t i2c_bus_add_device(const i2c_bus_dev_config_t *config, i2c_bus_dev_handle_t *dev);
+
+/**
+ * @brief  写寄存器：START | ADDR+W | REG | DATA... | STOP
+ */
+esp_err_t i2c_bus_write(i2c_bus_dev_handle_t dev, uint16_t reg_addr, const uint8_t *data, size_t data_len);
+
+/**
+ * @brief  读寄存器：先写寄存器地址，再读取 data_len 字节
+ */
+esp_err_t i2c_bus_read(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len);
+
+/**
+ * @brief  按寄存器表写入，只支持 1 字节寄存器地址的设备
+ *
+ * 相邻两项的寄存器地址连续时合并为一次多字节写 (设备需要支持地址自动递增)。到有等待的项为止的连续表项
+ * 作为一个请求在总线任务中执行：先读出需要读-改-写的寄存器，再写入全部数据；SDK 驱动设备的各段写入放在
+ * 同一个命令连接中 (重复起始条件)，只执行一次 i2c_master_cmd_begin()，软件 IIC 设备每段一次传输。
+ * 出错时不再执行后面的表项，在日志中输出出错的表项与寄存器地址。
+ * SDK 驱动设备的合并传输出错时不知道停在哪一段，不再逐段重写 (会把已写入的段写两次)，返回传输的错误码，
+ * 出错的表项为 I2C_BUS_TABLE_INDEX_UNKNOWN，该请求中的表项可能已经部分写入。
+ * 传输出错需要恢复总线时，默认不重新执行寄存器表请求；设置 I2C_BUS_TABLE_RETRY 时从该请求的第一项
+ * 重新执行 (包括读-改-写的读出)，只能用于重复写入结果相同的表，不能用于写 1 清除、复位 FIFO 等有副作用的寄存器。
+ * 可以在设备初始化回调中使用。
+ *
+ * @param  flags   0 或 I2C_BUS_TABLE_VERIFY、I2C_BUS_TABLE_RETRY 的组合
+ * @param  result  出错的表项与传输统计，可以为 NULL
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_RESPONSE (读回的值不一致) / IIC 驱动错误码
+ */
+esp_err_t i2c_bus_write_table(i2c_bus_dev_handle_t dev, const i2c_bus_reg_t *table, size_t num, uint32_t flags,
+                              i2c_bus_table_result_t *result);
+
+/**
+ * @brief  预先创建一个读事务，之后用 i2c_bus_execute() 重复执行
+ *
+ * 命令连接只创建一次，每次执行读到同一个 data 缓存区，适合周期性读取传感器
+ */
+esp_err_t i2c_bus_prepare_read(i2c_bus_dev_handle_t dev, uint16_t reg_addr, uint8_t *data, size_t data_len,
+                               i2c_bus_txn_handle_t *txn);
+
+/**
+ * @brief  执行预先创建的事务
+ */
+esp_err_t i2c_bus_execute(i2c_bus_txn_handle_t txn);
+
+/**
+ * @brief  释放预先创建的事务
+ */
+void i2c_bus_release(i2c_bus_txn_handle_t txn);
+
+/**
+ * @brief  测量设备实际的 SCL 频率，软件 IIC 设备同时按测量结果修正高低电平时间
+ *
+ * 软件 IIC：在空闲总线上输出一串时钟 (没有起始条件，从机忽略)，用 CCOUNT 计时；
+ * SDK 驱动：发送一次只有从机地址的写传输，按 10 个时钟 (含起止条件) 估算，包含驱动本身的开销
+ */
+esp_err_t i2c_bus_calibrate(i2c_bus_dev_handle_t dev, i2c_bus_calib_t *calib);
+
+/**
+ * @brief  扫描总线
+ *
+ * 每个地址只发送 START | ADDR+W | STOP，引脚支持时使用 400kHz 软件 IIC，
+ * 每个地址约 30us，全部 112 个地址约 4ms
+ *
+ * @param  found  位图，地址 addr 对应 found[addr >> 3] 的第 (addr & 7) 位
+ */
+esp_err_t i2c_bus_scan(uint8_t found[I2C_BUS_SCAN_BYTES]);
+
+/**
+ * @brief  扫描结果中是否有该地址
+ */
+static inline bool i2c_bus_scan_has(const uint8_t found[I2C_BUS_SCAN_BYTES], uint8_t addr)
+{
+    return 0 != (found[addr >> 3] & (1 << (addr & 0x07)));
+}
+
+/**
+ * @brief  按地址读寄存器，不需要注册设备，用于识别设备
+ */
+esp_err_t i2c_bus_read_addr(uint8_t addr, uint8_t reg_addr_len, uint16_t reg_addr, uint8_t *data, size_t data_len);
+
+/**
+ * @brief  读取设备统计
+ */
+esp_err_t i2c_bus_get_stats(i2c_bus_dev_handle_t dev, i2c_bus_dev_stats_t *stats);
+
+/**
+ * @brief  清零设备统计
+ */
+void i2c_bus_reset_stats(i2c_bus_dev_handle_t dev);
+
+/**
+ * @brief  设备名
+ */
+const char *i2c_bus_dev_name(i2c_bus_dev_handle_t dev);
+
+/**
+ * @brief  读取命令连接缓存统计，只统计 SDK 驱动设备的读写请求
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_STATE (没有配置缓存)
+ */
+esp_err_t i2c_bus_get_cache_stats(i2c_bus_cache_stats_t *stats);
+
+/**
+ * @brief  总线任务句柄，用于监测栈使用量，总线未初始化时为 NULL
+ */
+TaskHandle_t i2c_bus_task_handle(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _I2C_BUS_H_ */
@@ -0,0 +1,7 @@
+#
+# i2c_discover 组件
+#
+# 启动时扫描 IIC 总线，按特征寄存器识别 MPU6050、DS3231、AT24C32，并注册到 i2c_bus
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
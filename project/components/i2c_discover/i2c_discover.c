@@ -0,0 +1,154 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "ccount.h"
+#include "mpu6050.h"
+#include "ds3231.h"
+#include "at24c32.h"
+#include "i2c_discover.h"
+
+static const char *TAG = "i2c_discover";
+
+#define AT24C32_ADDR_MAX            (AT24C32_ADDR + 7)
+
+/* 合法的 BCD 码，高位不超过 high_max */
+static bool i2c_discover_is_bcd(uint8_t value, uint8_t high_max)
+{
+    return (value & 0x0F) <= 9 && (value >> 4) <= high_max;
+}
+
+static bool i2c_discover_is_mpu6050(uint8_t addr)
+{
+    uint8_t who_am_i = 0;
+
+    if(MPU6050_ADDR != addr && MPU6050_ADDR_AD0_HIGH != addr)
+    {
+        return false;
+    }
+
+    return ESP_OK == i2c_bus_read_addr(addr, 1, MPU6050_WHO_AM_I, &who_am_i, 1)
+           && MPU6050_WHO_AM_I_VAL == who_am_i;
+}
+
+static bool i2c_discover_is_ds3231(uint8_t addr)
+{
+    uint8_t regs[DS3231_REG_NUM];
+
+    if(DS3231_ADDR != addr || ESP_OK != i2c_bus_read_addr(addr, 1, DS3231_REG_SEC, regs, DS3231_REG_NUM))
+    {
+        return false;
+    }
+
+    return 0 == (regs[DS3231_REG_CTRL_STATUS] & 0x70)
+           && 0 == (regs[DS3231_REG_TEMP_LSB] & 0x3F)
+           && i2c_discover_is_bcd(regs[DS3231_REG_SEC], 5)
+           && i2c_discover_is_bcd(regs[DS3231_REG_MIN], 5);
+}
+
+/**
+ * EEPROM 没有特征寄存器，只按地址范围识别：
+ * 试读需要先写 2 字节存储地址，对 1 字节存储地址的小容量 EEPROM (24C02 等) 来说，
+ * 第 2 个字节会被当作数据写入，所以不做试读
+ */
+static bool i2c_discover_is_at24c32(uint8_t addr)
+{
+    return AT24C32_ADDR <= addr && AT24C32_ADDR_MAX >= addr;
+}
+
+/* 识别并用对应的驱动注册 */
+static void i2c_discover_bind(i2c_discover_dev_t *dev)
+{
+    esp_err_t ret = ESP_OK;
+
+    if(i2c_discover_is_mpu6050(dev->addr))
+    {
+        dev->type = I2C_DISCOVER_MPU6050;
+        ret = mpu6050_add(dev->addr, &dev->dev);
+    }
+    else if(i2c_discover_is_ds3231(dev->addr))
+    {
+        dev->type = I2C_DISCOVER_DS3231;
+        ret = ds3231_add(&dev->dev);
+    }
+    else if(i2c_discover_is_at24c32(dev->addr))
+    {
+        dev->type = I2C_DISCOVER_AT24C32;
+        ret = at24c32_add(dev->addr, &dev->dev);
+    }
+
+    if(ESP_OK != ret)
+    {
+        ESP_LOGE(TAG, "0x%02x %s: add failed: %d", dev->addr, i2c_discover_type_name(dev->type), ret);
+        dev->dev = NULL;
+    }
+}
+
+esp_err_t i2c_discover(i2c_discover_result_t *result)
+{
+    uint8_t found[I2C_BUS_SCAN_BYTES];
+    esp_err_t ret = ESP_OK;
+    uint32_t start = 0;
+    int addr = 0;
+
+    if(NULL == result)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(result, 0, sizeof(i2c_discover_result_t));
+
+    start = ccount_get();
+    ret = i2c_bus_scan(found);
+    result->scan_us = ccount_elapsed_us(start);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    for(addr = I2C_BUS_ADDR_MIN; addr <= I2C_BUS_ADDR_MAX && I2C_DISCOVER_MAX > result->num; ++addr)
+    {
+        if(i2c_bus_scan_has(found, addr))
+        {
+            result->dev[result->num].addr = addr;
+            i2c_discover_bind(&result->dev[result->num]);
+            ESP_LOGI(TAG, "0x%02x: %s", addr, i2c_discover_type_name(result->dev[result->num].type));
+            ++result->num;
+        }
+    }
+    result->total_us = ccount_elapsed_us(start);
+
+    return ESP_OK;
+}
+
+i2c_bus_dev_handle_t i2c_discover_find(const i2c_discover_result_t *result, i2c_discover_type_t type)
+{
+    int i = 0;
+
+    for(i = 0; NULL != result && i < result->num; ++i)
+    {
+        if(type == result->dev[i].type && NULL != result->dev[i].dev)
+        {
+            return result->dev[i].dev;
+        }
+    }
+
+    return NULL;
+}
+
+const char *i2c_discover_type_name(i2c_discover_type_t type)
+{
+    switch(type)
+    {
+        case I2C_DISCOVER_MPU6050:
+            return "mpu6050";
+        case I2C_DISCOVER_DS3231:
+            return "ds3231";
+        case I2C_DISCOVER_AT24C32:
+            return "at24c32";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * IIC 设备自动发现
+ *
+ * MPU6050 与 DS3231 默认地址都是 0x68，AT24C32 的地址由 A0 ~ A2 引脚决定，不同模块各不相同。
+ * 启动时扫描总线，按特征识别已知设备，再用各自的驱动注册到 i2c_bus，应用不需要写死地址：
+ * - MPU6050 (0x68/0x69)：WHO_AM_I (0x75) 固定为 0x68
+ * - DS3231 (0x68)：状态寄存器 bit6 ~ bit4 与温度低字节 bit5 ~ bit0 恒为 0，秒、分为合法的 BCD 码
+ * - AT24C32 (0x50 ~ 0x57)：EEPROM 没有特征寄存器，在该地址范围内有应答即认为是 AT24C32
+ */
+#ifndef _I2C_DISCOVER_H_
+#define _I2C_DISCOVER_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_DISCOVER_MAX            (8)
+
+typedef enum {
+    I2C_DISCOVER_UNKNOWN = 0,       /*!< 有应答，但不是已知设备 */
+    I2C_DISCOVER_MPU6050,
+    I2C_DISCOVER_DS3231,
+    I2C_DISCOVER_AT24C32,
+} i2c_discover_type_t;
+
+typedef struct {
+    uint8_t addr;
+    i2c_discover_type_t type;
+    i2c_bus_dev_handle_t dev;       /*!< 已知设备注册后的句柄，未知设备为 NULL */
+} i2c_discover_dev_t;
+
+typedef struct {
+    uint8_t num;
+    i2c_discover_dev_t dev[I2C_DISCOVER_MAX];
+    uint32_t scan_us;               /*!< 扫描用时 */
+    uint32_t total_us;              /*!< 扫描、识别、注册总用时 */
+} i2c_discover_result_t;
+
+/**
+ * @brief  扫描总线，识别并注册已知设备
+ *
+ * 只注册设备，不执行设备初始化 (mpu6050_init() 等)
+ */
+esp_err_t i2c_discover(i2c_discover_result_t *result);
+
+/**
+ * @brief  查找第一个该类型的设备
+ *
+ * @return 设备句柄，没有找到返回 NULL
+ */
+i2c_bus_dev_handle_t i2c_discover_find(const i2c_discover_result_t *result, i2c_discover_type_t type);
+
+/**
+ * @brief  设备类型名
+ */
+const char *i2c_discover_type_name(i2c_discover_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _I2C_DISCOVER_H_ */
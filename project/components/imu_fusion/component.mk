@@ -0,0 +1,7 @@
+#
+# imu_fusion 组件
+#
+# 定点数姿态解算：互补滤波、Mahony、Madgwick，输出四元数与横滚/俯仰/航向角
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
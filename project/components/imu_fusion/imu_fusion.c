@@ -0,0 +1,505 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "int_math.h"
+#include "imu_fusion.h"
+
+#define IMU_FUSION_CORDIC_ITER      (30)
+/* CORDIC 增益的倒数 0.6072529...，Q30 */
+#define IMU_FUSION_CORDIC_K         (652032874)
+/* 二进制角的 90° */
+#define IMU_FUSION_ANGLE_90         (0x40000000L)
+/* 每弧度的二进制角 2^32 / 2π，Q30 乘数 */
+#define IMU_FUSION_RAD_TO_ANGLE     (683565276)
+#define IMU_FUSION_Q30_HALF         (1L << 29)
+/* 四元数模长偏离 1 小于此值时用级数近似 1/sqrt(x)，否则做除法 */
+#define IMU_FUSION_NORM_FAST        (1L << 20)
+
+/* atan(2^-i)，二进制角 */
+static const int32_t s_atan_table[IMU_FUSION_CORDIC_ITER] = {
+    536870912, 316933406, 167458907, 85004756, 42667331, 21354465, 10679838, 5340245,
+    2670163, 1335087, 667544, 333772, 166886, 83443, 41722, 20861,
+    10430, 5215, 2608, 1304, 652, 326, 163, 81,
+    41, 20, 10, 5, 3, 1,
+};
+
+static inline int32_t mul_q30(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b + IMU_FUSION_Q30_HALF) >> 30);
+}
+
+/* CORDIC 向量模式，先把向量转到右半平面，再把模长缩放到 [2^28, 2^29) 防止溢出 */
+static int32_t imu_fusion_atan2_64(int64_t y, int64_t x)
+{
+    uint32_t angle = 0;
+    int64_t t = 0;
+    int64_t m = 0;
+    int32_t x32 = 0;
+    int32_t y32 = 0;
+    int32_t xn = 0;
+    int i = 0;
+
+    if(0 == x && 0 == y)
+    {
+        return 0;
+    }
+
+    if(0 > x)
+    {
+        t = x;
+        if(0 <= y)
+        {
+            angle = IMU_FUSION_ANGLE_90;
+            x = y;
+            y = -t;
+        }
+        else
+        {
+            angle = (uint32_t)-IMU_FUSION_ANGLE_90;
+            x = -y;
+            y = t;
+        }
+    }
+
+    m = (x > (0 > y ? -y : y)) ? x : (0 > y ? -y : y);
+    while((1LL << 29) <= m)
+    {
+        x >>= 1;
+        y >>= 1;
+        m >>= 1;
+    }
+    while((1LL << 28) > m)
+    {
+        x <<= 1;
+        y <<= 1;
+        m <<= 1;
+    }
+    x32 = (int32_t)x;
+    y32 = (int32_t)y;
+
+    for(i = 0; i < IMU_FUSION_CORDIC_ITER; ++i)
+    {
+        if(0 < y32)
+        {
+            xn = x32 + (y32 >> i);
+            y32 -= x32 >> i;
+            angle += s_atan_table[i];
+        }
+        else
+        {
+            xn = x32 - (y32 >> i);
+            y32 += x32 >> i;
+            angle -= s_atan_table[i];
+        }
+        x32 = xn;
+    }
+
+    return (int32_t)angle;
+}
+
+int32_t imu_fusion_atan2(int32_t y, int32_t x)
+{
+    return imu_fusion_atan2_64(y, x);
+}
+
+/* CORDIC 旋转模式，先把角度转到 [-90°, 90°] */
+void imu_fusion_cos_sin(int32_t angle, int32_t *cos_out, int32_t *sin_out)
+{
+    int32_t x = IMU_FUSION_CORDIC_K;
+    int32_t y = 0;
+    int32_t z = angle;
+    int32_t xn = 0;
+    bool negate = false;
+    int i = 0;
+
+    if(IMU_FUSION_ANGLE_90 < z || -IMU_FUSION_ANGLE_90 > z)
+    {
+        z = (int32_t)((uint32_t)z + 0x80000000UL);
+        negate = true;
+    }
+
+    for(i = 0; i < IMU_FUSION_CORDIC_ITER; ++i)
+    {
+        if(0 <= z)
+        {
+            xn = x - (y >> i);
+            y += x >> i;
+            z -= s_atan_table[i];
+        }
+        else
+        {
+            xn = x + (y >> i);
+            y -= x >> i;
+            z += s_atan_table[i];
+        }
+        x = xn;
+    }
+
+    *cos_out = negate ? -x : x;
+    *sin_out = negate ? -y : y;
+}
+
+/* 加速度归一化为 Q30 单位向量，一次 64 位除法 */
+static bool imu_fusion_unit(const int16_t v[3], int32_t out[3])
+{
+    uint32_t n2 = (uint32_t)((int32_t)v[0] * v[0]) + (uint32_t)((int32_t)v[1] * v[1])
+                  + (uint32_t)((int32_t)v[2] * v[2]);
+    uint64_t inv = 0;
+    int i = 0;
+
+    if(0 == n2)
+    {
+        return false;
+    }
+
+    inv = ((uint64_t)1 << 46) / int_math_isqrt64(n2);
+    for(i = 0; i < 3; ++i)
+    {
+        out[i] = (int32_t)(((int64_t)v[i] * (int64_t)inv) >> 16);
+    }
+
+    return true;
+}
+
+static void imu_fusion_normalize(int32_t q[4])
+{
+    int64_t n2 = 0;
+    int32_t e = 0;
+    int32_t inv = 0;
+    uint32_t norm = 0;
+    int i = 0;
+
+    for(i = 0; i < 4; ++i)
+    {
+        n2 += ((int64_t)q[i] * q[i]) >> 30;
+    }
+    if(0 >= n2)
+    {
+        q[0] = IMU_FUSION_Q30_ONE;
+        q[1] = q[2] = q[3] = 0;
+        return;
+    }
+
+    e = (int32_t)(n2 - IMU_FUSION_Q30_ONE);
+    if(IMU_FUSION_NORM_FAST > e && -IMU_FUSION_NORM_FAST < e)
+    {
+        // 每个采样都归一化，模长只偏离 1 很少：1/sqrt(1+e) ≈ 1 - e/2 + 3e²/8
+        inv = IMU_FUSION_Q30_ONE - e / 2 + mul_q30(e, e) * 3 / 8;
+        for(i = 0; i < 4; ++i)
+        {
+            q[i] = mul_q30(q[i], inv);
+        }
+        return;
+    }
+
+    norm = int_math_isqrt64((uint64_t)n2 << 30);
+    for(i = 0; i < 4; ++i)
+    {
+        q[i] = (int32_t)(((int64_t)q[i] << 30) / norm);
+    }
+}
+
+static void imu_fusion_from_euler(const int32_t euler[3], int32_t q[4])
+{
+    int32_t cr = 0;
+    int32_t sr = 0;
+    int32_t cp = 0;
+    int32_t sp = 0;
+    int32_t cy = 0;
+    int32_t sy = 0;
+
+    // 半角：二进制角算术右移 1 位
+    imu_fusion_cos_sin(euler[0] >> 1, &cr, &sr);
+    imu_fusion_cos_sin(euler[1] >> 1, &cp, &sp);
+    imu_fusion_cos_sin(euler[2] >> 1, &cy, &sy);
+
+    q[0] = mul_q30(mul_q30(cr, cp), cy) + mul_q30(mul_q30(sr, sp), sy);
+    q[1] = mul_q30(mul_q30(sr, cp), cy) - mul_q30(mul_q30(cr, sp), sy);
+    q[2] = mul_q30(mul_q30(cr, sp), cy) + mul_q30(mul_q30(sr, cp), sy);
+    q[3] = mul_q30(mul_q30(cr, cp), sy) - mul_q30(mul_q30(sr, sp), cy);
+}
+
+/* 由加速度确定横滚/俯仰角 */
+static void imu_fusion_accel_angles(const int16_t accel[3], int32_t *roll, int32_t *pitch)
+{
+    int32_t ay = accel[1];
+    int32_t az = accel[2];
+
+    *roll = imu_fusion_atan2(ay, az);
+    *pitch = imu_fusion_atan2(-(int32_t)accel[0], (int32_t)int_math_isqrt64((uint64_t)(ay * ay) + (uint64_t)(az * az)));
+}
+
+static void imu_fusion_complementary(imu_fusion_t *fusion, const int16_t accel[3], const int32_t g[3], bool valid)
+{
+    int32_t acc[2];
+    int64_t k = ((int64_t)fusion->gain * fusion->dt) >> 16;
+    int i = 0;
+
+    // gain * dt 超过 1 时完全采用加速度算出的角度
+    if(IMU_FUSION_Q30_ONE < k)
+    {
+        k = IMU_FUSION_Q30_ONE;
+    }
+
+    // 机体角速度直接积分为欧拉角
+    for(i = 0; i < 3; ++i)
+    {
+        fusion->euler[i] = (int32_t)((uint32_t)fusion->euler[i]
+                                     + mul_q30((int32_t)(((int64_t)g[i] * fusion->dt) >> 24), IMU_FUSION_RAD_TO_ANGLE));
+    }
+
+    if(valid)
+    {
+        // 向加速度算出的角度修正，差值按二进制角回绕
+        imu_fusion_accel_angles(accel, &acc[0], &acc[1]);
+        for(i = 0; i < 2; ++i)
+        {
+            fusion->euler[i] = (int32_t)((uint32_t)fusion->euler[i]
+                                         + mul_q30((int32_t)((uint32_t)acc[i] - (uint32_t)fusion->euler[i]), (int32_t)k));
+        }
+    }
+
+    imu_fusion_from_euler(fusion->euler, fusion->q);
+}
+
+static void imu_fusion_mahony(imu_fusion_t *fusion, const int32_t a[3], int32_t g[3], bool valid)
+{
+    int32_t *q = fusion->q;
+    int32_t v[3];
+    int32_t e[3];
+    int32_t h[3];
+    int32_t qa = 0;
+    int32_t qb = 0;
+    int32_t qc = 0;
+    int32_t t = 0;
+    int i = 0;
+
+    if(valid)
+    {
+        // 估计的重力方向的一半，与测量的重力方向的叉积为误差
+        v[0] = mul_q30(q[1], q[3]) - mul_q30(q[0], q[2]);
+        v[1] = mul_q30(q[0], q[1]) + mul_q30(q[2], q[3]);
+        v[2] = mul_q30(q[0], q[0]) - IMU_FUSION_Q30_HALF + mul_q30(q[3], q[3]);
+        e[0] = mul_q30(a[1], v[2]) - mul_q30(a[2], v[1]);
+        e[1] = mul_q30(a[2], v[0]) - mul_q30(a[0], v[2]);
+        e[2] = mul_q30(a[0], v[1]) - mul_q30(a[1], v[0]);
+
+        for(i = 0; i < 3; ++i)
+        {
+            if(0 < fusion->gain_i)
+            {
+                t = (int32_t)(((int64_t)e[i] * fusion->gain_i) >> 22);
+                fusion->integral[i] += (int32_t)(((int64_t)t * fusion->dt) >> 30);
+                g[i] += fusion->integral[i];
+            }
+            g[i] += (int32_t)(((int64_t)e[i] * fusion->gain) >> 22);
+        }
+    }
+
+    // q += 0.5 * q ⊗ (0, g) * dt
+    for(i = 0; i < 3; ++i)
+    {
+        h[i] = (int32_t)(((int64_t)g[i] * (fusion->dt >> 1)) >> 24);
+    }
+    qa = q[0];
+    qb = q[1];
+    qc = q[2];
+    q[0] += -mul_q30(qb, h[0]) - mul_q30(qc, h[1]) - mul_q30(q[3], h[2]);
+    q[1] += mul_q30(qa, h[0]) + mul_q30(qc, h[2]) - mul_q30(q[3], h[1]);
+    q[2] += mul_q30(qa, h[1]) - mul_q30(qb, h[2]) + mul_q30(q[3], h[0]);
+    q[3] += mul_q30(qa, h[2]) + mul_q30(qb, h[1]) - mul_q30(qc, h[0]);
+
+    imu_fusion_normalize(q);
+}
+
+static inline int64_t mul_q30_64(int32_t a, int32_t b)
+{
+    return ((int64_t)a * b + IMU_FUSION_Q30_HALF) >> 30;
+}
+
+static void imu_fusion_madgwick(imu_fusion_t *fusion, const int32_t a[3], const int32_t g[3], bool valid)
+{
+    int32_t *q = fusion->q;
+    int32_t qd[4];
+    int64_t s[4];
+    int64_t m = 0;
+    int32_t s32[4];
+    int shift = 0;
+    int32_t q0q0 = 0;
+    int32_t q1q1 = 0;
+    int32_t q2q2 = 0;
+    int32_t q3q3 = 0;
+    uint64_t n2 = 0;
+    uint32_t norm = 0;
+    int i = 0;
+
+    // 角速度引起的四元数变化率 0.5 * q ⊗ (0, g)，Q24
+    qd[0] = (-mul_q30(q[1], g[0]) - mul_q30(q[2], g[1]) - mul_q30(q[3], g[2])) / 2;
+    qd[1] = (mul_q30(q[0], g[0]) + mul_q30(q[2], g[2]) - mul_q30(q[3], g[1])) / 2;
+    qd[2] = (mul_q30(q[0], g[1]) - mul_q30(q[1], g[2]) + mul_q30(q[3], g[0])) / 2;
+    qd[3] = (mul_q30(q[0], g[2]) + mul_q30(q[1], g[1]) - mul_q30(q[2], g[0])) / 2;
+
+    if(valid)
+    {
+        // 重力误差函数的梯度，最大约为 20，用 64 位 Q30 累加
+        q0q0 = mul_q30(q[0], q[0]);
+        q1q1 = mul_q30(q[1], q[1]);
+        q2q2 = mul_q30(q[2], q[2]);
+        q3q3 = mul_q30(q[3], q[3]);
+        s[0] = 4 * mul_q30_64(q[0], q2q2) + 2 * mul_q30_64(q[2], a[0]) + 4 * mul_q30_64(q[0], q1q1)
+               - 2 * mul_q30_64(q[1], a[1]);
+        s[1] = 4 * mul_q30_64(q[1], q3q3) - 2 * mul_q30_64(q[3], a[0]) + 4 * mul_q30_64(q0q0, q[1])
+               - 2 * mul_q30_64(q[0], a[1]) - 4 * (int64_t)q[1] + 8 * mul_q30_64(q[1], q1q1)
+               + 8 * mul_q30_64(q[1], q2q2) + 4 * mul_q30_64(q[1], a[2]);
+        s[2] = 4 * mul_q30_64(q0q0, q[2]) + 2 * mul_q30_64(q[0], a[0]) + 4 * mul_q30_64(q[2], q3q3)
+               - 2 * mul_q30_64(q[3], a[1]) - 4 * (int64_t)q[2] + 8 * mul_q30_64(q[2], q1q1)
+               + 8 * mul_q30_64(q[2], q2q2) + 4 * mul_q30_64(q[2], a[2]);
+        s[3] = 4 * mul_q30_64(q1q1, q[3]) - 2 * mul_q30_64(q[1], a[0]) + 4 * mul_q30_64(q2q2, q[3])
+               - 2 * mul_q30_64(q[2], a[1]);
+
+        // 收敛后梯度很小，按最大分量缩放到 [2^28, 2^29) 再归一化，保持方向的精度
+        m = 0;
+        for(i = 0; i < 4; ++i)
+        {
+            m |= (0 > s[i]) ? -s[i] : s[i];
+        }
+        if(0 != m)
+        {
+            while((1LL << 29) <= m)
+            {
+                m >>= 1;
+                shift--;
+            }
+            while((1LL << 28) > m)
+            {
+                m <<= 1;
+                shift++;
+            }
+            for(i = 0; i < 4; ++i)
+            {
+                s32[i] = (int32_t)((0 <= shift) ? s[i] << shift : s[i] >> -shift);
+                n2 += (uint64_t)((int64_t)s32[i] * s32[i]);
+            }
+            norm = int_math_isqrt64(n2);
+            for(i = 0; i < 4; ++i)
+            {
+                qd[i] -= (int32_t)(((((int64_t)s32[i] << 30) / norm) * fusion->gain) >> 22);
+            }
+        }
+    }
+
+    for(i = 0; i < 4; ++i)
+    {
+        q[i] += (int32_t)(((int64_t)qd[i] * fusion->dt) >> 24);
+    }
+
+    imu_fusion_normalize(q);
+}
+
+esp_err_t imu_fusion_init(imu_fusion_t *fusion, const imu_fusion_config_t *config)
+{
+    if(NULL == fusion || NULL == config || 0 == config->sample_hz || 0 >= config->gyro_scale
+       || IMU_FUSION_MADGWICK < config->algo || 0 > config->gain || 0 > config->gain_i)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(fusion, 0, sizeof(imu_fusion_t));
+    fusion->algo = config->algo;
+    fusion->dt = (int32_t)((IMU_FUSION_Q30_ONE + config->sample_hz / 2) / config->sample_hz);
+    fusion->gyro_scale = config->gyro_scale;
+    fusion->gain = config->gain;
+    fusion->gain_i = config->gain_i;
+    imu_fusion_reset(fusion);
+
+    return ESP_OK;
+}
+
+void imu_fusion_reset(imu_fusion_t *fusion)
+{
+    fusion->started = false;
+    fusion->q[0] = IMU_FUSION_Q30_ONE;
+    fusion->q[1] = fusion->q[2] = fusion->q[3] = 0;
+    memset(fusion->integral, 0, sizeof(fusion->integral));
+    memset(fusion->euler, 0, sizeof(fusion->euler));
+}
+
+void imu_fusion_update(imu_fusion_t *fusion, const int16_t accel[3], const int16_t gyro[3])
+{
+    int32_t a[3];
+    int32_t g[3];
+    bool valid = imu_fusion_unit(accel, a);
+    int i = 0;
+
+    // 第一个采样：横滚/俯仰角取加速度的方向
+    if(!fusion->started)
+    {
+        if(valid)
+        {
+            imu_fusion_accel_angles(accel, &fusion->euler[0], &fusion->euler[1]);
+            fusion->euler[2] = 0;
+            imu_fusion_from_euler(fusion->euler, fusion->q);
+            fusion->started = true;
+        }
+        return;
+    }
+
+    // 原始值 -> Q24 rad/s
+    for(i = 0; i < 3; ++i)
+    {
+        g[i] = (int32_t)(((int64_t)gyro[i] * fusion->gyro_scale) >> 6);
+    }
+
+    switch(fusion->algo)
+    {
+        case IMU_FUSION_COMPLEMENTARY:
+            imu_fusion_complementary(fusion, accel, g, valid);
+            break;
+        case IMU_FUSION_MAHONY:
+            imu_fusion_mahony(fusion, a, g, valid);
+            break;
+        case IMU_FUSION_MADGWICK:
+            imu_fusion_madgwick(fusion, a, g, valid);
+            break;
+    }
+}
+
+void imu_fusion_get(const imu_fusion_t *fusion, imu_fusion_attitude_t *attitude)
+{
+    const int32_t *q = fusion->q;
+    int64_t sinp = 0;
+    int32_t roll = 0;
+    int32_t pitch = 0;
+    int32_t yaw = 0;
+
+    memcpy(attitude->q, q, sizeof(attitude->q));
+
+    if(IMU_FUSION_COMPLEMENTARY == fusion->algo)
+    {
+        roll = fusion->euler[0];
+        pitch = fusion->euler[1];
+        yaw = fusion->euler[2];
+    }
+    else
+    {
+        // 64 位 Q60 累加后转为 Q30 (乘 2 合并在移位中)
+        roll = imu_fusion_atan2_64(((int64_t)q[0] * q[1] + (int64_t)q[2] * q[3]) >> 29,
+                                   IMU_FUSION_Q30_ONE - (((int64_t)q[1] * q[1] + (int64_t)q[2] * q[2]) >> 29));
+        sinp = ((int64_t)q[0] * q[2] - (int64_t)q[3] * q[1]) >> 29;
+        if(IMU_FUSION_Q30_ONE < sinp)
+        {
+            sinp = IMU_FUSION_Q30_ONE;
+        }
+        else if(-IMU_FUSION_Q30_ONE > sinp)
+        {
+            sinp = -IMU_FUSION_Q30_ONE;
+        }
+        pitch = imu_fusion_atan2_64(sinp, int_math_isqrt64(((uint64_t)1 << 60) - (uint64_t)(sinp * sinp)));
+        yaw = imu_fusion_atan2_64(((int64_t)q[0] * q[3] + (int64_t)q[1] * q[2]) >> 29,
+                                  IMU_FUSION_Q30_ONE - (((int64_t)q[2] * q[2] + (int64_t)q[3] * q[3]) >> 29));
+    }
+
+    attitude->roll = IMU_FUSION_ANGLE_TO_CENTIDEG(roll);
+    attitude->pitch = IMU_FUSION_ANGLE_TO_CENTIDEG(pitch);
+    attitude->yaw = IMU_FUSION_ANGLE_TO_CENTIDEG(yaw);
+}
@@ -0,0 +1,130 @@
+/**
+ * 定点数姿态解算
+ *
+ * ESP8266 没有浮点单元，软件浮点一次乘法约需上百个周期。本组件全部用整数运算：
+ * - 四元数与单位向量为 Q30 (1.0 = 2^30)，角速度为 Q24 rad/s，增益为 Q16
+ * - 角度为 32 位二进制角 (2^32 = 360°)，回绕自然处理；三角函数用 CORDIC 计算
+ * - 乘法结果用 64 位中间值，除法只在加速度 (与 Madgwick 的梯度) 归一化时使用
+ *
+ * 输入为 MPU6050 一次突发读取解码后的加速度与角速度原始值，每个采样调用一次 imu_fusion_update()，
+ * 采样间隔由 sample_hz 决定。第一个采样按加速度确定初始横滚/俯仰角，航向角从 0 开始。
+ *
+ * 算法：
+ * - IMU_FUSION_COMPLEMENTARY：欧拉角互补滤波，角速度积分后按 gain (1/s) 向加速度算出的横滚/俯仰角修正，
+ *   直接把机体角速度当作欧拉角速度，只适合倾角较小的场合，计算量最小
+ * - IMU_FUSION_MAHONY：四元数积分，加速度方向与估计的重力方向的叉积作为误差，
+ *   gain 为比例增益 2Kp (1/s)，gain_i 为积分增益 2Ki (1/s^2)，积分项可以补偿陀螺仪零偏
+ * - IMU_FUSION_MADGWICK：四元数积分，按重力误差函数的梯度方向修正，gain 为 beta (rad/s)
+ *
+ * 只有加速度计，航向角不能修正，会随陀螺仪零偏漂移。
+ * 目标板上每个采样的周期数见 bench 实例的 imu_fusion_* 用例，与浮点参考实现的误差用 tools/imu_fusion_sim 检查。
+ */
+#ifndef _IMU_FUSION_H_
+#define _IMU_FUSION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IMU_FUSION_Q30_ONE          (1L << 30)
+
+/* 增益 -> Q16，编译期计算 */
+#define IMU_FUSION_Q16(x)           ((int32_t)((x) * 65536.0 + 0.5))
+/* 陀螺仪灵敏度 (LSB/(°/s)) -> 每 LSB 的角速度 (Q30 rad/s)，编译期计算 */
+#define IMU_FUSION_GYRO_SCALE(lsb_per_dps)  ((int32_t)(3.14159265358979 / 180.0 / (lsb_per_dps) * 1073741824.0 + 0.5))
+
+/* 二进制角 -> 0.01° (四舍五入) */
+#define IMU_FUSION_ANGLE_TO_CENTIDEG(a)     ((int32_t)(((int64_t)(a) * 36000 + (1LL << 31)) >> 32))
+
+typedef enum {
+    IMU_FUSION_COMPLEMENTARY = 0,
+    IMU_FUSION_MAHONY,
+    IMU_FUSION_MADGWICK,
+} imu_fusion_algo_t;
+
+typedef struct {
+    imu_fusion_algo_t algo;
+    uint16_t sample_hz;             /*!< 采样率 */
+    int32_t gyro_scale;             /*!< IMU_FUSION_GYRO_SCALE(陀螺仪灵敏度) */
+    int32_t gain;                   /*!< 互补滤波修正速率 / Mahony 2Kp / Madgwick beta，Q16 */
+    int32_t gain_i;                 /*!< Mahony 2Ki，Q16，其它算法不使用 */
+} imu_fusion_config_t;
+
+/* 各算法常用的增益 */
+#define IMU_FUSION_DEFAULT_GAIN(algo)                                       \
+    ((IMU_FUSION_MADGWICK == (algo)) ? IMU_FUSION_Q16(0.1)                  \
+     : ((IMU_FUSION_MAHONY == (algo)) ? IMU_FUSION_Q16(1.0) : IMU_FUSION_Q16(2.0)))
+
+/* 默认陀螺仪灵敏度为 MPU6050 +/-2000dps 量程 (mpu6050_init() 的设置) */
+#define IMU_FUSION_DEFAULT_CONFIG(a) {                                      \
+    .algo = (a),                                                            \
+    .sample_hz = 100,                                                       \
+    .gyro_scale = IMU_FUSION_GYRO_SCALE(16.4),                              \
+    .gain = IMU_FUSION_DEFAULT_GAIN(a),                                     \
+    .gain_i = 0,                                                            \
+}
+
+typedef struct {
+    int32_t q[4];                   /*!< 四元数 w x y z (机体 -> 参考系)，Q30 */
+    int32_t roll;                   /*!< 横滚角，0.01° */
+    int32_t pitch;                  /*!< 俯仰角，0.01° */
+    int32_t yaw;                    /*!< 航向角，0.01° */
+} imu_fusion_attitude_t;
+
+typedef struct {
+    imu_fusion_algo_t algo;
+    int32_t dt;                     /*!< 采样间隔，Q30 s */
+    int32_t gyro_scale;
+    int32_t gain;
+    int32_t gain_i;
+    bool started;                   /*!< 已用第一个采样初始化 */
+    int32_t q[4];                   /*!< Q30 */
+    int32_t integral[3];            /*!< Mahony 积分项，Q24 rad/s */
+    int32_t euler[3];               /*!< 互补滤波的横滚/俯仰/航向角，二进制角 */
+} imu_fusion_t;
+
+/**
+ * @brief  初始化
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t imu_fusion_init(imu_fusion_t *fusion, const imu_fusion_config_t *config);
+
+/**
+ * @brief  恢复到初始状态，下一个采样重新确定初始姿态
+ */
+void imu_fusion_reset(imu_fusion_t *fusion);
+
+/**
+ * @brief  输入一个采样
+ *
+ * @param  accel  加速度原始值 x/y/z，只用方向，与量程无关；全为 0 时只做角速度积分
+ * @param  gyro   角速度原始值 x/y/z
+ */
+void imu_fusion_update(imu_fusion_t *fusion, const int16_t accel[3], const int16_t gyro[3]);
+
+/**
+ * @brief  读取姿态：四元数与欧拉角 (ZYX 顺序：先航向，再俯仰，再横滚)
+ */
+void imu_fusion_get(const imu_fusion_t *fusion, imu_fusion_attitude_t *attitude);
+
+/**
+ * @brief  atan2(y, x)，返回二进制角，x、y 可以是任意比例的整数
+ */
+int32_t imu_fusion_atan2(int32_t y, int32_t x);
+
+/**
+ * @brief  二进制角的余弦与正弦，Q30
+ */
+void imu_fusion_cos_sin(int32_t angle, int32_t *cos_out, int32_t *sin_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IMU_FUSION_H_ */
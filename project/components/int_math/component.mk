@@ -0,0 +1,7 @@
+#
+# int_math 组件
+#
+# 定点数统计与姿态解算共用的整数运算，只有头文件
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
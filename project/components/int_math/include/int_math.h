@@ -0,0 +1,57 @@
+/**
+ * 整数运算
+ *
+ * stats_window、mpu6050_calib、imu_fusion 共用的四舍五入除法与 64 位整数平方根，
+ * 全部为内联函数，不依赖硬件，可以在主机上运行。
+ */
+#ifndef _INT_MATH_H_
+#define _INT_MATH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  四舍五入的整数除法，den 为正数，结果需要在 int32_t 范围内
+ */
+static inline int32_t int_math_div_round(int64_t num, int64_t den)
+{
+    return (int32_t)((0 > num) ? (num - den / 2) / den : (num + den / 2) / den);
+}
+
+/**
+ * @brief  64 位整数平方根 (向下取整)，逐位试商，32 次迭代，不使用乘除法
+ */
+static inline uint32_t int_math_isqrt64(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while(bit > value)
+    {
+        bit >>= 2;
+    }
+    while(0 != bit)
+    {
+        if(value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INT_MATH_H_ */
@@ -0,0 +1,7 @@
+#
+# led_effect 组件
+#
+# 预计算 LED 亮度曲线查找表 (CIE 1931 / 正弦呼吸)，查找表分辨率由 LED_EFFECT_LUT_BITS 决定
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,102 @@
+/**
+ * LED 效果模块
+ *
+ * 人眼对亮度的感知是非线性的，按占空比线性变化的呼吸灯看起来亮暗不均。
+ * 本模块提供编译期生成的亮度曲线查找表，运行时只按索引查表：
+ * - CIE 1931 亮度曲线：感知亮度 (L*) 线性 -> 占空比
+ * - 呼吸曲线：感知亮度按 sin^2 变化一个完整周期，已叠加 CIE 1931 校正
+ *
+ * 每个通道使用 16 位相位累加器，高 LED_EFFECT_LUT_BITS 位作为查表索引，
+ * 自然溢出即完成循环，各通道的速度和初始相位相互独立。
+ */
+#ifndef _LED_EFFECT_H_
+#define _LED_EFFECT_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 查找表分辨率：2^LED_EFFECT_LUT_BITS 项，可通过 CFLAGS 覆盖，取值 5 ~ 10 */
+#ifndef LED_EFFECT_LUT_BITS
+#define LED_EFFECT_LUT_BITS         (7)
+#endif
+
+#define LED_EFFECT_LUT_SIZE         (1 << LED_EFFECT_LUT_BITS)
+/* 查找表中的值为 0 ~ LED_EFFECT_LUT_MAX，对应 0% ~ 100% 亮度 */
+#define LED_EFFECT_LUT_MAX          (0xFFFF)
+/* 支持的最大通道数，与 PWM 驱动一致 */
+#define LED_EFFECT_CH_MAX           (8)
+
+typedef enum {
+    LED_CURVE_CIE1931 = 0,          /*!< 亮度斜坡 0 -> 100%，到顶后回到 0 */
+    LED_CURVE_BREATH,               /*!< 呼吸：0 -> 100% -> 0 */
+    LED_CURVE_MAX,
+} led_curve_t;
+
+typedef struct {
+    const uint16_t *lut;            /*!< 当前曲线查找表 */
+    uint16_t acc;                   /*!< 相位累加器 */
+    uint16_t step;                  /*!< 每次 led_effect_step() 累加值 */
+    uint32_t max_duty;              /*!< 100% 亮度对应的占空比 (us) */
+} led_effect_channel_t;
+
+typedef struct {
+    uint8_t channel_num;
+    led_effect_channel_t channel[LED_EFFECT_CH_MAX];
+} led_effect_t;
+
+/* 编译期生成的查找表 */
+extern const uint16_t led_effect_cie1931_lut[LED_EFFECT_LUT_SIZE];
+extern const uint16_t led_effect_breath_lut[LED_EFFECT_LUT_SIZE];
+
+/**
+ * @brief  初始化 LED 效果，所有通道默认为呼吸曲线、相位 0、停止状态
+ *
+ * @param  effect      效果对象
+ * @param  channel_num 通道数，不超过 LED_EFFECT_CH_MAX
+ * @param  max_duty    100% 亮度对应的占空比，一般为 PWM 周期
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t led_effect_init(led_effect_t *effect, uint8_t channel_num, uint32_t max_duty);
+
+/**
+ * @brief  设置通道曲线与速度
+ *
+ * @param  effect     效果对象
+ * @param  channel    通道号
+ * @param  curve      曲线类型
+ * @param  period_ms  曲线完整一周的时长，需大于 tick_ms 且不超过 65536 x tick_ms
+ * @param  tick_ms    调用 led_effect_step() 的间隔，不能为 0
+ * @param  phase      初始相位，0 ~ 65535 对应 0 ~ 360 度
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t led_effect_set_curve(led_effect_t *effect, uint8_t channel, led_curve_t curve,
+                               uint32_t period_ms, uint32_t tick_ms, uint16_t phase);
+
+/**
+ * @brief  感知亮度 -> 占空比，level 取值 0 ~ LED_EFFECT_LUT_SIZE - 1
+ */
+static inline uint32_t led_effect_level_to_duty(uint32_t level, uint32_t max_duty)
+{
+    return ((uint32_t)led_effect_cie1931_lut[level & (LED_EFFECT_LUT_SIZE - 1)] * max_duty + 0x8000) >> 16;
+}
+
+/**
+ * @brief  所有通道前进一步，并把新的占空比写入 duties
+ *
+ * @param  effect  效果对象
+ * @param  duties  占空比输出，至少 channel_num 项
+ */
+void led_effect_step(led_effect_t *effect, uint32_t *duties);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LED_EFFECT_H_ */
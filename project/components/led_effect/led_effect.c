@@ -0,0 +1,122 @@
+#include <stddef.h>
+
+#include "led_effect.h"
+
+/**
+ * 查找表在编译期由常量表达式展开生成，运行时不做任何浮点运算
+ *
+ * CIE 1931: 感知亮度 L* (0 ~ 100) -> 相对亮度 Y (0 ~ 1)
+ *   L* <= 8 : Y = L* / 903.3
+ *   L* >  8 : Y = ((L* + 16) / 116)^3
+ *
+ * 呼吸曲线: L* = 100 * sin^2(pi * x)，x = i / N
+ *   sin(pi * x) 使用 Bhaskara 近似：16x(1-x) / (5 - 4x(1-x))，误差 < 0.2%
+ */
+#define LED_CIE_CUBE(t)             ((t) * (t) * (t))
+#define LED_CIE_Y(l)                ((l) <= 8.0 ? (l) / 903.3 : LED_CIE_CUBE(((l) + 16.0) / 116.0))
+#define LED_LUT_VALUE(y)            ((uint16_t)((y) * LED_EFFECT_LUT_MAX + 0.5))
+
+#define LED_CIE_ENTRY(i)            LED_LUT_VALUE(LED_CIE_Y(100.0 * (i) / (LED_EFFECT_LUT_SIZE - 1)))
+
+#define LED_X(i)                    ((double)(i) / LED_EFFECT_LUT_SIZE)
+#define LED_SIN_PI(x)               (16.0 * (x) * (1.0 - (x)) / (5.0 - 4.0 * (x) * (1.0 - (x))))
+#define LED_BREATH_ENTRY(i)         LED_LUT_VALUE(LED_CIE_Y(100.0 * LED_SIN_PI(LED_X(i)) * LED_SIN_PI(LED_X(i))))
+
+/* 宏展开 2^n 项 */
+#define LED_R2(m, n)                m(n), m((n) + 1)
+#define LED_R4(m, n)                LED_R2(m, n), LED_R2(m, (n) + 2)
+#define LED_R8(m, n)                LED_R4(m, n), LED_R4(m, (n) + 4)
+#define LED_R16(m, n)               LED_R8(m, n), LED_R8(m, (n) + 8)
+#define LED_R32(m, n)               LED_R16(m, n), LED_R16(m, (n) + 16)
+#define LED_R64(m, n)               LED_R32(m, n), LED_R32(m, (n) + 32)
+#define LED_R128(m, n)              LED_R64(m, n), LED_R64(m, (n) + 64)
+#define LED_R256(m, n)              LED_R128(m, n), LED_R128(m, (n) + 128)
+#define LED_R512(m, n)              LED_R256(m, n), LED_R256(m, (n) + 256)
+#define LED_R1024(m, n)             LED_R512(m, n), LED_R512(m, (n) + 512)
+
+#if LED_EFFECT_LUT_BITS == 5
+#define LED_LUT_REPEAT(m)           LED_R32(m, 0)
+#elif LED_EFFECT_LUT_BITS == 6
+#define LED_LUT_REPEAT(m)           LED_R64(m, 0)
+#elif LED_EFFECT_LUT_BITS == 7
+#define LED_LUT_REPEAT(m)           LED_R128(m, 0)
+#elif LED_EFFECT_LUT_BITS == 8
+#define LED_LUT_REPEAT(m)           LED_R256(m, 0)
+#elif LED_EFFECT_LUT_BITS == 9
+#define LED_LUT_REPEAT(m)           LED_R512(m, 0)
+#elif LED_EFFECT_LUT_BITS == 10
+#define LED_LUT_REPEAT(m)           LED_R1024(m, 0)
+#else
+#error "LED_EFFECT_LUT_BITS must be 5 ~ 10"
+#endif
+
+const uint16_t led_effect_cie1931_lut[LED_EFFECT_LUT_SIZE] = { LED_LUT_REPEAT(LED_CIE_ENTRY) };
+const uint16_t led_effect_breath_lut[LED_EFFECT_LUT_SIZE] = { LED_LUT_REPEAT(LED_BREATH_ENTRY) };
+
+static const uint16_t *const s_curve_lut[LED_CURVE_MAX] = {
+    led_effect_cie1931_lut,
+    led_effect_breath_lut,
+};
+
+esp_err_t led_effect_init(led_effect_t *effect, uint8_t channel_num, uint32_t max_duty)
+{
+    uint8_t i = 0;
+
+    // max_duty * LED_EFFECT_LUT_MAX 不能超出 32 位
+    if(NULL == effect || 0 == channel_num || LED_EFFECT_CH_MAX < channel_num || 0xFFFF < max_duty)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    effect->channel_num = channel_num;
+    for(i = 0; i < channel_num; ++i)
+    {
+        effect->channel[i].lut = led_effect_breath_lut;
+        effect->channel[i].acc = 0;
+        effect->channel[i].step = 0;
+        effect->channel[i].max_duty = max_duty;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t led_effect_set_curve(led_effect_t *effect, uint8_t channel, led_curve_t curve,
+                               uint32_t period_ms, uint32_t tick_ms, uint16_t phase)
+{
+    led_effect_channel_t *ch = NULL;
+    uint64_t step = 0;
+
+    // period == tick 时一步为 65536，16 位累加值截断为 0，通道不再变化
+    if(NULL == effect || effect->channel_num <= channel || LED_CURVE_MAX <= curve
+       || 0 == tick_ms || period_ms <= tick_ms)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 一周 65536，每 tick 前进 65536 * tick / period，period > tick 时小于 65536
+    step = ((uint64_t)tick_ms << 16) / period_ms;
+    // 周期超过 65536 个 tick 时一步不足 1，同样不会变化
+    if(0 == step)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ch = &effect->channel[channel];
+    ch->lut = s_curve_lut[curve];
+    ch->acc = phase;
+    ch->step = (uint16_t)step;
+
+    return ESP_OK;
+}
+
+void led_effect_step(led_effect_t *effect, uint32_t *duties)
+{
+    led_effect_channel_t *ch = effect->channel;
+    uint8_t i = 0;
+
+    for(i = 0; i < effect->channel_num; ++i, ++ch)
+    {
+        ch->acc += ch->step;
+        duties[i] = ((uint32_t)ch->lut[ch->acc >> (16 - LED_EFFECT_LUT_BITS)] * ch->max_duty + 0x8000) >> 16;
+    }
+}
@@ -0,0 +1,7 @@
+#
+# mem_pool 组件
+#
+# 固定大小内存块池：初始化时一次分配，O(1) 分配/释放，使用统计
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,66 @@
+/**
+ * 固定大小内存块池
+ *
+ * 创建时一次分配 block_num 个 block_size 字节的块，之后的分配/释放只在空闲链表上操作，
+ * 不调用 malloc()/free()，不产生碎片，耗时固定。
+ * 空闲块的前 4 字节用作链表指针，块大小按 4 字节对齐。
+ *
+ * ESP8266 (LX106) 没有原子比较交换指令，链表操作放在临界区内，临界区只有几条指令。
+ */
+#ifndef _MEM_POOL_H_
+#define _MEM_POOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mem_pool *mem_pool_handle_t;
+
+typedef struct {
+    uint32_t block_size;            /*!< 对齐后的块大小 */
+    uint16_t block_num;             /*!< 块总数 */
+    uint16_t used;                  /*!< 正在使用的块数 */
+    uint16_t peak;                  /*!< 同时使用的最大块数 */
+    uint32_t allocs;                /*!< 成功分配的次数 */
+    uint32_t fails;                 /*!< 池已空导致分配失败的次数 */
+} mem_pool_stats_t;
+
+/**
+ * @brief  创建内存块池
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_NO_MEM
+ */
+esp_err_t mem_pool_create(size_t block_size, uint16_t block_num, mem_pool_handle_t *pool);
+
+/**
+ * @brief  删除内存块池，调用前应释放所有块
+ */
+void mem_pool_delete(mem_pool_handle_t pool);
+
+/**
+ * @brief  分配一块，池已空时返回 NULL
+ */
+void *mem_pool_alloc(mem_pool_handle_t pool);
+
+/**
+ * @brief  释放一块
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG (不是本池的块)
+ */
+esp_err_t mem_pool_free(mem_pool_handle_t pool, void *block);
+
+/**
+ * @brief  读取使用统计
+ */
+void mem_pool_get_stats(mem_pool_handle_t pool, mem_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MEM_POOL_H_ */
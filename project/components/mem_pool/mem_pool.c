@@ -0,0 +1,123 @@
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "mem_pool.h"
+
+#define MEM_POOL_ALIGN              (4)
+
+typedef struct mem_pool_block {
+    struct mem_pool_block *next;
+} mem_pool_block_t;
+
+struct mem_pool {
+    mem_pool_block_t *free_list;
+    uint8_t *storage;               /*!< 紧跟在本结构之后 */
+    uint8_t *storage_end;
+    mem_pool_stats_t stats;
+};
+
+esp_err_t mem_pool_create(size_t block_size, uint16_t block_num, mem_pool_handle_t *pool)
+{
+    struct mem_pool *new_pool = NULL;
+    mem_pool_block_t *block = NULL;
+    size_t size = 0;
+    uint16_t i = 0;
+
+    if(0 == block_size || 0 == block_num || NULL == pool)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(sizeof(mem_pool_block_t) > block_size)
+    {
+        block_size = sizeof(mem_pool_block_t);
+    }
+    size = (block_size + MEM_POOL_ALIGN - 1) & ~(size_t)(MEM_POOL_ALIGN - 1);
+
+    // 池头与全部块一次分配
+    new_pool = malloc(sizeof(struct mem_pool) + size * block_num);
+    if(NULL == new_pool)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(new_pool, 0, sizeof(struct mem_pool));
+    new_pool->storage = (uint8_t *)(new_pool + 1);
+    new_pool->storage_end = new_pool->storage + size * block_num;
+    new_pool->stats.block_size = size;
+    new_pool->stats.block_num = block_num;
+
+    // 按地址从低到高串成空闲链表
+    for(i = block_num; i > 0; --i)
+    {
+        block = (mem_pool_block_t *)(new_pool->storage + size * (i - 1));
+        block->next = new_pool->free_list;
+        new_pool->free_list = block;
+    }
+
+    *pool = new_pool;
+
+    return ESP_OK;
+}
+
+void mem_pool_delete(mem_pool_handle_t pool)
+{
+    free(pool);
+}
+
+void *mem_pool_alloc(mem_pool_handle_t pool)
+{
+    mem_pool_block_t *block = NULL;
+
+    taskENTER_CRITICAL();
+    block = pool->free_list;
+    if(NULL != block)
+    {
+        pool->free_list = block->next;
+        ++pool->stats.allocs;
+        if(++pool->stats.used > pool->stats.peak)
+        {
+            pool->stats.peak = pool->stats.used;
+        }
+    }
+    else
+    {
+        ++pool->stats.fails;
+    }
+    taskEXIT_CRITICAL();
+
+    return block;
+}
+
+esp_err_t mem_pool_free(mem_pool_handle_t pool, void *block)
+{
+    uint8_t *p = block;
+
+    if(NULL == block)
+    {
+        return ESP_OK;
+    }
+    if(p < pool->storage || p >= pool->storage_end || 0 != (p - pool->storage) % pool->stats.block_size)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL();
+    ((mem_pool_block_t *)block)->next = pool->free_list;
+    pool->free_list = block;
+    --pool->stats.used;
+    taskEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+void mem_pool_get_stats(mem_pool_handle_t pool, mem_pool_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = pool->stats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,7 @@
+#
+# mpu6050 组件
+#
+# MPU6050 六轴传感器驱动，基于 i2c_bus 组件
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,174 @@
+/**
+ * MPU6050 六轴传感器驱动
+ *
+ * 通过 i2c_bus 组件访问，可以与同一总线上的其它设备同时使用
+ */
+#ifndef _MPU6050_H_
+#define _MPU6050_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MPU6050_ADDR                0x68             /*!< AD0 接低电平时的地址 */
+#define MPU6050_ADDR_AD0_HIGH       0x69             /*!< AD0 接高电平时的地址 */
+#define MPU6050_WHO_AM_I_VAL        0x68             /*!< WHO_AM_I 寄存器固定值 */
+
+/**
+ * MPU6050 寄存器地址
+ */
+#define MPU6050_XA_OFFS_H           0x06             /*!< 加速度偏移 X/Y/Z，各 2 字节 */
+#define MPU6050_XG_OFFS_USRH        0x13             /*!< 角速度偏移 X/Y/Z，各 2 字节 */
+#define MPU6050_SMPLRT_DIV          0x19
+#define MPU6050_CONFIG              0x1A
+#define MPU6050_GYRO_CONFIG         0x1B
+#define MPU6050_ACCEL_CONFIG        0x1C
+#define MPU6050_FIFO_EN             0x23
+#define MPU6050_ACCEL_XOUT_H        0x3B
+#define MPU6050_TEMP_OUT_H          0x41
+#define MPU6050_GYRO_XOUT_H         0x43
+#define MPU6050_SIG_PATH_RST        0x68
+#define MPU6050_USER_CTRL           0x6A
+#define MPU6050_PWR_MGMT_1          0x6B
+#define MPU6050_FIFO_COUNTH         0x72
+#define MPU6050_FIFO_R_W            0x74
+#define MPU6050_WHO_AM_I            0x75
+
+/* 上电后可以访问寄存器的时间 */
+#define MPU6050_STARTUP_MS          (100)
+/* 退出睡眠后陀螺仪的启动时间 (数据手册典型值 30ms)，之后的采样才有效 */
+#define MPU6050_WAKE_MS             (30)
+
+/* mpu6050_init() 设置的量程：加速度 +/-2g，角速度 +/-2000dps */
+#define MPU6050_ACCEL_LSB_PER_G     (16384)
+#define MPU6050_GYRO_LSB_PER_DPS    (16.4)
+
+/*
+偏移寄存器的单位与量程无关：加速度按 +/-16g (2048 LSB/g)，最低位保留 (出厂温度补偿位，写入时保持)；
+角速度按 +/-1000dps (32.8 LSB/(°/s))。换算成 mpu6050_init() 量程下的数据 LSB：
+*/
+#define MPU6050_ACCEL_OFFS_DIV      (8)              /*!< 数据 LSB / 偏移寄存器 LSB */
+#define MPU6050_GYRO_OFFS_MUL       (2)              /*!< 偏移寄存器 LSB / 数据 LSB */
+#define MPU6050_OFFS_LEN            (6)
+
+/* 从 SMPLRT_DIV 开始连续的 4 个配置寄存器：采样率分频、低通滤波、陀螺仪量程、加速度量程 */
+#define MPU6050_CONFIG_LEN          (4)
+
+/* 加速计、温度、陀螺仪数据寄存器连续 14 字节 */
+#define MPU6050_RAW_LEN             (14)
+
+/*
+FIFO：1024 字节，每帧为加速度 x/y/z 与角速度 x/y/z (不含温度)，与 filter_bank 组件的帧格式相同
+*/
+#define MPU6050_FIFO_SIZE           (1024)
+#define MPU6050_FIFO_CHANNELS       (6)
+#define MPU6050_FIFO_FRAME_LEN      (2 * MPU6050_FIFO_CHANNELS)
+/* 打开数字低通滤波 (DLPF_CFG = 1，约 188Hz) 时陀螺仪输出速率为 1kHz */
+#define MPU6050_FIFO_RATE_MAX       (1000)
+
+typedef struct {
+    int16_t accel_x;
+    int16_t accel_y;
+    int16_t accel_z;
+    int16_t temp;
+    int16_t gyro_x;
+    int16_t gyro_y;
+    int16_t gyro_z;
+} mpu6050_raw_t;
+
+/**
+ * @brief  把 MPU6050 注册到总线上
+ *
+ * @param  addr  7 位地址：MPU6050_ADDR 或 MPU6050_ADDR_AD0_HIGH
+ */
+esp_err_t mpu6050_add(uint8_t addr, i2c_bus_dev_handle_t *dev);
+
+/**
+ * @brief  唤醒 MPU6050，设置采样率、低通滤波与量程
+ *
+ * 上电 100ms 后才能访问寄存器，只在系统启动不到 100ms 时等待剩余的时间；
+ * 四个配置寄存器地址连续，一次写入。
+ * 同时注册为设备初始化回调，总线恢复后自动重新执行；传感器可能已经复位，
+ * 之后再写入 mpu6050_set_offsets() 设置的偏移与 mpu6050_fifo_start() 的 FIFO 配置 (FIFO 被清空)
+ */
+esp_err_t mpu6050_init(i2c_bus_dev_handle_t dev);
+
+/**
+ * @brief  进入/退出睡眠 (PWR_MGMT_1 的 SLEEP 位)
+ *
+ * 睡眠电流约 5uA，配置与偏移寄存器保持不变，退出睡眠后不需要 mpu6050_init()，
+ * 等待 MPU6050_WAKE_MS 后读取数据
+ */
+esp_err_t mpu6050_set_sleep(i2c_bus_dev_handle_t dev, bool sleep);
+
+/**
+ * @brief  读取偏移寄存器：加速度 X/Y/Z，角速度 X/Y/Z
+ */
+esp_err_t mpu6050_get_offsets(i2c_bus_dev_handle_t dev, int16_t accel[3], int16_t gyro[3]);
+
+/**
+ * @brief  写偏移寄存器，加速度偏移的最低位应保持读出的值
+ *
+ * 写入的值由驱动记录，总线恢复后 mpu6050_init() 重新写入
+ */
+esp_err_t mpu6050_set_offsets(i2c_bus_dev_handle_t dev, const int16_t accel[3], const int16_t gyro[3]);
+
+/**
+ * @brief  按 rate_hz 采样写入 FIFO
+ *
+ * 设置采样率分频 (1kHz / rate_hz)，低通滤波改为约 188Hz，量程不变；清空并打开 FIFO。
+ * 采样率由驱动记录，总线恢复后 mpu6050_init() 重新打开 FIFO，采样率不变
+ *
+ * @param  rate_hz  1kHz 的整数分之一，4 ~ MPU6050_FIFO_RATE_MAX
+ */
+esp_err_t mpu6050_fifo_start(i2c_bus_dev_handle_t dev, uint16_t rate_hz);
+
+/**
+ * @brief  读取 FIFO 中的完整帧，最多 max 帧，按帧解码为有符号整数
+ *
+ * 先读 FIFO_COUNT，再一次突发读取。FIFO 溢出 (或字节数不是整帧) 时清空 FIFO，返回 ESP_ERR_INVALID_SIZE，
+ * 之前的数据丢失，调用方应重新开始滤波
+ *
+ * @param  frames  输出缓冲区，也用作接收缓冲区
+ * @param  num     返回读取的帧数
+ */
+esp_err_t mpu6050_fifo_read(i2c_bus_dev_handle_t dev, int16_t (*frames)[MPU6050_FIFO_CHANNELS], size_t max,
+                            size_t *num);
+
+/**
+ * @brief  读取 WHO_AM_I 寄存器
+ */
+esp_err_t mpu6050_who_am_i(i2c_bus_dev_handle_t dev, uint8_t *who_am_i);
+
+/**
+ * @brief  一次读取加速计、温度、陀螺仪共 14 字节原始数据
+ */
+esp_err_t mpu6050_read_raw(i2c_bus_dev_handle_t dev, uint8_t data[MPU6050_RAW_LEN]);
+
+/**
+ * @brief  把 14 字节大端数据解码为有符号整数
+ */
+void mpu6050_decode(const uint8_t data[MPU6050_RAW_LEN], mpu6050_raw_t *raw);
+
+/**
+ * @brief  温度原始值 -> 0.01 摄氏度
+ */
+static inline int32_t mpu6050_temp_centi(int16_t temp)
+{
+    // T = 36.53 + temp / 340
+    return 3653 + (int32_t)temp * 100 / 340;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MPU6050_H_ */
@@ -0,0 +1,291 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "mpu6050.h"
+
+/* 上电后的配置：PWR_MGMT_1 一次写入，SMPLRT_DIV ~ ACCEL_CONFIG 地址连续，合并为一次写入 */
+static const i2c_bus_reg_t mpu6050_init_table[] = {
+    I2C_BUS_REG(MPU6050_PWR_MGMT_1, 0x00),      // 唤醒 MPU6050，内部 8MHz 时钟
+    I2C_BUS_REG(MPU6050_SMPLRT_DIV, 0x07),      // 陀螺仪输出速率分频：8 分频
+    I2C_BUS_REG(MPU6050_CONFIG, 0x06),          // 数字低通过滤器 (DLPF)
+    I2C_BUS_REG(MPU6050_GYRO_CONFIG, 0x18),     // 陀螺仪测量范围: +/- 2000dps (FS_SEL = 3)
+    I2C_BUS_REG(MPU6050_ACCEL_CONFIG, 0x01),    // 加速计测量范围：+/-2g
+};
+
+/* 总线恢复 (传感器可能已经复位) 后 mpu6050_init() 需要恢复的设置，按地址的 AD0 位每个地址一份 */
+typedef struct {
+    i2c_bus_dev_handle_t dev;
+    uint16_t fifo_rate_hz;                  /*!< mpu6050_fifo_start() 的采样率，0 为没有打开 FIFO */
+    bool offs_set;                          /*!< 调用过 mpu6050_set_offsets() */
+    uint8_t accel_offs[MPU6050_OFFS_LEN];   /*!< 偏移寄存器的值，大端 */
+    uint8_t gyro_offs[MPU6050_OFFS_LEN];
+} mpu6050_state_t;
+
+static mpu6050_state_t s_mpu6050_state[2];
+
+static mpu6050_state_t *mpu6050_state_get(i2c_bus_dev_handle_t dev)
+{
+    size_t i = 0;
+
+    for(i = 0; i < sizeof(s_mpu6050_state) / sizeof(s_mpu6050_state[0]); ++i)
+    {
+        if(dev == s_mpu6050_state[i].dev)
+        {
+            return &s_mpu6050_state[i];
+        }
+    }
+
+    return NULL;
+}
+
+esp_err_t mpu6050_add(uint8_t addr, i2c_bus_dev_handle_t *dev)
+{
+    i2c_bus_dev_config_t config = {
+        .name = "mpu6050",
+        .addr = addr,
+        .reg_addr_len = 1,
+        .prio = I2C_BUS_PRIO_HIGH,
+        .init = mpu6050_init,
+        // 支持 400kHz 快速模式
+        .scl_hz = I2C_BUS_SCL_FAST,
+    };
+    mpu6050_state_t *state = &s_mpu6050_state[addr & 0x1];
+    esp_err_t ret = i2c_bus_add_device(&config, dev);
+
+    // 重新注册时清除之前的设置
+    if(ESP_OK == ret)
+    {
+        portENTER_CRITICAL();
+        memset(state, 0, sizeof(*state));
+        state->dev = *dev;
+        portEXIT_CRITICAL();
+    }
+
+    return ret;
+}
+
+/* 打开 FIFO：分频随采样率变化，在栈上填表；USER_CTRL 写两次，先复位再使能 */
+static esp_err_t mpu6050_fifo_config(i2c_bus_dev_handle_t dev, uint16_t rate_hz)
+{
+    i2c_bus_reg_t table[] = {
+        I2C_BUS_REG(MPU6050_SMPLRT_DIV, 0),
+        I2C_BUS_REG(MPU6050_CONFIG, 0x01),          // DLPF 约 188Hz，陀螺仪输出 1kHz
+        I2C_BUS_REG(MPU6050_FIFO_EN, 0x78),         // XG/YG/ZG 与加速度
+        I2C_BUS_REG(MPU6050_USER_CTRL, 0x04),       // FIFO_RESET
+        I2C_BUS_REG(MPU6050_USER_CTRL, 0x40),       // FIFO_EN
+    };
+
+    table[0].value = MPU6050_FIFO_RATE_MAX / rate_hz - 1;
+
+    return i2c_bus_write_table(dev, table, sizeof(table) / sizeof(table[0]), 0, NULL);
+}
+
+static esp_err_t mpu6050_write_offsets(i2c_bus_dev_handle_t dev, const uint8_t accel[MPU6050_OFFS_LEN],
+                                       const uint8_t gyro[MPU6050_OFFS_LEN])
+{
+    esp_err_t ret = i2c_bus_write(dev, MPU6050_XA_OFFS_H, accel, MPU6050_OFFS_LEN);
+
+    if(ESP_OK == ret)
+    {
+        ret = i2c_bus_write(dev, MPU6050_XG_OFFS_USRH, gyro, MPU6050_OFFS_LEN);
+    }
+
+    return ret;
+}
+
+esp_err_t mpu6050_init(i2c_bus_dev_handle_t dev)
+{
+    TickType_t now = xTaskGetTickCount();
+    mpu6050_state_t *state = mpu6050_state_get(dev);
+    mpu6050_state_t saved;
+    esp_err_t ret = ESP_OK;
+
+    if(MPU6050_STARTUP_MS / portTICK_RATE_MS > now)
+    {
+        vTaskDelay(MPU6050_STARTUP_MS / portTICK_RATE_MS - now);
+    }
+
+    memset(&saved, 0, sizeof(saved));
+    if(NULL != state)
+    {
+        portENTER_CRITICAL();
+        saved = *state;
+        portEXIT_CRITICAL();
+    }
+
+    ret = i2c_bus_write_table(dev, mpu6050_init_table, sizeof(mpu6050_init_table) / sizeof(mpu6050_init_table[0]),
+                              I2C_BUS_TABLE_RETRY, NULL);
+    // 传感器复位后偏移寄存器回到出厂值，FIFO 关闭，按之前的设置恢复
+    if(ESP_OK == ret && saved.offs_set)
+    {
+        ret = mpu6050_write_offsets(dev, saved.accel_offs, saved.gyro_offs);
+    }
+    if(ESP_OK == ret && 0 != saved.fifo_rate_hz)
+    {
+        ret = mpu6050_fifo_config(dev, saved.fifo_rate_hz);
+    }
+
+    return ret;
+}
+
+esp_err_t mpu6050_set_sleep(i2c_bus_dev_handle_t dev, bool sleep)
+{
+    // 时钟源保持内部 8MHz，与 mpu6050_init() 相同
+    uint8_t cmd_data = sleep ? 0x40 : 0x00;
+
+    return i2c_bus_write(dev, MPU6050_PWR_MGMT_1, &cmd_data, 1);
+}
+
+static void mpu6050_put_be(uint8_t *data, const int16_t value[3])
+{
+    int i = 0;
+
+    for(i = 0; i < 3; ++i)
+    {
+        data[2 * i] = (uint8_t)((uint16_t)value[i] >> 8);
+        data[2 * i + 1] = (uint8_t)value[i];
+    }
+}
+
+static void mpu6050_get_be(const uint8_t *data, int16_t value[3])
+{
+    int i = 0;
+
+    for(i = 0; i < 3; ++i)
+    {
+        value[i] = (int16_t)((data[2 * i] << 8) | data[2 * i + 1]);
+    }
+}
+
+esp_err_t mpu6050_get_offsets(i2c_bus_dev_handle_t dev, int16_t accel[3], int16_t gyro[3])
+{
+    uint8_t data[MPU6050_OFFS_LEN];
+    esp_err_t ret = i2c_bus_read(dev, MPU6050_XA_OFFS_H, data, sizeof(data));
+
+    if(ESP_OK == ret)
+    {
+        mpu6050_get_be(data, accel);
+        ret = i2c_bus_read(dev, MPU6050_XG_OFFS_USRH, data, sizeof(data));
+    }
+    if(ESP_OK == ret)
+    {
+        mpu6050_get_be(data, gyro);
+    }
+
+    return ret;
+}
+
+esp_err_t mpu6050_set_offsets(i2c_bus_dev_handle_t dev, const int16_t accel[3], const int16_t gyro[3])
+{
+    mpu6050_state_t *state = mpu6050_state_get(dev);
+    uint8_t accel_data[MPU6050_OFFS_LEN];
+    uint8_t gyro_data[MPU6050_OFFS_LEN];
+
+    mpu6050_put_be(accel_data, accel);
+    mpu6050_put_be(gyro_data, gyro);
+    // 写入失败时总线恢复会重新执行 mpu6050_init()，先记录
+    if(NULL != state)
+    {
+        portENTER_CRITICAL();
+        memcpy(state->accel_offs, accel_data, sizeof(accel_data));
+        memcpy(state->gyro_offs, gyro_data, sizeof(gyro_data));
+        state->offs_set = true;
+        portEXIT_CRITICAL();
+    }
+
+    return mpu6050_write_offsets(dev, accel_data, gyro_data);
+}
+
+esp_err_t mpu6050_fifo_start(i2c_bus_dev_handle_t dev, uint16_t rate_hz)
+{
+    mpu6050_state_t *state = mpu6050_state_get(dev);
+
+    if(4 > rate_hz || MPU6050_FIFO_RATE_MAX < rate_hz || 0 != MPU6050_FIFO_RATE_MAX % rate_hz)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL != state)
+    {
+        portENTER_CRITICAL();
+        state->fifo_rate_hz = rate_hz;
+        portEXIT_CRITICAL();
+    }
+
+    return mpu6050_fifo_config(dev, rate_hz);
+}
+
+esp_err_t mpu6050_fifo_read(i2c_bus_dev_handle_t dev, int16_t (*frames)[MPU6050_FIFO_CHANNELS], size_t max,
+                            size_t *num)
+{
+    uint8_t count_data[2];
+    uint8_t *data = (uint8_t *)frames;
+    uint16_t count = 0;
+    size_t n = 0;
+    size_t i = 0;
+    esp_err_t ret = ESP_OK;
+
+    *num = 0;
+    ret = i2c_bus_read(dev, MPU6050_FIFO_COUNTH, count_data, sizeof(count_data));
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    // 溢出时新数据覆盖旧数据，帧边界丢失
+    count = (count_data[0] << 8) | count_data[1];
+    if(MPU6050_FIFO_SIZE - MPU6050_FIFO_FRAME_LEN < count || 0 != count % MPU6050_FIFO_FRAME_LEN)
+    {
+        count_data[0] = 0x44;   // USER_CTRL：FIFO_EN | FIFO_RESET
+        ret = i2c_bus_write(dev, MPU6050_USER_CTRL, count_data, 1);
+        return (ESP_OK == ret) ? ESP_ERR_INVALID_SIZE : ret;
+    }
+
+    n = count / MPU6050_FIFO_FRAME_LEN;
+    if(n > max)
+    {
+        n = max;
+    }
+    if(0 == n)
+    {
+        return ESP_OK;
+    }
+    ret = i2c_bus_read(dev, MPU6050_FIFO_R_W, data, n * MPU6050_FIFO_FRAME_LEN);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    // 就地从大端字节转换
+    for(i = 0; i < n * MPU6050_FIFO_CHANNELS; ++i)
+    {
+        ((int16_t *)frames)[i] = (int16_t)((data[2 * i] << 8) | data[2 * i + 1]);
+    }
+    *num = n;
+
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_who_am_i(i2c_bus_dev_handle_t dev, uint8_t *who_am_i)
+{
+    return i2c_bus_read(dev, MPU6050_WHO_AM_I, who_am_i, 1);
+}
+
+esp_err_t mpu6050_read_raw(i2c_bus_dev_handle_t dev, uint8_t data[MPU6050_RAW_LEN])
+{
+    return i2c_bus_read(dev, MPU6050_ACCEL_XOUT_H, data, MPU6050_RAW_LEN);
+}
+
+void mpu6050_decode(const uint8_t data[MPU6050_RAW_LEN], mpu6050_raw_t *raw)
+{
+    raw->accel_x = (int16_t)((data[0] << 8) | data[1]);
+    raw->accel_y = (int16_t)((data[2] << 8) | data[3]);
+    raw->accel_z = (int16_t)((data[4] << 8) | data[5]);
+    raw->temp = (int16_t)((data[6] << 8) | data[7]);
+    raw->gyro_x = (int16_t)((data[8] << 8) | data[9]);
+    raw->gyro_y = (int16_t)((data[10] << 8) | data[11]);
+    raw->gyro_z = (int16_t)((data[12] << 8) | data[13]);
+}
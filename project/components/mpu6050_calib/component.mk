@@ -0,0 +1,7 @@
+#
+# mpu6050_calib 组件
+#
+# MPU6050 静止零偏标定，结果写入偏移寄存器并带校验保存在 AT24C32 中，下次启动直接恢复
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,97 @@
+/**
+ * MPU6050 零偏标定与保存
+ *
+ * 标定：传感器静止放置，连续读取若干采样，每个轴累加和与平方和 (64 位整数，逐个采样更新，不保存采样)，
+ * 得到均值与标准差：
+ * - 角速度的均值即零偏；加速度均值中绝对值最大的轴为重力方向，减去 1g 后为零偏，其余两轴的均值即零偏
+ * - 任一轴的标准差超过阈值时认为传感器在运动，返回 ESP_ERR_INVALID_STATE，不修改偏移寄存器
+ * - 零偏换算成偏移寄存器的修正量，在当前寄存器值上修正后写回，之后读出的数据已经扣除零偏。
+ *   加速度偏移寄存器的最低位保留，修正的步长为 16 LSB (+/-2g 量程)，残留不超过 8 LSB
+ * 静止单一姿态只能分辨零偏，标度因数需要多个姿态 (例如六面) 标定，这里不估计；
+ * 标准差一起保存，作为传感器噪声的参考 (例如姿态解算的增益选择)
+ *
+ * 保存：偏移寄存器值、标准差、标定时的温度，加上标识、版本与 CRC16 共 31 字节，
+ * 放在 AT24C32 的一页内，一次页写完成，写入中断时 CRC 不匹配
+ *
+ * 启动：mpu6050_calib_start() 先读 AT24C32 中的记录，有效时把偏移寄存器一次恢复 (热启动，几毫秒)；
+ * 没有有效记录时重新标定并保存 (冷启动，采样数 x 采样间隔)
+ */
+#ifndef _MPU6050_CALIB_H_
+#define _MPU6050_CALIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+#include "at24c32.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 默认保存在 AT24C32 最后一页 */
+#define MPU6050_CALIB_E2P_ADDR      (AT24C32_SIZE - AT24C32_PAGE_SIZE)
+/* 保存的记录长度，不超过一页 */
+#define MPU6050_CALIB_RECORD_LEN    (31)
+
+/* 采样间隔：一个节拍，数据输出速率为 125Hz (mpu6050_init() 的设置) */
+#define MPU6050_CALIB_PERIOD_MS     (10)
+#define MPU6050_CALIB_SAMPLES       (128)
+#define MPU6050_CALIB_SAMPLES_MAX   (4096)
+
+/* 静止判断：标准差上限 (LSB)，角速度约 1°/s，加速度约 12mg */
+#define MPU6050_CALIB_GYRO_STD_MAX  (16)
+#define MPU6050_CALIB_ACCEL_STD_MAX (200)
+
+typedef struct {
+    int16_t accel_offs[3];          /*!< 加速度偏移寄存器值 */
+    int16_t gyro_offs[3];           /*!< 角速度偏移寄存器值 */
+    uint16_t accel_std[3];          /*!< 加速度标准差，LSB */
+    uint16_t gyro_std[3];           /*!< 角速度标准差，LSB */
+    int16_t temp;                   /*!< 标定时的温度原始值 */
+    /* 以下只在 mpu6050_calib_run() 之后有效，不保存 */
+    int16_t accel_bias[3];          /*!< 标定前的加速度零偏，LSB */
+    int16_t gyro_bias[3];           /*!< 标定前的角速度零偏，LSB */
+} mpu6050_calib_t;
+
+/**
+ * @brief  静止标定，修正并写入偏移寄存器
+ *
+ * @param  samples  采样数，1 ~ MPU6050_CALIB_SAMPLES_MAX，每个采样间隔 MPU6050_CALIB_PERIOD_MS
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE (运动中) / 读写错误码
+ */
+esp_err_t mpu6050_calib_run(i2c_bus_dev_handle_t dev, uint16_t samples, mpu6050_calib_t *calib);
+
+/**
+ * @brief  把标定结果写入偏移寄存器
+ */
+esp_err_t mpu6050_calib_apply(i2c_bus_dev_handle_t dev, const mpu6050_calib_t *calib);
+
+/**
+ * @brief  保存到 AT24C32，mem_addr 与记录应在同一页内
+ */
+esp_err_t mpu6050_calib_save(i2c_bus_dev_handle_t e2p, uint16_t mem_addr, const mpu6050_calib_t *calib);
+
+/**
+ * @brief  从 AT24C32 读取
+ *
+ * @return ESP_OK / ESP_ERR_NOT_FOUND (没有记录) / ESP_ERR_INVALID_CRC / 读错误码
+ */
+esp_err_t mpu6050_calib_load(i2c_bus_dev_handle_t e2p, uint16_t mem_addr, mpu6050_calib_t *calib);
+
+/**
+ * @brief  启动时调用：有有效记录时恢复，否则标定并保存
+ *
+ * @param  warm  返回是否为热启动，可以为 NULL
+ */
+esp_err_t mpu6050_calib_start(i2c_bus_dev_handle_t dev, i2c_bus_dev_handle_t e2p, uint16_t mem_addr,
+                              uint16_t samples, mpu6050_calib_t *calib, bool *warm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MPU6050_CALIB_H_ */
@@ -0,0 +1,276 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "int_math.h"
+#include "mpu6050.h"
+#include "sample_codec.h"
+#include "mpu6050_calib.h"
+
+#define MPU6050_CALIB_MAGIC0        ('M')
+#define MPU6050_CALIB_MAGIC1        ('C')
+#define MPU6050_CALIB_VERSION       (1)
+
+/* 加速度偏移的修正步长：最低位保留，寄存器每次改 2 */
+#define MPU6050_CALIB_ACCEL_STEP    (2 * MPU6050_ACCEL_OFFS_DIV)
+
+/* 每个轴的累加量：和与平方和，整数精确累加 */
+typedef struct {
+    int64_t sum;
+    uint64_t sum2;
+} mpu6050_calib_acc_t;
+
+static void acc_add(mpu6050_calib_acc_t *acc, int16_t value)
+{
+    acc->sum += value;
+    acc->sum2 += (uint64_t)((int32_t)value * value);
+}
+
+static int32_t acc_mean(const mpu6050_calib_acc_t *acc, uint16_t n)
+{
+    return int_math_div_round(acc->sum, n);
+}
+
+/* 标准差 = sqrt(n * sum2 - sum^2) / n */
+static uint32_t acc_std(const mpu6050_calib_acc_t *acc, uint16_t n)
+{
+    uint64_t var_n2 = (uint64_t)n * acc->sum2 - (uint64_t)(acc->sum * acc->sum);
+
+    return (int_math_isqrt64(var_n2) + n / 2) / n;
+}
+
+static int16_t clamp16(int32_t value)
+{
+    if(INT16_MAX < value)
+    {
+        return INT16_MAX;
+    }
+    if(INT16_MIN > value)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t)value;
+}
+
+static uint16_t clamp_u16(uint32_t value)
+{
+    return (UINT16_MAX < value) ? UINT16_MAX : (uint16_t)value;
+}
+
+esp_err_t mpu6050_calib_run(i2c_bus_dev_handle_t dev, uint16_t samples, mpu6050_calib_t *calib)
+{
+    mpu6050_calib_acc_t accel[3];
+    mpu6050_calib_acc_t gyro[3];
+    mpu6050_calib_acc_t temp;
+    uint8_t data[MPU6050_RAW_LEN];
+    mpu6050_raw_t raw;
+    TickType_t last_wake = 0;
+    int32_t mean[3];
+    int32_t delta = 0;
+    int gravity = 0;
+    uint16_t n = 0;
+    int i = 0;
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == calib || 0 == samples || MPU6050_CALIB_SAMPLES_MAX < samples)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 在当前偏移寄存器值上修正
+    ret = mpu6050_get_offsets(dev, calib->accel_offs, calib->gyro_offs);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    memset(accel, 0, sizeof(accel));
+    memset(gyro, 0, sizeof(gyro));
+    memset(&temp, 0, sizeof(temp));
+    last_wake = xTaskGetTickCount();
+    for(n = 0; n < samples; ++n)
+    {
+        vTaskDelayUntil(&last_wake, MPU6050_CALIB_PERIOD_MS / portTICK_RATE_MS);
+        ret = mpu6050_read_raw(dev, data);
+        if(ESP_OK != ret)
+        {
+            return ret;
+        }
+        mpu6050_decode(data, &raw);
+        acc_add(&accel[0], raw.accel_x);
+        acc_add(&accel[1], raw.accel_y);
+        acc_add(&accel[2], raw.accel_z);
+        acc_add(&gyro[0], raw.gyro_x);
+        acc_add(&gyro[1], raw.gyro_y);
+        acc_add(&gyro[2], raw.gyro_z);
+        acc_add(&temp, raw.temp);
+    }
+
+    for(i = 0; i < 3; ++i)
+    {
+        calib->accel_std[i] = clamp_u16(acc_std(&accel[i], n));
+        calib->gyro_std[i] = clamp_u16(acc_std(&gyro[i], n));
+        if(MPU6050_CALIB_ACCEL_STD_MAX < calib->accel_std[i] || MPU6050_CALIB_GYRO_STD_MAX < calib->gyro_std[i])
+        {
+            return ESP_ERR_INVALID_STATE;
+        }
+        mean[i] = acc_mean(&accel[i], n);
+        if(abs(mean[i]) > abs(mean[gravity]))
+        {
+            gravity = i;
+        }
+    }
+    calib->temp = clamp16(acc_mean(&temp, n));
+
+    for(i = 0; i < 3; ++i)
+    {
+        // 重力方向的轴应为 +/-1g
+        if(i == gravity)
+        {
+            mean[i] -= (0 > mean[i]) ? -MPU6050_ACCEL_LSB_PER_G : MPU6050_ACCEL_LSB_PER_G;
+        }
+        calib->accel_bias[i] = clamp16(mean[i]);
+        delta = int_math_div_round(mean[i], MPU6050_CALIB_ACCEL_STEP) * 2;
+        calib->accel_offs[i] = clamp16(calib->accel_offs[i] - delta);
+
+        calib->gyro_bias[i] = clamp16(acc_mean(&gyro[i], n));
+        calib->gyro_offs[i] = clamp16(calib->gyro_offs[i] - calib->gyro_bias[i] * MPU6050_GYRO_OFFS_MUL);
+    }
+
+    return mpu6050_calib_apply(dev, calib);
+}
+
+esp_err_t mpu6050_calib_apply(i2c_bus_dev_handle_t dev, const mpu6050_calib_t *calib)
+{
+    if(NULL == calib)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return mpu6050_set_offsets(dev, calib->accel_offs, calib->gyro_offs);
+}
+
+static uint8_t *put16(uint8_t *p, const int16_t *value, int num)
+{
+    int i = 0;
+
+    for(i = 0; i < num; ++i)
+    {
+        *p++ = (uint8_t)((uint16_t)value[i] >> 8);
+        *p++ = (uint8_t)value[i];
+    }
+
+    return p;
+}
+
+static const uint8_t *get16(const uint8_t *p, int16_t *value, int num)
+{
+    int i = 0;
+
+    for(i = 0; i < num; ++i)
+    {
+        value[i] = (int16_t)((p[0] << 8) | p[1]);
+        p += 2;
+    }
+
+    return p;
+}
+
+/*
+记录格式 (大端)：
+'M' 'C' 版本 | 加速度偏移 x3 | 角速度偏移 x3 | 加速度标准差 x3 | 角速度标准差 x3 | 温度 | CRC16
+*/
+esp_err_t mpu6050_calib_save(i2c_bus_dev_handle_t e2p, uint16_t mem_addr, const mpu6050_calib_t *calib)
+{
+    uint8_t record[MPU6050_CALIB_RECORD_LEN];
+    uint8_t *p = record;
+    uint16_t crc = 0;
+
+    if(NULL == calib
+       || mem_addr / AT24C32_PAGE_SIZE != (mem_addr + MPU6050_CALIB_RECORD_LEN - 1) / AT24C32_PAGE_SIZE)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *p++ = MPU6050_CALIB_MAGIC0;
+    *p++ = MPU6050_CALIB_MAGIC1;
+    *p++ = MPU6050_CALIB_VERSION;
+    p = put16(p, calib->accel_offs, 3);
+    p = put16(p, calib->gyro_offs, 3);
+    p = put16(p, (const int16_t *)calib->accel_std, 3);
+    p = put16(p, (const int16_t *)calib->gyro_std, 3);
+    p = put16(p, &calib->temp, 1);
+    crc = sample_codec_crc16(0xFFFF, record, p - record);
+    *p++ = (uint8_t)(crc >> 8);
+    *p++ = (uint8_t)crc;
+
+    return at24c32_write(e2p, mem_addr, record, sizeof(record));
+}
+
+esp_err_t mpu6050_calib_load(i2c_bus_dev_handle_t e2p, uint16_t mem_addr, mpu6050_calib_t *calib)
+{
+    uint8_t record[MPU6050_CALIB_RECORD_LEN];
+    const uint8_t *p = &record[3];
+    uint16_t crc = 0;
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == calib)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ret = at24c32_read(e2p, mem_addr, record, sizeof(record));
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+    if(MPU6050_CALIB_MAGIC0 != record[0] || MPU6050_CALIB_MAGIC1 != record[1] || MPU6050_CALIB_VERSION != record[2])
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    crc = sample_codec_crc16(0xFFFF, record, sizeof(record) - 2);
+    if((uint8_t)(crc >> 8) != record[sizeof(record) - 2] || (uint8_t)crc != record[sizeof(record) - 1])
+    {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    memset(calib, 0, sizeof(mpu6050_calib_t));
+    p = get16(p, calib->accel_offs, 3);
+    p = get16(p, calib->gyro_offs, 3);
+    p = get16(p, (int16_t *)calib->accel_std, 3);
+    p = get16(p, (int16_t *)calib->gyro_std, 3);
+    get16(p, &calib->temp, 1);
+
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_calib_start(i2c_bus_dev_handle_t dev, i2c_bus_dev_handle_t e2p, uint16_t mem_addr,
+                              uint16_t samples, mpu6050_calib_t *calib, bool *warm)
+{
+    esp_err_t ret = mpu6050_calib_load(e2p, mem_addr, calib);
+
+    if(NULL != warm)
+    {
+        *warm = (ESP_OK == ret);
+    }
+    if(ESP_OK == ret)
+    {
+        return mpu6050_calib_apply(dev, calib);
+    }
+    if(ESP_ERR_NOT_FOUND != ret && ESP_ERR_INVALID_CRC != ret)
+    {
+        return ret;
+    }
+
+    ret = mpu6050_calib_run(dev, samples, calib);
+    if(ESP_OK == ret)
+    {
+        ret = mpu6050_calib_save(e2p, mem_addr, calib);
+    }
+
+    return ret;
+}
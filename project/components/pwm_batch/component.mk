@@ -0,0 +1,7 @@
+#
+# pwm_batch 组件
+#
+# 批量暂存多个 PWM 通道的占空比/相位，一次 pwm_start() 统一生效
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,97 @@
+/**
+ * PWM 批量更新 (双缓冲通道参数)
+ *
+ * pwm_set_duty() / pwm_set_phase() 只修改参数，真正生效要调用 pwm_start()，
+ * 而 pwm_start() 每次都要重新计算并装载整张通道表。
+ * 多个通道各自 set + start 时，每个通道都会触发一次重新计算。
+ *
+ * 本组件维护两份通道参数 (周期、占空比、相位、反相掩码)：
+ * - shadow: 暂存表，所有修改都先写到这里
+ * - active: 最近一次提交给驱动的参数
+ * pwm_batch_commit() 时只调用一次 pwm_start()，不调用 pwm_stop()，所有通道的修改一起交给驱动。
+ * 驱动预期在当前 PWM 周期结束时由 NMI 中断装载新的通道表，此时运行中修改相位、反相、周期不会出现毛刺；
+ * 实际切换时机取决于驱动实现，没有在硬件上验证 (tools/pwm_wave_sim 只在该假设下演示)。
+ */
+#ifndef _PWM_BATCH_H_
+#define _PWM_BATCH_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PWM_BATCH_CH_MAX            (8)
+
+typedef struct {
+    uint32_t period;                        /*!< PWM 周期 (us) */
+    uint32_t duties[PWM_BATCH_CH_MAX];      /*!< 占空比 (us) */
+    int16_t phases[PWM_BATCH_CH_MAX];       /*!< 相位 */
+    uint16_t invert_mask;                   /*!< 反相输出的通道掩码 */
+} pwm_batch_config_t;
+
+/**
+ * @brief  初始化 PWM 并记录当前参数，参数与 pwm_init() 相同
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t pwm_batch_init(uint32_t period, uint32_t *duties, uint8_t channel_num, const uint32_t *pin_num);
+
+/**
+ * @brief  暂存单个通道的占空比，不会立即生效
+ */
+esp_err_t pwm_batch_set_duty(uint8_t channel, uint32_t duty);
+
+/**
+ * @brief  暂存单个通道的相位，不会立即生效
+ */
+esp_err_t pwm_batch_set_phase(uint8_t channel, int16_t phase);
+
+/**
+ * @brief  按通道掩码暂存多个通道的占空比
+ *
+ * @param  channel_mask  bit n 为 1 表示更新通道 n
+ * @param  duties        占空比表，按通道号索引，未选中的通道不读取
+ */
+esp_err_t pwm_batch_set_duties(uint32_t channel_mask, const uint32_t *duties);
+
+/**
+ * @brief  暂存 PWM 周期，不会立即生效
+ */
+esp_err_t pwm_batch_set_period(uint32_t period);
+
+/**
+ * @brief  暂存反相输出的通道掩码 (完整掩码，不是增量)，不会立即生效
+ */
+esp_err_t pwm_batch_set_invert(uint16_t invert_mask);
+
+/**
+ * @brief  一次暂存整张通道参数表，不会立即生效
+ */
+esp_err_t pwm_batch_set_config(const pwm_batch_config_t *config);
+
+/**
+ * @brief  读取当前生效的通道参数表
+ */
+void pwm_batch_get_active(pwm_batch_config_t *config);
+
+/**
+ * @brief  提交所有暂存的修改，只调用一次 pwm_start()
+ *
+ * 没有暂存修改时直接返回 ESP_OK，不打印日志。pwm_start() 不能在中断中调用，本函数也一样。
+ * 驱动返回错误时暂存的修改全部保留，下一次提交重新写入
+ */
+esp_err_t pwm_batch_commit(void);
+
+/**
+ * @brief  返回有暂存修改的通道掩码
+ */
+uint32_t pwm_batch_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PWM_BATCH_H_ */
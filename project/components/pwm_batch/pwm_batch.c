@@ -0,0 +1,235 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "driver/pwm.h"
+
+#include "pwm_batch.h"
+
+#define PWM_BATCH_DIRTY_PERIOD      (0x1 << 0)
+#define PWM_BATCH_DIRTY_DUTY        (0x1 << 1)
+#define PWM_BATCH_DIRTY_PHASE       (0x1 << 2)
+#define PWM_BATCH_DIRTY_INVERT      (0x1 << 3)
+
+typedef struct {
+    uint8_t channel_num;
+    uint32_t dirty;                         /*!< PWM_BATCH_DIRTY_xxx */
+    uint32_t channel_dirty;                 /*!< 有修改的通道掩码 */
+    pwm_batch_config_t shadow;              /*!< 暂存表，修改都先写到这里 */
+    pwm_batch_config_t active;              /*!< 最近一次提交到驱动的参数 */
+} pwm_batch_obj_t;
+
+static pwm_batch_obj_t s_batch;
+
+esp_err_t pwm_batch_init(uint32_t period, uint32_t *duties, uint8_t channel_num, const uint32_t *pin_num)
+{
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == duties || NULL == pin_num || 0 == channel_num || PWM_BATCH_CH_MAX < channel_num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ret = pwm_init(period, duties, channel_num, pin_num);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    memset(&s_batch, 0, sizeof(s_batch));
+    s_batch.channel_num = channel_num;
+    s_batch.active.period = period;
+    memcpy(s_batch.active.duties, duties, channel_num * sizeof(uint32_t));
+    s_batch.shadow = s_batch.active;
+
+    // 驱动要求相位必须设置，即使全部为 0
+    return pwm_set_phases(s_batch.active.phases);
+}
+
+esp_err_t pwm_batch_set_duty(uint8_t channel, uint32_t duty)
+{
+    if(s_batch.channel_num <= channel)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL();
+    s_batch.shadow.duties[channel] = duty;
+    s_batch.dirty |= PWM_BATCH_DIRTY_DUTY;
+    s_batch.channel_dirty |= (0x1 << channel);
+    portEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_batch_set_phase(uint8_t channel, int16_t phase)
+{
+    if(s_batch.channel_num <= channel)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL();
+    s_batch.shadow.phases[channel] = phase;
+    s_batch.dirty |= PWM_BATCH_DIRTY_PHASE;
+    s_batch.channel_dirty |= (0x1 << channel);
+    portEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_batch_set_duties(uint32_t channel_mask, const uint32_t *duties)
+{
+    uint8_t i = 0;
+
+    if(NULL == duties || 0 != (channel_mask >> s_batch.channel_num))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL();
+    for(i = 0; i < s_batch.channel_num; ++i)
+    {
+        if(0 != (channel_mask & (0x1 << i)))
+        {
+            s_batch.shadow.duties[i] = duties[i];
+        }
+    }
+    s_batch.dirty |= PWM_BATCH_DIRTY_DUTY;
+    s_batch.channel_dirty |= channel_mask;
+    portEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_batch_set_period(uint32_t period)
+{
+    if(0 == period)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL();
+    s_batch.shadow.period = period;
+    s_batch.dirty |= PWM_BATCH_DIRTY_PERIOD;
+    s_batch.channel_dirty |= (0x1 << s_batch.channel_num) - 1;
+    portEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_batch_set_invert(uint16_t invert_mask)
+{
+    if(0 != (invert_mask >> s_batch.channel_num))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL();
+    s_batch.channel_dirty |= s_batch.shadow.invert_mask ^ invert_mask;
+    s_batch.shadow.invert_mask = invert_mask;
+    s_batch.dirty |= PWM_BATCH_DIRTY_INVERT;
+    portEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_batch_set_config(const pwm_batch_config_t *config)
+{
+    if(NULL == config || 0 == config->period || 0 != (config->invert_mask >> s_batch.channel_num))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL();
+    s_batch.shadow = *config;
+    s_batch.dirty |= PWM_BATCH_DIRTY_PERIOD | PWM_BATCH_DIRTY_DUTY | PWM_BATCH_DIRTY_PHASE | PWM_BATCH_DIRTY_INVERT;
+    s_batch.channel_dirty |= (0x1 << s_batch.channel_num) - 1;
+    portEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+void pwm_batch_get_active(pwm_batch_config_t *config)
+{
+    portENTER_CRITICAL();
+    *config = s_batch.active;
+    portEXIT_CRITICAL();
+}
+
+esp_err_t pwm_batch_commit(void)
+{
+    pwm_batch_config_t next;
+    uint32_t dirty = 0;
+    uint16_t set_mask = 0;
+    uint16_t clear_mask = 0;
+    esp_err_t ret = ESP_OK;
+
+    // 取出暂存表的快照，修改标志在驱动调用成功之后才清除
+    portENTER_CRITICAL();
+    dirty = s_batch.dirty;
+    next = s_batch.shadow;
+    portEXIT_CRITICAL();
+
+    if(0 == dirty)
+    {
+        return ESP_OK;
+    }
+
+    // 只修改参数，不重新计算通道表
+    if(0 != (dirty & PWM_BATCH_DIRTY_PERIOD))
+    {
+        ret = pwm_set_period_duties(next.period, next.duties);
+    }
+    else if(0 != (dirty & PWM_BATCH_DIRTY_DUTY))
+    {
+        ret = pwm_set_duties(next.duties);
+    }
+    if(ESP_OK == ret && 0 != (dirty & PWM_BATCH_DIRTY_PHASE))
+    {
+        ret = pwm_set_phases(next.phases);
+    }
+    // 反相只修改有变化的通道
+    if(ESP_OK == ret && 0 != (dirty & PWM_BATCH_DIRTY_INVERT))
+    {
+        set_mask = next.invert_mask & ~s_batch.active.invert_mask;
+        clear_mask = s_batch.active.invert_mask & ~next.invert_mask;
+        if(0 != set_mask)
+        {
+            ret = pwm_set_channel_invert(set_mask);
+        }
+        if(ESP_OK == ret && 0 != clear_mask)
+        {
+            ret = pwm_clear_channel_invert(clear_mask);
+        }
+    }
+    // 所有修改只触发一次重新计算，驱动在当前周期结束时切换到新的通道表
+    if(ESP_OK == ret)
+    {
+        ret = pwm_start();
+    }
+    if(ESP_OK != ret)
+    {
+        // 暂存的修改保留，下一次提交重新写入
+        return ret;
+    }
+
+    // 提交期间又有新的修改时保留标志，留到下一次提交
+    portENTER_CRITICAL();
+    s_batch.active = next;
+    if(0 == memcmp(&s_batch.shadow, &next, sizeof(pwm_batch_config_t)))
+    {
+        s_batch.dirty = 0;
+        s_batch.channel_dirty = 0;
+    }
+    portEXIT_CRITICAL();
+
+    return ESP_OK;
+}
+
+uint32_t pwm_batch_pending(void)
+{
+    return s_batch.channel_dirty;
+}
@@ -0,0 +1,7 @@
+#
+# pwm_dither 组件
+#
+# PWM 占空比时间抖动 (一阶 sigma-delta)，在不降低 PWM 频率的前提下提高有效分辨率
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,106 @@
+/**
+ * PWM 占空比时间抖动 (一阶 sigma-delta)
+ *
+ * PWM 周期 500us 时，占空比最小单位 1us，只有 500 级，低亮度时能看出台阶。
+ * 本模块把高分辨率占空比 (单位 1/2^frac_bits us) 分解为整数部分和小数部分，
+ * 每次更新占空比时把小数部分累加到误差累加器中，溢出时本次占空比 +1us，
+ * 连续多次更新的平均占空比即为目标值，有效分辨率增加 frac_bits 位。
+ *
+ * 小数为 1/2^n 时，抖动图样的周期为 2^n 次更新，抖动的最低频率为更新频率 / 2^n，
+ * 该频率需要不低于人眼可见的闪烁频率 PWM_DITHER_FLICKER_HZ，可用的小数位数由
+ * pwm_dither_max_frac_bits() 按更新频率给出，例如更新频率 2kHz 时最多 4 位。
+ * PWM 与 hw_timer 共用 FRC1，不能按 PWM 周期更新，只能由任务按节拍更新：
+ * 节拍 100Hz (SDK 默认) 时为 0 位，不能抖动；200Hz 时 1 位；节拍最高 1000Hz 时 3 位，
+ * PWM 周期 500us 时有效分辨率约 12 位。
+ *
+ * 本模块只做计算，不依赖硬件，可以在主机上运行 (见 tools/pwm_dither_sim)。
+ */
+#ifndef _PWM_DITHER_H_
+#define _PWM_DITHER_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PWM_DITHER_CH_MAX           (8)
+#define PWM_DITHER_FRAC_BITS_MAX    (8)
+/* 低于此频率的亮度变化可见 */
+#define PWM_DITHER_FLICKER_HZ       (100)
+
+typedef struct {
+    uint8_t frac_bits;
+    uint8_t channel_num;
+    uint32_t frac_mask;                     /*!< 占空比含小数部分的通道掩码 */
+    uint32_t duty[PWM_DITHER_CH_MAX];       /*!< 高分辨率目标占空比 */
+    uint32_t acc[PWM_DITHER_CH_MAX];        /*!< 误差累加器 */
+    uint32_t out[PWM_DITHER_CH_MAX];        /*!< 最近一次输出的整数占空比 */
+} pwm_dither_t;
+
+/**
+ * @brief  初始化，所有通道占空比为 0
+ *
+ * @param  dither       抖动对象
+ * @param  channel_num  通道数，不超过 PWM_DITHER_CH_MAX
+ * @param  frac_bits    小数位数，0 ~ PWM_DITHER_FRAC_BITS_MAX
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG
+ */
+esp_err_t pwm_dither_init(pwm_dither_t *dither, uint8_t channel_num, uint8_t frac_bits);
+
+/**
+ * @brief  按更新频率计算不产生可见闪烁的最大小数位数：更新频率 / 2^n >= PWM_DITHER_FLICKER_HZ
+ */
+static inline uint8_t pwm_dither_max_frac_bits(uint32_t update_hz)
+{
+    uint8_t bits = 0;
+
+    while(PWM_DITHER_FRAC_BITS_MAX > bits && PWM_DITHER_FLICKER_HZ <= (update_hz >> (bits + 1)))
+    {
+        ++bits;
+    }
+
+    return bits;
+}
+
+/**
+ * @brief  设置高分辨率目标占空比，单位 1/2^frac_bits us
+ */
+static inline void pwm_dither_set(pwm_dither_t *dither, uint8_t channel, uint32_t duty)
+{
+    dither->duty[channel] = duty;
+
+    if(0 != (duty & ((0x1 << dither->frac_bits) - 1)))
+    {
+        dither->frac_mask |= (0x1 << channel);
+    }
+    else
+    {
+        dither->frac_mask &= ~(0x1 << channel);
+    }
+}
+
+/**
+ * @brief  计算下一次更新的整数占空比，每次更新调用一次
+ *
+ * @return 整数占空比 (us)，同时记录在 out[channel] 中
+ */
+static inline uint32_t pwm_dither_step(pwm_dither_t *dither, uint8_t channel)
+{
+    uint32_t mask = (0x1 << dither->frac_bits) - 1;
+    uint32_t acc = dither->acc[channel] + (dither->duty[channel] & mask);
+
+    dither->acc[channel] = acc & mask;
+    dither->out[channel] = (dither->duty[channel] >> dither->frac_bits) + (acc >> dither->frac_bits);
+
+    return dither->out[channel];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PWM_DITHER_H_ */
@@ -0,0 +1,19 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "pwm_dither.h"
+
+esp_err_t pwm_dither_init(pwm_dither_t *dither, uint8_t channel_num, uint8_t frac_bits)
+{
+    if(NULL == dither || 0 == channel_num || PWM_DITHER_CH_MAX < channel_num
+       || PWM_DITHER_FRAC_BITS_MAX < frac_bits)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(dither, 0, sizeof(pwm_dither_t));
+    dither->channel_num = channel_num;
+    dither->frac_bits = frac_bits;
+
+    return ESP_OK;
+}
@@ -0,0 +1,7 @@
+#
+# pwm_fade 组件
+#
+# 由任务按节拍驱动的 PWM 渐变引擎
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,117 @@
+/**
+ * PWM 渐变引擎
+ *
+ * 调用者为每个通道给出目标占空比、渐变时长和曲线，之后每一步都在渐变任务中完成：
+ * 按节拍定时唤醒，计算所有活动通道的新占空比，通过 pwm_batch 一次提交，
+ * 驱动在当前 PWM 周期结束时切换到新的通道表。
+ * 渐变过程中应用任务不需要被唤醒，没有通道需要更新时渐变任务也不唤醒。
+ *
+ * 注意：
+ * - 依赖 led_effect、pwm_batch、pwm_dither 组件，PWM 需先用 pwm_batch_init() 初始化
+ * - PWM 驱动与 hw_timer 共用 FRC1，不能同时使用，因此不用 hw_timer 定时，pwm_start() 也不在中断中调用；
+ *   更新由任务按节拍驱动 (不是定时器中断)，更新频率最高为节拍频率 (configTICK_RATE_HZ)，
+ *   平滑度受节拍和任务调度影响。SDK 默认 CONFIG_FREERTOS_HZ=100，
+ *   需要更高的更新频率时在工程的 sdkconfig 中提高节拍频率 (例如 breath_led 使用 1000Hz)
+ * - 完成回调在渐变任务中执行，应尽快返回 (可以再次调用 pwm_fade_start())
+ */
+#ifndef _PWM_FADE_H_
+#define _PWM_FADE_H_
+
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 默认每个节拍更新一次 */
+#define PWM_FADE_DEFAULT_RATE_HZ    (configTICK_RATE_HZ)
+
+/* 渐变任务的栈与优先级，可通过 CFLAGS 覆盖 */
+#ifndef PWM_FADE_TASK_STACK
+#define PWM_FADE_TASK_STACK         (1024)
+#endif
+#ifndef PWM_FADE_TASK_PRIO
+#define PWM_FADE_TASK_PRIO          (10)
+#endif
+
+typedef enum {
+    PWM_FADE_CURVE_LINEAR = 0,      /*!< 占空比线性变化 */
+    PWM_FADE_CURVE_CIE1931,         /*!< 感知亮度线性变化，适合 LED */
+    PWM_FADE_CURVE_EASE,            /*!< 正弦缓入缓出 */
+    PWM_FADE_CURVE_MAX,
+} pwm_fade_curve_t;
+
+/**
+ * @brief  渐变完成回调，在渐变任务中执行
+ *
+ * @param  channel  完成渐变的通道
+ * @param  arg      pwm_fade_start() 传入的参数
+ */
+typedef void (*pwm_fade_done_cb_t)(uint8_t channel, void *arg);
+
+/**
+ * @brief  初始化渐变引擎并创建渐变任务
+ *
+ * @param  rate_hz  每秒更新次数，1 ~ configTICK_RATE_HZ，更新间隔取整到节拍
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE / ESP_ERR_NO_MEM
+ */
+esp_err_t pwm_fade_init(uint32_t rate_hz);
+
+/**
+ * @brief  设置高分辨率模式 (占空比时间抖动，见 pwm_dither.h)
+ *
+ * 设置后 pwm_fade_start() 的 target_duty 单位为 1/2^frac_bits us，
+ * 每次更新输出一个抖动后的整数占空比。
+ * 只能在没有渐变进行时调用。
+ * 抖动的最低频率为更新频率 / 2^frac_bits，不能低于 PWM_DITHER_FLICKER_HZ，
+ * 按 SDK 默认的 100Hz 节拍更新时只能为 0；节拍频率 (CONFIG_FREERTOS_HZ) 为 200Hz 时最多 1 位，
+ * 1000Hz 且每个节拍更新时最多 3 位。
+ *
+ * @param  frac_bits  小数位数，0 恢复普通模式，最大 pwm_dither_max_frac_bits(更新频率)
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE
+ */
+esp_err_t pwm_fade_set_resolution(uint8_t frac_bits);
+
+/**
+ * @brief  等待渐变任务退出并释放渐变引擎，不能在完成回调中调用
+ */
+esp_err_t pwm_fade_deinit(void);
+
+/**
+ * @brief  开始一个通道的渐变，会打断该通道正在进行的渐变
+ *
+ * @param  channel      通道号
+ * @param  target_duty  目标占空比
+ * @param  duration_ms  渐变时长，0 表示下一次更新时直接设置为目标值
+ * @param  curve        渐变曲线
+ * @param  done_cb      完成回调，可为 NULL
+ * @param  arg          回调参数
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE
+ */
+esp_err_t pwm_fade_start(uint8_t channel, uint32_t target_duty, uint32_t duration_ms,
+                         pwm_fade_curve_t curve, pwm_fade_done_cb_t done_cb, void *arg);
+
+/**
+ * @brief  停止通道渐变，占空比保持当前值
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG (通道号错误) / ESP_ERR_INVALID_STATE (该通道没有在渐变)
+ */
+esp_err_t pwm_fade_stop(uint8_t channel);
+
+/**
+ * @brief  返回正在渐变的通道掩码
+ */
+uint32_t pwm_fade_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PWM_FADE_H_ */
@@ -0,0 +1,353 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "driver/pwm.h"
+
+#include "led_effect.h"
+#include "pwm_batch.h"
+#include "pwm_dither.h"
+#include "pwm_fade.h"
+
+/* 渐变进度为 16.16 定点数，1 << 16 表示 100% */
+#define PWM_FADE_POS_END            (0x1 << 16)
+
+typedef struct {
+    uint32_t pos;                   /*!< 当前进度 */
+    uint32_t inc;                   /*!< 每次更新的进度增量 */
+    int32_t start_duty;
+    int32_t delta_duty;             /*!< 目标 - 起始 */
+    uint32_t cur_duty;              /*!< 高分辨率模式下为高分辨率占空比 */
+    pwm_fade_curve_t curve;
+    pwm_fade_done_cb_t done_cb;
+    void *arg;
+} pwm_fade_channel_t;
+
+typedef struct {
+    uint32_t rate_hz;               /*!< 实际更新频率 */
+    TickType_t ticks;               /*!< 更新间隔 (节拍) */
+    TaskHandle_t task;              /*!< 渐变任务，退出时清为 NULL */
+    SemaphoreHandle_t wake;         /*!< 空闲时渐变任务在此阻塞 */
+    volatile bool running;          /*!< 清除后任务退出 */
+    uint32_t active;                /*!< 正在渐变的通道掩码 */
+    uint8_t frac_bits;              /*!< 高分辨率模式的小数位数，0 为普通模式 */
+    pwm_dither_t dither;
+    pwm_fade_channel_t channel[PWM_BATCH_CH_MAX];
+} pwm_fade_obj_t;
+
+static pwm_fade_obj_t *s_fade = NULL;
+static pwm_fade_obj_t s_fade_obj;
+
+/* 进度 (0 ~ 65536) 经过曲线映射后的比例 (0 ~ 65535) */
+static inline uint32_t pwm_fade_curve_value(pwm_fade_curve_t curve, uint32_t pos)
+{
+    if(PWM_FADE_POS_END <= pos)
+    {
+        return LED_EFFECT_LUT_MAX;
+    }
+
+    switch(curve)
+    {
+        case PWM_FADE_CURVE_CIE1931:
+            return led_effect_cie1931_lut[pos >> (16 - LED_EFFECT_LUT_BITS)];
+        case PWM_FADE_CURVE_EASE:
+            // 呼吸表的前半段：0 -> 100%
+            return led_effect_breath_lut[pos >> (17 - LED_EFFECT_LUT_BITS)];
+        default:
+            return pos;
+    }
+}
+
+/* 变暗时把曲线镜像，保证亮、暗两个方向在感知上对称 */
+static inline uint32_t pwm_fade_curve_map(const pwm_fade_channel_t *ch)
+{
+    if(0 <= ch->delta_duty || PWM_FADE_CURVE_LINEAR == ch->curve || PWM_FADE_POS_END <= ch->pos)
+    {
+        return pwm_fade_curve_value(ch->curve, ch->pos);
+    }
+
+    return LED_EFFECT_LUT_MAX - pwm_fade_curve_value(ch->curve, PWM_FADE_POS_END - ch->pos);
+}
+
+/* 推进所有活动通道，一次提交 */
+static void pwm_fade_update(void)
+{
+    pwm_fade_channel_t *ch = NULL;
+    pwm_fade_done_cb_t done_cb[PWM_BATCH_CH_MAX];
+    void *done_arg[PWM_BATCH_CH_MAX];
+    uint32_t active = 0;
+    uint32_t done = 0;
+    uint32_t duty = 0;
+    uint32_t dither_mask = 0;
+    int changed = 0;
+    uint8_t i = 0;
+
+    // 其它任务可能同时调用 pwm_fade_start()/pwm_fade_stop()，计算部分在临界区中完成，驱动调用在临界区外
+    portENTER_CRITICAL();
+    active = s_fade->active;
+    for(i = 0; 0 != active; ++i, active >>= 1)
+    {
+        if(0 == (active & 0x1))
+        {
+            continue;
+        }
+
+        ch = &s_fade->channel[i];
+        ch->pos += ch->inc;
+        duty = ch->start_duty + (int32_t)(((int64_t)ch->delta_duty * pwm_fade_curve_map(ch)) >> 16);
+        if(PWM_FADE_POS_END <= ch->pos)
+        {
+            duty = ch->start_duty + ch->delta_duty;
+            done |= (0x1 << i);
+        }
+
+        if(0 != s_fade->frac_bits)
+        {
+            // 高分辨率模式：只更新目标，下面统一做抖动
+            ch->cur_duty = duty;
+            pwm_dither_set(&s_fade->dither, i, duty);
+        }
+        // 占空比没有变化时不提交，减少 pwm_start() 次数
+        else if(duty != ch->cur_duty)
+        {
+            ch->cur_duty = duty;
+            pwm_batch_set_duty(i, duty);
+            changed = 1;
+        }
+    }
+
+    // 高分辨率模式：正在渐变或含小数部分的通道，每次更新输出一个抖动后的整数占空比
+    if(0 != s_fade->frac_bits)
+    {
+        dither_mask = s_fade->active | s_fade->dither.frac_mask;
+        for(i = 0; 0 != dither_mask; ++i, dither_mask >>= 1)
+        {
+            if(0 == (dither_mask & 0x1))
+            {
+                continue;
+            }
+
+            duty = s_fade->dither.out[i];
+            if(duty != pwm_dither_step(&s_fade->dither, i))
+            {
+                pwm_batch_set_duty(i, s_fade->dither.out[i]);
+                changed = 1;
+            }
+        }
+    }
+
+    // 先清除完成标志再回调，回调中可以开始新的渐变
+    s_fade->active &= ~done;
+    for(i = 0; i < PWM_BATCH_CH_MAX; ++i)
+    {
+        done_cb[i] = s_fade->channel[i].done_cb;
+        done_arg[i] = s_fade->channel[i].arg;
+    }
+    portEXIT_CRITICAL();
+
+    // 驱动在当前 PWM 周期结束时切换到新的通道表
+    if(1 == changed)
+    {
+        pwm_batch_commit();
+    }
+
+    for(i = 0; 0 != done; ++i, done >>= 1)
+    {
+        if(0 != (done & 0x1) && NULL != done_cb[i])
+        {
+            done_cb[i](i, done_arg[i]);
+        }
+    }
+}
+
+static void pwm_fade_task(void *arg)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while(s_fade->running)
+    {
+        // 没有需要更新的通道时不再每个节拍唤醒，等待 pwm_fade_start()/pwm_fade_deinit()
+        if(0 == (s_fade->active | s_fade->dither.frac_mask))
+        {
+            xSemaphoreTake(s_fade->wake, portMAX_DELAY);
+            last_wake = xTaskGetTickCount();
+            continue;
+        }
+
+        vTaskDelayUntil(&last_wake, s_fade->ticks);
+        if(s_fade->running)
+        {
+            pwm_fade_update();
+        }
+    }
+
+    s_fade->task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t pwm_fade_init(uint32_t rate_hz)
+{
+    if(0 == rate_hz || configTICK_RATE_HZ < rate_hz)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(NULL != s_fade)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(&s_fade_obj, 0, sizeof(s_fade_obj));
+    // 更新间隔取整到节拍，渐变步数按实际频率计算
+    s_fade_obj.ticks = configTICK_RATE_HZ / rate_hz;
+    s_fade_obj.rate_hz = configTICK_RATE_HZ / s_fade_obj.ticks;
+    s_fade_obj.running = true;
+    s_fade_obj.wake = xSemaphoreCreateBinary();
+    if(NULL == s_fade_obj.wake)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    s_fade = &s_fade_obj;
+
+    if(pdPASS != xTaskCreate(pwm_fade_task, "pwm_fade", PWM_FADE_TASK_STACK, NULL, PWM_FADE_TASK_PRIO, &s_fade_obj.task))
+    {
+        vSemaphoreDelete(s_fade_obj.wake);
+        s_fade = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_fade_set_resolution(uint8_t frac_bits)
+{
+    uint32_t duty = 0;
+    esp_err_t ret = ESP_OK;
+    uint8_t i = 0;
+
+    // 渐变过程中不能切换模式
+    if(NULL == s_fade || 0 != s_fade->active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // 抖动图样的频率低于闪烁阈值时可以看到闪烁
+    if(pwm_dither_max_frac_bits(s_fade->rate_hz) < frac_bits)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL();
+    ret = pwm_dither_init(&s_fade->dither, PWM_BATCH_CH_MAX, frac_bits);
+    if(ESP_OK == ret)
+    {
+        s_fade->frac_bits = frac_bits;
+        // 以驱动当前的占空比作为起点
+        for(i = 0; i < PWM_BATCH_CH_MAX && ESP_OK == pwm_get_duty(i, &duty); ++i)
+        {
+            pwm_dither_set(&s_fade->dither, i, duty << frac_bits);
+            s_fade->dither.out[i] = duty;
+        }
+    }
+    portEXIT_CRITICAL();
+
+    return ret;
+}
+
+esp_err_t pwm_fade_deinit(void)
+{
+    // 不能在完成回调 (渐变任务) 中调用
+    if(NULL == s_fade || xTaskGetCurrentTaskHandle() == s_fade->task)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 等待任务在下一次更新时退出，驱动调用不会被打断
+    s_fade->running = false;
+    xSemaphoreGive(s_fade->wake);
+    while(NULL != s_fade->task)
+    {
+        vTaskDelay(1);
+    }
+    vSemaphoreDelete(s_fade->wake);
+    s_fade = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_fade_start(uint8_t channel, uint32_t target_duty, uint32_t duration_ms,
+                         pwm_fade_curve_t curve, pwm_fade_done_cb_t done_cb, void *arg)
+{
+    pwm_fade_channel_t *ch = NULL;
+    uint32_t steps = 0;
+    uint32_t cur_duty = 0;
+
+    if(NULL == s_fade)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(PWM_BATCH_CH_MAX <= channel || PWM_FADE_CURVE_MAX <= curve || ESP_OK != pwm_get_duty(channel, &cur_duty))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 高分辨率模式下从当前的高分辨率目标开始
+    if(0 != s_fade->frac_bits)
+    {
+        cur_duty = s_fade->dither.duty[channel];
+    }
+
+    // 渐变步数，至少 1 步
+    steps = (uint64_t)duration_ms * s_fade->rate_hz / 1000;
+    if(0 == steps)
+    {
+        steps = 1;
+    }
+
+    // 渐变任务同时在更新通道，临界区保护
+    portENTER_CRITICAL();
+    ch = &s_fade->channel[channel];
+    ch->pos = 0;
+    ch->inc = (PWM_FADE_POS_END + steps - 1) / steps;
+    ch->start_duty = cur_duty;
+    ch->delta_duty = (int32_t)target_duty - (int32_t)cur_duty;
+    ch->cur_duty = cur_duty;
+    ch->curve = curve;
+    ch->done_cb = done_cb;
+    ch->arg = arg;
+    s_fade->active |= (0x1 << channel);
+    portEXIT_CRITICAL();
+    xSemaphoreGive(s_fade->wake);
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_fade_stop(uint8_t channel)
+{
+    esp_err_t ret = ESP_OK;
+
+    if(PWM_BATCH_CH_MAX <= channel)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(NULL == s_fade)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL();
+    if(0 == (s_fade->active & (0x1 << channel)))
+    {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    s_fade->active &= ~(0x1 << channel);
+    portEXIT_CRITICAL();
+
+    return ret;
+}
+
+uint32_t pwm_fade_active(void)
+{
+    return (NULL == s_fade) ? 0 : s_fade->active;
+}
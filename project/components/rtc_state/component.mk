@@ -0,0 +1,7 @@
+#
+# rtc_state 组件
+#
+# 深度睡眠前把运行状态带校验保存在 RTC 用户内存中，唤醒后恢复，不需要重新探测与初始化设备
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
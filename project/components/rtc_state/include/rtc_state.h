@@ -0,0 +1,53 @@
+/**
+ * 深度睡眠的状态快照
+ *
+ * 深度睡眠时 RAM 掉电，唤醒后从头启动，只有 RTC 用户内存 (0x60001200 起 512 字节) 保持。
+ * 睡眠前把应用需要延续的状态 (设备配置是否完成、时间基准、记录写入位置、标定结果等) 连同版本与 CRC 写入 RTC 内存，
+ * 唤醒后读回，校验通过时跳过设备探测与初始化，直接开始采样；上电或 CRC 不匹配时按冷启动处理。
+ *
+ * 格式 (按 32 位字访问，RTC 内存不支持字节写)：
+ *   字 0：'R' 'S' 版本 0，字 1：u16 数据长度，u16 CRC16 (字 0 ~ 数据长度，同 sample_codec_crc16)，之后为数据
+ * 版本由应用定义，快照结构改变时加 1，旧快照按没有快照处理。
+ * RTC 用户内存由本组件独占，不要同时使用 RTC_DATA_ATTR。
+ */
+#ifndef _RTC_STATE_H_
+#define _RTC_STATE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RTC_STATE_MEM_SIZE          (512)
+#define RTC_STATE_HEADER            (8)
+/* 快照数据的最大长度 */
+#define RTC_STATE_DATA_MAX          (RTC_STATE_MEM_SIZE - RTC_STATE_HEADER)
+
+/**
+ * @brief  保存快照，深度睡眠前调用
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_SIZE (超过 RTC_STATE_DATA_MAX)
+ */
+esp_err_t rtc_state_save(uint8_t version, const void *data, size_t len);
+
+/**
+ * @brief  读取快照，长度与版本都要与保存时相同
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_NOT_FOUND (没有快照：上电、版本或长度不同) / ESP_ERR_INVALID_CRC
+ */
+esp_err_t rtc_state_load(uint8_t version, void *data, size_t len);
+
+/**
+ * @brief  清除快照，下次启动按冷启动处理
+ */
+void rtc_state_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTC_STATE_H_ */
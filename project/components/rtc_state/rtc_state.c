@@ -0,0 +1,114 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "sample_codec.h"
+#include "rtc_state.h"
+
+#define RTC_STATE_MAGIC0            ('R')
+#define RTC_STATE_MAGIC1            ('S')
+
+#if defined(__XTENSA__)
+/* RTC 用户内存，与 SDK 链接脚本中的 rtc_seg 相同 */
+#define RTC_STATE_MEM               ((volatile uint32_t *)0x60001200)
+#else
+volatile uint32_t *sim_rtc_mem(void);
+
+#define RTC_STATE_MEM               (sim_rtc_mem())
+#endif
+
+static uint32_t rtc_state_magic(uint8_t version)
+{
+    return RTC_STATE_MAGIC0 | ((uint32_t)RTC_STATE_MAGIC1 << 8) | ((uint32_t)version << 16);
+}
+
+/* 按字节计算 CRC，字按小端展开 */
+static uint16_t rtc_state_crc_word(uint16_t crc, uint32_t word)
+{
+    uint8_t bytes[4];
+
+    bytes[0] = (uint8_t)word;
+    bytes[1] = (uint8_t)(word >> 8);
+    bytes[2] = (uint8_t)(word >> 16);
+    bytes[3] = (uint8_t)(word >> 24);
+
+    return sample_codec_crc16(crc, bytes, sizeof(bytes));
+}
+
+esp_err_t rtc_state_save(uint8_t version, const void *data, size_t len)
+{
+    volatile uint32_t *mem = RTC_STATE_MEM;
+    const uint8_t *src = data;
+    uint32_t word = 0;
+    uint16_t crc = 0;
+    size_t i = 0;
+    size_t n = 0;
+
+    if(NULL == data || 0 == len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(RTC_STATE_DATA_MAX < len)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    crc = rtc_state_crc_word(0xFFFF, rtc_state_magic(version));
+    crc = sample_codec_crc16(crc, src, len);
+
+    // 数据不一定按字对齐，逐字拼好再写入，最后一个字不足的部分补 0
+    for(i = 0; i < len; i += 4)
+    {
+        n = (4 < len - i) ? 4 : len - i;
+        word = 0;
+        memcpy(&word, &src[i], n);
+        mem[RTC_STATE_HEADER / 4 + i / 4] = word;
+    }
+    mem[1] = (uint32_t)len | ((uint32_t)crc << 16);
+    // 头最后写入，写入中途复位时快照无效
+    mem[0] = rtc_state_magic(version);
+
+    return ESP_OK;
+}
+
+esp_err_t rtc_state_load(uint8_t version, void *data, size_t len)
+{
+    volatile uint32_t *mem = RTC_STATE_MEM;
+    uint8_t *dst = data;
+    uint32_t word = 0;
+    uint16_t crc = 0;
+    size_t i = 0;
+    size_t n = 0;
+
+    if(NULL == data || 0 == len || RTC_STATE_DATA_MAX < len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(rtc_state_magic(version) != mem[0] || len != (mem[1] & 0xFFFF))
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    for(i = 0; i < len; i += 4)
+    {
+        n = (4 < len - i) ? 4 : len - i;
+        word = mem[RTC_STATE_HEADER / 4 + i / 4];
+        memcpy(&dst[i], &word, n);
+    }
+
+    crc = rtc_state_crc_word(0xFFFF, mem[0]);
+    crc = sample_codec_crc16(crc, dst, len);
+    if(crc != (uint16_t)(mem[1] >> 16))
+    {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    return ESP_OK;
+}
+
+void rtc_state_clear(void)
+{
+    volatile uint32_t *mem = RTC_STATE_MEM;
+
+    mem[0] = 0;
+    mem[1] = 0;
+}
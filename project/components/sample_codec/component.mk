@@ -0,0 +1,7 @@
+#
+# sample_codec 组件
+#
+# 带时间戳的多通道采样记录的紧凑二进制格式：通道描述、差分 + zig-zag 变长整数编码、每块 CRC16
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
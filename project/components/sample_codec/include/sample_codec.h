@@ -0,0 +1,137 @@
+/**
+ * 采样记录的紧凑二进制格式
+ *
+ * 日志文本 ("Accel X: %d") 约为数据本身的 10 倍，本组件把带时间戳的多通道采样编码成块，
+ * 用于 AT24C32 中保存历史数据或通过串口传输，主机端用 tools/sample_decode 解码。
+ *
+ * 数据流由块组成，每个块可以单独校验与解码 (小端)：
+ *   u8 类型 ('S' 通道描述 / 'D' 数据)，u8 负载长度 len，len 字节负载，u16 CRC16 (类型 ~ 负载)
+ *
+ * 通道描述块负载：u8 版本，u8 通道数 n，n 个通道：i8 小数位数，u8 名称长度，名称 (不含 '\0')
+ *   数值 = 整数值 / 10^小数位数；描述的 id 为其 CRC16 的低 8 位，数据块中用 id 对应通道描述
+ *
+ * 数据块负载：u8 描述 id，u8 采样数 count，count 个采样：
+ *   时间戳 (ms)：第一个采样为绝对值，之后为与前一个采样的差，无符号变长整数
+ *   n 个通道：第一个采样为绝对值，之后为与前一个采样的差，zig-zag 后的无符号变长整数
+ * 变长整数每字节 7 位，低位在前，最高位为 1 表示后面还有字节；zig-zag 把 0, -1, 1, -2 ... 映射为 0, 1, 2, 3 ...，
+ * 变化缓慢的通道每个采样只占 1 字节。差值按 32 位回绕计算，任何 int32 序列都可以无损还原。
+ *
+ * CRC16 为 CRC-16/CCITT-FALSE (多项式 0x1021，初值 0xFFFF)，按半字节查表，表只有 16 项 (32 字节)。
+ */
+#ifndef _SAMPLE_CODEC_H_
+#define _SAMPLE_CODEC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SAMPLE_CODEC_VERSION        (1)
+
+#define SAMPLE_CODEC_TYPE_SCHEMA    ('S')
+#define SAMPLE_CODEC_TYPE_DATA      ('D')
+
+#define SAMPLE_CODEC_CHANNEL_MAX    (16)
+#define SAMPLE_CODEC_NAME_MAX       (11)
+
+/* 块头 (类型、长度) 与 CRC */
+#define SAMPLE_CODEC_BLOCK_HEADER   (2)
+#define SAMPLE_CODEC_BLOCK_CRC      (2)
+/* 块的最大长度 */
+#define SAMPLE_CODEC_BLOCK_MAX      (SAMPLE_CODEC_BLOCK_HEADER + 255 + SAMPLE_CODEC_BLOCK_CRC)
+/* 一个采样编码后的最大长度 */
+#define SAMPLE_CODEC_SAMPLE_MAX(n)  (5 * (1 + (n)))
+
+typedef struct {
+    char name[SAMPLE_CODEC_NAME_MAX + 1];
+    int8_t decimals;                /*!< 小数位数 */
+} sample_codec_channel_t;
+
+typedef struct {
+    uint8_t id;                     /*!< sample_codec_schema_pack() 时计算 */
+    uint8_t num;                    /*!< 通道数 */
+    sample_codec_channel_t channels[SAMPLE_CODEC_CHANNEL_MAX];
+} sample_codec_schema_t;
+
+typedef struct {
+    uint8_t *buf;
+    uint16_t size;                  /*!< 缓冲区大小，即块的最大长度 */
+    uint16_t len;                   /*!< 已写入的长度 (不含 CRC) */
+    uint8_t num;                    /*!< 通道数 */
+    uint8_t count;                  /*!< 块中的采样数 */
+    uint32_t last_ms;
+    int32_t last[SAMPLE_CODEC_CHANNEL_MAX];
+} sample_codec_enc_t;
+
+/**
+ * 解码得到一个采样
+ */
+typedef void (*sample_codec_sample_cb_t)(uint32_t timestamp_ms, const int32_t *values, uint8_t num, void *arg);
+
+/**
+ * @brief  计算 CRC-16/CCITT-FALSE，crc 为初值 (0xFFFF) 或上一段的结果
+ */
+uint16_t sample_codec_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief  通道描述打包成块，并计算 schema->id
+ *
+ * @return 块长度，缓冲区不够或描述无效时返回 0
+ */
+size_t sample_codec_schema_pack(sample_codec_schema_t *schema, uint8_t *buf, size_t size);
+
+/**
+ * @brief  开始一个数据块
+ *
+ * @param  size  缓冲区大小，不超过 SAMPLE_CODEC_BLOCK_MAX，例如 AT24C32 的整数页
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG (缓冲区放不下一个采样)
+ */
+esp_err_t sample_codec_enc_begin(sample_codec_enc_t *enc, const sample_codec_schema_t *schema,
+                                 uint8_t *buf, size_t size);
+
+/**
+ * @brief  向数据块中加入一个采样，values 为 schema 的 num 个通道
+ *
+ * @return ESP_OK / ESP_ERR_NO_MEM (块已满，本采样没有写入，应结束本块后在新块中重新加入)
+ */
+esp_err_t sample_codec_enc_add(sample_codec_enc_t *enc, uint32_t timestamp_ms, const int32_t *values);
+
+/**
+ * @brief  结束数据块，写入长度与 CRC
+ *
+ * @return 块长度，块中没有采样时返回 0
+ */
+size_t sample_codec_enc_finish(sample_codec_enc_t *enc);
+
+/**
+ * @brief  检查 buf 开头的块
+ *
+ * @param  block_len  块长度，可以为 NULL
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_SIZE (数据不完整) / ESP_ERR_INVALID_ARG (未知类型) / ESP_ERR_INVALID_CRC
+ */
+esp_err_t sample_codec_block_check(const uint8_t *buf, size_t len, size_t *block_len);
+
+/**
+ * @brief  解析通道描述块，块应已通过 sample_codec_block_check()
+ */
+esp_err_t sample_codec_schema_unpack(const uint8_t *block, size_t len, sample_codec_schema_t *schema);
+
+/**
+ * @brief  解码数据块，每个采样调用一次 callback，块应已通过 sample_codec_block_check()
+ *
+ * @return ESP_OK / ESP_ERR_NOT_FOUND (描述 id 不匹配) / ESP_ERR_INVALID_SIZE (负载不完整)
+ */
+esp_err_t sample_codec_data_decode(const uint8_t *block, size_t len, const sample_codec_schema_t *schema,
+                                   sample_codec_sample_cb_t callback, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SAMPLE_CODEC_H_ */
@@ -0,0 +1,359 @@
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "sample_codec.h"
+
+/* 数据块负载头：描述 id、采样数 */
+#define SAMPLE_CODEC_DATA_HEADER    (2)
+#define SAMPLE_CODEC_PAYLOAD_MAX    (255)
+
+static const uint16_t s_crc_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t sample_codec_crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    for(i = 0; i < len; ++i)
+    {
+        crc = (crc << 4) ^ s_crc_table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ s_crc_table[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+
+    return crc;
+}
+
+/* 写入变长整数，放不下时返回 0 */
+static size_t sample_codec_put_varint(uint8_t *buf, size_t size, uint32_t value)
+{
+    size_t n = 0;
+
+    while(0x80 <= value)
+    {
+        if(n >= size)
+        {
+            return 0;
+        }
+        buf[n++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    if(n >= size)
+    {
+        return 0;
+    }
+    buf[n++] = (uint8_t)value;
+
+    return n;
+}
+
+/* 读取变长整数，数据不完整或超过 5 字节时返回 0 */
+static size_t sample_codec_get_varint(const uint8_t *buf, size_t len, uint32_t *value)
+{
+    uint32_t v = 0;
+    size_t n = 0;
+
+    while(n < len && n < 5)
+    {
+        v |= (uint32_t)(buf[n] & 0x7F) << (7 * n);
+        if(0 == (buf[n++] & 0x80))
+        {
+            *value = v;
+            return n;
+        }
+    }
+
+    return 0;
+}
+
+static uint32_t sample_codec_zigzag(uint32_t delta)
+{
+    return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+static uint32_t sample_codec_unzigzag(uint32_t value)
+{
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+/* 写入块头与 CRC，返回块长度 */
+static size_t sample_codec_seal(uint8_t *buf, uint8_t type, size_t payload_len)
+{
+    uint16_t crc = 0;
+    size_t len = SAMPLE_CODEC_BLOCK_HEADER + payload_len;
+
+    buf[0] = type;
+    buf[1] = (uint8_t)payload_len;
+    crc = sample_codec_crc16(0xFFFF, buf, len);
+    buf[len] = (uint8_t)crc;
+    buf[len + 1] = (uint8_t)(crc >> 8);
+
+    return len + SAMPLE_CODEC_BLOCK_CRC;
+}
+
+size_t sample_codec_schema_pack(sample_codec_schema_t *schema, uint8_t *buf, size_t size)
+{
+    size_t len = SAMPLE_CODEC_BLOCK_HEADER;
+    size_t name_len = 0;
+    size_t block_len = 0;
+    uint8_t i = 0;
+
+    if(NULL == schema || NULL == buf || 0 == schema->num || SAMPLE_CODEC_CHANNEL_MAX < schema->num)
+    {
+        return 0;
+    }
+
+    if(len + 2 + SAMPLE_CODEC_BLOCK_CRC > size)
+    {
+        return 0;
+    }
+    buf[len++] = SAMPLE_CODEC_VERSION;
+    buf[len++] = schema->num;
+    for(i = 0; i < schema->num; ++i)
+    {
+        name_len = strnlen(schema->channels[i].name, SAMPLE_CODEC_NAME_MAX);
+        if(len + 2 + name_len + SAMPLE_CODEC_BLOCK_CRC > size
+           || len + 2 + name_len > SAMPLE_CODEC_BLOCK_HEADER + SAMPLE_CODEC_PAYLOAD_MAX)
+        {
+            return 0;
+        }
+        buf[len++] = (uint8_t)schema->channels[i].decimals;
+        buf[len++] = (uint8_t)name_len;
+        memcpy(&buf[len], schema->channels[i].name, name_len);
+        len += name_len;
+    }
+
+    block_len = sample_codec_seal(buf, SAMPLE_CODEC_TYPE_SCHEMA, len - SAMPLE_CODEC_BLOCK_HEADER);
+    schema->id = buf[len];
+
+    return block_len;
+}
+
+esp_err_t sample_codec_enc_begin(sample_codec_enc_t *enc, const sample_codec_schema_t *schema,
+                                 uint8_t *buf, size_t size)
+{
+    if(NULL == enc || NULL == schema || NULL == buf || 0 == schema->num || SAMPLE_CODEC_CHANNEL_MAX < schema->num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(SAMPLE_CODEC_BLOCK_MAX < size)
+    {
+        size = SAMPLE_CODEC_BLOCK_MAX;
+    }
+    // 至少放得下一个采样，保证每个块都能写入
+    if(SAMPLE_CODEC_BLOCK_HEADER + SAMPLE_CODEC_DATA_HEADER + SAMPLE_CODEC_SAMPLE_MAX(schema->num)
+       + SAMPLE_CODEC_BLOCK_CRC > size)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    enc->buf = buf;
+    enc->size = (uint16_t)size;
+    enc->num = schema->num;
+    enc->count = 0;
+    enc->buf[SAMPLE_CODEC_BLOCK_HEADER] = schema->id;
+    enc->len = SAMPLE_CODEC_BLOCK_HEADER + SAMPLE_CODEC_DATA_HEADER;
+
+    return ESP_OK;
+}
+
+esp_err_t sample_codec_enc_add(sample_codec_enc_t *enc, uint32_t timestamp_ms, const int32_t *values)
+{
+    uint8_t *p = &enc->buf[enc->len];
+    size_t room = enc->size - enc->len - SAMPLE_CODEC_BLOCK_CRC;
+    size_t n = 0;
+    size_t len = 0;
+    uint8_t i = 0;
+
+    if(UINT8_MAX == enc->count)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 写入失败时 enc->len 与上一个采样不变，本采样整体丢弃
+    if(0 == enc->count)
+    {
+        len = sample_codec_put_varint(p, room, timestamp_ms);
+        for(i = 0; i < enc->num && 0 != len; ++i)
+        {
+            n = sample_codec_put_varint(p + len, room - len, sample_codec_zigzag((uint32_t)values[i]));
+            len = (0 == n) ? 0 : len + n;
+        }
+    }
+    else
+    {
+        len = sample_codec_put_varint(p, room, timestamp_ms - enc->last_ms);
+        for(i = 0; i < enc->num && 0 != len; ++i)
+        {
+            n = sample_codec_put_varint(p + len, room - len,
+                                        sample_codec_zigzag((uint32_t)values[i] - (uint32_t)enc->last[i]));
+            len = (0 == n) ? 0 : len + n;
+        }
+    }
+    if(0 == len)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    enc->len += len;
+    enc->count++;
+    enc->last_ms = timestamp_ms;
+    memcpy(enc->last, values, enc->num * sizeof(int32_t));
+
+    return ESP_OK;
+}
+
+size_t sample_codec_enc_finish(sample_codec_enc_t *enc)
+{
+    if(0 == enc->count)
+    {
+        return 0;
+    }
+
+    enc->buf[SAMPLE_CODEC_BLOCK_HEADER + 1] = enc->count;
+
+    return sample_codec_seal(enc->buf, SAMPLE_CODEC_TYPE_DATA, enc->len - SAMPLE_CODEC_BLOCK_HEADER);
+}
+
+esp_err_t sample_codec_block_check(const uint8_t *buf, size_t len, size_t *block_len)
+{
+    size_t total = 0;
+    uint16_t crc = 0;
+
+    if(SAMPLE_CODEC_BLOCK_HEADER > len)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if(SAMPLE_CODEC_TYPE_SCHEMA != buf[0] && SAMPLE_CODEC_TYPE_DATA != buf[0])
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    total = SAMPLE_CODEC_BLOCK_HEADER + buf[1] + SAMPLE_CODEC_BLOCK_CRC;
+    if(total > len)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    crc = sample_codec_crc16(0xFFFF, buf, total - SAMPLE_CODEC_BLOCK_CRC);
+    if(buf[total - 2] != (uint8_t)crc || buf[total - 1] != (uint8_t)(crc >> 8))
+    {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    if(NULL != block_len)
+    {
+        *block_len = total;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t sample_codec_schema_unpack(const uint8_t *block, size_t len, sample_codec_schema_t *schema)
+{
+    const uint8_t *p = &block[SAMPLE_CODEC_BLOCK_HEADER];
+    const uint8_t *end = NULL;
+    uint8_t i = 0;
+
+    if(SAMPLE_CODEC_BLOCK_HEADER + SAMPLE_CODEC_BLOCK_CRC > len
+       || SAMPLE_CODEC_BLOCK_HEADER + block[1] + SAMPLE_CODEC_BLOCK_CRC > len)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if(SAMPLE_CODEC_TYPE_SCHEMA != block[0] || 2 > block[1])
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(SAMPLE_CODEC_VERSION != p[0])
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    end = p + block[1];
+    if(0 == p[1] || SAMPLE_CODEC_CHANNEL_MAX < p[1])
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    memset(schema, 0, sizeof(sample_codec_schema_t));
+    schema->num = p[1];
+    p += 2;
+    for(i = 0; i < schema->num; ++i)
+    {
+        if(2 > end - p || 2 + p[1] > end - p || SAMPLE_CODEC_NAME_MAX < p[1])
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        schema->channels[i].decimals = (int8_t)p[0];
+        memcpy(schema->channels[i].name, &p[2], p[1]);
+        p += 2 + p[1];
+    }
+    schema->id = end[0];
+
+    return ESP_OK;
+}
+
+esp_err_t sample_codec_data_decode(const uint8_t *block, size_t len, const sample_codec_schema_t *schema,
+                                   sample_codec_sample_cb_t callback, void *arg)
+{
+    const uint8_t *p = &block[SAMPLE_CODEC_BLOCK_HEADER];
+    size_t remain = 0;
+    uint32_t timestamp_ms = 0;
+    uint32_t value = 0;
+    int32_t values[SAMPLE_CODEC_CHANNEL_MAX];
+    uint8_t count = 0;
+    size_t n = 0;
+    uint8_t i = 0;
+    uint8_t k = 0;
+
+    if(SAMPLE_CODEC_BLOCK_HEADER + SAMPLE_CODEC_BLOCK_CRC > len
+       || SAMPLE_CODEC_BLOCK_HEADER + block[1] + SAMPLE_CODEC_BLOCK_CRC > len)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    remain = block[1];
+    if(SAMPLE_CODEC_TYPE_DATA != block[0] || SAMPLE_CODEC_DATA_HEADER > remain)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(NULL == schema || schema->id != p[0])
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    count = p[1];
+    p += SAMPLE_CODEC_DATA_HEADER;
+    remain -= SAMPLE_CODEC_DATA_HEADER;
+    memset(values, 0, sizeof(values));
+    for(k = 0; k < count; ++k)
+    {
+        // 第一个采样的时间戳与数值从 0 开始累加，即绝对值
+        n = sample_codec_get_varint(p, remain, &value);
+        if(0 == n)
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        p += n;
+        remain -= n;
+        timestamp_ms += value;
+
+        for(i = 0; i < schema->num; ++i)
+        {
+            n = sample_codec_get_varint(p, remain, &value);
+            if(0 == n)
+            {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            p += n;
+            remain -= n;
+            values[i] = (int32_t)((uint32_t)values[i] + sample_codec_unzigzag(value));
+        }
+
+        if(NULL != callback)
+        {
+            callback(timestamp_ms, values, schema->num, arg);
+        }
+    }
+
+    return (0 == remain) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
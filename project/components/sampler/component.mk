@@ -0,0 +1,7 @@
+#
+# sampler 组件
+#
+# 传感器采样调度：一个任务按截止时间顺序读取多个传感器，合并成带时间戳的记录
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
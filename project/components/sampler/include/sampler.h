@@ -0,0 +1,131 @@
+/**
+ * 传感器采样调度
+ *
+ * 原来每个传感器一个任务、一个 2KB 的栈，各自用 vTaskDelay() 控制周期，延时从上一次读取结束算起，
+ * 周期会随读取时间漂移。本组件用一个任务调度所有传感器：
+ * - 传感器登记周期、读取函数 (访问总线，读原始数据) 与解码函数 (原始数据 -> 数值)
+ * - 每个传感器的截止时间按周期累加，不随读取时间漂移；总是先执行截止时间最早的传感器
+ * - 同一时刻到期的传感器读完后合并成一条带时间戳的记录，通过回调输出，记录中保存各传感器最近一次的数值
+ * - 时间基准为 CCOUNT 扩展的 64 位微秒计数；任务用 vTaskDelay() 睡到截止时间前，
+ *   剩余时间不超过 spin_us 时忙等待，得到比节拍 (10ms) 更准确的启动时刻
+ * - 每个传感器统计：采样数、错误数、超时 (错过整个周期而跳过的次数)、启动抖动 (实际启动 - 截止时间)、执行时间
+ */
+#ifndef _SAMPLER_H_
+#define _SAMPLER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SAMPLER_SENSOR_MAX          (8)
+/* 记录中所有传感器的数值总数 */
+#define SAMPLER_VALUES_MAX          (16)
+/* 读取函数的原始数据缓冲区大小，所有传感器共用 */
+#define SAMPLER_RAW_MAX             (32)
+
+typedef struct {
+    uint64_t timestamp_us;          /*!< 本条记录的时刻 (最后一个传感器读完) */
+    uint32_t updated;               /*!< 本条记录中更新的传感器，按 id 的位图 */
+    uint32_t valid;                 /*!< 至少成功读取过一次的传感器 */
+    uint64_t sensor_us[SAMPLER_SENSOR_MAX];     /*!< 各传感器最近一次成功读取的时刻 */
+    int32_t values[SAMPLER_VALUES_MAX];         /*!< 各传感器的数值，位置见 sampler_values() */
+} sampler_record_t;
+
+/**
+ * 读取原始数据，在采样任务中执行
+ */
+typedef esp_err_t (*sampler_read_t)(void *ctx, uint8_t *raw);
+
+/**
+ * 原始数据 -> 数值，values 指向记录中该传感器的 value_num 个数值
+ */
+typedef void (*sampler_decode_t)(void *ctx, const uint8_t *raw, int32_t *values);
+
+/**
+ * 记录回调，在采样任务中执行，返回后 record 仍然有效但内容会被下一次更新覆盖
+ */
+typedef void (*sampler_record_cb_t)(const sampler_record_t *record, void *arg);
+
+typedef struct {
+    const char *name;
+    uint32_t period_ms;             /*!< 采样周期 */
+    uint32_t offset_ms;             /*!< 第一次采样相对启动的延时，错开同周期的传感器 */
+    uint8_t raw_len;                /*!< 原始数据长度，不超过 SAMPLER_RAW_MAX */
+    uint8_t value_num;              /*!< 解码后的数值个数 */
+    sampler_read_t read;
+    sampler_decode_t decode;
+    void *ctx;                      /*!< 传给 read/decode */
+} sampler_sensor_config_t;
+
+typedef struct {
+    uint32_t samples;               /*!< 成功的采样数 */
+    uint32_t errors;                /*!< 读取失败数 */
+    uint32_t overruns;              /*!< 错过整个周期而跳过的采样数 */
+    uint32_t jitter_avg_us;         /*!< 平均启动抖动 */
+    uint32_t jitter_max_us;         /*!< 最大启动抖动 */
+    uint32_t exec_avg_us;           /*!< 平均执行时间 (读取 + 解码) */
+    uint32_t exec_max_us;           /*!< 最大执行时间 */
+} sampler_stats_t;
+
+typedef struct {
+    uint32_t stack;                 /*!< 采样任务栈大小 */
+    UBaseType_t prio;               /*!< 采样任务优先级 */
+    uint32_t spin_us;               /*!< 截止时间前不超过此时间时忙等待，0 只按节拍睡眠 */
+    sampler_record_cb_t callback;
+    void *arg;                      /*!< 传给 callback */
+} sampler_config_t;
+
+#define SAMPLER_DEFAULT_CONFIG() {  \
+    .stack = 2048,                  \
+    .prio = 10,                     \
+    .spin_us = 0,                   \
+    .callback = NULL,               \
+    .arg = NULL,                    \
+}
+
+/**
+ * @brief  登记传感器，必须在 sampler_start() 之前调用
+ *
+ * @param  id  传感器编号，用于 sampler_values()、记录的位图与统计
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_NO_MEM (传感器或数值个数超出) / ESP_ERR_INVALID_STATE (已启动)
+ */
+esp_err_t sampler_add(const sampler_sensor_config_t *config, uint8_t *id);
+
+/**
+ * @brief  创建采样任务，开始调度
+ */
+esp_err_t sampler_start(const sampler_config_t *config);
+
+/**
+ * @brief  记录中传感器 id 的数值
+ */
+const int32_t *sampler_values(const sampler_record_t *record, uint8_t id);
+
+/**
+ * @brief  传感器名
+ */
+const char *sampler_name(uint8_t id);
+
+/**
+ * @brief  读取传感器统计
+ */
+esp_err_t sampler_get_stats(uint8_t id, sampler_stats_t *stats);
+
+/**
+ * @brief  清零传感器统计
+ */
+void sampler_reset_stats(uint8_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SAMPLER_H_ */
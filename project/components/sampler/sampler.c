@@ -0,0 +1,319 @@
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ccount.h"
+#include "sampler.h"
+
+#define SAMPLER_TICK_US             (portTICK_RATE_MS * 1000)
+/* 最长睡眠节拍数，保证 CCOUNT 回绕 (80MHz 约 53s) 前至少读一次 */
+#define SAMPLER_SLEEP_MAX_TICKS     (10000 / portTICK_RATE_MS)
+
+typedef struct {
+    sampler_sensor_config_t config;
+    uint8_t value_offset;           /*!< 在记录 values 中的位置 */
+    uint64_t period_us;
+    uint64_t deadline_us;
+    uint32_t samples;
+    uint32_t errors;
+    uint32_t overruns;
+    uint64_t jitter_sum_us;
+    uint32_t jitter_max_us;
+    uint64_t exec_sum_us;
+    uint32_t exec_max_us;
+} sampler_sensor_t;
+
+typedef struct {
+    sampler_config_t config;
+    sampler_sensor_t sensors[SAMPLER_SENSOR_MAX];
+    uint8_t num;
+    uint8_t value_num;
+    bool started;
+    uint32_t last_ccount;
+    uint64_t cycles;                /*!< 启动以来的 CPU 周期数 */
+    sampler_record_t record;
+    uint8_t raw[SAMPLER_RAW_MAX];
+} sampler_t;
+
+static sampler_t s_sampler;
+
+/* 64 位微秒时间，只在采样任务中调用 */
+static uint64_t sampler_now_us(void)
+{
+    uint32_t now = ccount_get();
+
+    s_sampler.cycles += (uint32_t)(now - s_sampler.last_ccount);
+    s_sampler.last_ccount = now;
+
+    return s_sampler.cycles / CCOUNT_CPU_MHZ;
+}
+
+/**
+ * 等待到截止时间
+ *
+ * vTaskDelay(n) 在第 n 个节拍边界唤醒，距现在 (n-1) ~ n 个节拍，按剩余时间向下取整不会睡过截止时间；
+ * 剩余不到一个节拍时，spin_us 足够就忙等待，否则再睡一个节拍 (最多晚一个节拍)
+ */
+static void sampler_wait(uint64_t deadline_us)
+{
+    uint64_t now = 0;
+    uint64_t remain = 0;
+    uint64_t ticks = 0;
+
+    for(;;)
+    {
+        now = sampler_now_us();
+        if(now >= deadline_us)
+        {
+            return;
+        }
+
+        remain = deadline_us - now;
+        if(remain <= s_sampler.config.spin_us)
+        {
+            while(sampler_now_us() < deadline_us)
+            {
+            }
+            return;
+        }
+
+        ticks = remain / SAMPLER_TICK_US;
+        if(0 == ticks)
+        {
+            ticks = 1;
+        }
+        else if(SAMPLER_SLEEP_MAX_TICKS < ticks)
+        {
+            ticks = SAMPLER_SLEEP_MAX_TICKS;
+        }
+        vTaskDelay((TickType_t)ticks);
+    }
+}
+
+/* 截止时间最早的传感器，only_due 时只在已到期且本轮还没执行过的传感器中选 */
+static sampler_sensor_t *sampler_earliest(uint64_t now, bool only_due, uint32_t done)
+{
+    sampler_sensor_t *earliest = NULL;
+    sampler_sensor_t *sensor = NULL;
+    uint8_t i = 0;
+
+    for(i = 0; i < s_sampler.num; ++i)
+    {
+        sensor = &s_sampler.sensors[i];
+        if(only_due && (sensor->deadline_us > now || 0 != (done & (1UL << i))))
+        {
+            continue;
+        }
+        if(NULL == earliest || sensor->deadline_us < earliest->deadline_us)
+        {
+            earliest = sensor;
+        }
+    }
+
+    return earliest;
+}
+
+static void sampler_run(sampler_sensor_t *sensor, uint8_t id)
+{
+    sampler_record_t *record = &s_sampler.record;
+    uint64_t start = sampler_now_us();
+    uint64_t now = 0;
+    uint64_t late = 0;
+    uint32_t jitter = (uint32_t)(start - sensor->deadline_us);
+    uint32_t exec = 0;
+
+    if(ESP_OK == sensor->config.read(sensor->config.ctx, s_sampler.raw))
+    {
+        if(NULL != sensor->config.decode)
+        {
+            sensor->config.decode(sensor->config.ctx, s_sampler.raw, &record->values[sensor->value_offset]);
+        }
+        ++sensor->samples;
+        record->updated |= 1UL << id;
+        record->valid |= 1UL << id;
+        record->sensor_us[id] = sampler_now_us();
+    }
+    else
+    {
+        ++sensor->errors;
+    }
+
+    now = sampler_now_us();
+    exec = (uint32_t)(now - start);
+
+    sensor->jitter_sum_us += jitter;
+    if(jitter > sensor->jitter_max_us)
+    {
+        sensor->jitter_max_us = jitter;
+    }
+    sensor->exec_sum_us += exec;
+    if(exec > sensor->exec_max_us)
+    {
+        sensor->exec_max_us = exec;
+    }
+
+    // 截止时间按周期累加；落后超过整个周期时跳过错过的采样，计入超时
+    sensor->deadline_us += sensor->period_us;
+    if(now > sensor->deadline_us)
+    {
+        late = (now - sensor->deadline_us) / sensor->period_us;
+        sensor->overruns += (uint32_t)late;
+        sensor->deadline_us += late * sensor->period_us;
+    }
+}
+
+static void sampler_task(void *arg)
+{
+    sampler_sensor_t *sensor = NULL;
+    uint64_t now = 0;
+    uint32_t done = 0;
+    uint8_t id = 0;
+
+    for(;;)
+    {
+        sensor = sampler_earliest(0, false, 0);
+        sampler_wait(sensor->deadline_us);
+
+        // 执行所有已到期的传感器，每个最多一次，先执行截止时间早的
+        s_sampler.record.updated = 0;
+        done = 0;
+        now = sampler_now_us();
+        while(NULL != (sensor = sampler_earliest(now, true, done)))
+        {
+            id = sensor - s_sampler.sensors;
+            sampler_run(sensor, id);
+            done |= 1UL << id;
+            now = sampler_now_us();
+        }
+
+        if(0 != s_sampler.record.updated && NULL != s_sampler.config.callback)
+        {
+            s_sampler.record.timestamp_us = now;
+            s_sampler.config.callback(&s_sampler.record, s_sampler.config.arg);
+        }
+    }
+}
+
+esp_err_t sampler_add(const sampler_sensor_config_t *config, uint8_t *id)
+{
+    sampler_sensor_t *sensor = NULL;
+
+    if(NULL == config || NULL == config->read || 0 == config->period_ms || SAMPLER_RAW_MAX < config->raw_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(s_sampler.started)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(SAMPLER_SENSOR_MAX <= s_sampler.num || SAMPLER_VALUES_MAX < s_sampler.value_num + config->value_num)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    sensor = &s_sampler.sensors[s_sampler.num];
+    memset(sensor, 0, sizeof(sampler_sensor_t));
+    sensor->config = *config;
+    sensor->value_offset = s_sampler.value_num;
+    sensor->period_us = (uint64_t)config->period_ms * 1000;
+    s_sampler.value_num += config->value_num;
+
+    if(NULL != id)
+    {
+        *id = s_sampler.num;
+    }
+    ++s_sampler.num;
+
+    return ESP_OK;
+}
+
+esp_err_t sampler_start(const sampler_config_t *config)
+{
+    uint8_t i = 0;
+
+    if(NULL == config || 0 == s_sampler.num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(s_sampler.started)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_sampler.config = *config;
+    s_sampler.last_ccount = ccount_get();
+    s_sampler.cycles = 0;
+    for(i = 0; i < s_sampler.num; ++i)
+    {
+        s_sampler.sensors[i].deadline_us = (uint64_t)s_sampler.sensors[i].config.offset_ms * 1000;
+    }
+
+    s_sampler.started = true;
+    if(pdPASS != xTaskCreate(sampler_task, "sampler", config->stack, NULL, config->prio, NULL))
+    {
+        s_sampler.started = false;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+const int32_t *sampler_values(const sampler_record_t *record, uint8_t id)
+{
+    if(NULL == record || s_sampler.num <= id)
+    {
+        return NULL;
+    }
+
+    return &record->values[s_sampler.sensors[id].value_offset];
+}
+
+const char *sampler_name(uint8_t id)
+{
+    return (s_sampler.num <= id || NULL == s_sampler.sensors[id].config.name) ? "?" : s_sampler.sensors[id].config.name;
+}
+
+esp_err_t sampler_get_stats(uint8_t id, sampler_stats_t *stats)
+{
+    sampler_sensor_t *sensor = NULL;
+    uint32_t runs = 0;
+
+    if(s_sampler.num <= id || NULL == stats)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sensor = &s_sampler.sensors[id];
+    runs = sensor->samples + sensor->errors;
+    stats->samples = sensor->samples;
+    stats->errors = sensor->errors;
+    stats->overruns = sensor->overruns;
+    stats->jitter_avg_us = (0 == runs) ? 0 : (uint32_t)(sensor->jitter_sum_us / runs);
+    stats->jitter_max_us = sensor->jitter_max_us;
+    stats->exec_avg_us = (0 == runs) ? 0 : (uint32_t)(sensor->exec_sum_us / runs);
+    stats->exec_max_us = sensor->exec_max_us;
+
+    return ESP_OK;
+}
+
+void sampler_reset_stats(uint8_t id)
+{
+    sampler_sensor_t *sensor = NULL;
+
+    if(s_sampler.num <= id)
+    {
+        return;
+    }
+
+    sensor = &s_sampler.sensors[id];
+    sensor->samples = 0;
+    sensor->errors = 0;
+    sensor->overruns = 0;
+    sensor->jitter_sum_us = 0;
+    sensor->jitter_max_us = 0;
+    sensor->exec_sum_us = 0;
+    sensor->exec_max_us = 0;
+}
@@ -0,0 +1,7 @@
+#
+# stats_window 组件
+#
+# 多通道滚动统计：翻滚/滑动窗口的最小值、最大值、均值、标准差，每个采样 O(1) 更新，内存与窗口内的采样数无关
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
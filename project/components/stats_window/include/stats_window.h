@@ -0,0 +1,106 @@
+/**
+ * 多通道滚动统计
+ *
+ * 传感器读数逐个输出后丢弃，要得到每分钟、每小时的最小值/最大值/均值/标准差，不能保存全部原始采样。
+ * 本组件对每个通道同时维护几个时间窗口的统计，窗口结束时通过回调输出一条记录：
+ * - 翻滚窗口：长度 L，按 L 的整数倍对齐，互不重叠
+ * - 滑动窗口：长度 L、步长 H (L 是 H 的整数倍)，每 H 输出一次最近 L 的统计
+ *
+ * 窗口按步长分段 (翻滚窗口只有一段)：每个采样只更新当前段的和、平方和、最小值、最大值 (O(1))；
+ * 一段结束时把这一段加入窗口的和、减去移出窗口的最老一段 (64 位整数，加减精确，没有累积误差)，
+ * 最小值/最大值用单调队列按段维护 (均摊 O(1))。均值与标准差只在输出时计算一次。
+ * 每个通道的内存为 L/H 段，与窗口内的采样数无关：1 小时的滑动窗口按 1 分钟步长为 60 段，
+ * 采样率是 1Hz 还是 1kHz 都一样。
+ *
+ * 时间戳为毫秒 (例如 xTaskGetTickCount() * portTICK_RATE_MS)，不能回退；窗口 [start_ms, end_ms) 内有采样时才输出，
+ * 长时间没有采样时跳过中间的空窗口。
+ * 采样值的绝对值不超过 2^20、一个窗口不超过 2^23 个采样时 64 位累加不会溢出。
+ *
+ * 只做计算，不依赖硬件，可以在主机上运行：与暴力计算的比较见 tools/stats_window_sim。
+ */
+#ifndef _STATS_WINDOW_H_
+#define _STATS_WINDOW_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STATS_WINDOW_CHANNEL_MAX    (8)
+/* 一个实例最多的窗口数 */
+#define STATS_WINDOW_MAX            (4)
+/* 滑动窗口 length_ms / hop_ms 的上限 */
+#define STATS_WINDOW_PANES_MAX      (240)
+/* 均值与标准差的倍数：输出为采样值单位的 1/100 */
+#define STATS_WINDOW_SCALE          (100)
+
+typedef struct {
+    uint32_t length_ms;
+    uint32_t hop_ms;                /*!< 0 或等于 length_ms 为翻滚窗口 */
+} stats_window_spec_t;
+
+typedef struct {
+    int32_t min;
+    int32_t max;
+    int32_t mean;                   /*!< x STATS_WINDOW_SCALE，四舍五入 */
+    int32_t std;                    /*!< 样本标准差 (除以 n - 1) x STATS_WINDOW_SCALE，少于 2 个采样时为 0 */
+} stats_window_stat_t;
+
+typedef struct {
+    uint8_t window;                 /*!< 窗口在配置中的序号 */
+    uint8_t num;                    /*!< 通道数 */
+    uint32_t start_ms;              /*!< 窗口 [start_ms, end_ms) */
+    uint32_t end_ms;
+    uint32_t count;                 /*!< 窗口内的采样数 */
+    stats_window_stat_t stats[STATS_WINDOW_CHANNEL_MAX];
+} stats_window_record_t;
+
+/**
+ * 窗口结束，在 stats_window_add()/stats_window_advance() 中调用
+ */
+typedef void (*stats_window_cb_t)(const stats_window_record_t *record, void *arg);
+
+typedef struct stats_window *stats_window_handle_t;
+
+/**
+ * @brief  创建统计实例，全部内存一次分配
+ *
+ * @param  num       通道数，1 ~ STATS_WINDOW_CHANNEL_MAX
+ * @param  specs     各窗口的长度与步长，最多 STATS_WINDOW_MAX 个
+ * @param  callback  窗口结束时的回调
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_NO_MEM
+ */
+esp_err_t stats_window_create(uint8_t num, const stats_window_spec_t *specs, uint8_t spec_num,
+                              stats_window_cb_t callback, void *arg, stats_window_handle_t *handle);
+
+void stats_window_delete(stats_window_handle_t handle);
+
+/**
+ * @brief  加入一个采样，先输出在 timestamp_ms 之前结束的窗口
+ *
+ * @param  values  num 个通道的值
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG (时间戳早于当前段，采样丢弃)
+ */
+esp_err_t stats_window_add(stats_window_handle_t handle, uint32_t timestamp_ms, const int32_t *values);
+
+/**
+ * @brief  没有采样时推进时间，输出在 timestamp_ms 之前结束的窗口
+ */
+void stats_window_advance(stats_window_handle_t handle, uint32_t timestamp_ms);
+
+/**
+ * @brief  实例占用的内存字节数
+ */
+size_t stats_window_mem_size(stats_window_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _STATS_WINDOW_H_ */
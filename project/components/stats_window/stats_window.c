@@ -0,0 +1,342 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "int_math.h"
+#include "stats_window.h"
+
+/* 一段或一个窗口中一个通道的和与平方和，整数精确累加 */
+typedef struct {
+    int64_t sum;
+    uint64_t sum2;
+} stats_window_sum_t;
+
+/* 单调队列的一项：段序号与该段的最小值或最大值 */
+typedef struct {
+    uint32_t seq;
+    int32_t value;
+} stats_window_mono_t;
+
+/* 单调队列，存放在 panes 项的环形缓冲区中 */
+typedef struct {
+    uint16_t head;
+    uint16_t len;
+} stats_window_deque_t;
+
+typedef struct {
+    uint32_t hop_ms;
+    uint16_t panes;                 /*!< 窗口的段数，翻滚窗口为 1 */
+    uint32_t seq;                   /*!< 当前段的序号 = 时间 / hop_ms */
+    uint32_t cur_n;                 /*!< 当前段的采样数 */
+    uint32_t total_n;               /*!< 窗口内已结束的段的采样数 */
+    uint32_t *pane_n;               /*!< [panes] 已结束的段的采样数，按序号取模存放 */
+    stats_window_sum_t *cur;        /*!< [num] */
+    int32_t *cur_min;               /*!< [num] */
+    int32_t *cur_max;               /*!< [num] */
+    stats_window_sum_t *total;      /*!< [num] */
+    stats_window_sum_t *pane;       /*!< [panes][num] */
+    stats_window_mono_t *min_q;     /*!< [num][panes] 段最小值递增 */
+    stats_window_mono_t *max_q;     /*!< [num][panes] 段最大值递减 */
+    stats_window_deque_t *min_d;    /*!< [num] */
+    stats_window_deque_t *max_d;    /*!< [num] */
+} stats_window_win_t;
+
+struct stats_window {
+    uint8_t num;
+    uint8_t win_num;
+    bool started;
+    stats_window_cb_t callback;
+    void *arg;
+    size_t size;
+    stats_window_win_t win[STATS_WINDOW_MAX];
+    stats_window_record_t record;
+};
+
+/* 按 8 字节对齐分配，64 位成员放在前面 */
+#define STATS_WINDOW_ALIGN(n)       (((n) + 7) & ~(size_t)7)
+
+/* 样本标准差 x STATS_WINDOW_SCALE */
+static int32_t stats_window_std(const stats_window_sum_t *s, uint32_t n)
+{
+    int64_t q = 0;
+    int64_t r = 0;
+    uint64_t r2 = 0;
+    uint64_t c = 0;
+    uint64_t f = 0;
+    uint64_t m2 = 0;
+    uint64_t scale2 = (uint64_t)STATS_WINDOW_SCALE * STATS_WINDOW_SCALE;
+
+    if(2 > n)
+    {
+        return 0;
+    }
+
+    // 偏差平方和 M2 = sum2 - sum^2 / n，sum = q * n + r 展开，避免 sum^2 溢出；
+    // r^2 / n 向上取整，M2 = m2 + f / n，小数部分保留到方差中，采样少、方差小时也不损失精度
+    q = s->sum / n;
+    r = s->sum % n;
+    r2 = (uint64_t)(r * r);
+    c = (r2 + n - 1) / n;
+    f = c * n - r2;
+    m2 = s->sum2 - (uint64_t)(q * q) * n - (uint64_t)(2 * q * r) - c;
+
+    // 方差 x scale^2 = (m2 + f / n) x scale^2 / (n - 1)，整数部分与余数分开计算
+    return (int32_t)int_math_isqrt64(m2 / (n - 1) * scale2 + (m2 % (n - 1) * scale2 + f * scale2 / n) / (n - 1));
+}
+
+static void stats_window_deque_push(stats_window_mono_t *q, stats_window_deque_t *d, uint16_t size,
+                                    uint32_t seq, int32_t value, bool is_min)
+{
+    stats_window_mono_t *back = NULL;
+
+    // 从队尾移除不会再成为最值的段：更早且不比新段更优
+    while(0 < d->len)
+    {
+        back = &q[(d->head + d->len - 1) % size];
+        if(is_min ? (back->value < value) : (back->value > value))
+        {
+            break;
+        }
+        --d->len;
+    }
+    back = &q[(d->head + d->len) % size];
+    back->seq = seq;
+    back->value = value;
+    ++d->len;
+}
+
+static void stats_window_deque_expire(stats_window_mono_t *q, stats_window_deque_t *d, uint16_t size, uint32_t oldest)
+{
+    while(0 < d->len && q[d->head].seq < oldest)
+    {
+        d->head = (d->head + 1) % size;
+        --d->len;
+    }
+}
+
+static void stats_window_emit(stats_window_handle_t handle, uint8_t index)
+{
+    stats_window_win_t *win = &handle->win[index];
+    stats_window_record_t *record = &handle->record;
+    stats_window_stat_t *stat = NULL;
+    uint8_t c = 0;
+
+    record->window = index;
+    record->num = handle->num;
+    record->end_ms = (win->seq + 1) * win->hop_ms;
+    // 开始后不满一个窗口长度时从 0 算起
+    record->start_ms = (win->seq + 1 >= win->panes) ? record->end_ms - win->panes * win->hop_ms : 0;
+    record->count = win->total_n;
+    for(c = 0; c < handle->num; ++c)
+    {
+        stat = &record->stats[c];
+        stat->min = win->min_q[c * win->panes + win->min_d[c].head].value;
+        stat->max = win->max_q[c * win->panes + win->max_d[c].head].value;
+        stat->mean = int_math_div_round(win->total[c].sum * STATS_WINDOW_SCALE, win->total_n);
+        stat->std = stats_window_std(&win->total[c], win->total_n);
+    }
+
+    handle->callback(record, handle->arg);
+}
+
+/* 当前段结束：加入窗口，移出最老的一段，窗口内有采样时输出 */
+static void stats_window_close(stats_window_handle_t handle, uint8_t index)
+{
+    stats_window_win_t *win = &handle->win[index];
+    uint16_t slot = win->seq % win->panes;
+    stats_window_sum_t *old = &win->pane[slot * handle->num];
+    uint32_t oldest = (win->seq + 1 >= win->panes) ? win->seq + 1 - win->panes : 0;
+    uint8_t c = 0;
+
+    win->total_n += win->cur_n - win->pane_n[slot];
+    win->pane_n[slot] = win->cur_n;
+    for(c = 0; c < handle->num; ++c)
+    {
+        win->total[c].sum += win->cur[c].sum - old[c].sum;
+        win->total[c].sum2 += win->cur[c].sum2 - old[c].sum2;
+        old[c] = win->cur[c];
+
+        stats_window_deque_expire(&win->min_q[c * win->panes], &win->min_d[c], win->panes, oldest);
+        stats_window_deque_expire(&win->max_q[c * win->panes], &win->max_d[c], win->panes, oldest);
+        if(0 < win->cur_n)
+        {
+            stats_window_deque_push(&win->min_q[c * win->panes], &win->min_d[c], win->panes,
+                                    win->seq, win->cur_min[c], true);
+            stats_window_deque_push(&win->max_q[c * win->panes], &win->max_d[c], win->panes,
+                                    win->seq, win->cur_max[c], false);
+        }
+    }
+
+    if(0 < win->total_n)
+    {
+        stats_window_emit(handle, index);
+    }
+
+    memset(win->cur, 0, handle->num * sizeof(stats_window_sum_t));
+    win->cur_n = 0;
+    ++win->seq;
+}
+
+static void stats_window_advance_win(stats_window_handle_t handle, uint8_t index, uint32_t seq)
+{
+    stats_window_win_t *win = &handle->win[index];
+
+    while(win->seq < seq)
+    {
+        // 窗口内已经没有采样：之后的段都是空的，不输出，直接跳到 seq
+        if(0 == win->total_n && 0 == win->cur_n)
+        {
+            win->seq = seq;
+            break;
+        }
+        stats_window_close(handle, index);
+    }
+}
+
+esp_err_t stats_window_create(uint8_t num, const stats_window_spec_t *specs, uint8_t spec_num,
+                              stats_window_cb_t callback, void *arg, stats_window_handle_t *handle)
+{
+    struct stats_window *new_handle = NULL;
+    stats_window_win_t *win = NULL;
+    uint32_t hop_ms = 0;
+    uint16_t panes[STATS_WINDOW_MAX];
+    size_t size = STATS_WINDOW_ALIGN(sizeof(struct stats_window));
+    uint8_t *p = NULL;
+    uint8_t i = 0;
+
+    if(0 == num || STATS_WINDOW_CHANNEL_MAX < num || NULL == specs || 0 == spec_num || STATS_WINDOW_MAX < spec_num
+       || NULL == callback || NULL == handle)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for(i = 0; i < spec_num; ++i)
+    {
+        hop_ms = (0 == specs[i].hop_ms) ? specs[i].length_ms : specs[i].hop_ms;
+        if(0 == hop_ms || 0 != specs[i].length_ms % hop_ms || STATS_WINDOW_PANES_MAX < specs[i].length_ms / hop_ms)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        panes[i] = specs[i].length_ms / hop_ms;
+        size += STATS_WINDOW_ALIGN(num * (3 + panes[i]) * sizeof(stats_window_sum_t)
+                                   + 2 * num * panes[i] * sizeof(stats_window_mono_t)
+                                   + panes[i] * sizeof(uint32_t) + 2 * num * sizeof(int32_t)
+                                   + 2 * num * sizeof(stats_window_deque_t));
+    }
+
+    new_handle = calloc(1, size);
+    if(NULL == new_handle)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    new_handle->num = num;
+    new_handle->win_num = spec_num;
+    new_handle->callback = callback;
+    new_handle->arg = arg;
+    new_handle->size = size;
+
+    // 各窗口的数组紧跟在结构之后
+    p = (uint8_t *)new_handle + STATS_WINDOW_ALIGN(sizeof(struct stats_window));
+    for(i = 0; i < spec_num; ++i)
+    {
+        win = &new_handle->win[i];
+        win->hop_ms = specs[i].length_ms / panes[i];
+        win->panes = panes[i];
+        win->cur = (stats_window_sum_t *)p;
+        win->total = win->cur + num;
+        win->pane = win->total + num;
+        p = (uint8_t *)(win->pane + num * panes[i]);
+        win->min_q = (stats_window_mono_t *)p;
+        win->max_q = win->min_q + num * panes[i];
+        p = (uint8_t *)(win->max_q + num * panes[i]);
+        win->pane_n = (uint32_t *)p;
+        win->cur_min = (int32_t *)(win->pane_n + panes[i]);
+        win->cur_max = win->cur_min + num;
+        win->min_d = (stats_window_deque_t *)(win->cur_max + num);
+        win->max_d = win->min_d + num;
+        p = (uint8_t *)STATS_WINDOW_ALIGN((size_t)(win->max_d + num));
+    }
+
+    *handle = new_handle;
+
+    return ESP_OK;
+}
+
+void stats_window_delete(stats_window_handle_t handle)
+{
+    free(handle);
+}
+
+esp_err_t stats_window_add(stats_window_handle_t handle, uint32_t timestamp_ms, const int32_t *values)
+{
+    stats_window_win_t *win = NULL;
+    uint8_t i = 0;
+    uint8_t c = 0;
+
+    if(NULL == handle || NULL == values)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 第一个采样确定各窗口的起始段
+    if(!handle->started)
+    {
+        handle->started = true;
+        for(i = 0; i < handle->win_num; ++i)
+        {
+            handle->win[i].seq = timestamp_ms / handle->win[i].hop_ms;
+        }
+    }
+    for(i = 0; i < handle->win_num; ++i)
+    {
+        if(timestamp_ms / handle->win[i].hop_ms < handle->win[i].seq)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    stats_window_advance(handle, timestamp_ms);
+
+    for(i = 0; i < handle->win_num; ++i)
+    {
+        win = &handle->win[i];
+        for(c = 0; c < handle->num; ++c)
+        {
+            win->cur[c].sum += values[c];
+            win->cur[c].sum2 += (uint64_t)((int64_t)values[c] * values[c]);
+            if(0 == win->cur_n || values[c] < win->cur_min[c])
+            {
+                win->cur_min[c] = values[c];
+            }
+            if(0 == win->cur_n || values[c] > win->cur_max[c])
+            {
+                win->cur_max[c] = values[c];
+            }
+        }
+        ++win->cur_n;
+    }
+
+    return ESP_OK;
+}
+
+void stats_window_advance(stats_window_handle_t handle, uint32_t timestamp_ms)
+{
+    uint8_t i = 0;
+
+    if(NULL == handle || !handle->started)
+    {
+        return;
+    }
+
+    for(i = 0; i < handle->win_num; ++i)
+    {
+        stats_window_advance_win(handle, i, timestamp_ms / handle->win[i].hop_ms);
+    }
+}
+
+size_t stats_window_mem_size(stats_window_handle_t handle)
+{
+    return (NULL == handle) ? 0 : handle->size;
+}
@@ -0,0 +1,7 @@
+#
+# telemetry 组件
+#
+# 运行时内存监测：任务栈高水位、空闲堆、最小空闲堆、最大空闲块与按任务统计的分配次数
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
@@ -0,0 +1,102 @@
+/**
+ * 运行时内存监测
+ *
+ * 周期性采样：
+ * - 已登记任务的栈高水位 uxTaskGetStackHighWaterMark()，即运行以来剩余栈的最小值
+ * - 空闲堆、运行以来的最小空闲堆
+ * - 最大空闲块 heap_caps_get_largest_free_block()，遍历空闲链表，不分配内存，反映碎片程度
+ * - 按任务统计的分配/释放次数与分配字节数，由 alloc_hook 组件的回调计入当前任务，
+ *   未登记的任务与中断中的分配 (xPortInIsrContext()) 计入 "other"
+ *
+ * 分配按任务而不是按子系统统计：本工程的子系统 (i2c_bus、各传感器任务、uart_link 等) 各自运行在
+ * 自己的任务中，登记子系统的任务即得到该子系统的分配次数；同一任务中调用的多个组件不再细分，
+ * 例如传感器任务中 stats_window 的分配计入该传感器任务。
+ *
+ * 栈大小与高水位的单位与 xTaskCreate() 的栈大小参数相同，可以直接用来调整任务栈。
+ *
+ * 结果用 ESP_LOGI 输出为表格，或用 telemetry_pack() 打包成紧凑的二进制记录 (小端)：
+ *   u8 'T'，u8 版本，u8 任务数 n，u32 运行时间 ms，u32 空闲堆，u32 最小空闲堆，u32 最大空闲块，
+ *   n 个任务 (最后一个为 other)：u16 剩余栈，u32 分配次数，u32 释放次数，u32 分配字节数
+ */
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TELEMETRY_TASK_MAX          (8)
+
+#define TELEMETRY_PACK_MAGIC        ('T')
+#define TELEMETRY_PACK_VERSION      (1)
+#define TELEMETRY_PACK_HEADER_LEN   (19)
+#define TELEMETRY_PACK_TASK_LEN     (14)
+/* 打包后的最大长度：登记的任务加上 other */
+#define TELEMETRY_PACK_MAX          (TELEMETRY_PACK_HEADER_LEN + (TELEMETRY_TASK_MAX + 1) * TELEMETRY_PACK_TASK_LEN)
+
+typedef struct {
+    const char *name;
+    uint32_t stack_depth;           /*!< 创建时的栈大小，other 为 0 */
+    uint32_t stack_free;            /*!< 栈高水位 */
+    uint32_t allocs;                /*!< 运行以来的分配次数 */
+    uint32_t frees;                 /*!< 运行以来的释放次数 */
+    uint32_t alloc_bytes;           /*!< 运行以来请求分配的字节数 */
+} telemetry_task_t;
+
+typedef struct {
+    uint32_t uptime_ms;
+    uint32_t free_heap;
+    uint32_t min_free_heap;
+    uint32_t largest_block;
+    uint8_t num;                    /*!< tasks 中的个数，最后一个为 other */
+    telemetry_task_t tasks[TELEMETRY_TASK_MAX + 1];
+} telemetry_snapshot_t;
+
+/**
+ * @brief  登记任务，开始统计其栈高水位与分配次数
+ *
+ * @param  stack_depth  创建任务时的栈大小，用于计算使用率
+ */
+esp_err_t telemetry_task_add(TaskHandle_t task, uint32_t stack_depth);
+
+/**
+ * @brief  创建任务并登记，参数与 xTaskCreate() 相同
+ */
+esp_err_t telemetry_task_create(TaskFunction_t func, const char *name, uint32_t stack_depth, void *arg,
+                                UBaseType_t prio, TaskHandle_t *handle);
+
+/**
+ * @brief  采样一次
+ */
+esp_err_t telemetry_sample(telemetry_snapshot_t *snap);
+
+/**
+ * @brief  用 ESP_LOGI 输出一次采样结果
+ */
+void telemetry_log(const telemetry_snapshot_t *snap);
+
+/**
+ * @brief  打包成二进制记录
+ *
+ * @return 写入的字节数，缓冲区不够时返回 0
+ */
+size_t telemetry_pack(const telemetry_snapshot_t *snap, uint8_t *buf, size_t len);
+
+/**
+ * @brief  创建监测任务，每 period_ms 采样并输出一次，监测任务自身也被登记
+ */
+esp_err_t telemetry_start(uint32_t period_ms, UBaseType_t prio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TELEMETRY_H_ */
@@ -0,0 +1,253 @@
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+
+#include "alloc_hook.h"
+#include "telemetry.h"
+
+#define TELEMETRY_TASK_STACK        (2048)
+
+typedef struct {
+    TaskHandle_t handle;
+    const char *name;
+    uint32_t stack_depth;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t alloc_bytes;
+} telemetry_entry_t;
+
+static const char *TAG = "telemetry";
+
+/* 最后一项为 other */
+static telemetry_entry_t s_entries[TELEMETRY_TASK_MAX + 1];
+static volatile uint8_t s_num = 0;
+static uint32_t s_period_ms = 0;
+
+/* 在 malloc/free 的上下文中执行：线性查找当前任务，最多 TELEMETRY_TASK_MAX 次比较 */
+static void telemetry_alloc_hook(size_t size, bool is_free)
+{
+    TaskHandle_t current = NULL;
+    telemetry_entry_t *entry = &s_entries[TELEMETRY_TASK_MAX];
+    uint8_t num = s_num;
+    uint8_t i = 0;
+
+    // 中断中的当前任务是被打断的任务，不计入该任务
+    if(!xPortInIsrContext())
+    {
+        current = xTaskGetCurrentTaskHandle();
+    }
+    for(i = 0; NULL != current && i < num; ++i)
+    {
+        if(current == s_entries[i].handle)
+        {
+            entry = &s_entries[i];
+            break;
+        }
+    }
+
+    if(is_free)
+    {
+        ++entry->frees;
+    }
+    else
+    {
+        ++entry->allocs;
+        entry->alloc_bytes += size;
+    }
+}
+
+esp_err_t telemetry_task_add(TaskHandle_t task, uint32_t stack_depth)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t i = 0;
+
+    if(NULL == task)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL();
+    for(i = 0; i < s_num; ++i)
+    {
+        if(task == s_entries[i].handle)
+        {
+            break;
+        }
+    }
+    if(i < s_num)
+    {
+        s_entries[i].stack_depth = stack_depth;
+    }
+    else if(TELEMETRY_TASK_MAX <= s_num)
+    {
+        ret = ESP_ERR_NO_MEM;
+    }
+    else
+    {
+        // 先填好再增加个数，回调中不会看到未初始化的项
+        memset(&s_entries[s_num], 0, sizeof(telemetry_entry_t));
+        s_entries[s_num].handle = task;
+        s_entries[s_num].name = pcTaskGetTaskName(task);
+        s_entries[s_num].stack_depth = stack_depth;
+        ++s_num;
+    }
+    taskEXIT_CRITICAL();
+
+    s_entries[TELEMETRY_TASK_MAX].name = "other";
+    alloc_hook_set(telemetry_alloc_hook);
+
+    return ret;
+}
+
+esp_err_t telemetry_task_create(TaskFunction_t func, const char *name, uint32_t stack_depth, void *arg,
+                                UBaseType_t prio, TaskHandle_t *handle)
+{
+    TaskHandle_t task = NULL;
+
+    if(pdPASS != xTaskCreate(func, name, stack_depth, arg, prio, &task))
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if(NULL != handle)
+    {
+        *handle = task;
+    }
+
+    return telemetry_task_add(task, stack_depth);
+}
+
+esp_err_t telemetry_sample(telemetry_snapshot_t *snap)
+{
+    telemetry_entry_t *entry = NULL;
+    telemetry_task_t *task = NULL;
+    uint8_t i = 0;
+
+    if(NULL == snap)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    snap->uptime_ms = xTaskGetTickCount() * portTICK_RATE_MS;
+    snap->free_heap = esp_get_free_heap_size();
+    snap->min_free_heap = esp_get_minimum_free_heap_size();
+    snap->largest_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+    snap->num = s_num + 1;
+    for(i = 0; i < snap->num; ++i)
+    {
+        entry = (i < s_num) ? &s_entries[i] : &s_entries[TELEMETRY_TASK_MAX];
+        task = &snap->tasks[i];
+        task->name = (NULL != entry->name) ? entry->name : "other";
+        task->stack_depth = entry->stack_depth;
+        task->stack_free = (NULL != entry->handle) ? uxTaskGetStackHighWaterMark(entry->handle) : 0;
+        task->allocs = entry->allocs;
+        task->frees = entry->frees;
+        task->alloc_bytes = entry->alloc_bytes;
+    }
+
+    return ESP_OK;
+}
+
+void telemetry_log(const telemetry_snapshot_t *snap)
+{
+    const telemetry_task_t *task = NULL;
+    uint8_t i = 0;
+
+    ESP_LOGI(TAG, "heap free: %u, min: %u, largest: %u", snap->free_heap, snap->min_free_heap, snap->largest_block);
+    ESP_LOGI(TAG, "task              stack   free  used%%   allocs    frees    bytes");
+    for(i = 0; i < snap->num; ++i)
+    {
+        task = &snap->tasks[i];
+        ESP_LOGI(TAG, "%-16s %6u %6u %5u %8u %8u %8u", task->name, task->stack_depth, task->stack_free,
+                 (0 == task->stack_depth) ? 0 : (task->stack_depth - task->stack_free) * 100 / task->stack_depth,
+                 task->allocs, task->frees, task->alloc_bytes);
+    }
+}
+
+static uint8_t *telemetry_put16(uint8_t *p, uint32_t value)
+{
+    // 超出 16 位时饱和
+    if(0xFFFF < value)
+    {
+        value = 0xFFFF;
+    }
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+
+    return p + 2;
+}
+
+static uint8_t *telemetry_put32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+
+    return p + 4;
+}
+
+size_t telemetry_pack(const telemetry_snapshot_t *snap, uint8_t *buf, size_t len)
+{
+    const telemetry_task_t *task = NULL;
+    uint8_t *p = buf;
+    uint8_t i = 0;
+
+    if(NULL == snap || NULL == buf || len < TELEMETRY_PACK_HEADER_LEN + (size_t)snap->num * TELEMETRY_PACK_TASK_LEN)
+    {
+        return 0;
+    }
+
+    *p++ = TELEMETRY_PACK_MAGIC;
+    *p++ = TELEMETRY_PACK_VERSION;
+    *p++ = snap->num;
+    p = telemetry_put32(p, snap->uptime_ms);
+    p = telemetry_put32(p, snap->free_heap);
+    p = telemetry_put32(p, snap->min_free_heap);
+    p = telemetry_put32(p, snap->largest_block);
+    for(i = 0; i < snap->num; ++i)
+    {
+        task = &snap->tasks[i];
+        p = telemetry_put16(p, task->stack_free);
+        p = telemetry_put32(p, task->allocs);
+        p = telemetry_put32(p, task->frees);
+        p = telemetry_put32(p, task->alloc_bytes);
+    }
+
+    return p - buf;
+}
+
+static void telemetry_task(void *arg)
+{
+    static telemetry_snapshot_t snap;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    for(;;)
+    {
+        vTaskDelayUntil(&last_wake, s_period_ms / portTICK_RATE_MS);
+
+        if(ESP_OK == telemetry_sample(&snap))
+        {
+            telemetry_log(&snap);
+        }
+    }
+}
+
+esp_err_t telemetry_start(uint32_t period_ms, UBaseType_t prio)
+{
+    if(0 == period_ms / portTICK_RATE_MS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_period_ms = period_ms;
+
+    return telemetry_task_create(telemetry_task, "telemetry", TELEMETRY_TASK_STACK, NULL, prio, NULL);
+}
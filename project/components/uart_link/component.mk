@@ -0,0 +1,7 @@
+#
+# uart_link 组件
+#
+# 串口二进制遥测链路：COBS 分帧、序号、CRC16，发送环形缓冲区由 TX FIFO 空中断发出
+#
+
+COMPONENT_ADD_INCLUDEDIRS := include
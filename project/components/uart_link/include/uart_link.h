@@ -0,0 +1,145 @@
+/**
+ * 串口二进制遥测链路
+ *
+ * 日志文本在 115200 波特率下每秒只能输出几百个采样，本组件把二进制数据分帧后从串口发出，
+ * 波特率可以设到 921600 或更高，主机端用 tools/uart_capture 接收、校验并保存。
+ *
+ * 帧 (编码前，小端)：u8 类型，u16 序号，负载，u16 CRC16 (类型 ~ 负载，同 sample_codec_crc16)
+ * 整帧按 COBS 编码，编码后不含 0x00，每帧以 0x00 结束。接收端从任意位置开始，遇到 0x00 即重新同步；
+ * COBS 每 254 字节最多增加 1 字节。序号每帧加 1，接收端按序号的间隔统计丢帧。
+ *
+ * 发送不阻塞：uart_link_send() 把编码后的帧写入发送环形缓冲区并打开 TX FIFO 空中断，
+ * 中断服务程序把缓冲区中的数据搬到 128 字节的硬件 FIFO，缓冲区空时关闭中断。
+ * 缓冲区放不下整帧时丢弃该帧并返回 ESP_ERR_NO_MEM，序号照常递增。
+ * 缓冲区只有一个写入者：多个任务发送时由调用者加锁。
+ *
+ * 链路独占串口：使用 UART0 时把日志改到 UART1 (menuconfig 中的 "UART for console output")，
+ * 否则日志文本夹在帧中间，所在的帧会因 CRC 错误被丢弃。
+ */
+#ifndef _UART_LINK_H_
+#define _UART_LINK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "driver/uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 帧类型约定，tools/uart_capture 按类型处理负载 */
+#define UART_LINK_TYPE_TEXT         ('T')   /*!< 文本，不含 '\0' */
+#define UART_LINK_TYPE_RECORD       ('R')   /*!< sample_codec 组件的一个块 */
+
+#define UART_LINK_HEADER            (3)
+#define UART_LINK_CRC               (2)
+#define UART_LINK_PAYLOAD_MAX       (512)
+/* 编码前帧的最大长度 */
+#define UART_LINK_FRAME_MAX         (UART_LINK_HEADER + UART_LINK_PAYLOAD_MAX + UART_LINK_CRC)
+/* 负载 len 字节的帧编码后的最大长度，含结束的 0x00 */
+#define UART_LINK_ENCODED_MAX(len)  ((UART_LINK_HEADER + (len) + UART_LINK_CRC) * 255 / 254 + 2)
+
+/* 硬件 FIFO 中的字节数低于门限时进入中断，921600 波特率下约 1ms 一次 */
+#define UART_LINK_TX_THRESH         (32)
+
+#define UART_LINK_DEFAULT_CONFIG() {    \
+    .port = UART_NUM_0,                 \
+    .baud_rate = 921600,                \
+    .tx_buf_size = 2048,                \
+}
+
+typedef struct {
+    uart_port_t port;
+    uint32_t baud_rate;
+    size_t tx_buf_size;             /*!< 发送缓冲区大小，2 的幂，至少放得下一个最大的帧 */
+} uart_link_config_t;
+
+typedef struct uart_link *uart_link_handle_t;
+
+typedef struct {
+    uint32_t frames;                /*!< 写入缓冲区的帧数 */
+    uint32_t dropped;               /*!< 缓冲区满丢弃的帧数 */
+    uint32_t bytes;                 /*!< 编码后写入缓冲区的字节数 */
+    uint32_t isr_count;             /*!< 中断次数 */
+    uint32_t buf_size;
+    uint32_t buf_peak;              /*!< 缓冲区最大占用 */
+} uart_link_stats_t;
+
+/**
+ * 接收到一个校验正确的帧
+ */
+typedef void (*uart_link_frame_cb_t)(uint8_t type, uint16_t seq, const uint8_t *payload, size_t len, void *arg);
+
+/**
+ * 接收端：COBS 解码、CRC 校验与序号检查，可以逐字节或分块输入
+ */
+typedef struct {
+    uint8_t buf[UART_LINK_FRAME_MAX];
+    size_t len;
+    uint8_t remain;                 /*!< 当前 COBS 段剩余的字节数 */
+    bool zero;                      /*!< 当前段结束后补 0x00 */
+    bool started;
+    bool overflow;
+    bool synced;                    /*!< 已收到过正确的帧，可以比较序号 */
+    uint16_t next_seq;
+    uart_link_frame_cb_t callback;
+    void *arg;
+    uint32_t frames;                /*!< 正确的帧数 */
+    uint32_t crc_errors;
+    uint32_t framing_errors;        /*!< 过长、过短或 COBS 段不完整 */
+    uint32_t lost;                  /*!< 按序号间隔计算的丢帧数 */
+    uint64_t bytes;
+} uart_link_dec_t;
+
+/**
+ * @brief  配置串口，分配发送缓冲区，登记中断服务程序
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG / ESP_ERR_NO_MEM
+ */
+esp_err_t uart_link_create(const uart_link_config_t *config, uart_link_handle_t *link);
+
+/**
+ * @brief  等待缓冲区中的数据发完后删除
+ */
+void uart_link_delete(uart_link_handle_t link);
+
+/**
+ * @brief  发送一帧，不阻塞
+ *
+ * @return ESP_OK / ESP_ERR_INVALID_ARG (负载过长) / ESP_ERR_NO_MEM (缓冲区满，丢弃)
+ */
+esp_err_t uart_link_send(uart_link_handle_t link, uint8_t type, const void *payload, size_t len);
+
+/**
+ * @brief  读取发送统计
+ */
+void uart_link_get_stats(uart_link_handle_t link, uart_link_stats_t *stats);
+
+/**
+ * @brief  编码一帧，主机端生成测试数据也用这个函数
+ *
+ * @param  size  out 的大小，至少 UART_LINK_ENCODED_MAX(len)
+ *
+ * @return 编码后的长度 (含结束的 0x00)，负载过长或 out 不够时返回 0
+ */
+size_t uart_link_frame_encode(uint8_t type, uint16_t seq, const void *payload, size_t len,
+                              uint8_t *out, size_t size);
+
+/**
+ * @brief  初始化接收端
+ */
+void uart_link_dec_init(uart_link_dec_t *dec, uart_link_frame_cb_t callback, void *arg);
+
+/**
+ * @brief  输入收到的字节，每个正确的帧调用一次回调
+ */
+void uart_link_dec_feed(uart_link_dec_t *dec, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UART_LINK_H_ */
@@ -0,0 +1,341 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp8266/uart_struct.h"
+
+#include "sample_codec.h"
+#include "uart_link.h"
+
+/* 每次访问都重新取地址，主机仿真中寄存器访问展开为函数调用 */
+#define UART_LINK_DEV(port)         ((UART_NUM_0 == (port)) ? &uart0 : &uart1)
+
+/* COBS 一段最多 254 个非 0 字节，段首为 255 */
+#define UART_LINK_COBS_BLOCK        (0xFF)
+
+struct uart_link {
+    uart_port_t port;
+    uint8_t *buf;                   /*!< 紧跟在本结构之后 */
+    uint32_t mask;
+    volatile uint32_t head;         /*!< 写入位置，只由发送者修改 */
+    volatile uint32_t tail;         /*!< 读出位置，只由中断修改 */
+    uint16_t seq;
+    uart_link_stats_t stats;
+    uint8_t frame[UART_LINK_ENCODED_MAX(UART_LINK_PAYLOAD_MAX)];
+};
+
+typedef struct {
+    uint8_t *out;
+    size_t n;
+    size_t code_pos;                /*!< 当前段段首的位置 */
+    uint8_t code;
+} uart_link_cobs_t;
+
+static void uart_link_cobs_put(uart_link_cobs_t *cobs, const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    for(i = 0; i < len; ++i)
+    {
+        if(0 != data[i])
+        {
+            cobs->out[cobs->n++] = data[i];
+            ++cobs->code;
+        }
+        // 遇到 0 或段满时结束当前段，段首写入本段长度 + 1
+        if(0 == data[i] || UART_LINK_COBS_BLOCK == cobs->code)
+        {
+            cobs->out[cobs->code_pos] = cobs->code;
+            cobs->code_pos = cobs->n++;
+            cobs->code = 1;
+        }
+    }
+}
+
+size_t uart_link_frame_encode(uint8_t type, uint16_t seq, const void *payload, size_t len,
+                              uint8_t *out, size_t size)
+{
+    uart_link_cobs_t cobs;
+    uint8_t header[UART_LINK_HEADER];
+    uint8_t crc_buf[UART_LINK_CRC];
+    uint16_t crc = 0;
+
+    if(UART_LINK_PAYLOAD_MAX < len || (NULL == payload && 0 < len) || NULL == out || UART_LINK_ENCODED_MAX(len) > size)
+    {
+        return 0;
+    }
+
+    header[0] = type;
+    header[1] = (uint8_t)seq;
+    header[2] = (uint8_t)(seq >> 8);
+    crc = sample_codec_crc16(0xFFFF, header, sizeof(header));
+    crc = sample_codec_crc16(crc, (const uint8_t *)payload, len);
+    crc_buf[0] = (uint8_t)crc;
+    crc_buf[1] = (uint8_t)(crc >> 8);
+
+    cobs.out = out;
+    cobs.n = 1;
+    cobs.code_pos = 0;
+    cobs.code = 1;
+    uart_link_cobs_put(&cobs, header, sizeof(header));
+    uart_link_cobs_put(&cobs, (const uint8_t *)payload, len);
+    uart_link_cobs_put(&cobs, crc_buf, sizeof(crc_buf));
+    out[cobs.code_pos] = cobs.code;
+    out[cobs.n++] = 0;
+
+    return cobs.n;
+}
+
+static void uart_link_isr(void *arg)
+{
+    struct uart_link *link = arg;
+    uint32_t tail = link->tail;
+    uint32_t head = link->head;
+    uint32_t room = 0;
+
+    if(!UART_LINK_DEV(link->port)->int_st.txfifo_empty)
+    {
+        return;
+    }
+
+    ++link->stats.isr_count;
+    room = UART_FIFO_LEN - UART_LINK_DEV(link->port)->status.txfifo_cnt;
+    while(0 < room && tail != head)
+    {
+        UART_LINK_DEV(link->port)->fifo.rw_byte = link->buf[tail & link->mask];
+        ++tail;
+        --room;
+    }
+    link->tail = tail;
+
+    // 缓冲区空时关闭中断，下一次发送时再打开
+    if(tail == head)
+    {
+        uart_disable_tx_intr(link->port);
+    }
+    uart_clear_intr_status(link->port, UART_TXFIFO_EMPTY_INT_CLR_M);
+}
+
+esp_err_t uart_link_create(const uart_link_config_t *config, uart_link_handle_t *link)
+{
+    struct uart_link *new_link = NULL;
+    uart_config_t uart_config = {
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+    };
+    esp_err_t ret = ESP_OK;
+
+    if(NULL == config || NULL == link || UART_NUM_MAX <= config->port || 0 == config->baud_rate
+       || 0 != (config->tx_buf_size & (config->tx_buf_size - 1))
+       || UART_LINK_ENCODED_MAX(UART_LINK_PAYLOAD_MAX) > config->tx_buf_size)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uart_config.baud_rate = config->baud_rate;
+    ret = uart_param_config(config->port, &uart_config);
+    if(ESP_OK != ret)
+    {
+        return ret;
+    }
+
+    // 链路与发送缓冲区一次分配
+    new_link = malloc(sizeof(struct uart_link) + config->tx_buf_size);
+    if(NULL == new_link)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(new_link, 0, sizeof(struct uart_link));
+    new_link->port = config->port;
+    new_link->buf = (uint8_t *)(new_link + 1);
+    new_link->mask = config->tx_buf_size - 1;
+    new_link->stats.buf_size = config->tx_buf_size;
+
+    ret = uart_isr_register(config->port, uart_link_isr, new_link);
+    if(ESP_OK != ret)
+    {
+        free(new_link);
+        return ret;
+    }
+
+    *link = new_link;
+
+    return ESP_OK;
+}
+
+void uart_link_delete(uart_link_handle_t link)
+{
+    if(NULL == link)
+    {
+        return;
+    }
+
+    while(link->tail != link->head)
+    {
+        vTaskDelay(1);
+    }
+    uart_disable_tx_intr(link->port);
+    uart_isr_register(link->port, NULL, NULL);
+    free(link);
+}
+
+esp_err_t uart_link_send(uart_link_handle_t link, uint8_t type, const void *payload, size_t len)
+{
+    uint32_t head = 0;
+    uint32_t used = 0;
+    uint32_t pos = 0;
+    size_t first = 0;
+    size_t n = 0;
+
+    if(NULL == link || UART_LINK_PAYLOAD_MAX < len || (NULL == payload && 0 < len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 丢弃的帧也占用序号，接收端由此发现丢帧
+    n = uart_link_frame_encode(type, link->seq++, payload, len, link->frame, sizeof(link->frame));
+
+    head = link->head;
+    used = head - link->tail;
+    if(n > link->mask + 1 - used)
+    {
+        ++link->stats.dropped;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 回绕时分两段复制；中断只读取 head 之前的数据，复制完成后再移动 head
+    pos = head & link->mask;
+    first = link->mask + 1 - pos;
+    if(first > n)
+    {
+        first = n;
+    }
+    memcpy(&link->buf[pos], link->frame, first);
+    memcpy(link->buf, &link->frame[first], n - first);
+
+    portENTER_CRITICAL();
+    link->head = head + n;
+    portEXIT_CRITICAL();
+
+    ++link->stats.frames;
+    link->stats.bytes += n;
+    if(used + n > link->stats.buf_peak)
+    {
+        link->stats.buf_peak = used + n;
+    }
+
+    uart_enable_tx_intr(link->port, 1, UART_LINK_TX_THRESH);
+
+    return ESP_OK;
+}
+
+void uart_link_get_stats(uart_link_handle_t link, uart_link_stats_t *stats)
+{
+    portENTER_CRITICAL();
+    *stats = link->stats;
+    portEXIT_CRITICAL();
+}
+
+void uart_link_dec_init(uart_link_dec_t *dec, uart_link_frame_cb_t callback, void *arg)
+{
+    memset(dec, 0, sizeof(uart_link_dec_t));
+    dec->callback = callback;
+    dec->arg = arg;
+}
+
+/* 收到 0x00：检查缓冲区中的一帧 */
+static void uart_link_dec_frame(uart_link_dec_t *dec)
+{
+    uint16_t crc = 0;
+    uint16_t seq = 0;
+
+    // 连续的 0x00 之间没有数据，不算错误
+    if(!dec->started)
+    {
+        return;
+    }
+    if(dec->overflow || 0 != dec->remain || UART_LINK_HEADER + UART_LINK_CRC > dec->len)
+    {
+        ++dec->framing_errors;
+        return;
+    }
+
+    crc = dec->buf[dec->len - 2] | ((uint16_t)dec->buf[dec->len - 1] << 8);
+    if(sample_codec_crc16(0xFFFF, dec->buf, dec->len - UART_LINK_CRC) != crc)
+    {
+        ++dec->crc_errors;
+        return;
+    }
+
+    seq = dec->buf[1] | ((uint16_t)dec->buf[2] << 8);
+    if(dec->synced)
+    {
+        dec->lost += (uint16_t)(seq - dec->next_seq);
+    }
+    dec->synced = true;
+    dec->next_seq = seq + 1;
+    ++dec->frames;
+
+    if(NULL != dec->callback)
+    {
+        dec->callback(dec->buf[0], seq, &dec->buf[UART_LINK_HEADER],
+                      dec->len - UART_LINK_HEADER - UART_LINK_CRC, dec->arg);
+    }
+}
+
+void uart_link_dec_feed(uart_link_dec_t *dec, const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    dec->bytes += len;
+    for(i = 0; i < len; ++i)
+    {
+        if(0 == data[i])
+        {
+            uart_link_dec_frame(dec);
+            dec->len = 0;
+            dec->remain = 0;
+            dec->zero = false;
+            dec->started = false;
+            dec->overflow = false;
+            continue;
+        }
+
+        dec->started = true;
+        if(dec->overflow)
+        {
+            continue;
+        }
+
+        // 段首：上一段不是满段时补 0x00 (最后一段之后的 0x00 不属于帧)
+        if(0 == dec->remain)
+        {
+            if(dec->zero)
+            {
+                if(sizeof(dec->buf) <= dec->len)
+                {
+                    dec->overflow = true;
+                    continue;
+                }
+                dec->buf[dec->len++] = 0;
+            }
+            dec->remain = data[i] - 1;
+            dec->zero = (UART_LINK_COBS_BLOCK != data[i]);
+            continue;
+        }
+
+        if(sizeof(dec->buf) <= dec->len)
+        {
+            dec->overflow = true;
+            continue;
+        }
+        dec->buf[dec->len++] = data[i];
+        --dec->remain;
+    }
+}
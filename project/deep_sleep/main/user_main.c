@@ -0,0 +1,335 @@
+/**
+ * 说明:
+ * 本实例展示深度睡眠占空比采样 (rtc_state 组件)
+ * 节点每 WAKE_PERIOD_S 秒醒来一次，读取 MPU6050 与 DS3231 各一个采样，用 sample_codec 编码后追加到 AT24C32 中的记录环，
+ * 运行状态保存到 RTC 用户内存后进入深度睡眠，由 DS3231 闹钟 (或 RTC 定时器) 唤醒
+ *
+ * GPIO 配置状态:
+ * GPIO14 作为主机 SDA，GPIO2 作为主机 SCL，连接 MPU6050 (AD0 接高电平，0x69) 与 DS3231 模块 (DS3231 0x68，AT24C32 0x57)
+ * DS3231 INT/SQW 经 100nF 电容接 RST，闹钟触发时的下降沿复位芯片 (INT/SQW 一直拉低到清除标志，直接接 RST 会一直复位)
+ * 改用定时器唤醒 (WAKE_BY_ALARM 为 0) 时 GPIO16 接 RST
+ *
+ * 测试:
+ * 冷启动 (上电) 时探测并初始化设备、标定 MPU6050 零偏 (AT24C32 中有标定记录时直接恢复)、记录时间基准；
+ * 之后每次唤醒从 RTC 内存恢复状态，不探测、不初始化设备，只让 MPU6050 退出睡眠，采样后重新睡眠。
+ * 每次唤醒输出复位到采样完成的时间、醒着的时间，以及按电流模型估算的平均电流与每个采样消耗的电量
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_sleep.h"
+#include "esp_err.h"
+
+#include "ccount.h"
+#include "i2c_bus.h"
+#include "mpu6050.h"
+#include "mpu6050_calib.h"
+#include "ds3231.h"
+#include "at24c32.h"
+#include "sample_codec.h"
+#include "rtc_state.h"
+
+
+static const char *TAG = "main";
+
+/* 1：DS3231 闹钟唤醒 (INT/SQW 接 RST)；0：RTC 定时器唤醒 (GPIO16 接 RST，误差约几个百分点) */
+#define WAKE_BY_ALARM				(1)
+/* 唤醒周期，闹钟只匹配秒，不超过 59 秒 */
+#define WAKE_PERIOD_S				(2)
+
+/* AT24C32：通道描述块，之后为数据块环，最后一页是 MPU6050 的标定记录 */
+#define LOG_SCHEMA_ADDR				(0)
+#define LOG_SCHEMA_SIZE				(128)
+#define LOG_DATA_ADDR				(LOG_SCHEMA_ADDR + LOG_SCHEMA_SIZE)
+#define LOG_BLOCK_SIZE				(64)
+#define LOG_BLOCKS					((MPU6050_CALIB_E2P_ADDR - LOG_DATA_ADDR) / LOG_BLOCK_SIZE)
+
+/* 快照结构改变时加 1，旧快照按冷启动处理 */
+#define STATE_VERSION				(1)
+
+/*
+电流模型 (uA)，数据手册典型值，按实测修改：
+ESP8266 唤醒后不打开射频 (esp_deep_sleep_set_rf_option(4)) 约 15mA，深度睡眠 20uA；
+MPU6050 工作 3.9mA，睡眠 5uA；DS3231 待机约 110uA (模块上的电源指示灯需要去掉)
+*/
+#define ESP_ACTIVE_UA				(15000)
+#define ESP_SLEEP_UA				(20)
+#define MPU6050_ACTIVE_UA			(3900)
+#define MPU6050_SLEEP_UA			(5)
+#define DS3231_UA					(110)
+#define ACTIVE_UA					(ESP_ACTIVE_UA + MPU6050_ACTIVE_UA + DS3231_UA)
+#define SLEEP_UA					(ESP_SLEEP_UA + MPU6050_SLEEP_UA + DS3231_UA)
+
+/* 加速度 x/y/z，角速度 x/y/z，MPU6050 温度与 DS3231 温度 (0.01°C) */
+#define VALUE_NUM					(8)
+
+/* 深度睡眠期间保存在 RTC 内存中的状态 */
+typedef struct {
+	uint32_t epoch;					/* 冷启动时 DS3231 的时间 (2000 年起的秒数)，记录的时间戳从这里算起 */
+	uint32_t wakes;					/* 冷启动以来的唤醒次数 */
+	uint32_t samples;
+	uint64_t awake_us;				/* 冷启动以来醒着的总时间 */
+	uint32_t first_us_sum;			/* 唤醒后复位到采样完成的时间，不含冷启动 */
+	uint32_t first_us_max;
+	uint16_t log_head;				/* 下一个数据块的序号 */
+	uint16_t log_blocks;			/* 写入的数据块数 */
+	mpu6050_calib_t calib;			/* 偏移寄存器丢失时恢复 */
+	sample_codec_enc_t enc;			/* 未写满的数据块，enc.buf 指向 block */
+	uint8_t block[LOG_BLOCK_SIZE];
+} node_state_t;
+
+static i2c_bus_dev_handle_t mpu6050_dev = NULL;
+static i2c_bus_dev_handle_t ds3231_dev = NULL;
+static i2c_bus_dev_handle_t at24c32_dev = NULL;
+
+static node_state_t state;
+
+static sample_codec_schema_t rec_schema = {
+	.num = VALUE_NUM,
+	.channels = {
+		{ "accel_x", 0 }, { "accel_y", 0 }, { "accel_z", 0 },
+		{ "gyro_x", 0 }, { "gyro_y", 0 }, { "gyro_z", 0 },
+		{ "mpu_temp", 2 }, { "rtc_temp", 2 },
+	},
+};
+
+static uint32_t bcd_to_int(uint8_t bcd)
+{
+	return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+/* DS3231 的时间 -> 2000-01-01 00:00:00 起的秒数 */
+static uint32_t rtc_seconds(const uint8_t regs[DS3231_REG_NUM])
+{
+	static const uint16_t days_before[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+	uint32_t year = bcd_to_int(regs[DS3231_REG_YEAR]);
+	uint32_t month = bcd_to_int(regs[DS3231_REG_MONTH] & 0x1F);
+	uint32_t days = 0;
+
+	if(1 > month || 12 < month)
+	{
+		month = 1;
+	}
+	days = year * 365 + (year + 3) / 4 + days_before[month - 1] + bcd_to_int(regs[DS3231_REG_DATE] & 0x3F) - 1;
+	if(2 < month && 0 == year % 4)
+	{
+		days++;
+	}
+
+	return days * 86400 + bcd_to_int(regs[DS3231_REG_HOUR] & 0x3F) * 3600
+		   + bcd_to_int(regs[DS3231_REG_MIN]) * 60 + bcd_to_int(regs[DS3231_REG_SEC]);
+}
+
+/* 冷启动：探测并初始化全部设备，记录重新开始 */
+static esp_err_t node_cold_init(void)
+{
+	uint8_t block[LOG_SCHEMA_SIZE];
+	uint8_t regs[DS3231_REG_NUM];
+	uint8_t who_am_i = 0;
+	uint32_t start = ccount_get();
+	bool warm = false;
+	size_t len = 0;
+	esp_err_t ret = ESP_OK;
+
+	memset(&state, 0, sizeof(state));
+
+	ret = mpu6050_who_am_i(mpu6050_dev, &who_am_i);
+	if(ESP_OK == ret && MPU6050_WHO_AM_I_VAL != who_am_i)
+	{
+		ret = ESP_ERR_NOT_FOUND;
+	}
+	if(ESP_OK == ret)
+	{
+		ret = mpu6050_init(mpu6050_dev);
+	}
+	if(ESP_OK == ret)
+	{
+		ret = mpu6050_calib_start(mpu6050_dev, at24c32_dev, MPU6050_CALIB_E2P_ADDR, MPU6050_CALIB_SAMPLES,
+								  &state.calib, &warm);
+	}
+	if(ESP_OK == ret)
+	{
+		ret = ds3231_init(ds3231_dev);
+	}
+	if(ESP_OK == ret)
+	{
+		ret = ds3231_read_all(ds3231_dev, regs);
+	}
+	if(ESP_OK == ret)
+	{
+		state.epoch = rtc_seconds(regs);
+		len = sample_codec_schema_pack(&rec_schema, block, sizeof(block));
+		ret = at24c32_write(at24c32_dev, LOG_SCHEMA_ADDR, block, len);
+	}
+	if(ESP_OK == ret)
+	{
+		ret = sample_codec_enc_begin(&state.enc, &rec_schema, state.block, sizeof(state.block));
+	}
+
+	ESP_LOGI(TAG, "cold init: error %d, calibration %s, %u us", ret, warm ? "restored" : "measured",
+			 ccount_elapsed_us(start));
+
+	return ret;
+}
+
+/* 热启动：设备保持冷启动时的配置，只让 MPU6050 退出睡眠 */
+static esp_err_t node_resume(void)
+{
+	uint8_t block[LOG_SCHEMA_SIZE];
+	esp_err_t ret = ESP_OK;
+
+	// 快照中的编码器指向上一次启动时 block 的地址；schema id 在 RAM 中，重新计算 (不写 AT24C32)
+	state.enc.buf = state.block;
+	sample_codec_schema_pack(&rec_schema, block, sizeof(block));
+
+	ret = mpu6050_set_sleep(mpu6050_dev, false);
+	if(ESP_OK != ret)
+	{
+		// MPU6050 没有应答 (例如掉过电)：重新配置，偏移寄存器用快照中的标定结果恢复
+		ESP_LOGW(TAG, "mpu6050 wake error %d, reinit", ret);
+		ret = mpu6050_init(mpu6050_dev);
+		if(ESP_OK == ret)
+		{
+			ret = mpu6050_calib_apply(mpu6050_dev, &state.calib);
+		}
+	}
+
+	return ret;
+}
+
+/* 追加到当前数据块，块满时写入 AT24C32 */
+static void log_add(uint32_t timestamp_ms, const int32_t *values)
+{
+	uint16_t addr = 0;
+	size_t len = 0;
+	esp_err_t ret = ESP_OK;
+
+	if(ESP_ERR_NO_MEM != sample_codec_enc_add(&state.enc, timestamp_ms, values))
+	{
+		return;
+	}
+
+	len = sample_codec_enc_finish(&state.enc);
+	addr = LOG_DATA_ADDR + state.log_head * LOG_BLOCK_SIZE;
+	ret = at24c32_write(at24c32_dev, addr, state.block, len);
+	ESP_LOGI(TAG, "log: block %u at 0x%03x, %u samples, %u bytes, error %d", state.log_blocks, addr,
+			 state.enc.count, (unsigned)len, ret);
+	state.log_head = (state.log_head + 1) % LOG_BLOCKS;
+	state.log_blocks++;
+
+	sample_codec_enc_begin(&state.enc, &rec_schema, state.block, sizeof(state.block));
+	sample_codec_enc_add(&state.enc, timestamp_ms, values);
+}
+
+void app_main(void)
+{
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
+	esp_reset_reason_t reason = esp_reset_reason();
+	uint8_t raw[MPU6050_RAW_LEN];
+	uint8_t regs[DS3231_REG_NUM];
+	mpu6050_raw_t data;
+	int32_t values[VALUE_NUM];
+	TickType_t wake_tick = 0;
+	uint32_t now = 0;
+	uint32_t first_us = 0;
+	uint32_t awake_us = 0;
+	uint64_t elapsed_us = 0;
+	uint64_t sleep_us = 0;
+	uint32_t cycle_ua = 0;
+	uint32_t total_ua = 0;
+	bool warm = false;
+	esp_err_t ret = ESP_OK;
+
+	// 总线与设备句柄在 RAM 中，每次启动都要重新登记，不访问设备
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(mpu6050_add(MPU6050_ADDR_AD0_HIGH, &mpu6050_dev));
+	ESP_ERROR_CHECK(ds3231_add(&ds3231_dev));
+	ESP_ERROR_CHECK(at24c32_add(AT24C32_ADDR_DS3231_MODULE, &at24c32_dev));
+
+	ret = ESP_ERR_NOT_FOUND;
+	if(ESP_RST_DEEPSLEEP == reason)
+	{
+		ret = rtc_state_load(STATE_VERSION, &state, sizeof(state));
+	}
+	if(ESP_OK == ret)
+	{
+		warm = true;
+		ESP_ERROR_CHECK(node_resume());
+	}
+	else
+	{
+		ESP_LOGI(TAG, "cold boot: reset reason %d, state error %d", reason, ret);
+		ESP_ERROR_CHECK(node_cold_init());
+	}
+
+	// 等待 MPU6050 启动的同时读取 DS3231
+	wake_tick = xTaskGetTickCount();
+	ESP_ERROR_CHECK(ds3231_read_all(ds3231_dev, regs));
+	if(warm)
+	{
+		vTaskDelayUntil(&wake_tick, MPU6050_WAKE_MS / portTICK_RATE_MS);
+	}
+	ESP_ERROR_CHECK(mpu6050_read_raw(mpu6050_dev, raw));
+	first_us = ccount_to_us(ccount_get());
+
+	mpu6050_decode(raw, &data);
+	values[0] = data.accel_x;
+	values[1] = data.accel_y;
+	values[2] = data.accel_z;
+	values[3] = data.gyro_x;
+	values[4] = data.gyro_y;
+	values[5] = data.gyro_z;
+	values[6] = mpu6050_temp_centi(data.temp);
+	values[7] = ds3231_temp_centi(regs[DS3231_REG_TEMP_MSB], regs[DS3231_REG_TEMP_LSB]);
+	now = rtc_seconds(regs) - state.epoch;
+	state.samples++;
+	ESP_LOGI(TAG, "[%5u s] accel: %6d %6d %6d  gyro: %6d %6d %6d  temp: %d.%02d %d.%02d", now,
+			 values[0], values[1], values[2], values[3], values[4], values[5],
+			 values[6] / 100, abs(values[6]) % 100, values[7] / 100, abs(values[7]) % 100);
+	log_add(now * 1000, values);
+
+	// 准备睡眠：MPU6050 睡眠，清除闹钟标志释放 INT/SQW，下一次在周期的整数倍上唤醒
+	ESP_ERROR_CHECK(mpu6050_set_sleep(mpu6050_dev, true));
+#if WAKE_BY_ALARM
+	ESP_ERROR_CHECK(ds3231_clear_alarms(ds3231_dev));
+	ESP_ERROR_CHECK(ds3231_set_alarm1_sec(ds3231_dev, (uint8_t)((bcd_to_int(regs[DS3231_REG_SEC]) + WAKE_PERIOD_S) % 60)));
+#endif
+
+	awake_us = ccount_to_us(ccount_get());
+	state.awake_us += awake_us;
+	if(warm)
+	{
+		state.wakes++;
+		state.first_us_sum += first_us;
+		if(first_us > state.first_us_max)
+		{
+			state.first_us_max = first_us;
+		}
+		ESP_LOGI(TAG, "wake %u: first sample %u us (avg %u, max %u), awake %u us", state.wakes, first_us,
+				 state.first_us_sum / state.wakes, state.first_us_max, awake_us);
+	}
+
+	// 本次的周期电流：醒着 awake_us，其余时间睡眠；累计：冷启动以来按 DS3231 的时间计
+	cycle_ua = (uint32_t)(((uint64_t)ACTIVE_UA * awake_us + (uint64_t)SLEEP_UA * (WAKE_PERIOD_S * 1000000 - awake_us))
+						  / (WAKE_PERIOD_S * 1000000));
+	elapsed_us = (uint64_t)(now + WAKE_PERIOD_S) * 1000000;
+	sleep_us = (elapsed_us > state.awake_us) ? elapsed_us - state.awake_us : 0;
+	total_ua = (uint32_t)(((uint64_t)ACTIVE_UA * state.awake_us + (uint64_t)SLEEP_UA * sleep_us) / elapsed_us);
+	ESP_LOGI(TAG, "energy: %u uA average, %u uC per sample; since cold boot %u uA, %u uC per sample (%u samples)",
+			 cycle_ua, cycle_ua * WAKE_PERIOD_S, total_ua,
+			 (uint32_t)((uint64_t)total_ua * elapsed_us / 1000000 / state.samples), state.samples);
+
+	ESP_ERROR_CHECK(rtc_state_save(STATE_VERSION, &state, sizeof(state)));
+	esp_deep_sleep_set_rf_option(4);
+#if WAKE_BY_ALARM
+	esp_deep_sleep(0);
+#else
+	esp_deep_sleep(WAKE_PERIOD_S * 1000000 - awake_us);
+#endif
+}
@@ -10,6 +10,7 @@
  *
  * 测试:
  * 如果连接上 DS3231，则读取数据
+ * 温度同时加入 stats_window 组件，每分钟输出一次最近 1 分钟与最近 10 分钟的最小值/最大值/均值/标准差
  */
 #include <stdio.h>
 #include <string.h>
@@ -23,253 +24,83 @@
 #include "esp_system.h"
 #include "esp_err.h"
 
-#include "driver/i2c.h"
-#include "driver/gpio.h"
+#include "i2c_bus.h"
+#include "ds3231.h"
+#include "stats_window.h"
 
 
 static const char *TAG = "DS3231";
 
-#define I2C_PORT_2_DS3231			I2C_NUM_0        /*!< 主机设备 IIC 端口号 */
+static i2c_bus_dev_handle_t ds3231_dev = NULL;
 
-#define DS3231_ADDR					0x68             /*!< 从机 DS3231 地址 */
-#define WRITE_BIT                   I2C_MASTER_WRITE /*!< I2C 主机写操作位 */
-#define READ_BIT                    I2C_MASTER_READ  /*!< I2C 主机读操作位 */
-#define ACK_CHECK_EN                0x1              /*!< I2C 主机确认接收从机 ACK 信号 */
-#define ACK_CHECK_DIS               0x0              /*!< I2C 主机不接收从机 ACK 信号  */
-#define ACK_VAL                     0x0              /*!< I2C ACK值 */
-#define NACK_VAL                    0x1              /*!< I2C NACK值 */
-#define LAST_NACK_VAL               0x2              /*!< I2C 末尾ACK值 */
+/* 温度，单位 0.01 摄氏度 */
+static const stats_window_spec_t stats_specs[] = {
+	{ 60 * 1000, 0 },
+	{ 10 * 60 * 1000, 60 * 1000 },
+};
 
-/**
- * DS3231 寄存器地址
- */
-#define REG_SEC					0x00
-#define REG_MIN					0x01
-#define REG_HOUR				0x02
-#define REG_DAY					0x03
-#define REG_DATE				0x04
-#define REG_MONTH				0x05
-#define REG_YEAR				0x06
-#define REG_A1_SEC				0x07
-#define REG_A1_MIN				0x08
-#define REG_A1_HOUR				0x09
-#define REG_A1_DATE				0x0A
-#define REG_A2_MIN				0x0B
-#define REG_A2_HOUR				0x0C
-#define REG_A2_DATE				0x0D
-#define REG_CTRL				0x0E
-#define REG_CTRL_STATUS			0x0F
-#define REG_AGING_OFFSET		0x10
-#define REG_TEMP_MSB			0x11
-#define REG_TEMP_LSB			0x12
-
-/* IIC 主机初始化：主机模式，GPIO */
-static esp_err_t i2c_module_init(void)
+/* 0.01 -> "-12.34" */
+static const char *centi_str(int32_t value, char *buf, size_t len)
 {
-	i2c_config_t conf;
-
-	// 主机模式
-	conf.mode = I2C_MODE_MASTER;
-	// GPIO14 -> SDA
-	conf.sda_io_num = GPIO_NUM_14;
-	// SDA 引脚上拉
-	conf.sda_pullup_en = 0;
-	// GPIO2 -> SCL
-	conf.scl_io_num = GPIO_NUM_2;
-	// SCL 引脚上拉
-	conf.scl_pullup_en = 0;
+	snprintf(buf, len, "%s%d.%02d", (0 > value) ? "-" : "", abs(value) / 100, abs(value) % 100);
 
-	// 设置 IIC 工作模式
-	ESP_ERROR_CHECK(i2c_driver_install(I2C_PORT_2_DS3231, conf.mode));
-	// 设置 IIC 引脚配置
-	ESP_ERROR_CHECK(i2c_param_config(I2C_PORT_2_DS3231, &conf));
-
-	return ESP_OK;
+	return buf;
 }
 
-/* IIC 主机发送数据 */
-static esp_err_t ds3231_write(i2c_port_t i2c_num, uint8_t reg_address,
-							   uint8_t *data, size_t data_len)
+static void stats_record(const stats_window_record_t *record, void *arg)
 {
-	int ret = 0;
-	// 创建 IIC 命令连接
-	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-
-	// 创建一个命令队列，并装载一个开始信号
-	i2c_master_start(cmd);
-	// 装载一个从机地址及写指令，ACK 应答使能
-	i2c_master_write_byte(cmd, DS3231_ADDR << 1 | WRITE_BIT, ACK_CHECK_EN);
-	// 装载从机寄存器地址，ACK应答使能
-	i2c_master_write_byte(cmd, reg_address, ACK_CHECK_EN);
-	// 装载写至从机寄存器的数据，ACK应答使能
-	i2c_master_write(cmd, data, data_len, ACK_CHECK_EN);
-	// 装载停止信号
-	i2c_master_stop(cmd);
-
-	// 发送命令队列中的数据
-	ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-	// 释放命令连接
-	i2c_cmd_link_delete(cmd);
-
-	return ret;
+	char min[16];
+	char max[16];
+	char mean[16];
+	char std[16];
+
+	// 均值与标准差为 0.01 x STATS_WINDOW_SCALE，保留两位小数
+	ESP_LOGI(TAG, "Temp %2u min: min %s max %s mean %s std %s (%u samples)",
+			 stats_specs[record->window].length_ms / 60000,
+			 centi_str(record->stats[0].min, min, sizeof(min)), centi_str(record->stats[0].max, max, sizeof(max)),
+			 centi_str(record->stats[0].mean / STATS_WINDOW_SCALE, mean, sizeof(mean)),
+			 centi_str(record->stats[0].std / STATS_WINDOW_SCALE, std, sizeof(std)), record->count);
 }
 
-/**
- * 1. IIC 主机发送待读取寄存器地址到从设备
- * 2. IIC 主机读取从机返回的数据
- */
-static esp_err_t ds3231_read(i2c_port_t i2c_num, uint8_t reg_address,
-							  uint8_t *data, size_t data_len)
-{
-	int ret;
-	// 创建 IIC 命令连接
-	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-
-	// 给从机发送读数据地址，通知其准备数据
-	// 创建一个命令队列，并装载一个开始信号
-	i2c_master_start(cmd);
-	// 装载一个从机地址及写指令，ACK 应答使能
-	i2c_master_write_byte(cmd, DS3231_ADDR << 1 | WRITE_BIT, ACK_CHECK_EN);
-	// 装载从机寄存器地址，即待读取数据的寄存器地址，ACK应答使能
-	i2c_master_write_byte(cmd, reg_address, ACK_CHECK_EN);
-	// 装载停止信号
-	i2c_master_stop(cmd);
-	// 发送命令队列中的数据
-	ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-	// 释放命令连接
-	i2c_cmd_link_delete(cmd);
-
-	// 验证读取命令是否发送成功
-	if(ret != ESP_OK)
-	{
-		return ret;
-	}
-
-	// 主机读取从机发送的数据
-	cmd = i2c_cmd_link_create();
-	// 创建一个命令队列，并装载一个开始信号
-	i2c_master_start(cmd);
-	// 装载一个从机地址及读指令，ACK 应答使能
-	i2c_master_write_byte(cmd, DS3231_ADDR << 1 | READ_BIT, ACK_CHECK_EN);
-	// 装载读取命令，待读取数据缓存区和数据长度，用于从 IIC 总线读取数据，
-	// 最后一个数据应答 NACK
-	i2c_master_read(cmd, data, data_len, LAST_NACK_VAL);
-	// 装载停止信号
-	i2c_master_stop(cmd);
-	// 发送命令队列中的数据
-	// ** 这里不好理解 **
-	// 命令队列中装载了读取的信息：缓存区和数据长度，
-	// 这里才会真正处理读取数据操作。是阻塞运行。并将读取的数据存储至缓存区
-	// 所以程序返回时，数据应该已经读取到缓存区了，可以再取出来用了
-	// 多个数据的读取，被封装在底层驱动中了
-	ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-	// 释放命令连接
-	i2c_cmd_link_delete(cmd);
-
-	return ret;
-}
-
-static void ds3231_set_datetime(uint8_t year, uint8_t mon, uint8_t day,
-								uint8_t weekday,
-								uint8_t hour, uint8_t min, uint8_t sec)
-{
-	uint8_t datetime[7];
-
-	datetime[0] = ((sec / 10) << 4) | (sec % 10);
-	datetime[1] = ((min / 10) << 4) | (min % 10);
-	datetime[2] = ((hour / 10) << 4) | (hour % 10);
-	datetime[3] = ((weekday / 10) << 4) | (weekday % 10);
-	datetime[4] = ((day / 10) << 4) | (day % 10);
-	datetime[5] = ((mon / 10) << 4) | (mon % 10);
-	datetime[6] = ((year / 10) << 4) | (year % 10);
-
-	// 设置 DS3231 RTC 时间
-	ESP_ERROR_CHECK(ds3231_write(I2C_PORT_2_DS3231, REG_SEC, datetime, 7));
-}
-
-/* is_by_weekday: 0 - 每月这天; 1 - 每周这天 */
-/* 闹钟触发条件：日/星期，时，分，均匹配时触发 */
-static void ds3231_set_alarm1(uint8_t day, uint8_t hour, uint8_t min, uint8_t sec, uint8_t is_by_weekday)
-{
-	uint8_t datetime[4];
-
-	datetime[0] = ((sec / 10) << 4) | (sec % 10);
-	datetime[1] = ((min / 10) << 4) | (min % 10);
-	datetime[2] = ((hour / 10) << 4) | (hour % 10);
-	datetime[3] = ((day / 10) << 4) | (day % 10);
-
-	if(1 == is_by_weekday)
-	{
-		datetime[3] |= 0x40;
-	}
-
-	// 设置 DS3231 RTC 时间
-	ESP_ERROR_CHECK(ds3231_write(I2C_PORT_2_DS3231, REG_A1_SEC, datetime, 4));
-}
-
-/* is_by_weekday: 0 - 每月这天; 1 - 每周这天 */
-/* 闹钟触发条件：日/星期，时，分，均匹配时触发 */
-static void ds3231_set_alarm2(uint8_t day, uint8_t hour, uint8_t min, uint8_t is_by_weekday)
+static void i2c_task_example(void *arg)
 {
-	uint8_t datetime[3];
+	uint8_t datetime_data[DS3231_REG_NUM];
+	static uint32_t error_count = 0;
+	int temp = 0;
+	int temp_flag = ' ';
+	float temp_val = 0;
+	int ret = 0;
+	int need_clean_alarm_flag = 0;
+	stats_window_handle_t stats = NULL;
+	int32_t centi_temp = 0;
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
 
-	datetime[0] = ((min / 10) << 4) | (min % 10);
-	datetime[1] = ((hour / 10) << 4) | (hour % 10);
-	datetime[2] = ((day / 10) << 4) | (day % 10);
+	vTaskDelay(100 / portTICK_RATE_MS);
 
-	if(1 == is_by_weekday)
+	// 初始化 IIC 总线，注册并初始化 DS3231
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(ds3231_add(&ds3231_dev));
+	// 失败时继续运行，出错的寄存器已在日志中输出
+	if(ESP_OK != ds3231_init(ds3231_dev))
 	{
-		datetime[2] |= 0x40;
+		ESP_LOGW(TAG, "ds3231 init failed");
 	}
 
-	// 设置 DS3231 RTC 时间
-	ESP_ERROR_CHECK(ds3231_write(I2C_PORT_2_DS3231, REG_A2_MIN, datetime, 3));
-}
-
-/* 初始化 DS3231 */
-static esp_err_t ds3231_init(i2c_port_t i2c_num)
-{
-	uint8_t cmd_data = 0;
-
-	vTaskDelay(100 / portTICK_RATE_MS);
-
-	i2c_module_init();	// 初始化 IIC 接口
-
 	// 开机时设置当前日期时间
-	// ds3231_set_datetime(20, 6, 30, 2, 15, 21, 0);
-
-	// 配置 DS3231，RS: 8kHz, 中断使能，闹钟 1 和 2 中断使能
-	cmd_data = 0x1F;
-	ESP_ERROR_CHECK(ds3231_write(I2C_PORT_2_DS3231, REG_CTRL, &cmd_data, 1));
-	// 配置 DS3231，清除 Alarm 1 和 Alarm 2 中断标志位
-	cmd_data = 0x88;
-	ESP_ERROR_CHECK(ds3231_write(I2C_PORT_2_DS3231, REG_CTRL_STATUS, &cmd_data, 1));
+	// ds3231_set_datetime(ds3231_dev, 20, 6, 30, 2, 15, 21, 0);
 
 	// 设置闹钟
-	ds3231_set_alarm1(2, 15, 48, 05, 1);
-	// ds3231_set_alarm2(4, 22, 54, 1);
+	ESP_ERROR_CHECK(ds3231_set_alarm1(ds3231_dev, 2, 15, 48, 05, 1));
+	// ds3231_set_alarm2(ds3231_dev, 4, 22, 54, 1);
 
-	return ESP_OK;
-}
-
-static void i2c_task_example(void *arg)
-{
-	uint8_t datetime_data[19];
-	static uint32_t error_count = 0;
-	int temp = 0;
-	int temp_flag = ' ';
-	float temp_val = 0;
-	int ret = 0;
-	int need_clean_alarm_flag = 0;
-
-	// 初始化 DS3231
-	ds3231_init(I2C_PORT_2_DS3231);
+	ESP_ERROR_CHECK(stats_window_create(1, stats_specs, sizeof(stats_specs) / sizeof(stats_specs[0]),
+										stats_record, NULL, &stats));
 
 	for(;;)
 	{
-		memset(datetime_data, 0, 19);
+		memset(datetime_data, 0, DS3231_REG_NUM);
 		// 读取 DS3231 日期时间数据
-		ret = ds3231_read(I2C_PORT_2_DS3231, REG_SEC, datetime_data, 19);
+		ret = ds3231_read_all(ds3231_dev, datetime_data);
 		if(ret == ESP_OK)
 		{
 			ESP_LOGI(TAG, "*******************");
@@ -318,22 +149,27 @@ static void i2c_task_example(void *arg)
 			
 			ESP_LOGI(TAG, "Temp     :%c%d.%02d", temp_flag, (int)temp_val, ((int)(temp_val * 100) % 100));
 
+			// 0.25 度一个单位
+			centi_temp = ('-' == temp_flag) ? -temp * 25 : temp * 25;
+			stats_window_add(stats, xTaskGetTickCount() * portTICK_RATE_MS, &centi_temp);
+
 			ESP_LOGI(TAG, "error_count: %d\n", error_count);
 
 			if(1 == need_clean_alarm_flag)
 			{
-				ESP_ERROR_CHECK(ds3231_write(I2C_PORT_2_DS3231, REG_CTRL_STATUS, &datetime_data[15], 1));
+				ESP_ERROR_CHECK(i2c_bus_write(ds3231_dev, DS3231_REG_CTRL_STATUS, &datetime_data[15], 1));
 			}
 		}
 		else
 		{
 			ESP_LOGE(TAG, "No ack, sensor not connected...skip...\n");
+			stats_window_advance(stats, xTaskGetTickCount() * portTICK_RATE_MS);
 		}
 
 		vTaskDelay(1000 / portTICK_RATE_MS);
 	}
 
-	i2c_driver_delete(I2C_PORT_2_DS3231);
+	vTaskDelete(NULL);
 }
 
 void app_main(void)
@@ -9,6 +9,8 @@
 
 /* GPIO 驱动 */
 #include "driver/gpio.h"
+/* 多引脚端口操作 */
+#include "gpio_port.h"
 
 /* ESP 日志打印输出 */
 #include "esp_log.h"
@@ -31,6 +33,7 @@ static const char *TAG = "main";
  * 连接 GPIO15 至 GPIO4
  * 连接 GPIO16 至 GPIO5
  * 在 GPIO15/16 两个 IO 口产生脉冲, 由此来触发 GPIO4/5 中断
+ * GPIO15/16 由 gpio_port 一次调用同时翻转，GPIO16 在 RTC 寄存器中，比 GPIO15 稍晚改变
  */
 
 static xQueueHandle gpio_evt_queue = NULL;
@@ -116,8 +119,8 @@ void app_main(void)
 		ESP_LOGI(TAG, "cnt: %d", cnt++);
 		vTaskDelay(1000 / portTICK_RATE_MS);
 		// 设置 GPIO15/16 输出电平高低，根据 cnt 计数器进行高低电平翻转，生成脉冲
-		gpio_set_level(GPIO_NUM_15, cnt % 2);
-		gpio_set_level(GPIO_NUM_16, cnt % 2);
+		// 按位掩码一次写入，等同于分别调用 gpio_set_level(GPIO_NUM_15/16, cnt % 2)
+		gpio_port_write(GPIO_Pin_15 | GPIO_Pin_16, (cnt % 2) ? (GPIO_Pin_15 | GPIO_Pin_16) : 0);
 	}
 }
 
@@ -0,0 +1,3 @@
+#
+# Main Makefile. This is basically the same as a component makefile.
+#
@@ -0,0 +1,177 @@
+/**
+ * 说明:
+ * 本实例展示 GPIO 中断计数 (gpio_counter 组件)：测量 PWM 的频率与占空比，解码正交编码器，
+ * 中断中只累加结果，任务每秒读取一次快照，不再每个边沿发送一个事件
+ *
+ * GPIO 配置状态:
+ * GPIO12: PWM 输出，1kHz，占空比 25%
+ * GPIO13: 输入，脉冲通道
+ * GPIO15: 输出，模拟编码器 A 相
+ * GPIO16: 输出，模拟编码器 B 相
+ * GPIO4:  输入，正交通道 A 相
+ * GPIO5:  输入，正交通道 B 相
+ *
+ * 测试:
+ * 连接 GPIO12 至 GPIO13，GPIO15 至 GPIO4，GPIO16 至 GPIO5 (也可以把真实的编码器接到 GPIO4/5)
+ * 启动时由 GPIO15/16 输出正转与反转的正交信号，检查解码的位置；
+ * 再逐步缩短边沿间隔直到 CPU 饱和，输出每档的实际边沿频率、错误数与中断周期数，
+ * 饱和时的边沿频率即为能承受的最高边沿频率 (含信号产生的开销，是下限)；
+ * 之后每秒输出脉冲通道的边沿数、频率、占空比、周期范围与正交通道的位置
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_err.h"
+
+#include "driver/gpio.h"
+#include "driver/pwm.h"
+
+#include "ccount.h"
+#include "gpio_port.h"
+#include "gpio_counter.h"
+
+
+static const char *TAG = "main";
+
+#define PWM_PIN						(12)
+#define PWM_PERIOD					(1000)
+#define PWM_DUTY					(250)
+#define PULSE_GPIO					(GPIO_NUM_13)
+#define QUAD_A_GPIO					(GPIO_NUM_4)
+#define QUAD_B_GPIO					(GPIO_NUM_5)
+/* 模拟编码器的输出 */
+#define QUAD_OUT_A					(GPIO_Pin_15)
+#define QUAD_OUT_B					(GPIO_Pin_16)
+
+#define QUAD_TEST_FORWARD			(600)
+#define QUAD_TEST_BACKWARD			(200)
+#define QUAD_TEST_GAP_US			(200)
+/* 每档输出的边沿数 */
+#define SWEEP_EDGES					(2000)
+#define REPORT_PERIOD_MS			(1000)
+
+/* 边沿间隔 (us)，0 为不等待，连续输出 */
+static const uint32_t s_sweep_gap_us[] = { 100, 20, 10, 5, 2, 0 };
+
+static gpio_counter_handle_t pulse = NULL;
+static gpio_counter_handle_t quad = NULL;
+static uint8_t quad_a = 0;
+static uint8_t quad_b = 0;
+
+/* 输出 steps 步正交信号，steps < 0 为反转，gap_cycles 为相邻边沿的间隔；返回实际用时 (周期) */
+static uint32_t quad_generate(int32_t steps, uint32_t gap_cycles)
+{
+	uint32_t start = ccount_get();
+	uint32_t n = abs(steps);
+	uint32_t i = 0;
+
+	for(i = 0; i < n; ++i)
+	{
+		// 按绝对时刻等待，中断占用的时间不会累积到后面的边沿
+		while(ccount_get() - start < i * gap_cycles)
+		{
+		}
+		// 正转 00 -> 10 -> 11 -> 01：A/B 相同时翻转 A，否则翻转 B；反转相反
+		if((quad_a == quad_b) == (0 < steps))
+		{
+			quad_a = !quad_a;
+		}
+		else
+		{
+			quad_b = !quad_b;
+		}
+		gpio_port_write(QUAD_OUT_A | QUAD_OUT_B, (quad_a ? QUAD_OUT_A : 0) | (quad_b ? QUAD_OUT_B : 0));
+	}
+
+	return ccount_get() - start;
+}
+
+static void quad_test(void)
+{
+	gpio_counter_snapshot_t snap;
+
+	gpio_counter_read(quad, &snap);
+	quad_generate(QUAD_TEST_FORWARD, QUAD_TEST_GAP_US * CCOUNT_CPU_MHZ);
+	quad_generate(-QUAD_TEST_BACKWARD, QUAD_TEST_GAP_US * CCOUNT_CPU_MHZ);
+	gpio_counter_read(quad, &snap);
+	ESP_LOGI(TAG, "quad test: %d steps, position %d (expected %d), edges %u, errors %u, missed %u",
+			 QUAD_TEST_FORWARD + QUAD_TEST_BACKWARD, snap.delta, QUAD_TEST_FORWARD - QUAD_TEST_BACKWARD,
+			 snap.edges, snap.errors, snap.missed);
+}
+
+/* 逐步缩短边沿间隔，CPU 饱和后实际频率不再升高 */
+static void rate_sweep(void)
+{
+	gpio_counter_snapshot_t snap;
+	uint32_t cycles = 0;
+	uint32_t rate = 0;
+	uint32_t max_rate = 0;
+	uint32_t isr_avg = 0;
+	size_t i = 0;
+
+	for(i = 0; i < sizeof(s_sweep_gap_us) / sizeof(s_sweep_gap_us[0]); ++i)
+	{
+		gpio_counter_read(quad, &snap);
+		cycles = quad_generate(SWEEP_EDGES, s_sweep_gap_us[i] * CCOUNT_CPU_MHZ);
+		gpio_counter_read(quad, &snap);
+
+		rate = (uint32_t)((uint64_t)SWEEP_EDGES * CCOUNT_CPU_MHZ * 1000000 / cycles);
+		isr_avg = (0 < snap.isr_count) ? snap.isr_cycles / snap.isr_count : 0;
+		ESP_LOGI(TAG, "sweep: gap %u us, %u edges/s, position %+d, errors %u, missed %u, isr avg %u max %u cycles",
+				 s_sweep_gap_us[i], rate, snap.delta, snap.errors, snap.missed, isr_avg, snap.isr_max);
+		if(SWEEP_EDGES == snap.delta && 0 == snap.errors && rate > max_rate)
+		{
+			max_rate = rate;
+		}
+	}
+
+	// 饱和时每个边沿的周期数包括中断入口、中断服务分发、解码与信号产生
+	ESP_LOGI(TAG, "max edge rate without errors: %u edges/s (%u cycles per edge)", max_rate,
+			 (0 < max_rate) ? CCOUNT_CPU_MHZ * 1000000 / max_rate : 0);
+}
+
+static void counter_task(void *arg)
+{
+	gpio_counter_snapshot_t snap;
+	TickType_t last_wake = 0;
+	uint32_t pin_num[1] = { PWM_PIN };
+	uint32_t duties[1] = { PWM_DUTY };
+
+	ESP_ERROR_CHECK(gpio_port_config(QUAD_OUT_A | QUAD_OUT_B, GPIO_MODE_OUTPUT, 0));
+	ESP_ERROR_CHECK(gpio_counter_quad_create(QUAD_A_GPIO, QUAD_B_GPIO, &quad));
+	quad_test();
+	rate_sweep();
+	gpio_counter_set_position(quad, 0);
+
+	ESP_ERROR_CHECK(pwm_init(PWM_PERIOD, duties, 1, pin_num));
+	ESP_ERROR_CHECK(pwm_start());
+	ESP_ERROR_CHECK(gpio_counter_pulse_create(PULSE_GPIO, &pulse));
+
+	last_wake = xTaskGetTickCount();
+	while(1)
+	{
+		vTaskDelayUntil(&last_wake, REPORT_PERIOD_MS / portTICK_RATE_MS);
+
+		gpio_counter_read(pulse, &snap);
+		ESP_LOGI(TAG, "pulse: %u ms, %u edges, %u.%03u Hz, duty %u.%02u%%, period %u ~ %u us, missed %u, isr %u cycles",
+				 snap.interval_ms, snap.edges, snap.freq_mhz / 1000, snap.freq_mhz % 1000,
+				 snap.duty_x100 / 100, snap.duty_x100 % 100, snap.period_min / CCOUNT_CPU_MHZ,
+				 snap.period_max / CCOUNT_CPU_MHZ, snap.missed, snap.isr_cycles);
+
+		gpio_counter_read(quad, &snap);
+		ESP_LOGI(TAG, "quad: position %d, delta %+d, errors %u", snap.position, snap.delta, snap.errors);
+	}
+
+	vTaskDelete(NULL);
+}
+
+void app_main(void)
+{
+	xTaskCreate(counter_task, "counter_task", 2048, NULL, 10, NULL);
+}
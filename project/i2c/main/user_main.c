@@ -1,15 +1,20 @@
 /**
  * 说明:
  * 本实例展示如何使用 IIC
- * 使用 IIC 控制 MPU6050 六轴传感器
+ * 使用 IIC 控制 MPU6050 六轴传感器，在板上用定点数解算姿态 (imu_fusion 组件)
+ * 零偏标定结果保存在 DS3231 模块的 AT24C32 中 (mpu6050_calib 组件)
  *
  * GPIO 配置状态:
- * GPIO14 作为主机 SDA 连接至 MPU6050 SDA
- * GPIO2  作为主机 SCL 连接到 MPU6050 SCL
+ * GPIO14 作为主机 SDA 连接至 MPU6050 与 AT24C32 SDA
+ * GPIO2  作为主机 SCL 连接到 MPU6050 与 AT24C32 SCL
  * 不必要增加外部上拉电阻，驱动程序将使能内部上拉电阻
  *
  * 测试:
- * 如果连接上传感器，则读取数据
+ * 启动时从 AT24C32 恢复零偏标定 (热启动)；没有保存的标定时保持传感器静止，标定后保存 (冷启动)，
+ * 输出标定方式与到第一个有效采样的时间。
+ * 然后 MPU6050 以 1kHz 采样写入 FIFO，每 10ms 读出一次，经 CIC 抽取滤波 (filter_bank 组件) 降到 100Hz 后
+ * 解算姿态，每秒输出横滚/俯仰/航向角与四元数，每 10 秒输出读取错误数、FIFO 溢出次数与每次读取的滤波 + 解算周期数。
+ * 姿态角按 10Hz 加入 stats_window 组件，每 10 秒输出最近 10 秒与最近 1 分钟的最小值/最大值/均值/标准差
  */
 #include <stdio.h>
 #include <string.h>
@@ -23,235 +28,213 @@
 #include "esp_system.h"
 #include "esp_err.h"
 
-#include "driver/i2c.h"
-#include "driver/gpio.h"
+#include "i2c_bus.h"
+#include "mpu6050.h"
+#include "at24c32.h"
+#include "mpu6050_calib.h"
+#include "ccount.h"
+#include "filter_bank.h"
+#include "imu_fusion.h"
+#include "stats_window.h"
 
 
 static const char *TAG = "main";
 
-#define I2C_PORT_2_MPU6050          I2C_NUM_0        /*!< 主机设备 IIC 端口号 */
-
-#define MPU6050_SENSOR_ADDR         0x68             /*!< 从机 MPU6050 地址 */
-#define MPU6050_CMD_START           0x41             /*!< 设置 MPU6050 测量模式指令 */
-#define MPU6050_WHO_AM_I            0x75             /*!< 读取 MPU6050 WHO_AM_I 寄存器指令 */
-#define WRITE_BIT                   I2C_MASTER_WRITE /*!< I2C 主机写操作位 */
-#define READ_BIT                    I2C_MASTER_READ  /*!< I2C 主机读操作位 */
-#define ACK_CHECK_EN                0x1              /*!< I2C 主机确认接收从机 ACK 信号 */
-#define ACK_CHECK_DIS               0x0              /*!< I2C 主机不接收从机 ACK 信号  */
-#define ACK_VAL                     0x0              /*!< I2C ACK值 */
-#define NACK_VAL                    0x1              /*!< I2C NACK值 */
-#define LAST_NACK_VAL               0x2              /*!< I2C 末尾ACK值 */
-
-/**
- * MPU6050 寄存器地址
- */
-#define SMPLRT_DIV                  0x19
-#define CONFIG                      0x1A
-#define GYRO_CONFIG                 0x1B
-#define ACCEL_CONFIG                0x1C
-#define ACCEL_XOUT_H                0x3B
-#define ACCEL_XOUT_L                0x3C
-#define ACCEL_YOUT_H                0x3D
-#define ACCEL_YOUT_L                0x3E
-#define ACCEL_ZOUT_H                0x3F
-#define ACCEL_ZOUT_L                0x40
-#define TEMP_OUT_H                  0x41
-#define TEMP_OUT_L                  0x42
-#define GYRO_XOUT_H                 0x43
-#define GYRO_XOUT_L                 0x44
-#define GYRO_YOUT_H                 0x45
-#define GYRO_YOUT_L                 0x46
-#define GYRO_ZOUT_H                 0x47
-#define GYRO_ZOUT_L                 0x48
-#define SIG_PATH_RST                0x68
-#define PWR_MGMT_1                  0x6B
-#define WHO_AM_I                    0x75
-
-/* IIC 主机初始化：主机模式，GPIO */
-static esp_err_t i2c_module_init(void)
-{
-	i2c_config_t conf;
-
-	// 主机模式
-	conf.mode = I2C_MODE_MASTER;
-	// GPIO14 -> SDA
-	conf.sda_io_num = GPIO_NUM_14;
-	// SDA 引脚上拉
-	conf.sda_pullup_en = 0;
-	// GPIO2 -> SCL
-	conf.scl_io_num = GPIO_NUM_2;
-	// SCL 引脚上拉
-	conf.scl_pullup_en = 0;
-
-	// 设置 IIC 工作模式
-	ESP_ERROR_CHECK(i2c_driver_install(I2C_PORT_2_MPU6050, conf.mode));
-	// 设置 IIC 引脚配置
-	ESP_ERROR_CHECK(i2c_param_config(I2C_PORT_2_MPU6050, &conf));
-
-	return ESP_OK;
-}
-
-/* IIC 主机发送数据 */
-static esp_err_t mpu6050_write(i2c_port_t i2c_num, uint8_t reg_address,
-							   uint8_t *data, size_t data_len)
+#define FUSION_ALGO					(IMU_FUSION_MAHONY)
+/* FIFO 采样率与抽取后的解算频率 */
+#define FIFO_RATE_HZ				(1000)
+#define SAMPLE_HZ					(100)
+#define CIC_STAGES					(3)
+/* 每 10ms 读一次约 10 帧，留出余量；FIFO 最多 85 帧 */
+#define READ_PERIOD_MS				(10)
+#define READ_FRAMES_MAX				(32)
+#define LOG_SAMPLES					(SAMPLE_HZ)
+/* 姿态角统计的采样间隔：10Hz */
+#define ATT_STATS_SAMPLES			(SAMPLE_HZ / 10)
+#define STATS_SAMPLES				(10 * SAMPLE_HZ)
+/* 每次读取的滤波 + 解算周期数预算：读取周期的 5% */
+#define FUSION_CYCLE_BUDGET			(CCOUNT_CPU_MHZ * 1000 * READ_PERIOD_MS / 20)
+
+static i2c_bus_dev_handle_t mpu6050_dev = NULL;
+static i2c_bus_dev_handle_t at24c32_dev = NULL;
+static filter_frame_t frames[READ_FRAMES_MAX];
+
+/* 横滚、俯仰、航向，单位 0.01° */
+static const stats_window_spec_t att_stats_specs[] = {
+	{ 10 * 1000, 0 },
+	{ 60 * 1000, 10 * 1000 },
+};
+
+/* 0.01° -> "-12.34" */
+static const char *centideg_str(int32_t value, char *buf, size_t len)
 {
-	int ret = 0;
-	// 创建 IIC 命令连接
-	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+	snprintf(buf, len, "%s%d.%02d", (0 > value) ? "-" : "", abs(value) / 100, abs(value) % 100);
 
-	// 创建一个命令队列，并装载一个开始信号
-	i2c_master_start(cmd);
-	// 装载一个从机地址及写指令，ACK 应答使能
-	i2c_master_write_byte(cmd, MPU6050_SENSOR_ADDR << 1 | WRITE_BIT, ACK_CHECK_EN);
-	// 装载从机寄存器地址，ACK应答使能
-	i2c_master_write_byte(cmd, reg_address, ACK_CHECK_EN);
-	// 装载写至从机寄存器的数据，ACK应答使能
-	i2c_master_write(cmd, data, data_len, ACK_CHECK_EN);
-	// 装载停止信号
-	i2c_master_stop(cmd);
-
-	// 发送命令队列中的数据
-	ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-	// 释放命令连接
-	i2c_cmd_link_delete(cmd);
-
-	return ret;
+	return buf;
 }
 
-/**
- * 1. IIC 主机发送待读取寄存器地址到从设备
- * 2. IIC 主机读取从机返回的数据
- */
-static esp_err_t mpu6050_read(i2c_port_t i2c_num, uint8_t reg_address,
-							  uint8_t *data, size_t data_len)
+static void att_stats_record(const stats_window_record_t *record, void *arg)
 {
-	int ret;
-	// 创建 IIC 命令连接
-	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-
-	// 给从机发送读数据地址，通知其准备数据
-	// 创建一个命令队列，并装载一个开始信号
-	i2c_master_start(cmd);
-	// 装载一个从机地址及写指令，ACK 应答使能
-	i2c_master_write_byte(cmd, MPU6050_SENSOR_ADDR << 1 | WRITE_BIT, ACK_CHECK_EN);
-	// 装载从机寄存器地址，即待读取数据的寄存器地址，ACK应答使能
-	i2c_master_write_byte(cmd, reg_address, ACK_CHECK_EN);
-	// 装载停止信号
-	i2c_master_stop(cmd);
-	// 发送命令队列中的数据
-	ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-	// 释放命令连接
-	i2c_cmd_link_delete(cmd);
-
-	// 验证读取命令是否发送成功
-	if(ret != ESP_OK)
+	static const char *names[] = { "roll", "pitch", "yaw" };
+	char min[16];
+	char max[16];
+	char mean[16];
+	char std[16];
+	uint8_t i = 0;
+
+	for(i = 0; i < record->num; ++i)
 	{
-		return ret;
+		// 均值与标准差为 0.01° x STATS_WINDOW_SCALE
+		ESP_LOGI(TAG, "%2us %-5s min: %s max: %s mean: %s std: %s (%u samples)",
+				 att_stats_specs[record->window].length_ms / 1000, names[i],
+				 centideg_str(record->stats[i].min, min, sizeof(min)),
+				 centideg_str(record->stats[i].max, max, sizeof(max)),
+				 centideg_str(record->stats[i].mean / STATS_WINDOW_SCALE, mean, sizeof(mean)),
+				 centideg_str(record->stats[i].std / STATS_WINDOW_SCALE, std, sizeof(std)), record->count);
 	}
-
-	// 主机读取从机发送的数据
-	cmd = i2c_cmd_link_create();
-	// 创建一个命令队列，并装载一个开始信号
-	i2c_master_start(cmd);
-	// 装载一个从机地址及读指令，ACK 应答使能
-	i2c_master_write_byte(cmd, MPU6050_SENSOR_ADDR << 1 | READ_BIT, ACK_CHECK_EN);
-	// 装载读取命令，待读取数据缓存区和数据长度，用于从 IIC 总线读取数据，
-	// 最后一个数据应答 NACK
-	i2c_master_read(cmd, data, data_len, LAST_NACK_VAL);
-	// 装载停止信号
-	i2c_master_stop(cmd);
-	// 发送命令队列中的数据
-	// ** 这里不好理解 **
-	// 命令队列中装载了读取的信息：缓存区和数据长度，
-	// 这里才会真正处理读取数据操作。是阻塞运行。并将读取的数据存储至缓存区
-	// 所以程序返回时，数据应该已经读取到缓存区了，可以再取出来用了
-	// 多个数据的读取，被封装在底层驱动中了
-	ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-	// 释放命令连接
-	i2c_cmd_link_delete(cmd);
-
-	return ret;
-}
-
-/* 初始化 MPU6050 */
-static esp_err_t mpu6050_init(i2c_port_t i2c_num)
-{
-	uint8_t cmd_data;
-
-	vTaskDelay(100 / portTICK_RATE_MS);
-
-	i2c_module_init();	// 初始化 IIC 接口
-
-	// 对 MPU6050 进行必要的配置
-	cmd_data = 0x00;	// 设置 PWR_MGMT_1 寄存器，唤醒 MPU6050
-	ESP_ERROR_CHECK(mpu6050_write(i2c_num, PWR_MGMT_1, &cmd_data, 1));
-	cmd_data = 0x07;    // 设置 SMPRT_DIV 寄存器, 设置陀螺仪输出速率分频：8 分频
-	ESP_ERROR_CHECK(mpu6050_write(i2c_num, SMPLRT_DIV, &cmd_data, 1));
-	cmd_data = 0x06;    // 设置 CONFIG 寄存器，设置数字低通过滤器 (DLPF) 
-	ESP_ERROR_CHECK(mpu6050_write(i2c_num, CONFIG, &cmd_data, 1));
-	cmd_data = 0x18;    // 设置 GYRO_CONFIG 寄存器，设置陀螺仪测量范围: +/- 1000dps
-	ESP_ERROR_CHECK(mpu6050_write(i2c_num, GYRO_CONFIG, &cmd_data, 1));
-	cmd_data = 0x01;    // 设置 ACCEL_CONFIG 寄存器，设置加速计测量范围：+/-2g
-	ESP_ERROR_CHECK(mpu6050_write(i2c_num, ACCEL_CONFIG, &cmd_data, 1));
-
-	return ESP_OK;
 }
 
 static void i2c_task_example(void *arg)
 {
-	uint8_t sensor_data[14];
 	uint8_t who_am_i = 0;
-	double temp = 0;
+	mpu6050_calib_t calib;
+	bool warm = false;
+	TickType_t boot = 0;
+	filter_cic_t cic;
+	size_t frame_num = 0;
+	size_t num = 0;
+	size_t i = 0;
+	static uint32_t overflow_count = 0;
+	imu_fusion_config_t fusion_config = IMU_FUSION_DEFAULT_CONFIG(FUSION_ALGO);
+	imu_fusion_t fusion;
+	imu_fusion_attitude_t att;
+	stats_window_handle_t att_stats = NULL;
+	int32_t att_values[3];
+	TickType_t last_wake = 0;
+	uint32_t samples = 0;
+	uint32_t reads = 0;
+	uint32_t start = 0;
+	uint32_t cycles = 0;
+	uint32_t cycles_max = 0;
+	uint64_t cycles_sum = 0;
+	char roll[16];
+	char pitch[16];
+	char yaw[16];
 	static uint32_t error_count = 0;
 	int ret = 0;
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
 
-	// 初始化 MPU6050
-	mpu6050_init(I2C_PORT_2_MPU6050);
+	// 初始化 IIC 总线，注册并初始化 MPU6050 与 AT24C32
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(mpu6050_add(MPU6050_ADDR, &mpu6050_dev));
+	// 失败时继续运行，出错的寄存器已在日志中输出
+	if(ESP_OK != mpu6050_init(mpu6050_dev))
+	{
+		ESP_LOGW(TAG, "mpu6050 init failed");
+	}
+	ESP_ERROR_CHECK(at24c32_add(AT24C32_ADDR_DS3231_MODULE, &at24c32_dev));
 
-	while(1)
+	// 读取 WHO_AM_I 寄存器，验证 MPU6050 连接与数据读取
+	mpu6050_who_am_i(mpu6050_dev, &who_am_i);
+	ESP_LOGI(TAG, "WHO_AM_I: 0x%02x", who_am_i);
+
+	// 恢复或重新标定零偏，标定失败 (传感器在运动) 时不修正，继续运行
+	boot = xTaskGetTickCount();
+	ret = mpu6050_calib_start(mpu6050_dev, at24c32_dev, MPU6050_CALIB_E2P_ADDR, MPU6050_CALIB_SAMPLES, &calib, &warm);
+	if(ESP_OK == ret)
 	{
-		who_am_i = 0;
-		// 读取 WHO_AM_I 寄存器，验证 MPU6050 连接与数据读取
-		mpu6050_read(I2C_PORT_2_MPU6050, WHO_AM_I, &who_am_i, 1);
-		if(0x68 != who_am_i)
+		ESP_LOGI(TAG, "calib: %s start, first sample after %u ms", warm ? "warm" : "cold",
+				 (xTaskGetTickCount() - boot) * portTICK_RATE_MS);
+		if(!warm)
 		{
-			error_count++;
+			ESP_LOGI(TAG, "calib: accel bias %d %d %d, gyro bias %d %d %d, gyro std %u %u %u (LSB)",
+					 calib.accel_bias[0], calib.accel_bias[1], calib.accel_bias[2],
+					 calib.gyro_bias[0], calib.gyro_bias[1], calib.gyro_bias[2],
+					 calib.gyro_std[0], calib.gyro_std[1], calib.gyro_std[2]);
 		}
+	}
+	else
+	{
+		ESP_LOGW(TAG, "calib failed: error %d", ret);
+	}
 
-		temp = 0;
-		memset(sensor_data, 0, 14);
-		// 读取 MPU6050 加速计、温度传感器与陀螺仪数据
-		ret = mpu6050_read(I2C_PORT_2_MPU6050, ACCEL_XOUT_H, sensor_data, 14);
-
-		if(ret == ESP_OK)
-		{
-			ESP_LOGI(TAG, "*******************");
-			ESP_LOGI(TAG, "WHO_AM_I: 0x%02x", who_am_i);
-			temp = 36.53 + ((double)(int16_t)((sensor_data[6] << 8) | sensor_data[7]) / 340);
-			ESP_LOGI(TAG, "TEMP: %d.%d", (uint16_t)temp, (uint16_t)(temp * 100) % 100);
+	fusion_config.sample_hz = SAMPLE_HZ;
+	fusion_config.gyro_scale = IMU_FUSION_GYRO_SCALE(MPU6050_GYRO_LSB_PER_DPS);
+	ESP_ERROR_CHECK(imu_fusion_init(&fusion, &fusion_config));
+	ESP_ERROR_CHECK(filter_cic_init(&cic, CIC_STAGES, FIFO_RATE_HZ / SAMPLE_HZ));
+	ESP_ERROR_CHECK(stats_window_create(3, att_stats_specs, sizeof(att_stats_specs) / sizeof(att_stats_specs[0]),
+										att_stats_record, NULL, &att_stats));
+	ESP_ERROR_CHECK(mpu6050_fifo_start(mpu6050_dev, FIFO_RATE_HZ));
 
-			ESP_LOGI(TAG, "Accel X: %d", (int16_t)((sensor_data[0] << 8) | sensor_data[1]));
-			ESP_LOGI(TAG, "Accel Y: %d", (int16_t)((sensor_data[2] << 8) | sensor_data[3]));
-			ESP_LOGI(TAG, "Accel Z: %d", (int16_t)((sensor_data[4] << 8) | sensor_data[5]));
+	last_wake = xTaskGetTickCount();
+	while(1)
+	{
+		vTaskDelayUntil(&last_wake, READ_PERIOD_MS / portTICK_RATE_MS);
 
-			ESP_LOGI(TAG, "Gyros X: %d", (int16_t)((sensor_data[8] << 8) | sensor_data[9]));
-			ESP_LOGI(TAG, "Gyros Y: %d", (int16_t)((sensor_data[10] << 8) | sensor_data[11]));
-			ESP_LOGI(TAG, "Gyros Z: %d", (int16_t)((sensor_data[12] << 8) | sensor_data[13]));
+		// 读出 FIFO 中的加速计与陀螺仪数据，溢出后丢失的数据不能接上，重新开始滤波
+		ret = mpu6050_fifo_read(mpu6050_dev, frames, READ_FRAMES_MAX, &frame_num);
+		if(ESP_ERR_INVALID_SIZE == ret)
+		{
+			overflow_count++;
+			filter_cic_init(&cic, CIC_STAGES, FIFO_RATE_HZ / SAMPLE_HZ);
+			continue;
+		}
+		if(ESP_OK != ret)
+		{
+			error_count++;
+			continue;
+		}
 
-			ESP_LOGI(TAG, "error_count: %d\n", error_count);
+		// 1kHz -> 100Hz，就地输出
+		start = ccount_get();
+		num = filter_cic_process(&cic, frames, frame_num, frames);
+		for(i = 0; i < num; ++i)
+		{
+			imu_fusion_update(&fusion, &frames[i][0], &frames[i][3]);
 		}
-		else
+		cycles = ccount_get() - start;
+		cycles_sum += cycles;
+		if(cycles > cycles_max)
 		{
-			ESP_LOGE(TAG, "No ack, sensor not connected...skip...\n");
+			cycles_max = cycles;
 		}
+		reads++;
 
-		vTaskDelay(3000 / portTICK_RATE_MS);
+		for(i = 0; i < num; ++i)
+		{
+			if(0 != ++samples % ATT_STATS_SAMPLES)
+			{
+				continue;
+			}
+
+			// 同一次读出的采样使用本次读取的时间，误差不超过一个读取周期
+			imu_fusion_get(&fusion, &att);
+			att_values[0] = att.roll;
+			att_values[1] = att.pitch;
+			att_values[2] = att.yaw;
+			stats_window_add(att_stats, last_wake * portTICK_RATE_MS, att_values);
+			if(0 != samples % LOG_SAMPLES)
+			{
+				continue;
+			}
+
+			ESP_LOGI(TAG, "roll: %s pitch: %s yaw: %s q: %6d %6d %6d %6d",
+					 centideg_str(att.roll, roll, sizeof(roll)), centideg_str(att.pitch, pitch, sizeof(pitch)),
+					 centideg_str(att.yaw, yaw, sizeof(yaw)),
+					 (int)(att.q[0] >> 16), (int)(att.q[1] >> 16), (int)(att.q[2] >> 16), (int)(att.q[3] >> 16));
+			if(0 == samples % STATS_SAMPLES)
+			{
+				ESP_LOGI(TAG, "samples: %u, error_count: %u, fifo overflow: %u, cycles per read avg: %u max: %u "
+						 "(budget %u)", samples, error_count, overflow_count, (uint32_t)(cycles_sum / reads),
+						 cycles_max, FUSION_CYCLE_BUDGET);
+			}
+		}
 	}
 
-	i2c_driver_delete(I2C_PORT_2_MPU6050);
+	vTaskDelete(NULL);
 }
 
 void app_main(void)
 {
 	xTaskCreate(i2c_task_example, "i2c_task_example", 2048, NULL, 10, NULL);
-}
\ No newline at end of file
+}
@@ -0,0 +1,215 @@
+/**
+ * 说明:
+ * 本实例展示多个任务如何共享同一条 IIC 总线
+ * MPU6050、DS3231、AT24C32 分别由各自的任务访问，经 i2c_bus 组件排队执行
+ *
+ * GPIO 配置状态:
+ * GPIO14 作为主机 SDA 连接至各设备 SDA
+ * GPIO2  作为主机 SCL 连接到各设备 SCL
+ * MPU6050 AD0 接高电平，地址 0x69，避免与 DS3231 的 0x68 冲突
+ * 设备地址不写死，启动时扫描总线自动识别并注册
+ *
+ * 测试:
+ * 各任务周期性读写设备，每 10 秒输出各设备的请求数、错误数、延时与吞吐量
+ * 以及各任务的栈高水位、空闲堆与分配次数
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+#include "mpu6050.h"
+#include "ds3231.h"
+#include "at24c32.h"
+#include "i2c_discover.h"
+#include "telemetry.h"
+
+
+static const char *TAG = "main";
+
+#define MPU6050_PERIOD_MS			(10)
+#define DS3231_PERIOD_MS			(1000)
+#define AT24C32_PERIOD_MS			(5000)
+#define STATS_PERIOD_MS				(10000)
+#define TELEMETRY_PERIOD_MS			(10000)
+
+#define TASK_STACK					(2048)
+
+#define AT24C32_TEST_ADDR			(0x02)
+#define AT24C32_TEST_DATA_LEN		(66)
+
+static i2c_bus_dev_handle_t mpu6050_dev = NULL;
+static i2c_bus_dev_handle_t ds3231_dev = NULL;
+static i2c_bus_dev_handle_t at24c32_dev = NULL;
+
+static void mpu6050_task(void *arg)
+{
+	uint8_t sensor_data[MPU6050_RAW_LEN];
+	mpu6050_raw_t raw;
+	i2c_bus_txn_handle_t txn = NULL;
+	TickType_t last_wake = 0;
+	uint32_t count = 0;
+
+	// 失败时继续运行，出错的寄存器已在日志中输出
+	if(ESP_OK != mpu6050_init(mpu6050_dev))
+	{
+		ESP_LOGW(TAG, "mpu6050 init failed");
+	}
+
+	// 周期性读取，预先创建读事务，每次执行复用同一组命令连接
+	ESP_ERROR_CHECK(i2c_bus_prepare_read(mpu6050_dev, MPU6050_ACCEL_XOUT_H, sensor_data, MPU6050_RAW_LEN, &txn));
+
+	last_wake = xTaskGetTickCount();
+	for(;;)
+	{
+		if(ESP_OK == i2c_bus_execute(txn))
+		{
+			mpu6050_decode(sensor_data, &raw);
+
+			// 每秒输出一次
+			if(0 == (++count % (1000 / MPU6050_PERIOD_MS)))
+			{
+				ESP_LOGI(TAG, "MPU6050 accel: %6d %6d %6d  gyro: %6d %6d %6d",
+						 raw.accel_x, raw.accel_y, raw.accel_z,
+						 raw.gyro_x, raw.gyro_y, raw.gyro_z);
+			}
+		}
+
+		vTaskDelayUntil(&last_wake, MPU6050_PERIOD_MS / portTICK_RATE_MS);
+	}
+
+	i2c_bus_release(txn);
+	vTaskDelete(NULL);
+}
+
+static void ds3231_task(void *arg)
+{
+	uint8_t datetime_data[DS3231_REG_NUM];
+	int32_t temp = 0;
+
+	if(ESP_OK != ds3231_init(ds3231_dev))
+	{
+		ESP_LOGW(TAG, "ds3231 init failed");
+	}
+
+	for(;;)
+	{
+		if(ESP_OK == ds3231_read_all(ds3231_dev, datetime_data))
+		{
+			temp = ds3231_temp_centi(datetime_data[DS3231_REG_TEMP_MSB], datetime_data[DS3231_REG_TEMP_LSB]);
+			ESP_LOGI(TAG, "DS3231 datetime: 20%02X-%02X-%02X %02X:%02X:%02X temp:%c%d.%02d",
+					 datetime_data[6], datetime_data[5], datetime_data[4],
+					 datetime_data[2], datetime_data[1], datetime_data[0],
+					 temp < 0 ? '-' : ' ', abs(temp) / 100, abs(temp) % 100);
+		}
+
+		vTaskDelay(DS3231_PERIOD_MS / portTICK_RATE_MS);
+	}
+
+	vTaskDelete(NULL);
+}
+
+static void at24c32_task(void *arg)
+{
+	uint8_t e2p_wb[AT24C32_TEST_DATA_LEN];
+	uint8_t e2p_rb[AT24C32_TEST_DATA_LEN];
+	uint8_t temp = 0;
+	int i = 0;
+
+	for(;;)
+	{
+		for(i = 0; i < AT24C32_TEST_DATA_LEN; ++i)
+		{
+			e2p_wb[i] = temp++;
+		}
+
+		memset(e2p_rb, 0, AT24C32_TEST_DATA_LEN);
+		if(ESP_OK == at24c32_write(at24c32_dev, AT24C32_TEST_ADDR, e2p_wb, AT24C32_TEST_DATA_LEN)
+		   && ESP_OK == at24c32_read(at24c32_dev, AT24C32_TEST_ADDR, e2p_rb, AT24C32_TEST_DATA_LEN))
+		{
+			ESP_LOGI(TAG, "AT24C32 verify: %s", 0 == memcmp(e2p_wb, e2p_rb, AT24C32_TEST_DATA_LEN) ? "ok" : "mismatch");
+		}
+
+		vTaskDelay(AT24C32_PERIOD_MS / portTICK_RATE_MS);
+	}
+
+	vTaskDelete(NULL);
+}
+
+static void stats_task(void *arg)
+{
+	i2c_bus_dev_handle_t devs[] = { mpu6050_dev, ds3231_dev, at24c32_dev };
+	i2c_bus_dev_stats_t stats;
+	i2c_bus_calib_t calib;
+	size_t i = 0;
+
+	// 校准各设备的 SCL 频率
+	for(i = 0; i < sizeof(devs) / sizeof(devs[0]); ++i)
+	{
+		if(NULL != devs[i] && ESP_OK == i2c_bus_calibrate(devs[i], &calib))
+		{
+			ESP_LOGI(TAG, "%-8s SCL target: %u Hz, measured: %u Hz, low/high: %u/%u cycles", i2c_bus_dev_name(devs[i]),
+					 calib.target_hz, calib.scl_hz, calib.low_cycles, calib.high_cycles);
+		}
+	}
+
+	for(;;)
+	{
+		vTaskDelay(STATS_PERIOD_MS / portTICK_RATE_MS);
+
+		ESP_LOGI(TAG, "device     count  errors   bytes  avg(us)  max(us)  byte/s  recover");
+		for(i = 0; i < sizeof(devs) / sizeof(devs[0]); ++i)
+		{
+			if(NULL == devs[i])
+			{
+				continue;
+			}
+			i2c_bus_get_stats(devs[i], &stats);
+			ESP_LOGI(TAG, "%-8s %7u %7u %7u %8u %8u %7u %8u", i2c_bus_dev_name(devs[i]),
+					 stats.count, stats.errors, stats.bytes,
+					 stats.latency_avg_us, stats.latency_max_us, stats.throughput_bps, stats.recoveries);
+			i2c_bus_reset_stats(devs[i]);
+		}
+	}
+}
+
+void app_main(void)
+{
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
+	static i2c_discover_result_t result;
+
+	// 初始化 IIC 总线，扫描并注册设备
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(i2c_discover(&result));
+	ESP_LOGI(TAG, "%d device(s), scan: %u us, total: %u us", result.num, result.scan_us, result.total_us);
+
+	mpu6050_dev = i2c_discover_find(&result, I2C_DISCOVER_MPU6050);
+	ds3231_dev = i2c_discover_find(&result, I2C_DISCOVER_DS3231);
+	at24c32_dev = i2c_discover_find(&result, I2C_DISCOVER_AT24C32);
+
+	if(NULL != mpu6050_dev)
+	{
+		telemetry_task_create(mpu6050_task, "mpu6050_task", TASK_STACK, NULL, 10, NULL);
+	}
+	if(NULL != ds3231_dev)
+	{
+		telemetry_task_create(ds3231_task, "ds3231_task", TASK_STACK, NULL, 9, NULL);
+	}
+	if(NULL != at24c32_dev)
+	{
+		telemetry_task_create(at24c32_task, "at24c32_task", TASK_STACK, NULL, 8, NULL);
+	}
+	telemetry_task_create(stats_task, "stats_task", TASK_STACK, NULL, 5, NULL);
+
+	// 每 10 秒输出各任务的栈高水位、堆与分配次数
+	telemetry_task_add(i2c_bus_task_handle(), bus_config.task_stack);
+	telemetry_start(TELEMETRY_PERIOD_MS, 4);
+}
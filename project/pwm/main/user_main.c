@@ -12,6 +12,7 @@
  * 测试:
  * 连接 GPIO12/13/14/15 至 逻辑分析仪
  * 在 GPIO 产生相同频率的方形波形，各个波形可能相位或占空比不一样
+ * 每 5s 在运行中切换一次相位与反相配置，切换发生在周期边界，波形连续无毛刺
  */
 #include <stdio.h>
 #include <string.h>
@@ -29,6 +30,8 @@
 /* pwm 驱动 */
 #include "driver/pwm.h"
 
+#include "pwm_batch.h"
+
 // PWM 周期 500us(2Khz)
 #define PWM_CHANNEL_NUM     (4)
 #define PWM_PERIOD          (500)
@@ -55,37 +58,45 @@ int16_t phase[PWM_CHANNEL_NUM] = {
     0, 0, 50, -50
 };
 
+// 运行中切换的第二组相位
+int16_t phase_alt[PWM_CHANNEL_NUM] = {
+    0, 0, -100, 100
+};
+
 void app_main()
 {
     int16_t count = 0;
+    int alt = 0;
+    uint8_t i = 0;
 
-    // PWM 初始化
-    pwm_init(PWM_PERIOD, duties, PWM_CHANNEL_NUM, pin_num);
+    // PWM 初始化，同时记录双缓冲参数表
+    pwm_batch_init(PWM_PERIOD, duties, PWM_CHANNEL_NUM, pin_num);
     // 设置 PWM 通道 0 反转输出，所以 通道 1 可作为参考输出
-    pwm_set_channel_invert(0x1 << 0);
+    pwm_batch_set_invert(0x1 << 0);
     // 设置 PWM 相位
     // 即使用希望相位为 0，也必需要配置为 0
-    pwm_set_phases(phase);
+    for(i = 0; i < PWM_CHANNEL_NUM; ++i)
+    {
+        pwm_batch_set_phase(i, phase[i]);
+    }
     // 开启 PWM
-    pwm_start();
+    pwm_batch_commit();
 
-    // PWM 输出 5s，停止 5s，输出 5s，停止 5s ... ...
+    // 原来修改相位或反相需要 pwm_stop() 再 pwm_start()，每次都会在所有通道上产生毛刺
+    // 现在修改先写入暂存表，pwm_batch_commit() 在当前周期结束时一次切换，输出不中断
     while(1)
     {
-        // PWM 运行 5s
         if(count == 5)
         {
-            // 0x3 : b0011
-            // PWM 通道 0，1 输出高电平
-            // PWM 通道 2，3 输出低电平
-            pwm_stop(0x3);
-            ESP_LOGI(TAG, "PWM stop\n");
-        }
-        // 等待 5s，重新启动 PWM
-        else if(count == 10)
-        {
-            pwm_start();
-            ESP_LOGI(TAG, "PWM re-start\n");
+            alt = !alt;
+            for(i = 0; i < PWM_CHANNEL_NUM; ++i)
+            {
+                pwm_batch_set_phase(i, alt ? phase_alt[i] : phase[i]);
+            }
+            // 反相通道在通道 0 与通道 1 之间切换
+            pwm_batch_set_invert(alt ? (0x1 << 1) : (0x1 << 0));
+            pwm_batch_commit();
+            ESP_LOGI(TAG, "PWM switch to config %d\n", alt);
             count = 0;
         }
 
@@ -0,0 +1,149 @@
+/**
+ * 说明:
+ * 本实例对比两种更新多路 PWM 占空比的方式的 CPU 开销
+ * 1. 每个通道 pwm_set_duty() + pwm_start()
+ * 2. pwm_batch 组件暂存所有通道的修改，pwm_batch_commit() 只调用一次 pwm_start()
+ *
+ * GPIO 配置状态:
+ * GPIO12/13/14/15/4/5/0/2: PWM 通道 0 ~ 7 输出
+ *
+ * 测试:
+ * 运行后在串口输出 1 ~ 8 个通道时，两种方式每次更新所用的 CPU 周期数，
+ * 之后 8 个通道用 led_effect 显示依次相差 45 度的流水呼吸效果，每个 tick 所有通道一次提交
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_err.h"
+
+#include "driver/gpio.h"
+/* pwm 驱动 */
+#include "driver/pwm.h"
+
+#include "pwm_batch.h"
+#include "led_effect.h"
+#include "ccount.h"
+
+// PWM 周期 500us(2Khz)
+#define PWM_CHANNEL_MAX     (8)
+#define PWM_PERIOD          (500)
+// 每种情况重复更新的次数
+#define BENCH_LOOPS         (50)
+// 流水呼吸：一周 2 秒，每 20ms 更新一次
+#define EFFECT_PERIOD_MS    (2000)
+#define EFFECT_TICK_MS      (20)
+
+static const char *TAG = "pwm_batch";
+
+const uint32_t pin_num[PWM_CHANNEL_MAX] = {
+    GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_15,
+    GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_0, GPIO_NUM_2
+};
+
+uint32_t duties[PWM_CHANNEL_MAX] = { 0 };
+int16_t phases[PWM_CHANNEL_MAX] = { 0 };
+
+/* 方式 1：每个通道 set_duty + start */
+static uint32_t bench_set_and_start(uint8_t channel_num)
+{
+    uint32_t start = 0;
+    uint32_t cycles = 0;
+    int loop = 0;
+    uint8_t ch = 0;
+
+    pwm_init(PWM_PERIOD, duties, channel_num, pin_num);
+    pwm_set_phases(phases);
+    pwm_start();
+
+    for(loop = 0; loop < BENCH_LOOPS; ++loop)
+    {
+        start = ccount_get();
+        for(ch = 0; ch < channel_num; ++ch)
+        {
+            pwm_set_duty(ch, (loop * 10 + ch * 50) % PWM_PERIOD);
+            pwm_start();
+        }
+        cycles += ccount_get() - start;
+    }
+
+    pwm_deinit();
+
+    return cycles / BENCH_LOOPS;
+}
+
+/* 方式 2：批量暂存，一次提交 */
+static uint32_t bench_batch(uint8_t channel_num)
+{
+    uint32_t start = 0;
+    uint32_t cycles = 0;
+    int loop = 0;
+    uint8_t ch = 0;
+
+    pwm_batch_init(PWM_PERIOD, duties, channel_num, pin_num);
+    pwm_start();
+
+    for(loop = 0; loop < BENCH_LOOPS; ++loop)
+    {
+        start = ccount_get();
+        for(ch = 0; ch < channel_num; ++ch)
+        {
+            pwm_batch_set_duty(ch, (loop * 10 + ch * 50) % PWM_PERIOD);
+        }
+        pwm_batch_commit();
+        cycles += ccount_get() - start;
+    }
+
+    pwm_deinit();
+
+    return cycles / BENCH_LOOPS;
+}
+
+/* 各通道同一条呼吸曲线，初始相位依次相差 1/PWM_CHANNEL_MAX 周 */
+static void run_effect(void)
+{
+    led_effect_t effect;
+    TickType_t last_wake = 0;
+    uint8_t ch = 0;
+
+    ESP_ERROR_CHECK(pwm_batch_init(PWM_PERIOD, duties, PWM_CHANNEL_MAX, pin_num));
+    ESP_ERROR_CHECK(led_effect_init(&effect, PWM_CHANNEL_MAX, PWM_PERIOD));
+    for(ch = 0; ch < PWM_CHANNEL_MAX; ++ch)
+    {
+        ESP_ERROR_CHECK(led_effect_set_curve(&effect, ch, LED_CURVE_BREATH, EFFECT_PERIOD_MS, EFFECT_TICK_MS,
+                                             ch * (0x10000 / PWM_CHANNEL_MAX)));
+    }
+    ESP_LOGI(TAG, "led_effect: %d channels, period %d ms, tick %d ms", PWM_CHANNEL_MAX, EFFECT_PERIOD_MS, EFFECT_TICK_MS);
+
+    last_wake = xTaskGetTickCount();
+    while(1)
+    {
+        led_effect_step(&effect, duties);
+        pwm_batch_set_duties((0x1 << PWM_CHANNEL_MAX) - 1, duties);
+        pwm_batch_commit();
+        vTaskDelayUntil(&last_wake, EFFECT_TICK_MS / portTICK_RATE_MS);
+    }
+}
+
+void app_main()
+{
+    uint8_t channel_num = 0;
+    uint32_t single = 0;
+    uint32_t batch = 0;
+
+    ESP_LOGI(TAG, "ch  set+start  batch  (cycles/update)");
+    for(channel_num = 1; channel_num <= PWM_CHANNEL_MAX; ++channel_num)
+    {
+        single = bench_set_and_start(channel_num);
+        batch = bench_batch(channel_num);
+        ESP_LOGI(TAG, "%2d  %9d  %5d", channel_num, single, batch);
+    }
+
+    run_effect();
+}
@@ -0,0 +1,271 @@
+/**
+ * 说明:
+ * 本实例展示用一个采样任务调度多个传感器 (sampler 组件)
+ * MPU6050 每 3 秒、DS3231 每 1 秒、AM2301 每 5 秒采样一次，原来各实例每个传感器一个任务
+ *
+ * GPIO 配置状态:
+ * GPIO14 作为主机 SDA，GPIO2 作为主机 SCL，连接 MPU6050 (AD0 接高电平，0x69) 与 DS3231 (0x68)
+ * GPIO4  连接 AM2301 数据线
+ *
+ * 测试:
+ * 每次有传感器更新时输出记录中的数值，每 10 秒输出各传感器的采样数、错误数、超时、启动抖动与执行时间
+ * 记录同时用 sample_codec 编码成 128 字节的块，以 "rec: " 加十六进制输出 (第一块为通道描述)，
+ * 保存日志后用 tools/sample_decode -x 解码
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+#include "mpu6050.h"
+#include "ds3231.h"
+#include "am2301.h"
+#include "sampler.h"
+#include "sample_codec.h"
+
+
+static const char *TAG = "sensors";
+
+#define AM2301_CTRL_PIN				(GPIO_NUM_4)
+
+#define MPU6050_PERIOD_MS			(3000)
+#define DS3231_PERIOD_MS			(1000)
+#define AM2301_PERIOD_MS			(5000)
+#define STATS_PERIOD_MS				(10000)
+
+/* 解码后的数值个数 */
+#define MPU6050_VALUE_NUM			(7)
+#define DS3231_VALUE_NUM			(3)
+#define AM2301_VALUE_NUM			(2)
+
+/* 编码块大小：AT24C32 的 4 页 */
+#define REC_BLOCK_SIZE				(128)
+#define LINE_LEN					(96)
+
+static i2c_bus_dev_handle_t mpu6050_dev = NULL;
+static i2c_bus_dev_handle_t ds3231_dev = NULL;
+
+static uint8_t mpu6050_id = 0;
+static uint8_t ds3231_id = 0;
+static uint8_t am2301_id = 0;
+
+/* 与登记顺序相同，即记录中 values 的顺序 */
+static sample_codec_schema_t rec_schema = {
+	.num = DS3231_VALUE_NUM + MPU6050_VALUE_NUM + AM2301_VALUE_NUM,
+	.channels = {
+		{ "date", 0 }, { "time", 0 }, { "rtc_temp", 2 },
+		{ "accel_x", 0 }, { "accel_y", 0 }, { "accel_z", 0 }, { "mpu_temp", 2 },
+		{ "gyro_x", 0 }, { "gyro_y", 0 }, { "gyro_z", 0 },
+		{ "humidity", 1 }, { "temp", 1 },
+	},
+};
+static sample_codec_enc_t rec_enc;
+static uint8_t rec_block[REC_BLOCK_SIZE];
+/* 本块中的记录按日志文本输出的长度 */
+static uint32_t rec_text = 0;
+
+static esp_err_t mpu6050_sample_read(void *ctx, uint8_t *raw)
+{
+	return mpu6050_read_raw(mpu6050_dev, raw);
+}
+
+/* 加速度 x/y/z，温度 (0.01°C)，角速度 x/y/z */
+static void mpu6050_sample_decode(void *ctx, const uint8_t *raw, int32_t *values)
+{
+	mpu6050_raw_t data;
+
+	mpu6050_decode(raw, &data);
+	values[0] = data.accel_x;
+	values[1] = data.accel_y;
+	values[2] = data.accel_z;
+	values[3] = mpu6050_temp_centi(data.temp);
+	values[4] = data.gyro_x;
+	values[5] = data.gyro_y;
+	values[6] = data.gyro_z;
+}
+
+static esp_err_t ds3231_sample_read(void *ctx, uint8_t *raw)
+{
+	return ds3231_read_all(ds3231_dev, raw);
+}
+
+static int32_t bcd_to_int(uint8_t bcd)
+{
+	return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+/* 日期 YYYYMMDD，时间 HHMMSS，温度 (0.01°C) */
+static void ds3231_sample_decode(void *ctx, const uint8_t *raw, int32_t *values)
+{
+	values[0] = (2000 + bcd_to_int(raw[DS3231_REG_YEAR])) * 10000
+				+ bcd_to_int(raw[DS3231_REG_MONTH] & 0x1F) * 100 + bcd_to_int(raw[DS3231_REG_DATE]);
+	values[1] = bcd_to_int(raw[DS3231_REG_HOUR] & 0x3F) * 10000
+				+ bcd_to_int(raw[DS3231_REG_MIN]) * 100 + bcd_to_int(raw[DS3231_REG_SEC]);
+	values[2] = ds3231_temp_centi(raw[DS3231_REG_TEMP_MSB], raw[DS3231_REG_TEMP_LSB]);
+}
+
+static esp_err_t am2301_sample_read(void *ctx, uint8_t *raw)
+{
+	am2301_data_t data;
+	esp_err_t ret = am2301_read(AM2301_CTRL_PIN, &data);
+
+	if(ESP_OK == ret)
+	{
+		memcpy(raw, &data, sizeof(data));
+	}
+
+	return ret;
+}
+
+/* 湿度 (0.1%RH)，温度 (0.1°C) */
+static void am2301_sample_decode(void *ctx, const uint8_t *raw, int32_t *values)
+{
+	am2301_data_t data;
+
+	memcpy(&data, raw, sizeof(data));
+	values[0] = data.humidity;
+	values[1] = data.temp;
+}
+
+static void rec_output(const uint8_t *block, size_t len)
+{
+	static char hex[2 * REC_BLOCK_SIZE + 1];
+	size_t i = 0;
+
+	for(i = 0; i < len; ++i)
+	{
+		sprintf(&hex[2 * i], "%02x", block[i]);
+	}
+	ESP_LOGI(TAG, "rec: %s", hex);
+}
+
+/* 输出一行日志，并累计文本长度 */
+static void log_line(const char *line)
+{
+	rec_text += strlen(line) + 1;
+	ESP_LOGI(TAG, "%s", line);
+}
+
+static void record_callback(const sampler_record_t *record, void *arg)
+{
+	const int32_t *v = NULL;
+	uint32_t ms = (uint32_t)(record->timestamp_us / 1000);
+	char line[LINE_LEN];
+	size_t len = 0;
+
+	if(0 != (record->updated & (1UL << ds3231_id)))
+	{
+		v = sampler_values(record, ds3231_id);
+		snprintf(line, sizeof(line), "[%7u ms] ds3231  %d %06d temp: %d.%02d", ms, v[0], v[1], v[2] / 100, abs(v[2]) % 100);
+		log_line(line);
+	}
+	if(0 != (record->updated & (1UL << mpu6050_id)))
+	{
+		v = sampler_values(record, mpu6050_id);
+		snprintf(line, sizeof(line), "[%7u ms] mpu6050 accel: %6d %6d %6d  gyro: %6d %6d %6d", ms, v[0], v[1], v[2],
+				 v[4], v[5], v[6]);
+		log_line(line);
+	}
+	if(0 != (record->updated & (1UL << am2301_id)))
+	{
+		v = sampler_values(record, am2301_id);
+		snprintf(line, sizeof(line), "[%7u ms] am2301  %d.%d %%RH, %c%d.%d Centigrade", ms, v[0] / 10, v[0] % 10,
+				 (0 > v[1]) ? '-' : ' ', abs(v[1]) / 10, abs(v[1]) % 10);
+		log_line(line);
+	}
+
+	// 块满时输出本块，在新块中重新加入
+	if(ESP_ERR_NO_MEM == sample_codec_enc_add(&rec_enc, ms, record->values))
+	{
+		len = sample_codec_enc_finish(&rec_enc);
+		ESP_LOGI(TAG, "block: %u records, %u bytes, text %u bytes", rec_enc.count, (unsigned)len, rec_text);
+		rec_output(rec_block, len);
+		rec_text = 0;
+		sample_codec_enc_begin(&rec_enc, &rec_schema, rec_block, sizeof(rec_block));
+		sample_codec_enc_add(&rec_enc, ms, record->values);
+	}
+}
+
+void app_main(void)
+{
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
+	sampler_config_t sampler_config = SAMPLER_DEFAULT_CONFIG();
+	sampler_sensor_config_t sensor_config;
+	sampler_stats_t stats;
+	uint8_t ids[3];
+	int i = 0;
+
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(mpu6050_add(MPU6050_ADDR_AD0_HIGH, &mpu6050_dev));
+	// 失败时继续运行，出错的寄存器已在日志中输出
+	if(ESP_OK != mpu6050_init(mpu6050_dev))
+	{
+		ESP_LOGW(TAG, "mpu6050 init failed");
+	}
+	ESP_ERROR_CHECK(ds3231_add(&ds3231_dev));
+	if(ESP_OK != ds3231_init(ds3231_dev))
+	{
+		ESP_LOGW(TAG, "ds3231 init failed");
+	}
+	ESP_ERROR_CHECK(am2301_init(AM2301_CTRL_PIN));
+
+	// 登记传感器：周期、读取函数、解码函数
+	memset(&sensor_config, 0, sizeof(sensor_config));
+	sensor_config.name = "ds3231";
+	sensor_config.period_ms = DS3231_PERIOD_MS;
+	sensor_config.raw_len = DS3231_REG_NUM;
+	sensor_config.value_num = DS3231_VALUE_NUM;
+	sensor_config.read = ds3231_sample_read;
+	sensor_config.decode = ds3231_sample_decode;
+	ESP_ERROR_CHECK(sampler_add(&sensor_config, &ds3231_id));
+
+	sensor_config.name = "mpu6050";
+	sensor_config.period_ms = MPU6050_PERIOD_MS;
+	sensor_config.raw_len = MPU6050_RAW_LEN;
+	sensor_config.value_num = MPU6050_VALUE_NUM;
+	sensor_config.read = mpu6050_sample_read;
+	sensor_config.decode = mpu6050_sample_decode;
+	ESP_ERROR_CHECK(sampler_add(&sensor_config, &mpu6050_id));
+
+	// AM2301 上电后 2 秒内不响应
+	sensor_config.name = "am2301";
+	sensor_config.period_ms = AM2301_PERIOD_MS;
+	sensor_config.offset_ms = 2000;
+	sensor_config.raw_len = sizeof(am2301_data_t);
+	sensor_config.value_num = AM2301_VALUE_NUM;
+	sensor_config.read = am2301_sample_read;
+	sensor_config.decode = am2301_sample_decode;
+	ESP_ERROR_CHECK(sampler_add(&sensor_config, &am2301_id));
+
+	// 通道描述块
+	rec_output(rec_block, sample_codec_schema_pack(&rec_schema, rec_block, sizeof(rec_block)));
+	ESP_ERROR_CHECK(sample_codec_enc_begin(&rec_enc, &rec_schema, rec_block, sizeof(rec_block)));
+
+	// 截止时间前 1 个节拍内忙等待，启动抖动小于节拍
+	sampler_config.spin_us = portTICK_RATE_MS * 1000;
+	sampler_config.callback = record_callback;
+	ESP_ERROR_CHECK(sampler_start(&sampler_config));
+
+	ids[0] = ds3231_id;
+	ids[1] = mpu6050_id;
+	ids[2] = am2301_id;
+	for(;;)
+	{
+		vTaskDelay(STATS_PERIOD_MS / portTICK_RATE_MS);
+
+		ESP_LOGI(TAG, "sensor   samples errors overrun jitter avg/max(us) exec avg/max(us)");
+		for(i = 0; i < 3; ++i)
+		{
+			sampler_get_stats(ids[i], &stats);
+			ESP_LOGI(TAG, "%-8s %7u %6u %7u %8u %8u %8u %8u", sampler_name(ids[i]), stats.samples, stats.errors,
+					 stats.overruns, stats.jitter_avg_us, stats.jitter_max_us, stats.exec_avg_us, stats.exec_max_us);
+		}
+	}
+}
@@ -0,0 +1,193 @@
+/**
+ * 说明:
+ * 本实例展示串口二进制遥测 (uart_link 组件)
+ * MPU6050 以 1kHz 采样写入 FIFO，每 10ms 读出一次，每个采样的加速度/角速度用 sample_codec 编码成块，
+ * 每块作为一帧从 UART0 以 921600 波特率发出，主机端用 tools/uart_capture 接收并保存为 CSV
+ *
+ * GPIO 配置状态:
+ * GPIO14 作为主机 SDA 连接至 MPU6050 SDA
+ * GPIO12 作为主机 SCL 连接到 MPU6050 SCL (GPIO2 留给 UART1)
+ * GPIO1 (U0TXD) 经 USB 串口芯片连接主机
+ * GPIO2 (U1TXD) 日志输出，另接一个 USB 串口 (115200)
+ * 链路独占 UART0，sdkconfig.defaults 把日志改到 UART1，启动前的 ROM 日志仍在 UART0
+ *
+ * 测试:
+ * 启动时发送一个文本帧，之后每秒发送一次通道描述块，主机端从任意时刻开始接收都能解码。
+ * 每 10 秒输出采样数、FIFO 溢出次数、发送的帧数/字节数/丢帧数、缓冲区最大占用，
+ * 以及每个采样按二进制与按日志文本输出的字节数、两种方式在各自波特率下每秒能输出的采样数
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_err.h"
+
+#include "i2c_bus.h"
+#include "mpu6050.h"
+#include "sample_codec.h"
+#include "uart_link.h"
+
+
+static const char *TAG = "main";
+
+#define LINK_UART_NUM				(UART_NUM_0)
+/* UART1 的 TX 固定在 GPIO2 上，SCL 改用 GPIO12 */
+#define I2C_SCL_IO					(GPIO_NUM_12)
+#define LINK_BAUD					(921600)
+/* 日志的波特率，用于比较 */
+#define TEXT_BAUD					(115200)
+
+#define FIFO_RATE_HZ				(1000)
+#define READ_PERIOD_MS				(10)
+#define READ_FRAMES_MAX				(32)
+#define REC_BLOCK_SIZE				(128)
+#define SCHEMA_PERIOD_MS			(1000)
+#define STATS_PERIOD_MS				(10000)
+#define LINE_LEN					(96)
+
+static i2c_bus_dev_handle_t mpu6050_dev = NULL;
+static uart_link_handle_t link = NULL;
+static int16_t frames[READ_FRAMES_MAX][MPU6050_FIFO_CHANNELS];
+
+static sample_codec_schema_t rec_schema = {
+	.num = MPU6050_FIFO_CHANNELS,
+	.channels = {
+		{ "accel_x", 0 }, { "accel_y", 0 }, { "accel_z", 0 },
+		{ "gyro_x", 0 }, { "gyro_y", 0 }, { "gyro_z", 0 },
+	},
+};
+static sample_codec_enc_t rec_enc;
+static uint8_t rec_block[REC_BLOCK_SIZE];
+static uint8_t schema_block[REC_BLOCK_SIZE];
+static size_t schema_len = 0;
+
+static void link_send(uint8_t type, const void *payload, size_t len)
+{
+	// 缓冲区满时丢弃，接收端按序号统计，采样不等待串口
+	uart_link_send(link, type, payload, len);
+}
+
+static void telemetry_task(void *arg)
+{
+	uint8_t who_am_i = 0;
+	uart_link_config_t link_config = UART_LINK_DEFAULT_CONFIG();
+	uart_link_stats_t stats;
+	TickType_t last_wake = 0;
+	TickType_t last_schema = 0;
+	TickType_t last_stats = 0;
+	size_t frame_num = 0;
+	size_t i = 0;
+	size_t j = 0;
+	int32_t values[MPU6050_FIFO_CHANNELS];
+	uint32_t sample_ms = 0;
+	uint32_t samples = 0;
+	uint32_t overflow_count = 0;
+	uint32_t error_count = 0;
+	uint32_t text_bytes = 0;
+	uint32_t bin_per_sample = 0;
+	uint32_t text_per_sample = 0;
+	char line[LINE_LEN];
+	int ret = 0;
+	i2c_bus_config_t bus_config = I2C_BUS_DEFAULT_CONFIG();
+
+	bus_config.scl_io_num = I2C_SCL_IO;
+	ESP_ERROR_CHECK(i2c_bus_init(&bus_config));
+	ESP_ERROR_CHECK(mpu6050_add(MPU6050_ADDR, &mpu6050_dev));
+	// 失败时继续运行，出错的寄存器已在日志中输出
+	if(ESP_OK != mpu6050_init(mpu6050_dev))
+	{
+		ESP_LOGW(TAG, "mpu6050 init failed");
+	}
+	mpu6050_who_am_i(mpu6050_dev, &who_am_i);
+	ESP_LOGI(TAG, "WHO_AM_I: 0x%02x", who_am_i);
+
+	link_config.port = LINK_UART_NUM;
+	link_config.baud_rate = LINK_BAUD;
+	ESP_ERROR_CHECK(uart_link_create(&link_config, &link));
+
+	snprintf(line, sizeof(line), "uart_telemetry: mpu6050 %d Hz, %d channels, block %d bytes",
+			 FIFO_RATE_HZ, MPU6050_FIFO_CHANNELS, REC_BLOCK_SIZE);
+	link_send(UART_LINK_TYPE_TEXT, line, strlen(line));
+	schema_len = sample_codec_schema_pack(&rec_schema, schema_block, sizeof(schema_block));
+	link_send(UART_LINK_TYPE_RECORD, schema_block, schema_len);
+	ESP_ERROR_CHECK(sample_codec_enc_begin(&rec_enc, &rec_schema, rec_block, sizeof(rec_block)));
+
+	ESP_ERROR_CHECK(mpu6050_fifo_start(mpu6050_dev, FIFO_RATE_HZ));
+
+	last_wake = xTaskGetTickCount();
+	last_schema = last_wake;
+	last_stats = last_wake;
+	while(1)
+	{
+		vTaskDelayUntil(&last_wake, READ_PERIOD_MS / portTICK_RATE_MS);
+
+		ret = mpu6050_fifo_read(mpu6050_dev, frames, READ_FRAMES_MAX, &frame_num);
+		if(ESP_ERR_INVALID_SIZE == ret)
+		{
+			overflow_count++;
+		}
+		else if(ESP_OK != ret)
+		{
+			error_count++;
+		}
+		else
+		{
+			for(i = 0; i < frame_num; ++i)
+			{
+				for(j = 0; j < MPU6050_FIFO_CHANNELS; ++j)
+				{
+					values[j] = frames[i][j];
+				}
+				// 1kHz 采样，序号即毫秒数
+				sample_ms = samples++ * 1000 / FIFO_RATE_HZ;
+
+				// 同样的内容按日志文本输出的长度 (含 "I (时间) main: " 与换行)
+				text_bytes += snprintf(line, sizeof(line), "I (%u) %s: %d %d %d %d %d %d\n", sample_ms, TAG,
+									   frames[i][0], frames[i][1], frames[i][2],
+									   frames[i][3], frames[i][4], frames[i][5]);
+
+				// 块满时发送本块，在新块中重新加入
+				if(ESP_ERR_NO_MEM == sample_codec_enc_add(&rec_enc, sample_ms, values))
+				{
+					link_send(UART_LINK_TYPE_RECORD, rec_block, sample_codec_enc_finish(&rec_enc));
+					sample_codec_enc_begin(&rec_enc, &rec_schema, rec_block, sizeof(rec_block));
+					sample_codec_enc_add(&rec_enc, sample_ms, values);
+				}
+			}
+		}
+
+		if(last_wake - last_schema >= SCHEMA_PERIOD_MS / portTICK_RATE_MS)
+		{
+			last_schema = last_wake;
+			link_send(UART_LINK_TYPE_RECORD, schema_block, schema_len);
+		}
+
+		if(last_wake - last_stats >= STATS_PERIOD_MS / portTICK_RATE_MS && 0 < samples)
+		{
+			last_stats = last_wake;
+			uart_link_get_stats(link, &stats);
+			// 每个采样的字节数 x100
+			bin_per_sample = (uint32_t)((uint64_t)stats.bytes * 100 / samples);
+			text_per_sample = (uint32_t)((uint64_t)text_bytes * 100 / samples);
+			ESP_LOGI(TAG, "samples: %u, error_count: %u, fifo overflow: %u", samples, error_count, overflow_count);
+			ESP_LOGI(TAG, "link: frames %u, bytes %u, dropped %u, isr %u, buffer peak %u/%u",
+					 stats.frames, stats.bytes, stats.dropped, stats.isr_count, stats.buf_peak, stats.buf_size);
+			ESP_LOGI(TAG, "per sample: binary %u.%02u bytes, text %u.%02u bytes; max rate: binary %u samples/s at %u, "
+					 "text %u samples/s at %u", bin_per_sample / 100, bin_per_sample % 100,
+					 text_per_sample / 100, text_per_sample % 100,
+					 LINK_BAUD / 10 * 100 / bin_per_sample, LINK_BAUD, TEXT_BAUD / 10 * 100 / text_per_sample, TEXT_BAUD);
+		}
+	}
+
+	vTaskDelete(NULL);
+}
+
+void app_main(void)
+{
+	xTaskCreate(telemetry_task, "telemetry_task", 2048, NULL, 10, NULL);
+}
@@ -0,0 +1,196 @@
+/**
+ * 说明:
+ * 比较 bench 组件 (project/components/bench) 两次运行的结果
+ *
+ * 从日志中提取以 "bench," 开头的结果行 (其余行忽略，可以直接使用串口日志或 sim_run 的输出)，
+ * 按用例名配对，输出中位数、p99 与分配次数的变化。
+ *
+ * 使用:
+ * $ ./bench_compare [-t 阈值%] 基准日志 新日志
+ *
+ * 任一用例的中位数或 p99 变慢超过阈值 (默认 10%)、分配次数增加、出现错误或泄漏，
+ * 或基准中的用例在新日志中缺失时返回 1
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+
+#define BENCH_CASES_MAX             (64)
+#define BENCH_NAME_LEN              (32)
+#define BENCH_LINE_LEN              (256)
+
+typedef struct {
+    char name[BENCH_NAME_LEN];
+    uint32_t iterations;
+    uint32_t errors;
+    uint32_t min;
+    uint32_t median;
+    uint32_t p99;
+    uint32_t max;
+    double allocs;
+    int32_t heap_delta;
+} bench_row_t;
+
+typedef struct {
+    bench_row_t rows[BENCH_CASES_MAX];
+    int num;
+} bench_log_t;
+
+static int bench_load(const char *path, bench_log_t *log)
+{
+    char line[BENCH_LINE_LEN];
+    bench_row_t row;
+    char *p = NULL;
+    FILE *fp = fopen(path, "r");
+
+    if(NULL == fp)
+    {
+        perror(path);
+        return -1;
+    }
+
+    log->num = 0;
+    while(NULL != fgets(line, sizeof(line), fp))
+    {
+        // 结果行可能带有串口日志前缀，从 "bench," 开始解析
+        p = strstr(line, "bench,");
+        if(NULL == p)
+        {
+            continue;
+        }
+        memset(&row, 0, sizeof(row));
+        if(9 != sscanf(p, "bench,%31[^,],%u,%u,%u,%u,%u,%u,%lf,%d", row.name, &row.iterations, &row.errors,
+                       &row.min, &row.median, &row.p99, &row.max, &row.allocs, &row.heap_delta))
+        {
+            // 表头
+            continue;
+        }
+        if(BENCH_CASES_MAX <= log->num)
+        {
+            fprintf(stderr, "%s: too many cases\n", path);
+            break;
+        }
+        log->rows[log->num++] = row;
+    }
+    fclose(fp);
+
+    return log->num;
+}
+
+static const bench_row_t *bench_find(const bench_log_t *log, const char *name)
+{
+    int i = 0;
+
+    for(i = 0; i < log->num; ++i)
+    {
+        if(0 == strcmp(log->rows[i].name, name))
+        {
+            return &log->rows[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* 变化百分比，基准为 0 时新值非 0 视为 100% */
+static double bench_change(uint32_t base, uint32_t cur)
+{
+    if(0 == base)
+    {
+        return (0 == cur) ? 0.0 : 100.0;
+    }
+
+    return ((double)cur - (double)base) * 100.0 / (double)base;
+}
+
+int main(int argc, char *argv[])
+{
+    static bench_log_t base;
+    static bench_log_t cur;
+    const bench_row_t *b = NULL;
+    const bench_row_t *c = NULL;
+    double threshold = 10.0;
+    double median_pct = 0.0;
+    double p99_pct = 0.0;
+    const char *verdict = NULL;
+    int fail = 0;
+    int opt = 0;
+    int i = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "t:")))
+    {
+        switch(opt)
+        {
+            case 't': threshold = strtod(optarg, NULL); break;
+            default:
+                fprintf(stderr, "usage: %s [-t threshold_pct] base.log new.log\n", argv[0]);
+                return 2;
+        }
+    }
+    if(2 != argc - optind)
+    {
+        fprintf(stderr, "usage: %s [-t threshold_pct] base.log new.log\n", argv[0]);
+        return 2;
+    }
+
+    if(0 >= bench_load(argv[optind], &base) || 0 > bench_load(argv[optind + 1], &cur))
+    {
+        fprintf(stderr, "no bench results\n");
+        return 2;
+    }
+
+    printf("%-20s %10s %10s %8s %10s %10s %8s %7s %7s\n", "name", "median", "new", "diff%",
+           "p99", "new", "diff%", "allocs", "new");
+    for(i = 0; i < base.num; ++i)
+    {
+        b = &base.rows[i];
+        c = bench_find(&cur, b->name);
+        if(NULL == c)
+        {
+            printf("%-20s missing\n", b->name);
+            fail = 1;
+            continue;
+        }
+
+        median_pct = bench_change(b->median, c->median);
+        p99_pct = bench_change(b->p99, c->p99);
+        verdict = "";
+        if(0 != c->errors)
+        {
+            verdict = "ERRORS";
+        }
+        else if(0 != c->heap_delta)
+        {
+            verdict = "LEAK";
+        }
+        else if(c->allocs > b->allocs)
+        {
+            verdict = "MORE ALLOCS";
+        }
+        else if(median_pct > threshold || p99_pct > threshold)
+        {
+            verdict = "SLOWER";
+        }
+        if('\0' != verdict[0])
+        {
+            fail = 1;
+        }
+
+        printf("%-20s %10u %10u %+7.1f%% %10u %10u %+7.1f%% %7.2f %7.2f  %s\n", b->name,
+               b->median, c->median, median_pct, b->p99, c->p99, p99_pct, b->allocs, c->allocs, verdict);
+    }
+
+    // 新增的用例只列出，不参与判断
+    for(i = 0; i < cur.num; ++i)
+    {
+        if(NULL == bench_find(&base, cur.rows[i].name))
+        {
+            printf("%-20s new: median %u, p99 %u, allocs %.2f\n", cur.rows[i].name,
+                   cur.rows[i].median, cur.rows[i].p99, cur.rows[i].allocs);
+        }
+    }
+
+    return fail;
+}
@@ -0,0 +1,480 @@
+/**
+ * 说明:
+ * 滤波器组 (filter_bank 组件) 的主机端检查
+ *
+ * 合成 6 通道 1kHz 数据：各通道不同频率的低频运动 + 高于输出奈奎斯特频率的振动 + 噪声 + 偶发尖峰，
+ * 依次通过各滤波器，与参考实现逐个输出比较：
+ * - CIC：N 个长度 R 的滑动和 (64 位精确计算) 抽取后除以 R^N，误差应不超过 1 LSB (舍入)
+ * - 双二阶：同样的 Q14 系数按双精度计算，输出截断误差经反馈后应在几个 LSB 以内
+ * - 滑动平均、中值：整数精确参考，输出应完全相同
+ * 然后比较抗混叠效果：单频振动直接每 R 个取一个与经过 CIC 后的幅度，以及通带的衰减 (sinc^N 下垂)，
+ * 最后按块处理测量主机上每通道每秒处理的采样数。
+ *
+ * 使用:
+ * $ ./filter_sim [-r 采样率Hz] [-R 抽取比] [-N CIC级数] [-c 截止频率Hz] [-q 品质因数] [-b 块帧数] [-s 时长s]
+ * $ ./filter_sim -d [-r 采样率Hz] [-c 截止频率Hz] [-q 品质因数]      只输出低通系数 (FILTER_BIQUAD_LOWPASS)
+ *
+ * 任一滤波器与参考的误差超过上述范围时返回 1
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+
+#include "filter_bank.h"
+
+#define SIM_CH                      FILTER_BANK_CHANNELS
+#define SIM_BIQUAD_ERR_MAX          (4)
+#define SIM_MAVG_WINDOW             (8)
+#define SIM_MEDIAN_WINDOW           (5)
+/* 吞吐量测量重复处理整段数据的次数 */
+#define SIM_SPEED_ROUNDS            (20)
+
+typedef struct {
+    double fs;
+    uint16_t ratio;
+    uint8_t stages;
+    double fc;
+    double q;
+    size_t block;
+    double seconds;
+} sim_opts_t;
+
+typedef struct {
+    double b[3];
+    double a[2];
+} sim_coef_t;
+
+static double sim_now_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (double)t.tv_sec * 1e9 + (double)t.tv_nsec;
+}
+
+/* RBJ Audio EQ Cookbook 低通 */
+static void sim_design_lowpass(double fs, double fc, double q, sim_coef_t *coef)
+{
+    double w0 = 2.0 * M_PI * fc / fs;
+    double alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+
+    coef->b[0] = (1.0 - cos(w0)) / 2.0 / a0;
+    coef->b[1] = (1.0 - cos(w0)) / a0;
+    coef->b[2] = coef->b[0];
+    coef->a[0] = -2.0 * cos(w0) / a0;
+    coef->a[1] = (1.0 - alpha) / a0;
+}
+
+/* 与 FILTER_BIQUAD_LOWPASS() 相同的量化 */
+static void sim_quantize(const sim_coef_t *coef, filter_biquad_coef_t *q14)
+{
+    const filter_biquad_coef_t q = FILTER_BIQUAD_LOWPASS(coef->b[0], coef->a[0], coef->a[1]);
+
+    *q14 = q;
+}
+
+static int16_t sim_clip(double value)
+{
+    value = round(value);
+    if(INT16_MAX < value)
+    {
+        return INT16_MAX;
+    }
+    if(INT16_MIN > value)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t)value;
+}
+
+/* 低频运动 + 振动 + 噪声 + 每 0.5 秒一个尖峰 */
+static void sim_synth(filter_frame_t *in, size_t n, double fs, double vib_hz)
+{
+    uint32_t seed = 1;
+    double t = 0;
+    double v = 0;
+    size_t k = 0;
+    int c = 0;
+
+    for(k = 0; k < n; ++k)
+    {
+        t = k / fs;
+        for(c = 0; c < SIM_CH; ++c)
+        {
+            seed = seed * 1103515245 + 12345;
+            v = 8000.0 * sin(2.0 * M_PI * (0.5 + 0.3 * c) * t + c)
+                + 3000.0 * sin(2.0 * M_PI * (vib_hz + 7.0 * c) * t)
+                + (double)((seed >> 16) % 101) - 50.0;
+            if(0 == (k + 37 * c) % (size_t)(fs / 2))
+            {
+                v += 12000.0;
+            }
+            in[k][c] = sim_clip(v);
+        }
+    }
+}
+
+/* CIC 参考：N 级长度 R 的滑动和 */
+static int sim_check_cic(const filter_frame_t *in, size_t n, const sim_opts_t *o, int32_t *err_max)
+{
+    static filter_cic_t cic;
+    filter_frame_t *out = calloc(n / o->ratio + 1, sizeof(filter_frame_t));
+    int64_t *stage = calloc(n, sizeof(int64_t));
+    int64_t *next = calloc(n, sizeof(int64_t));
+    double gain = pow(o->ratio, o->stages);
+    size_t num = 0;
+    size_t k = 0;
+    size_t j = 0;
+    int32_t err = 0;
+    int c = 0;
+    int s = 0;
+
+    *err_max = 0;
+    if(NULL == out || NULL == stage || NULL == next || ESP_OK != filter_cic_init(&cic, o->stages, o->ratio))
+    {
+        free(out);
+        free(stage);
+        free(next);
+        return -1;
+    }
+    num = filter_cic_process(&cic, in, n, out);
+
+    for(c = 0; c < SIM_CH; ++c)
+    {
+        for(k = 0; k < n; ++k)
+        {
+            stage[k] = in[k][c];
+        }
+        for(s = 0; s < o->stages; ++s)
+        {
+            for(k = 0; k < n; ++k)
+            {
+                next[k] = stage[k] + ((0 < k) ? next[k - 1] : 0) - ((k >= o->ratio) ? stage[k - o->ratio] : 0);
+            }
+            memcpy(stage, next, n * sizeof(int64_t));
+        }
+        for(j = 0; j < num; ++j)
+        {
+            err = abs(out[j][c] - sim_clip((double)stage[(j + 1) * o->ratio - 1] / gain));
+            if(err > *err_max)
+            {
+                *err_max = err;
+            }
+        }
+    }
+
+    free(out);
+    free(stage);
+    free(next);
+
+    return (int)num;
+}
+
+static void sim_check_biquad(const filter_frame_t *in, size_t n, const filter_biquad_coef_t *q14,
+                             int32_t *err_max, double *err_rms)
+{
+    static filter_biquad_t biquad;
+    filter_frame_t *out = calloc(n, sizeof(filter_frame_t));
+    double b[3];
+    double a[2];
+    double x1 = 0;
+    double x2 = 0;
+    double y1 = 0;
+    double y2 = 0;
+    double y = 0;
+    double sum2 = 0;
+    size_t k = 0;
+    int32_t err = 0;
+    int c = 0;
+    int i = 0;
+
+    *err_max = 0;
+    *err_rms = 0;
+    if(NULL == out || ESP_OK != filter_biquad_init(&biquad, q14))
+    {
+        *err_max = INT16_MAX;
+        free(out);
+        return;
+    }
+    filter_biquad_process(&biquad, in, n, out);
+
+    for(i = 0; i < 3; ++i)
+    {
+        b[i] = q14->b[i] / 16384.0;
+    }
+    for(i = 0; i < 2; ++i)
+    {
+        a[i] = q14->a[i] / 16384.0;
+    }
+    for(c = 0; c < SIM_CH; ++c)
+    {
+        x1 = x2 = y1 = y2 = 0;
+        for(k = 0; k < n; ++k)
+        {
+            y = b[0] * in[k][c] + b[1] * x1 + b[2] * x2 - a[0] * y1 - a[1] * y2;
+            x2 = x1;
+            x1 = in[k][c];
+            y2 = y1;
+            y1 = y;
+            err = abs(out[k][c] - sim_clip(y));
+            sum2 += (out[k][c] - y) * (out[k][c] - y);
+            if(err > *err_max)
+            {
+                *err_max = err;
+            }
+        }
+    }
+    *err_rms = sqrt(sum2 / (n * SIM_CH));
+
+    free(out);
+}
+
+static int cmp_i16(const void *a, const void *b)
+{
+    return *(const int16_t *)a - *(const int16_t *)b;
+}
+
+/* 滑动平均与中值：按 0 填充的窗口精确计算，返回不同的输出个数 */
+static uint32_t sim_check_window(const filter_frame_t *in, size_t n)
+{
+    static filter_mavg_t mavg;
+    static filter_median_t median;
+    filter_frame_t *avg = calloc(n, sizeof(filter_frame_t));
+    filter_frame_t *med = calloc(n, sizeof(filter_frame_t));
+    int16_t win[SIM_MEDIAN_WINDOW];
+    int32_t sum = 0;
+    uint32_t diff = 0;
+    size_t k = 0;
+    int c = 0;
+    int j = 0;
+
+    if(NULL == avg || NULL == med || ESP_OK != filter_mavg_init(&mavg, SIM_MAVG_WINDOW)
+       || ESP_OK != filter_median_init(&median, SIM_MEDIAN_WINDOW))
+    {
+        free(avg);
+        free(med);
+        return UINT32_MAX;
+    }
+    filter_mavg_process(&mavg, in, n, avg);
+    filter_median_process(&median, in, n, med);
+
+    for(c = 0; c < SIM_CH; ++c)
+    {
+        for(k = 0; k < n; ++k)
+        {
+            sum = 0;
+            for(j = 0; j < SIM_MAVG_WINDOW; ++j)
+            {
+                sum += (k >= (size_t)j) ? in[k - j][c] : 0;
+            }
+            diff += (avg[k][c] != (int16_t)((sum + SIM_MAVG_WINDOW / 2) >> 3));
+            for(j = 0; j < SIM_MEDIAN_WINDOW; ++j)
+            {
+                win[j] = (k >= (size_t)j) ? in[k - j][c] : 0;
+            }
+            qsort(win, SIM_MEDIAN_WINDOW, sizeof(int16_t), cmp_i16);
+            diff += (med[k][c] != win[SIM_MEDIAN_WINDOW / 2]);
+        }
+    }
+
+    free(avg);
+    free(med);
+
+    return diff;
+}
+
+/* 单频信号的输出幅度：跳过开头的建立时间后取最大绝对值 */
+static double sim_tone(const sim_opts_t *o, double hz, bool use_cic)
+{
+    static filter_cic_t cic;
+    size_t n = (size_t)(o->fs * 2);
+    filter_frame_t *in = calloc(n, sizeof(filter_frame_t));
+    filter_frame_t *out = calloc(n, sizeof(filter_frame_t));
+    size_t num = 0;
+    size_t k = 0;
+    double peak = 0;
+
+    if(NULL == in || NULL == out)
+    {
+        free(in);
+        free(out);
+        return -1;
+    }
+    for(k = 0; k < n; ++k)
+    {
+        in[k][0] = sim_clip(10000.0 * sin(2.0 * M_PI * hz * k / o->fs + 0.3));
+    }
+    if(use_cic)
+    {
+        filter_cic_init(&cic, o->stages, o->ratio);
+        num = filter_cic_process(&cic, in, n, out);
+    }
+    else
+    {
+        for(num = 0; num * o->ratio + o->ratio - 1 < n; ++num)
+        {
+            out[num][0] = in[num * o->ratio + o->ratio - 1][0];
+        }
+    }
+    for(k = num / 4; k < num; ++k)
+    {
+        peak = fmax(peak, fabs(out[k][0]));
+    }
+
+    free(in);
+    free(out);
+
+    return peak / 10000.0;
+}
+
+/* 按块处理整段数据，返回每通道每秒的采样数 (百万) */
+static double sim_speed(const filter_frame_t *in, size_t n, size_t block, int which,
+                        const filter_biquad_coef_t *q14, const sim_opts_t *o)
+{
+    static filter_cic_t cic;
+    static filter_biquad_t biquad;
+    static filter_mavg_t mavg;
+    static filter_median_t median;
+    filter_frame_t *out = calloc(block, sizeof(filter_frame_t));
+    volatile int16_t sink = 0;
+    double t0 = 0;
+    size_t k = 0;
+    size_t len = 0;
+    int r = 0;
+
+    if(NULL == out)
+    {
+        return 0;
+    }
+    filter_cic_init(&cic, o->stages, o->ratio);
+    filter_biquad_init(&biquad, q14);
+    filter_mavg_init(&mavg, SIM_MAVG_WINDOW);
+    filter_median_init(&median, SIM_MEDIAN_WINDOW);
+
+    t0 = sim_now_ns();
+    for(r = 0; r < SIM_SPEED_ROUNDS; ++r)
+    {
+        for(k = 0; k < n; k += block)
+        {
+            len = (n - k < block) ? n - k : block;
+            switch(which)
+            {
+                case 0: filter_cic_process(&cic, &in[k], len, out); break;
+                case 1: filter_biquad_process(&biquad, &in[k], len, out); break;
+                case 2: filter_mavg_process(&mavg, &in[k], len, out); break;
+                default: filter_median_process(&median, &in[k], len, out); break;
+            }
+            sink += out[0][0];
+        }
+    }
+
+    free(out);
+
+    return (double)n * SIM_SPEED_ROUNDS / (sim_now_ns() - t0) * 1e3;
+}
+
+int main(int argc, char *argv[])
+{
+    sim_opts_t o = { .fs = 1000, .ratio = 10, .stages = 3, .fc = 40, .q = M_SQRT1_2, .block = 40, .seconds = 10 };
+    static const char *names[] = { "cic", "biquad", "mavg", "median" };
+    filter_biquad_coef_t q14;
+    filter_frame_t *in = NULL;
+    sim_coef_t coef;
+    bool design = false;
+    double vib_hz = 0;
+    double rms = 0;
+    int32_t cic_err = 0;
+    int32_t biquad_err = 0;
+    uint32_t window_diff = 0;
+    size_t n = 0;
+    int num = 0;
+    int fail = 0;
+    int opt = 0;
+    int i = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "r:R:N:c:q:b:s:d")))
+    {
+        switch(opt)
+        {
+            case 'r': o.fs = strtod(optarg, NULL); break;
+            case 'R': o.ratio = (uint16_t)strtoul(optarg, NULL, 10); break;
+            case 'N': o.stages = (uint8_t)strtoul(optarg, NULL, 10); break;
+            case 'c': o.fc = strtod(optarg, NULL); break;
+            case 'q': o.q = strtod(optarg, NULL); break;
+            case 'b': o.block = strtoul(optarg, NULL, 10); break;
+            case 's': o.seconds = strtod(optarg, NULL); break;
+            case 'd': design = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-d] [-r hz] [-R ratio] [-N stages] [-c cutoff_hz] [-q q] [-b block] "
+                                "[-s seconds]\n", argv[0]);
+                return 2;
+        }
+    }
+    if(0 >= o.fs || 0 >= o.fc || o.fc >= o.fs / 2 || 0 >= o.q || 0 == o.block || 0 >= o.seconds)
+    {
+        fprintf(stderr, "invalid arguments\n");
+        return 2;
+    }
+
+    sim_design_lowpass(o.fs, o.fc, o.q, &coef);
+    sim_quantize(&coef, &q14);
+    if(design)
+    {
+        printf("/* 低通 fs = %g Hz, fc = %g Hz, Q = %.4f */\n", o.fs, o.fc, o.q);
+        printf("FILTER_BIQUAD_LOWPASS(%.8f, %.8f, %.8f)\n", coef.b[0], coef.a[0], coef.a[1]);
+        printf("/* Q14: b = %d %d %d, a = %d %d, DC gain %.5f */\n", q14.b[0], q14.b[1], q14.b[2], q14.a[0], q14.a[1],
+               (double)(q14.b[0] + q14.b[1] + q14.b[2]) / (16384 + q14.a[0] + q14.a[1]));
+        return 0;
+    }
+
+    n = (size_t)(o.fs * o.seconds);
+    in = calloc(n, sizeof(filter_frame_t));
+    if(NULL == in || 0 == n)
+    {
+        return 2;
+    }
+    // 振动频率选在抽取后会混叠到 5Hz 附近的位置
+    vib_hz = o.fs / o.ratio - 5.0;
+    sim_synth(in, n, o.fs, vib_hz);
+    printf("synthetic: %zu frames x %d channels at %g Hz, vibration %g Hz + 7 Hz/channel, spikes every 0.5 s\n",
+           n, SIM_CH, o.fs, vib_hz);
+
+    num = sim_check_cic(in, n, &o, &cic_err);
+    if(0 > num)
+    {
+        fprintf(stderr, "cic: invalid stages/ratio\n");
+        return 2;
+    }
+    sim_check_biquad(in, n, &q14, &biquad_err, &rms);
+    window_diff = sim_check_window(in, n);
+    fail |= (1 < cic_err) || (SIM_BIQUAD_ERR_MAX < biquad_err) || (0 != window_diff);
+
+    printf("cic N=%u R=%u: %d outputs at %g Hz, max error vs exact %d LSB\n", o.stages, o.ratio, num,
+           o.fs / o.ratio, cic_err);
+    printf("biquad lowpass fc=%g Hz Q=%.3f: max error vs double %d LSB, rms %.3f LSB\n", o.fc, o.q, biquad_err, rms);
+    printf("mavg %d / median %d: %u outputs differ from exact\n", SIM_MAVG_WINDOW, SIM_MEDIAN_WINDOW, window_diff);
+
+    printf("alias: %g Hz tone -> %g Hz, amplitude %.4f decimated directly, %.4f after cic\n", vib_hz,
+           o.fs / o.ratio - vib_hz, sim_tone(&o, vib_hz, false), sim_tone(&o, vib_hz, true));
+    printf("passband: 2 Hz amplitude %.4f, %g Hz amplitude %.4f after cic\n", sim_tone(&o, 2, true),
+           o.fs / o.ratio / 4, sim_tone(&o, o.fs / o.ratio / 4, true));
+
+    printf("host throughput (block %zu frames), Msamples/s per channel:", o.block);
+    for(i = 0; i < 4; ++i)
+    {
+        printf(" %s %.1f", names[i], sim_speed(in, n, o.block, i, &q14, &o));
+    }
+    printf("\n%s\n", fail ? "FAIL" : "ok");
+
+    free(in);
+
+    return fail;
+}
@@ -0,0 +1,8 @@
+#
+# 主机仿真框架的源文件，供 tools 下各工具的 Makefile 包含
+#
+# HOST_SIM 为本目录相对于包含者的路径
+#
+
+HOST_SIM_SRCS := $(wildcard $(HOST_SIM)/*.c)
+HOST_SIM_CFLAGS := -I$(HOST_SIM)/../include -I$(HOST_SIM)
@@ -0,0 +1,262 @@
+/**
+ * 主机仿真：PWM 驱动模型，行为说明见 sim_pwm.h
+ */
+#include <string.h>
+
+#include "driver/pwm.h"
+
+#include "sim_pwm.h"
+#include "sim_internal.h"
+
+typedef struct {
+    uint8_t channel_num;
+    int init;
+    int running;
+    int next_valid;
+    uint32_t t;                     /*!< 当前周期内的时间 (us) */
+    uint32_t stop_level;
+    uint32_t start_count;
+    sim_pwm_param_t param;          /*!< pwm_set_xxx() 修改的参数 */
+    sim_pwm_param_t next;           /*!< pwm_start() 计算的新通道表，周期结束时切换 */
+    sim_pwm_param_t run;            /*!< 正在输出的通道表 */
+} sim_pwm_t;
+
+static sim_pwm_t s_pwm;
+
+#define SIM_PWM_CHECK_CH(ch)        do { if(0 == s_pwm.init || s_pwm.channel_num <= (ch)) return ESP_ERR_INVALID_ARG; } while(0)
+
+void sim_pwm_reset(void)
+{
+    memset(&s_pwm, 0, sizeof(s_pwm));
+}
+
+int sim_pwm_level(const sim_pwm_param_t *param, uint8_t channel, uint32_t t)
+{
+    int32_t pos = ((int32_t)t - param->phases[channel]) % (int32_t)param->period;
+    int level = 0;
+
+    if(0 > pos)
+    {
+        pos += param->period;
+    }
+    level = ((uint32_t)pos < param->duties[channel]) ? 1 : 0;
+
+    return (0 != (param->invert_mask & (0x1 << channel))) ? !level : level;
+}
+
+uint32_t sim_pwm_step(int *period_start)
+{
+    uint32_t out = 0;
+    uint8_t i = 0;
+
+    if(NULL != period_start)
+    {
+        *period_start = 0;
+    }
+    if(0 == s_pwm.running)
+    {
+        return s_pwm.stop_level;
+    }
+
+    if(0 == s_pwm.t && NULL != period_start)
+    {
+        *period_start = 1;
+    }
+    for(i = 0; i < s_pwm.channel_num; ++i)
+    {
+        out |= (uint32_t)sim_pwm_level(&s_pwm.run, i, s_pwm.t) << i;
+    }
+
+    // 周期结束，切换到 pwm_start() 计算好的新通道表
+    if(++s_pwm.t >= s_pwm.run.period)
+    {
+        s_pwm.t = 0;
+        if(1 == s_pwm.next_valid)
+        {
+            s_pwm.run = s_pwm.next;
+            s_pwm.next_valid = 0;
+        }
+    }
+
+    return out;
+}
+
+bool sim_pwm_in_use(void)
+{
+    return 0 != s_pwm.init;
+}
+
+const sim_pwm_param_t *sim_pwm_running(void)
+{
+    return (1 == s_pwm.running) ? &s_pwm.run : NULL;
+}
+
+uint32_t sim_pwm_start_count(void)
+{
+    return s_pwm.start_count;
+}
+
+esp_err_t pwm_init(uint32_t period, uint32_t *duties, uint8_t channel_num, const uint32_t *pin_num)
+{
+    if(NULL == duties || NULL == pin_num || 0 == channel_num || SIM_PWM_CH_MAX < channel_num || 0 == period)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(sim_hw_timer_in_use())
+    {
+        sim_frc1_conflict("pwm_init");
+    }
+
+    memset(&s_pwm, 0, sizeof(s_pwm));
+    s_pwm.init = 1;
+    s_pwm.channel_num = channel_num;
+    s_pwm.param.period = period;
+    memcpy(s_pwm.param.duties, duties, channel_num * sizeof(uint32_t));
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_deinit(void)
+{
+    memset(&s_pwm, 0, sizeof(s_pwm));
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_set_duty(uint8_t channel_num, uint32_t duty)
+{
+    SIM_PWM_CHECK_CH(channel_num);
+    s_pwm.param.duties[channel_num] = duty;
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_get_duty(uint8_t channel_num, uint32_t *duty_p)
+{
+    SIM_PWM_CHECK_CH(channel_num);
+    *duty_p = s_pwm.param.duties[channel_num];
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_set_period(uint32_t period)
+{
+    if(0 == s_pwm.init || 0 == period)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_pwm.param.period = period;
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_get_period(uint32_t *period_p)
+{
+    *period_p = s_pwm.param.period;
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_start(void)
+{
+    if(0 == s_pwm.init)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ++s_pwm.start_count;
+    if(0 == s_pwm.running)
+    {
+        s_pwm.run = s_pwm.param;
+        s_pwm.t = 0;
+        s_pwm.running = 1;
+        s_pwm.next_valid = 0;
+    }
+    else
+    {
+        s_pwm.next = s_pwm.param;
+        s_pwm.next_valid = 1;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_stop(uint32_t stop_level_mask)
+{
+    if(0 == s_pwm.init)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_pwm.running = 0;
+    s_pwm.next_valid = 0;
+    s_pwm.stop_level = stop_level_mask;
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_set_duties(uint32_t *duties)
+{
+    if(0 == s_pwm.init || NULL == duties)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(s_pwm.param.duties, duties, s_pwm.channel_num * sizeof(uint32_t));
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_set_phase(uint8_t channel_num, int16_t phase)
+{
+    SIM_PWM_CHECK_CH(channel_num);
+    s_pwm.param.phases[channel_num] = phase;
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_set_phases(int16_t *phases)
+{
+    if(0 == s_pwm.init || NULL == phases)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(s_pwm.param.phases, phases, s_pwm.channel_num * sizeof(int16_t));
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_get_phase(uint8_t channel_num, uint16_t *phase_p)
+{
+    SIM_PWM_CHECK_CH(channel_num);
+    *phase_p = (uint16_t)s_pwm.param.phases[channel_num];
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_set_period_duties(uint32_t period, uint32_t *duties)
+{
+    esp_err_t ret = pwm_set_period(period);
+
+    return (ESP_OK == ret) ? pwm_set_duties(duties) : ret;
+}
+
+esp_err_t pwm_set_channel_invert(uint16_t channel_mask)
+{
+    if(0 == s_pwm.init)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_pwm.param.invert_mask |= channel_mask;
+
+    return ESP_OK;
+}
+
+esp_err_t pwm_clear_channel_invert(uint16_t channel_mask)
+{
+    if(0 == s_pwm.init)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_pwm.param.invert_mask &= ~channel_mask;
+
+    return ESP_OK;
+}
@@ -0,0 +1,81 @@
+/**
+ * 主机仿真：虚拟时间、中断事件与任务调度
+ *
+ * - 时间以 CPU 周期 (80MHz) 计，只在以下情况前进，运行结果与主机速度无关：
+ *   读 CCOUNT、忙等待 (os_delay_us 等)、驱动模型的传输时间、所有任务阻塞时跳到下一个事件
+ * - 中断 (hw_timer、GPIO) 为定时事件，到期时在当前上下文中执行回调；临界区内推迟到退出临界区
+ * - FreeRTOS 任务为用户态上下文 (ucontext)，同一时刻只有一个在运行：
+ *   阻塞 API 切换到调度器；节拍边界上有更高优先级的任务就绪时抢占，同优先级轮转
+ */
+#ifndef _SIM_H_
+#define _SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+
+#define SIM_CPU_MHZ                 (80)
+#define SIM_CYCLES_PER_US           (SIM_CPU_MHZ)
+#define SIM_CYCLES_PER_TICK         (SIM_CPU_MHZ * 1000000 / configTICK_RATE_HZ)
+#define SIM_TIME_NEVER              (UINT64_MAX)
+
+/* 读一次 CCOUNT 推进的周期数，保证忙等待循环能结束 */
+#define SIM_CCOUNT_READ_CYCLES      (4)
+
+typedef void (*sim_event_cb_t)(void *arg);
+
+typedef struct sim_event {
+    uint64_t when;                  /*!< 到期时刻 (周期) */
+    sim_event_cb_t cb;
+    void *arg;
+    bool armed;
+    struct sim_event *next;
+} sim_event_t;
+
+/**
+ * @brief  当前虚拟时间
+ */
+uint64_t sim_cycles(void);
+uint64_t sim_time_us(void);
+
+/**
+ * @brief  当前上下文忙等待，推进虚拟时间，期间到期的事件依次执行
+ */
+void sim_advance_cycles(uint64_t cycles);
+void sim_advance_us(uint32_t us);
+
+/**
+ * @brief  CCOUNT，每次读取推进 SIM_CCOUNT_READ_CYCLES 个周期
+ */
+uint32_t sim_ccount(void);
+
+/**
+ * @brief  定时事件，when 为绝对时刻 (周期)，重复调度会先取消
+ */
+void sim_event_schedule(sim_event_t *ev, uint64_t when, sim_event_cb_t cb, void *arg);
+void sim_event_cancel(sim_event_t *ev);
+
+/**
+ * @brief  立即执行中断回调，临界区内推迟执行
+ */
+void sim_isr_run(sim_event_cb_t cb, void *arg);
+
+/**
+ * @brief  是否在中断回调中
+ */
+bool sim_in_isr(void);
+
+/**
+ * @brief  运行仿真：创建 main 任务执行 app_main，直到虚拟时间到达 duration_us 或所有任务永久阻塞
+ *
+ * @return 结束时的虚拟时间 (us)
+ */
+uint64_t sim_run(void (*app_main)(void), uint64_t duration_us);
+
+/**
+ * @brief  请求结束仿真，当前任务切换出去后 sim_run() 返回
+ */
+void sim_stop(void);
+
+#endif /* _SIM_H_ */
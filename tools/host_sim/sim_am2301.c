@@ -0,0 +1,153 @@
+/**
+ * 主机仿真：AM2301 单总线模型，行为说明见 sim_models.h
+ *
+ * 主机释放总线 30us 后开始应答：低 80us、高 80us，然后 40 位数据 (高位在前)，
+ * 每位先低 50us，再高 26us 表示 0 或高 70us 表示 1，最后低 50us 后释放总线
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_models.h"
+
+#define SIM_AM2301_START_MIN_US     (800)
+#define SIM_AM2301_RESPONSE_US      (30)
+#define SIM_AM2301_ACK_US           (80)
+#define SIM_AM2301_BIT_LOW_US       (50)
+#define SIM_AM2301_BIT0_HIGH_US     (26)
+#define SIM_AM2301_BIT1_HIGH_US     (70)
+#define SIM_AM2301_BITS             (40)
+
+/* 应答 2 段 + 每位 2 段 + 结束 1 段 */
+#define SIM_AM2301_SEGMENTS         (2 + 2 * SIM_AM2301_BITS + 1)
+
+struct sim_am2301 {
+    gpio_num_t gpio_num;
+    sim_gpio_ext_t ext;
+    uint16_t humidity;
+    int16_t temp;
+    uint64_t low_since;             /*!< 主机开始拉低的时刻 */
+    bool host_low;
+    bool active;
+    uint64_t t0;                    /*!< 应答开始时刻 */
+    uint64_t seg_end[SIM_AM2301_SEGMENTS];  /*!< 每段结束时刻 (相对 t0，周期) */
+    uint8_t seg;                    /*!< 当前段，偶数段拉低，奇数段释放 */
+};
+
+static void sim_am2301_frame(sim_am2301_t *sensor)
+{
+    uint8_t data[5];
+    uint64_t t = 0;
+    int n = 0;
+    int i = 0;
+
+    data[0] = (uint8_t)(sensor->humidity >> 8);
+    data[1] = (uint8_t)sensor->humidity;
+    // 温度最高位为符号位，其余为绝对值
+    data[2] = (uint8_t)((uint16_t)abs(sensor->temp) >> 8) | ((0 > sensor->temp) ? 0x80 : 0);
+    data[3] = (uint8_t)abs(sensor->temp);
+    data[4] = (uint8_t)(data[0] + data[1] + data[2] + data[3]);
+
+    t += SIM_AM2301_ACK_US;
+    sensor->seg_end[n++] = t;
+    t += SIM_AM2301_ACK_US;
+    sensor->seg_end[n++] = t;
+    for(i = 0; i < SIM_AM2301_BITS; ++i)
+    {
+        t += SIM_AM2301_BIT_LOW_US;
+        sensor->seg_end[n++] = t;
+        t += (0 != (data[i / 8] & (0x80 >> (i % 8)))) ? SIM_AM2301_BIT1_HIGH_US : SIM_AM2301_BIT0_HIGH_US;
+        sensor->seg_end[n++] = t;
+    }
+    t += SIM_AM2301_BIT_LOW_US;
+    sensor->seg_end[n++] = t;
+
+    for(i = 0; i < n; ++i)
+    {
+        sensor->seg_end[i] *= SIM_CYCLES_PER_US;
+    }
+}
+
+static int sim_am2301_drive(void *ctx, gpio_num_t gpio_num)
+{
+    sim_am2301_t *sensor = ctx;
+    uint64_t now = sim_cycles();
+
+    if(!sensor->active || now < sensor->t0)
+    {
+        return -1;
+    }
+
+    while(SIM_AM2301_SEGMENTS > sensor->seg && now - sensor->t0 >= sensor->seg_end[sensor->seg])
+    {
+        ++sensor->seg;
+    }
+    if(SIM_AM2301_SEGMENTS <= sensor->seg)
+    {
+        sensor->active = false;
+        return -1;
+    }
+
+    return (0 == sensor->seg % 2) ? 0 : -1;
+}
+
+static void sim_am2301_changed(void *ctx, gpio_num_t gpio_num, int level)
+{
+    sim_am2301_t *sensor = ctx;
+    uint64_t now = sim_cycles();
+
+    // 主机没有等到结束信号就改为输出时，没有人再采样数据线，按时间判断这一帧是否已经发完
+    if(sensor->active && now >= sensor->t0 && now - sensor->t0 >= sensor->seg_end[SIM_AM2301_SEGMENTS - 1])
+    {
+        sensor->active = false;
+    }
+    if(sensor->active)
+    {
+        return;
+    }
+
+    // 主机拉低足够长时间后释放，作为起始信号
+    if(0 == level)
+    {
+        sensor->host_low = true;
+        sensor->low_since = now;
+    }
+    else if(sensor->host_low)
+    {
+        sensor->host_low = false;
+        if(now - sensor->low_since >= (uint64_t)SIM_AM2301_START_MIN_US * SIM_CYCLES_PER_US)
+        {
+            sim_am2301_frame(sensor);
+            sensor->t0 = now + (uint64_t)SIM_AM2301_RESPONSE_US * SIM_CYCLES_PER_US;
+            sensor->seg = 0;
+            sensor->active = true;
+        }
+    }
+}
+
+sim_am2301_t *sim_am2301_attach(gpio_num_t gpio_num)
+{
+    sim_am2301_t *sensor = calloc(1, sizeof(sim_am2301_t));
+
+    if(NULL == sensor)
+    {
+        return NULL;
+    }
+
+    sensor->gpio_num = gpio_num;
+    sensor->humidity = 500;
+    sensor->temp = 250;
+    sensor->ext.drive = sim_am2301_drive;
+    sensor->ext.changed = sim_am2301_changed;
+    sensor->ext.ctx = sensor;
+    sim_gpio_attach(gpio_num, &sensor->ext);
+
+    return sensor;
+}
+
+void sim_am2301_set(sim_am2301_t *sensor, uint16_t humidity, int16_t temp)
+{
+    sensor->humidity = humidity;
+    sensor->temp = temp;
+}
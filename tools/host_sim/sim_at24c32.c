@@ -0,0 +1,116 @@
+/**
+ * 主机仿真：AT24C32 模型，行为说明见 sim_models.h
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_i2c.h"
+#include "sim_models.h"
+
+#define SIM_AT24C32_SIZE            (4096)
+#define SIM_AT24C32_PAGE_SIZE       (32)
+
+struct sim_at24c32 {
+    sim_i2c_dev_t i2c;
+    uint8_t mem[SIM_AT24C32_SIZE];
+    uint8_t page[SIM_AT24C32_PAGE_SIZE];
+    uint32_t page_mask;             /*!< 页缓冲中被写入的字节 */
+    uint16_t ptr;
+    uint8_t addr_bytes;             /*!< 本次写访问已经收到的地址字节数 */
+    uint64_t busy_until;            /*!< 写周期结束时刻 */
+};
+
+static bool sim_at24c32_start(void *ctx, bool read)
+{
+    sim_at24c32_t *e2p = ctx;
+
+    // 写周期内不应答，主机可以用应答查询写周期是否结束
+    if(sim_cycles() < e2p->busy_until)
+    {
+        return false;
+    }
+
+    e2p->addr_bytes = 0;
+    e2p->page_mask = 0;
+
+    return true;
+}
+
+static bool sim_at24c32_write(void *ctx, uint8_t data)
+{
+    sim_at24c32_t *e2p = ctx;
+    uint16_t base = 0;
+
+    if(2 > e2p->addr_bytes)
+    {
+        e2p->ptr = ((e2p->ptr << 8) | data) & (SIM_AT24C32_SIZE - 1);
+        ++e2p->addr_bytes;
+        if(2 == e2p->addr_bytes)
+        {
+            memcpy(e2p->page, &e2p->mem[e2p->ptr & ~(SIM_AT24C32_PAGE_SIZE - 1)], SIM_AT24C32_PAGE_SIZE);
+        }
+        return true;
+    }
+
+    // 页写：地址低 5 位在页内回绕，超过一页的数据覆盖页首
+    base = e2p->ptr & ~(SIM_AT24C32_PAGE_SIZE - 1);
+    e2p->page[e2p->ptr - base] = data;
+    e2p->page_mask |= 1UL << (e2p->ptr - base);
+    e2p->ptr = base | ((e2p->ptr + 1) & (SIM_AT24C32_PAGE_SIZE - 1));
+
+    return true;
+}
+
+static uint8_t sim_at24c32_read(void *ctx)
+{
+    sim_at24c32_t *e2p = ctx;
+    uint8_t data = e2p->mem[e2p->ptr];
+
+    // 顺序读跨页连续
+    e2p->ptr = (e2p->ptr + 1) & (SIM_AT24C32_SIZE - 1);
+
+    return data;
+}
+
+static void sim_at24c32_stop(void *ctx)
+{
+    sim_at24c32_t *e2p = ctx;
+    uint16_t base = e2p->ptr & ~(SIM_AT24C32_PAGE_SIZE - 1);
+
+    // 收到数据后的 STOP 启动写周期，只写地址 (随机读的前半部分) 不启动
+    if(0 != e2p->page_mask)
+    {
+        memcpy(&e2p->mem[base], e2p->page, SIM_AT24C32_PAGE_SIZE);
+        e2p->page_mask = 0;
+        e2p->busy_until = sim_cycles() + (uint64_t)SIM_AT24C32_WRITE_US * SIM_CYCLES_PER_US;
+    }
+    e2p->addr_bytes = 0;
+}
+
+sim_at24c32_t *sim_at24c32_attach(uint8_t addr)
+{
+    sim_at24c32_t *e2p = calloc(1, sizeof(sim_at24c32_t));
+
+    if(NULL == e2p)
+    {
+        return NULL;
+    }
+
+    memset(e2p->mem, 0xFF, sizeof(e2p->mem));
+
+    e2p->i2c.addr = addr;
+    e2p->i2c.ctx = e2p;
+    e2p->i2c.start = sim_at24c32_start;
+    e2p->i2c.write = sim_at24c32_write;
+    e2p->i2c.read = sim_at24c32_read;
+    e2p->i2c.stop = sim_at24c32_stop;
+    sim_i2c_attach(&e2p->i2c);
+
+    return e2p;
+}
+
+uint8_t *sim_at24c32_mem(sim_at24c32_t *e2p)
+{
+    return e2p->mem;
+}
@@ -0,0 +1,259 @@
+/**
+ * 主机仿真：虚拟时间、定时事件、临界区与系统函数
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+
+/* 临界区内或中断嵌套时推迟执行的中断回调 */
+#define SIM_DEFERRED_MAX            (32)
+
+typedef struct {
+    sim_event_cb_t cb;
+    void *arg;
+} sim_deferred_t;
+
+static uint64_t s_now = 0;
+static uint64_t s_boot = 0;         /* 本次启动的时刻，深度睡眠唤醒后重新开始计时 */
+static sim_event_t *s_events = NULL;
+static uint32_t s_critical = 0;
+static uint32_t s_isr_nest = 0;
+static sim_deferred_t s_deferred[SIM_DEFERRED_MAX];
+static uint32_t s_deferred_num = 0;
+
+uint64_t sim_cycles(void)
+{
+    return s_now;
+}
+
+uint64_t sim_time_us(void)
+{
+    return s_now / SIM_CYCLES_PER_US;
+}
+
+uint64_t sim_boot_cycles(void)
+{
+    return s_boot;
+}
+
+void sim_boot_set(uint64_t boot)
+{
+    s_boot = boot;
+}
+
+void sim_core_reset(void)
+{
+    s_critical = 0;
+    s_deferred_num = 0;
+}
+
+bool sim_in_isr(void)
+{
+    return 0 < s_isr_nest;
+}
+
+static void sim_isr_call(sim_event_cb_t cb, void *arg)
+{
+    ++s_isr_nest;
+    cb(arg);
+    --s_isr_nest;
+}
+
+/* 执行推迟的中断回调，回调中再推迟的也一并执行 */
+static void sim_deferred_run(void)
+{
+    uint32_t i = 0;
+
+    for(i = 0; i < s_deferred_num; ++i)
+    {
+        sim_isr_call(s_deferred[i].cb, s_deferred[i].arg);
+    }
+    s_deferred_num = 0;
+}
+
+void sim_isr_run(sim_event_cb_t cb, void *arg)
+{
+    if(0 < s_critical || 0 < s_isr_nest)
+    {
+        if(SIM_DEFERRED_MAX <= s_deferred_num)
+        {
+            fprintf(stderr, "sim: too many deferred interrupts\n");
+            abort();
+        }
+        s_deferred[s_deferred_num].cb = cb;
+        s_deferred[s_deferred_num].arg = arg;
+        ++s_deferred_num;
+        return;
+    }
+
+    sim_isr_call(cb, arg);
+    sim_deferred_run();
+}
+
+void sim_event_cancel(sim_event_t *ev)
+{
+    sim_event_t **pp = &s_events;
+
+    if(!ev->armed)
+    {
+        return;
+    }
+    while(NULL != *pp && ev != *pp)
+    {
+        pp = &(*pp)->next;
+    }
+    if(NULL != *pp)
+    {
+        *pp = ev->next;
+    }
+    ev->armed = false;
+}
+
+void sim_event_schedule(sim_event_t *ev, uint64_t when, sim_event_cb_t cb, void *arg)
+{
+    sim_event_t **pp = &s_events;
+
+    sim_event_cancel(ev);
+    ev->when = when;
+    ev->cb = cb;
+    ev->arg = arg;
+    ev->armed = true;
+
+    // 按到期时刻排序，同一时刻先调度的先执行
+    while(NULL != *pp && (*pp)->when <= when)
+    {
+        pp = &(*pp)->next;
+    }
+    ev->next = *pp;
+    *pp = ev;
+}
+
+uint64_t sim_event_next(void)
+{
+    return (NULL != s_events) ? s_events->when : SIM_TIME_NEVER;
+}
+
+/* 执行到期时刻不晚于 until 的事件，时间停在每个事件的到期时刻 */
+static void sim_events_run(uint64_t until)
+{
+    sim_event_t *ev = NULL;
+
+    while(0 == s_critical && 0 == s_isr_nest && NULL != s_events && s_events->when <= until)
+    {
+        ev = s_events;
+        s_events = ev->next;
+        ev->armed = false;
+        if(ev->when > s_now)
+        {
+            s_now = ev->when;
+        }
+        sim_isr_run(ev->cb, ev->arg);
+    }
+}
+
+void sim_advance_cycles(uint64_t cycles)
+{
+    uint64_t end = s_now + cycles;
+
+    sim_gpio_flush();
+    sim_events_run(end);
+    s_now = end;
+
+    if(0 == s_critical && 0 == s_isr_nest)
+    {
+        sim_task_preempt();
+    }
+}
+
+void sim_advance_us(uint32_t us)
+{
+    sim_advance_cycles((uint64_t)us * SIM_CYCLES_PER_US);
+}
+
+void sim_advance_to(uint64_t when)
+{
+    if(when > s_now)
+    {
+        sim_events_run(when);
+        s_now = when;
+    }
+    else
+    {
+        sim_events_run(s_now);
+    }
+}
+
+uint32_t sim_ccount(void)
+{
+    sim_advance_cycles(SIM_CCOUNT_READ_CYCLES);
+
+    // 与目标一样从启动时开始计数
+    return (uint32_t)(s_now - s_boot);
+}
+
+void sim_critical_enter(void)
+{
+    ++s_critical;
+}
+
+void sim_critical_exit(void)
+{
+    if(0 == s_critical)
+    {
+        fprintf(stderr, "sim: unbalanced critical section\n");
+        abort();
+    }
+    if(0 == --s_critical && 0 == s_isr_nest)
+    {
+        sim_deferred_run();
+        sim_events_run(s_now);
+    }
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return (uint32_t)((s_now - s_boot) / (SIM_CYCLES_PER_US * 1000));
+}
+
+const char *esp_get_idf_version(void)
+{
+    return "v3.1-host-sim";
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return SIM_HEAP_SIZE;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return SIM_HEAP_SIZE;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return SIM_HEAP_SIZE;
+}
+
+void esp_restart(void)
+{
+    printf("sim: esp_restart() at %llu us\n", (unsigned long long)sim_time_us());
+    fflush(stdout);
+    exit(0);
+}
+
+void os_delay_us(uint16_t us)
+{
+    sim_advance_us(us);
+}
+
+void ets_delay_us(uint32_t us)
+{
+    sim_advance_us(us);
+}
@@ -0,0 +1,498 @@
+/**
+ * 主机仿真：DS3231 模型，行为说明见 sim_models.h
+ *
+ * 时间保存为从 2000-01-01 00:00:00 起的秒数，每次访问开始时按虚拟时间更新时间寄存器，
+ * 并检查这段时间内每一秒的闹钟匹配。只支持 24 小时制。
+ * 方波的电平由 DS3231 时间计算，连接到引脚时在每个边沿安排一个事件通知 GPIO 模型
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_models.h"
+
+#define SIM_DS3231_REG_NUM          (19)
+#define SIM_DS3231_REG_A1_SEC       (0x07)
+#define SIM_DS3231_REG_A2_MIN       (0x0B)
+#define SIM_DS3231_REG_CTRL         (0x0E)
+#define SIM_DS3231_REG_STATUS       (0x0F)
+#define SIM_DS3231_REG_TEMP_MSB     (0x11)
+#define SIM_DS3231_REG_TEMP_LSB     (0x12)
+
+#define SIM_DS3231_CTRL_EOSC        (0x80)
+#define SIM_DS3231_CTRL_RS_SHIFT    (3)
+#define SIM_DS3231_CTRL_INTCN       (0x04)
+#define SIM_DS3231_CTRL_A2IE        (0x02)
+#define SIM_DS3231_CTRL_A1IE        (0x01)
+#define SIM_DS3231_STATUS_OSF       (0x80)
+#define SIM_DS3231_STATUS_EN32KHZ   (0x08)
+#define SIM_DS3231_STATUS_A2F       (0x02)
+#define SIM_DS3231_STATUS_A1F       (0x01)
+
+#define SIM_DS3231_ALARM_MASK       (0x80)
+#define SIM_DS3231_ALARM_DY         (0x40)
+
+/* 一次访问最多补查的闹钟秒数，更久没有访问时跳过 */
+#define SIM_DS3231_ALARM_SCAN_MAX   (2 * 86400)
+
+#define SIM_DS3231_SECS_PER_DAY     (86400)
+#define SIM_CYCLES_PER_SEC          ((uint64_t)SIM_CYCLES_PER_US * 1000000)
+#define SIM_DS3231_PPB              (1000000000LL)
+#define SIM_DS3231_32K_HZ           (32768)
+
+typedef struct {
+    uint8_t sec;
+    uint8_t min;
+    uint8_t hour;
+    uint8_t wday;
+    uint8_t date;
+    uint8_t month;
+    uint8_t year;                   /*!< 00~99 */
+} sim_ds3231_time_t;
+
+struct sim_ds3231 {
+    sim_i2c_dev_t i2c;
+    uint8_t regs[SIM_DS3231_REG_NUM];
+    uint8_t ptr;
+    bool ptr_set;
+    bool time_written;              /*!< 本次访问写了时间寄存器，STOP 时重新计时 */
+    uint32_t base_secs;             /*!< base_cycles 时刻的时间 */
+    uint64_t base_cycles;
+    uint8_t base_wday;              /*!< base_secs 所在那天的星期 */
+    uint32_t checked_secs;          /*!< 闹钟已经检查到的时间 */
+    int32_t drift_ppb;              /*!< 虚拟时钟 (ESP8266) 相对 DS3231 的误差 */
+    int sqw_gpio;                   /*!< 连接的引脚，-1 为没有连接 */
+    int k32_gpio;
+    sim_gpio_ext_t sqw_ext;
+    sim_gpio_ext_t k32_ext;
+    sim_event_t sqw_event;
+    sim_event_t k32_event;
+};
+
+static uint8_t sim_bcd(uint8_t value)
+{
+    return (uint8_t)(((value / 10) << 4) | (value % 10));
+}
+
+static uint8_t sim_bcd_value(uint8_t bcd)
+{
+    return (uint8_t)((bcd >> 4) * 10 + (bcd & 0x0F));
+}
+
+static uint8_t sim_ds3231_month_days(uint8_t year, uint8_t month)
+{
+    static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    // 2000~2099 年中能被 4 整除的都是闰年
+    return (2 == month && 0 == year % 4) ? 29 : days[month - 1];
+}
+
+static void sim_ds3231_split(const sim_ds3231_t *rtc, uint32_t secs, sim_ds3231_time_t *t)
+{
+    uint32_t days = secs / SIM_DS3231_SECS_PER_DAY;
+    uint32_t base_days = rtc->base_secs / SIM_DS3231_SECS_PER_DAY;
+    uint32_t year_days = 0;
+
+    t->sec = secs % 60;
+    t->min = (secs / 60) % 60;
+    t->hour = (secs / 3600) % 24;
+    t->wday = (uint8_t)((rtc->base_wday - 1 + (days - base_days)) % 7 + 1);
+
+    t->year = 0;
+    for(;;)
+    {
+        year_days = (0 == t->year % 4) ? 366 : 365;
+        if(days < year_days)
+        {
+            break;
+        }
+        days -= year_days;
+        t->year = (t->year + 1) % 100;
+    }
+    t->month = 1;
+    while(days >= sim_ds3231_month_days(t->year, t->month))
+    {
+        days -= sim_ds3231_month_days(t->year, t->month);
+        ++t->month;
+    }
+    t->date = (uint8_t)(days + 1);
+}
+
+static uint32_t sim_ds3231_join(const sim_ds3231_time_t *t)
+{
+    uint32_t days = 0;
+    uint8_t i = 0;
+
+    for(i = 0; i < t->year; ++i)
+    {
+        days += (0 == i % 4) ? 366 : 365;
+    }
+    for(i = 1; i < t->month && i <= 12; ++i)
+    {
+        days += sim_ds3231_month_days(t->year, i);
+    }
+    days += t->date - 1;
+
+    return days * SIM_DS3231_SECS_PER_DAY + t->hour * 3600 + t->min * 60 + t->sec;
+}
+
+/* 从 base_cycles 起经过的 DS3231 时间，单位 1/den 秒，向下取整 */
+static uint64_t sim_ds3231_elapsed(const sim_ds3231_t *rtc, uint64_t den)
+{
+    return (uint64_t)((unsigned __int128)(sim_cycles() - rtc->base_cycles) * den * SIM_DS3231_PPB
+                      / ((unsigned __int128)SIM_CYCLES_PER_SEC * (SIM_DS3231_PPB + rtc->drift_ppb)));
+}
+
+/* DS3231 时间 num/den 秒 (从 base_cycles 起) 对应的虚拟时刻，向上取整 */
+static uint64_t sim_ds3231_cycles_at(const sim_ds3231_t *rtc, uint64_t num, uint64_t den)
+{
+    unsigned __int128 scaled = (unsigned __int128)num * SIM_CYCLES_PER_SEC * (SIM_DS3231_PPB + rtc->drift_ppb);
+    unsigned __int128 div = (unsigned __int128)den * SIM_DS3231_PPB;
+
+    return rtc->base_cycles + (uint64_t)((scaled + div - 1) / div);
+}
+
+static uint32_t sim_ds3231_now(const sim_ds3231_t *rtc)
+{
+    // 振荡器停止时时间不走
+    if(0 != (rtc->regs[SIM_DS3231_REG_CTRL] & SIM_DS3231_CTRL_EOSC))
+    {
+        return rtc->base_secs;
+    }
+
+    return rtc->base_secs + (uint32_t)sim_ds3231_elapsed(rtc, 1);
+}
+
+/* 方波的电平：秒的起点为高电平，前半周期高、后半周期低 */
+static int sim_ds3231_wave(const sim_ds3231_t *rtc, uint32_t hz)
+{
+    return (0 == sim_ds3231_elapsed(rtc, 2 * (uint64_t)hz) % 2) ? 1 : 0;
+}
+
+static uint32_t sim_ds3231_sqw_hz(const sim_ds3231_t *rtc)
+{
+    static const uint32_t hz[4] = { 1, 1024, 4096, 8192 };
+
+    return hz[(rtc->regs[SIM_DS3231_REG_CTRL] >> SIM_DS3231_CTRL_RS_SHIFT) & 0x03];
+}
+
+static bool sim_ds3231_sqw_on(const sim_ds3231_t *rtc)
+{
+    return 0 == (rtc->regs[SIM_DS3231_REG_CTRL] & (SIM_DS3231_CTRL_INTCN | SIM_DS3231_CTRL_EOSC));
+}
+
+static bool sim_ds3231_k32_on(const sim_ds3231_t *rtc)
+{
+    return 0 != (rtc->regs[SIM_DS3231_REG_STATUS] & SIM_DS3231_STATUS_EN32KHZ)
+           && 0 == (rtc->regs[SIM_DS3231_REG_CTRL] & SIM_DS3231_CTRL_EOSC);
+}
+
+static void sim_ds3231_schedule(sim_ds3231_t *rtc);
+
+static void sim_ds3231_edge(void *arg)
+{
+    sim_gpio_update();
+    sim_ds3231_schedule(arg);
+}
+
+/* 在已连接引脚的下一个方波边沿安排事件，方波关闭时取消 */
+static void sim_ds3231_schedule(sim_ds3231_t *rtc)
+{
+    uint64_t den = 0;
+
+    if(0 <= rtc->sqw_gpio && sim_ds3231_sqw_on(rtc))
+    {
+        den = 2 * (uint64_t)sim_ds3231_sqw_hz(rtc);
+        sim_event_schedule(&rtc->sqw_event, sim_ds3231_cycles_at(rtc, sim_ds3231_elapsed(rtc, den) + 1, den),
+                           sim_ds3231_edge, rtc);
+    }
+    else
+    {
+        sim_event_cancel(&rtc->sqw_event);
+    }
+
+    if(0 <= rtc->k32_gpio && sim_ds3231_k32_on(rtc))
+    {
+        den = 2 * SIM_DS3231_32K_HZ;
+        sim_event_schedule(&rtc->k32_event, sim_ds3231_cycles_at(rtc, sim_ds3231_elapsed(rtc, den) + 1, den),
+                           sim_ds3231_edge, rtc);
+    }
+    else
+    {
+        sim_event_cancel(&rtc->k32_event);
+    }
+}
+
+/* 寄存器或时间改变后更新引脚电平与边沿事件 */
+static void sim_ds3231_pins_changed(sim_ds3231_t *rtc)
+{
+    if(0 > rtc->sqw_gpio && 0 > rtc->k32_gpio)
+    {
+        return;
+    }
+    sim_gpio_update();
+    sim_ds3231_schedule(rtc);
+}
+
+/* 闹钟寄存器某一项是否匹配，屏蔽位置 1 时不比较 */
+static bool sim_ds3231_field_match(uint8_t reg, uint8_t value)
+{
+    return 0 != (reg & SIM_DS3231_ALARM_MASK) || (reg & 0x7F) == sim_bcd(value);
+}
+
+static bool sim_ds3231_day_match(uint8_t reg, const sim_ds3231_time_t *t)
+{
+    if(0 != (reg & SIM_DS3231_ALARM_MASK))
+    {
+        return true;
+    }
+
+    return (0 != (reg & SIM_DS3231_ALARM_DY)) ? (reg & 0x0F) == t->wday : (reg & 0x3F) == sim_bcd(t->date);
+}
+
+static void sim_ds3231_check_alarms(sim_ds3231_t *rtc, uint32_t now)
+{
+    const uint8_t *a1 = &rtc->regs[SIM_DS3231_REG_A1_SEC];
+    const uint8_t *a2 = &rtc->regs[SIM_DS3231_REG_A2_MIN];
+    sim_ds3231_time_t t;
+    uint32_t secs = 0;
+
+    if(now - rtc->checked_secs > SIM_DS3231_ALARM_SCAN_MAX)
+    {
+        rtc->checked_secs = now - SIM_DS3231_ALARM_SCAN_MAX;
+    }
+
+    for(secs = rtc->checked_secs + 1; secs <= now && rtc->checked_secs < now; ++secs)
+    {
+        sim_ds3231_split(rtc, secs, &t);
+        if(sim_ds3231_field_match(a1[0], t.sec) && sim_ds3231_field_match(a1[1], t.min)
+           && sim_ds3231_field_match(a1[2], t.hour) && sim_ds3231_day_match(a1[3], &t))
+        {
+            rtc->regs[SIM_DS3231_REG_STATUS] |= SIM_DS3231_STATUS_A1F;
+        }
+        // 闹钟 2 没有秒，在整分钟匹配
+        if(0 == t.sec && sim_ds3231_field_match(a2[0], t.min)
+           && sim_ds3231_field_match(a2[1], t.hour) && sim_ds3231_day_match(a2[2], &t))
+        {
+            rtc->regs[SIM_DS3231_REG_STATUS] |= SIM_DS3231_STATUS_A2F;
+        }
+    }
+    rtc->checked_secs = now;
+}
+
+static void sim_ds3231_refresh(sim_ds3231_t *rtc)
+{
+    uint32_t now = sim_ds3231_now(rtc);
+    sim_ds3231_time_t t;
+
+    sim_ds3231_check_alarms(rtc, now);
+    sim_ds3231_split(rtc, now, &t);
+    rtc->regs[0] = sim_bcd(t.sec);
+    rtc->regs[1] = sim_bcd(t.min);
+    rtc->regs[2] = sim_bcd(t.hour);
+    rtc->regs[3] = t.wday;
+    rtc->regs[4] = sim_bcd(t.date);
+    // 世纪位不使用
+    rtc->regs[5] = sim_bcd(t.month);
+    rtc->regs[6] = sim_bcd(t.year);
+}
+
+/* 主机写入时间寄存器后，从寄存器重新开始计时 */
+static void sim_ds3231_rebase(sim_ds3231_t *rtc)
+{
+    sim_ds3231_time_t t;
+
+    t.sec = sim_bcd_value(rtc->regs[0] & 0x7F);
+    t.min = sim_bcd_value(rtc->regs[1] & 0x7F);
+    t.hour = sim_bcd_value(rtc->regs[2] & 0x3F);
+    t.wday = rtc->regs[3] & 0x07;
+    t.date = sim_bcd_value(rtc->regs[4] & 0x3F);
+    t.month = sim_bcd_value(rtc->regs[5] & 0x1F);
+    t.year = sim_bcd_value(rtc->regs[6]);
+    if(1 > t.month || 12 < t.month || 1 > t.date)
+    {
+        t.month = 1;
+        t.date = 1;
+    }
+
+    rtc->base_secs = sim_ds3231_join(&t);
+    rtc->base_cycles = sim_cycles();
+    rtc->base_wday = (0 == t.wday) ? 1 : t.wday;
+    rtc->checked_secs = rtc->base_secs;
+}
+
+static bool sim_ds3231_start(void *ctx, bool read)
+{
+    sim_ds3231_t *rtc = ctx;
+
+    rtc->ptr_set = false;
+    rtc->time_written = false;
+    sim_ds3231_refresh(rtc);
+
+    return true;
+}
+
+static bool sim_ds3231_write(void *ctx, uint8_t data)
+{
+    sim_ds3231_t *rtc = ctx;
+    uint8_t *status = &rtc->regs[SIM_DS3231_REG_STATUS];
+
+    if(!rtc->ptr_set)
+    {
+        rtc->ptr = (SIM_DS3231_REG_NUM > data) ? data : 0;
+        rtc->ptr_set = true;
+        return true;
+    }
+
+    if(SIM_DS3231_REG_STATUS == rtc->ptr)
+    {
+        // OSF、A2F、A1F 只能写 0 清除，EN32kHz 可写，其余只读
+        *status &= data | ~(SIM_DS3231_STATUS_OSF | SIM_DS3231_STATUS_A2F | SIM_DS3231_STATUS_A1F);
+        *status = (*status & ~SIM_DS3231_STATUS_EN32KHZ) | (data & SIM_DS3231_STATUS_EN32KHZ);
+    }
+    else if(SIM_DS3231_REG_TEMP_MSB > rtc->ptr)
+    {
+        rtc->regs[rtc->ptr] = data;
+        if(SIM_DS3231_REG_A1_SEC > rtc->ptr)
+        {
+            rtc->time_written = true;
+        }
+    }
+    rtc->ptr = (rtc->ptr + 1) % SIM_DS3231_REG_NUM;
+
+    return true;
+}
+
+static uint8_t sim_ds3231_read(void *ctx)
+{
+    sim_ds3231_t *rtc = ctx;
+    uint8_t data = rtc->regs[rtc->ptr];
+
+    rtc->ptr = (rtc->ptr + 1) % SIM_DS3231_REG_NUM;
+
+    return data;
+}
+
+static void sim_ds3231_stop(void *ctx)
+{
+    sim_ds3231_t *rtc = ctx;
+
+    if(rtc->time_written)
+    {
+        rtc->time_written = false;
+        sim_ds3231_rebase(rtc);
+    }
+    sim_ds3231_pins_changed(rtc);
+}
+
+sim_ds3231_t *sim_ds3231_attach(uint8_t addr)
+{
+    sim_ds3231_t *rtc = calloc(1, sizeof(sim_ds3231_t));
+
+    if(NULL == rtc)
+    {
+        return NULL;
+    }
+
+    rtc->sqw_gpio = -1;
+    rtc->k32_gpio = -1;
+    rtc->regs[SIM_DS3231_REG_CTRL] = 0x1C;
+    rtc->regs[SIM_DS3231_REG_STATUS] = SIM_DS3231_STATUS_OSF | SIM_DS3231_STATUS_EN32KHZ;
+    sim_ds3231_set_time(rtc, 2000, 1, 1, 6, 0, 0, 0);
+    sim_ds3231_set_temp(rtc, 2525);
+
+    rtc->i2c.addr = addr;
+    rtc->i2c.ctx = rtc;
+    rtc->i2c.start = sim_ds3231_start;
+    rtc->i2c.write = sim_ds3231_write;
+    rtc->i2c.read = sim_ds3231_read;
+    rtc->i2c.stop = sim_ds3231_stop;
+    sim_i2c_attach(&rtc->i2c);
+
+    return rtc;
+}
+
+void sim_ds3231_set_time(sim_ds3231_t *rtc, uint16_t year, uint8_t month, uint8_t date,
+                         uint8_t wday, uint8_t hour, uint8_t min, uint8_t sec)
+{
+    rtc->regs[0] = sim_bcd(sec);
+    rtc->regs[1] = sim_bcd(min);
+    rtc->regs[2] = sim_bcd(hour);
+    rtc->regs[3] = wday;
+    rtc->regs[4] = sim_bcd(date);
+    rtc->regs[5] = sim_bcd(month);
+    rtc->regs[6] = sim_bcd((uint8_t)(year % 100));
+    sim_ds3231_rebase(rtc);
+    sim_ds3231_pins_changed(rtc);
+}
+
+void sim_ds3231_set_temp(sim_ds3231_t *rtc, int32_t centi)
+{
+    // 高字节为整数部分 (补码)，低字节 bit7:6 为 0.25°C 的倍数
+    int32_t quarters = (centi >= 0) ? (centi + 12) / 25 : -((-centi + 12) / 25);
+
+    rtc->regs[SIM_DS3231_REG_TEMP_MSB] = (uint8_t)(quarters >> 2);
+    rtc->regs[SIM_DS3231_REG_TEMP_LSB] = (uint8_t)((quarters & 0x03) << 6);
+}
+
+int sim_ds3231_int_level(sim_ds3231_t *rtc)
+{
+    uint8_t ctrl = rtc->regs[SIM_DS3231_REG_CTRL];
+    uint8_t status = 0;
+
+    sim_ds3231_refresh(rtc);
+    status = rtc->regs[SIM_DS3231_REG_STATUS];
+    if(0 == (ctrl & SIM_DS3231_CTRL_INTCN))
+    {
+        return sim_ds3231_sqw_on(rtc) ? sim_ds3231_wave(rtc, sim_ds3231_sqw_hz(rtc)) : 1;
+    }
+    if((0 != (ctrl & SIM_DS3231_CTRL_A1IE) && 0 != (status & SIM_DS3231_STATUS_A1F))
+       || (0 != (ctrl & SIM_DS3231_CTRL_A2IE) && 0 != (status & SIM_DS3231_STATUS_A2F)))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+void sim_ds3231_set_drift(sim_ds3231_t *rtc, int32_t ppb)
+{
+    // 从当前时刻起按新的速率计时
+    sim_ds3231_refresh(rtc);
+    sim_ds3231_rebase(rtc);
+    rtc->drift_ppb = ppb;
+    sim_ds3231_pins_changed(rtc);
+}
+
+/* 开漏输出：低电平时拉低，高电平时释放 */
+static int sim_ds3231_sqw_drive(void *ctx, gpio_num_t gpio_num)
+{
+    return (0 == sim_ds3231_int_level(ctx)) ? 0 : -1;
+}
+
+static int sim_ds3231_k32_drive(void *ctx, gpio_num_t gpio_num)
+{
+    sim_ds3231_t *rtc = ctx;
+
+    return (sim_ds3231_k32_on(rtc) && 0 == sim_ds3231_wave(rtc, SIM_DS3231_32K_HZ)) ? 0 : -1;
+}
+
+void sim_ds3231_connect_sqw(sim_ds3231_t *rtc, gpio_num_t gpio_num)
+{
+    rtc->sqw_gpio = gpio_num;
+    rtc->sqw_ext.drive = sim_ds3231_sqw_drive;
+    rtc->sqw_ext.ctx = rtc;
+    sim_gpio_attach(gpio_num, &rtc->sqw_ext);
+    sim_ds3231_pins_changed(rtc);
+}
+
+void sim_ds3231_connect_32k(sim_ds3231_t *rtc, gpio_num_t gpio_num)
+{
+    rtc->k32_gpio = gpio_num;
+    rtc->k32_ext.drive = sim_ds3231_k32_drive;
+    rtc->k32_ext.ctx = rtc;
+    sim_gpio_attach(gpio_num, &rtc->k32_ext);
+    sim_ds3231_pins_changed(rtc);
+}
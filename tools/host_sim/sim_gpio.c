@@ -0,0 +1,421 @@
+/**
+ * 主机仿真：GPIO 驱动与寄存器模型，行为说明见 sim_gpio.h
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver/gpio.h"
+#include "esp8266/gpio_struct.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+#include "sim_gpio.h"
+
+/* 外部驱动在电平变化回调中又改变电平时，最多重新计算的次数 */
+#define SIM_GPIO_SETTLE_MAX         (8)
+
+typedef struct {
+    bool od;                        /*!< 开漏输出 */
+    bool pulldown;
+    int level;                      /*!< 上次计算的电平 */
+    int from;                       /*!< 跳线来源，-1 为没有 */
+    uint32_t edges;
+    gpio_int_type_t intr_type;
+    gpio_isr_t isr;
+    void *isr_arg;
+    const sim_gpio_ext_t *ext;
+} sim_gpio_pin_t;
+
+static gpio_dev_t s_regs;
+static uint32_t s_out16 = 0;        /* GPIO16 在 RTC 寄存器中，单独保存 */
+static uint32_t s_enable16 = 0;
+static sim_gpio_pin_t s_pins[GPIO_NUM_MAX];
+static bool s_init = false;
+static bool s_updating = false;
+static bool s_again = false;
+
+static void sim_gpio_init(void)
+{
+    int i = 0;
+
+    if(s_init)
+    {
+        return;
+    }
+    for(i = 0; i < GPIO_NUM_MAX; ++i)
+    {
+        s_pins[i].level = 1;
+        s_pins[i].from = -1;
+    }
+    s_init = true;
+}
+
+static bool sim_gpio_out(gpio_num_t gpio_num)
+{
+    return (GPIO_NUM_16 == gpio_num) ? (0 != s_out16) : (0 != (s_regs.out & (1 << gpio_num)));
+}
+
+static bool sim_gpio_enabled(gpio_num_t gpio_num)
+{
+    return (GPIO_NUM_16 == gpio_num) ? (0 != s_enable16) : (0 != (s_regs.enable & (1 << gpio_num)));
+}
+
+static int sim_gpio_resolve(gpio_num_t gpio_num, int depth)
+{
+    sim_gpio_pin_t *pin = &s_pins[gpio_num];
+    bool enabled = sim_gpio_enabled(gpio_num);
+    int ext = -1;
+
+    if(enabled && !pin->od)
+    {
+        return sim_gpio_out(gpio_num) ? 1 : 0;
+    }
+
+    if(enabled && !sim_gpio_out(gpio_num))
+    {
+        return 0;
+    }
+    if(NULL != pin->ext)
+    {
+        ext = pin->ext->drive(pin->ext->ctx, gpio_num);
+        if(0 <= ext)
+        {
+            return ext;
+        }
+    }
+    if(0 <= pin->from && 0 < depth)
+    {
+        return sim_gpio_resolve((gpio_num_t)pin->from, depth - 1);
+    }
+
+    return pin->pulldown ? 0 : 1;
+}
+
+int sim_gpio_level(gpio_num_t gpio_num)
+{
+    sim_gpio_init();
+
+    return sim_gpio_resolve(gpio_num, GPIO_NUM_MAX);
+}
+
+static bool sim_gpio_intr_match(gpio_int_type_t type, int level)
+{
+    switch(type)
+    {
+        case GPIO_INTR_POSEDGE:
+        case GPIO_INTR_HIGH_LEVEL:
+            return 1 == level;
+        case GPIO_INTR_NEGEDGE:
+        case GPIO_INTR_LOW_LEVEL:
+            return 0 == level;
+        case GPIO_INTR_ANYEDGE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void sim_gpio_update(void)
+{
+    sim_gpio_pin_t *pin = NULL;
+    int level = 0;
+    int round = 0;
+    int i = 0;
+
+    sim_gpio_init();
+
+    // 回调里引起的变化由外层循环处理
+    if(s_updating)
+    {
+        s_again = true;
+        return;
+    }
+
+    s_updating = true;
+    do
+    {
+        s_again = false;
+        for(i = 0; i < GPIO_NUM_MAX; ++i)
+        {
+            pin = &s_pins[i];
+            level = sim_gpio_resolve((gpio_num_t)i, GPIO_NUM_MAX);
+            if(level == pin->level)
+            {
+                continue;
+            }
+            pin->level = level;
+            ++pin->edges;
+
+            if(NULL != pin->ext && NULL != pin->ext->changed)
+            {
+                pin->ext->changed(pin->ext->ctx, (gpio_num_t)i, level);
+            }
+            if(NULL != pin->isr && sim_gpio_intr_match(pin->intr_type, level))
+            {
+                if(GPIO_NUM_16 != i)
+                {
+                    s_regs.status |= (1 << i);
+                }
+                sim_isr_run(pin->isr, pin->isr_arg);
+            }
+        }
+    } while(s_again && ++round < SIM_GPIO_SETTLE_MAX);
+    s_updating = false;
+}
+
+void sim_gpio_flush(void)
+{
+    bool dirty = false;
+
+    if(0 != s_regs.out_w1ts || 0 != s_regs.out_w1tc)
+    {
+        s_regs.out = (s_regs.out | s_regs.out_w1ts) & ~s_regs.out_w1tc;
+        s_regs.out_w1ts = 0;
+        s_regs.out_w1tc = 0;
+        dirty = true;
+    }
+    if(0 != s_regs.enable_w1ts || 0 != s_regs.enable_w1tc)
+    {
+        s_regs.enable = (s_regs.enable | s_regs.enable_w1ts) & ~s_regs.enable_w1tc;
+        s_regs.enable_w1ts = 0;
+        s_regs.enable_w1tc = 0;
+        dirty = true;
+    }
+    if(0 != s_regs.status_w1ts || 0 != s_regs.status_w1tc)
+    {
+        s_regs.status = (s_regs.status | s_regs.status_w1ts) & ~s_regs.status_w1tc;
+        s_regs.status_w1ts = 0;
+        s_regs.status_w1tc = 0;
+    }
+
+    if(dirty)
+    {
+        sim_gpio_update();
+    }
+}
+
+gpio_dev_t *sim_gpio_regs(void)
+{
+    uint32_t in = 0;
+    int i = 0;
+
+    sim_gpio_flush();
+    // 直接写 out/enable 的情况也在这里生效
+    sim_gpio_update();
+
+    for(i = 0; i < GPIO_NUM_16; ++i)
+    {
+        in |= (uint32_t)s_pins[i].level << i;
+    }
+    s_regs.in = in;
+
+    return &s_regs;
+}
+
+void sim_gpio_attach(gpio_num_t gpio_num, const sim_gpio_ext_t *ext)
+{
+    sim_gpio_init();
+    s_pins[gpio_num].ext = ext;
+    sim_gpio_update();
+}
+
+void sim_gpio_connect(gpio_num_t from, gpio_num_t to)
+{
+    sim_gpio_init();
+    s_pins[to].from = from;
+    sim_gpio_update();
+}
+
+/* 寄存器与引脚配置恢复为复位值，外部驱动与跳线保持 */
+void sim_gpio_reset(void)
+{
+    int i = 0;
+
+    sim_gpio_init();
+    memset((void *)&s_regs, 0, sizeof(s_regs));
+    s_out16 = 0;
+    s_enable16 = 0;
+    for(i = 0; i < GPIO_NUM_MAX; ++i)
+    {
+        s_pins[i].od = false;
+        s_pins[i].pulldown = false;
+        s_pins[i].intr_type = GPIO_INTR_DISABLE;
+        s_pins[i].isr = NULL;
+        s_pins[i].isr_arg = NULL;
+    }
+    sim_gpio_update();
+}
+
+uint32_t sim_gpio_edges(gpio_num_t gpio_num)
+{
+    return s_pins[gpio_num].edges;
+}
+
+static void sim_gpio_set_enable(gpio_num_t gpio_num, bool enable)
+{
+    if(GPIO_NUM_16 == gpio_num)
+    {
+        s_enable16 = enable ? 1 : 0;
+    }
+    else if(enable)
+    {
+        s_regs.enable |= (1 << gpio_num);
+    }
+    else
+    {
+        s_regs.enable &= ~(1 << gpio_num);
+    }
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    if(!GPIO_IS_VALID_GPIO(gpio_num))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // GPIO16 没有开漏输出
+    if(GPIO_NUM_16 == gpio_num && GPIO_MODE_OUTPUT_OD == mode)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sim_gpio_init();
+    sim_gpio_flush();
+    s_pins[gpio_num].od = (GPIO_MODE_OUTPUT_OD == mode);
+    sim_gpio_set_enable(gpio_num, GPIO_MODE_OUTPUT == mode || GPIO_MODE_OUTPUT_OD == mode);
+    sim_gpio_update();
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull)
+{
+    if(!GPIO_IS_VALID_GPIO(gpio_num))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sim_gpio_init();
+    s_pins[gpio_num].pulldown = (GPIO_PULLDOWN_ONLY == pull);
+    sim_gpio_update();
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+    // GPIO16 不支持中断
+    if(!GPIO_IS_VALID_GPIO(gpio_num) || GPIO_NUM_16 == gpio_num || GPIO_INTR_MAX <= intr_type)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_pins[gpio_num].intr_type = intr_type;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_config(const gpio_config_t *gpio_cfg)
+{
+    int i = 0;
+
+    for(i = 0; i < GPIO_NUM_MAX; ++i)
+    {
+        if(0 == (gpio_cfg->pin_bit_mask & (1UL << i)))
+        {
+            continue;
+        }
+        if(ESP_OK != gpio_set_direction((gpio_num_t)i, gpio_cfg->mode))
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        gpio_set_pull_mode((gpio_num_t)i, (GPIO_PULLDOWN_ENABLE == gpio_cfg->pull_down_en) ? GPIO_PULLDOWN_ONLY
+                           : (GPIO_PULLUP_ENABLE == gpio_cfg->pull_up_en) ? GPIO_PULLUP_ONLY : GPIO_FLOATING);
+        if(GPIO_NUM_16 != i)
+        {
+            gpio_set_intr_type((gpio_num_t)i, gpio_cfg->intr_type);
+        }
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if(!GPIO_IS_VALID_GPIO(gpio_num))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sim_gpio_init();
+    sim_gpio_flush();
+    if(GPIO_NUM_16 == gpio_num)
+    {
+        s_out16 = level ? 1 : 0;
+    }
+    else if(level)
+    {
+        s_regs.out |= (1 << gpio_num);
+    }
+    else
+    {
+        s_regs.out &= ~(1 << gpio_num);
+    }
+    sim_gpio_update();
+
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    if(!GPIO_IS_VALID_GPIO(gpio_num))
+    {
+        return 0;
+    }
+
+    sim_advance_cycles(SIM_GPIO_READ_CYCLES);
+    sim_gpio_update();
+
+    return s_pins[gpio_num].level;
+}
+
+esp_err_t gpio_install_isr_service(int no_use)
+{
+    return ESP_OK;
+}
+
+void gpio_uninstall_isr_service(void)
+{
+    int i = 0;
+
+    for(i = 0; i < GPIO_NUM_MAX; ++i)
+    {
+        s_pins[i].isr = NULL;
+    }
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if(!GPIO_IS_VALID_GPIO(gpio_num) || GPIO_NUM_16 == gpio_num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_pins[gpio_num].isr = isr_handler;
+    s_pins[gpio_num].isr_arg = args;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    if(!GPIO_IS_VALID_GPIO(gpio_num))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_pins[gpio_num].isr = NULL;
+
+    return ESP_OK;
+}
@@ -0,0 +1,53 @@
+/**
+ * 主机仿真：GPIO 模型
+ *
+ * 引脚电平由主机输出、外部驱动 (设备模型) 与跳线共同决定：
+ * - 推挽输出：输出寄存器的值
+ * - 开漏输出/输入：任何一方拉低为低电平，否则为高电平 (假定有上拉电阻)
+ * - 跳线：输入引脚跟随另一个引脚的电平，用于例程中把输出接到输入
+ * 电平变化时通知外部驱动，并按中断类型执行中断服务程序
+ */
+#ifndef _SIM_GPIO_H_
+#define _SIM_GPIO_H_
+
+#include <stdint.h>
+
+#include "driver/gpio.h"
+
+/* gpio_get_level() 推进的周期数 */
+#define SIM_GPIO_READ_CYCLES        (20)
+
+typedef struct {
+    /* 外部驱动的电平：-1 释放，0 拉低，1 推高 */
+    int (*drive)(void *ctx, gpio_num_t gpio_num);
+    /* 引脚电平变化，可为 NULL */
+    void (*changed)(void *ctx, gpio_num_t gpio_num, int level);
+    void *ctx;
+} sim_gpio_ext_t;
+
+/**
+ * @brief  在引脚上连接外部驱动，ext 需要在仿真期间一直有效
+ */
+void sim_gpio_attach(gpio_num_t gpio_num, const sim_gpio_ext_t *ext);
+
+/**
+ * @brief  跳线：引脚 to 的电平跟随引脚 from
+ */
+void sim_gpio_connect(gpio_num_t from, gpio_num_t to);
+
+/**
+ * @brief  外部驱动的电平随时间变化后调用，重新计算引脚电平并检查中断
+ */
+void sim_gpio_update(void);
+
+/**
+ * @brief  引脚当前电平
+ */
+int sim_gpio_level(gpio_num_t gpio_num);
+
+/**
+ * @brief  引脚电平变化的次数
+ */
+uint32_t sim_gpio_edges(gpio_num_t gpio_num);
+
+#endif /* _SIM_GPIO_H_ */
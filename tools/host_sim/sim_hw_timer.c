@@ -0,0 +1,138 @@
+/**
+ * 主机仿真：hw_timer 驱动模型
+ *
+ * 报警为定时事件，重载模式下下一次报警按上一次的到期时刻计算，没有累积误差
+ * hw_timer 与 PWM 驱动共用 FRC1，PWM 已初始化时调用 hw_timer_init() 结束仿真
+ */
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver/hw_timer.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+
+/* SDK 要求重载模式的定时时间不小于 50us */
+#define SIM_HW_TIMER_RELOAD_MIN_US  (50)
+/* 23 位计数器，16 分频 */
+#define SIM_HW_TIMER_MAX_US         (0x7FFFFF / (SIM_CPU_MHZ / 16))
+
+typedef struct {
+    bool init;
+    bool reload;
+    uint32_t value_us;
+    hw_timer_callback_t callback;
+    void *arg;
+    sim_event_t ev;
+} sim_hw_timer_t;
+
+static sim_hw_timer_t s_timer;
+
+static void sim_hw_timer_fire(void *arg)
+{
+    if(s_timer.reload)
+    {
+        sim_event_schedule(&s_timer.ev, s_timer.ev.when + (uint64_t)s_timer.value_us * SIM_CYCLES_PER_US,
+                           sim_hw_timer_fire, NULL);
+    }
+    if(NULL != s_timer.callback)
+    {
+        s_timer.callback(s_timer.arg);
+    }
+}
+
+bool sim_hw_timer_in_use(void)
+{
+    return s_timer.init;
+}
+
+void sim_frc1_conflict(const char *who)
+{
+    fprintf(stderr, "sim: %s: PWM and hw_timer both use FRC1 and cannot be used together\n", who);
+    abort();
+}
+
+void sim_hw_timer_reset(void)
+{
+    sim_event_cancel(&s_timer.ev);
+    memset(&s_timer, 0, sizeof(s_timer));
+}
+
+esp_err_t hw_timer_init(hw_timer_callback_t callback, void *arg)
+{
+    if(NULL == callback)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(sim_pwm_in_use())
+    {
+        sim_frc1_conflict("hw_timer_init");
+    }
+
+    s_timer.callback = callback;
+    s_timer.arg = arg;
+    s_timer.init = true;
+
+    return ESP_OK;
+}
+
+esp_err_t hw_timer_deinit(void)
+{
+    if(!s_timer.init)
+    {
+        return ESP_FAIL;
+    }
+
+    sim_event_cancel(&s_timer.ev);
+    s_timer.callback = NULL;
+    s_timer.init = false;
+
+    return ESP_OK;
+}
+
+esp_err_t hw_timer_alarm_us(uint32_t value, bool reload)
+{
+    if(!s_timer.init)
+    {
+        return ESP_FAIL;
+    }
+    if((reload && SIM_HW_TIMER_RELOAD_MIN_US > value) || SIM_HW_TIMER_MAX_US < value || 0 == value)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_timer.value_us = value;
+    s_timer.reload = reload;
+    sim_event_schedule(&s_timer.ev, sim_cycles() + (uint64_t)value * SIM_CYCLES_PER_US, sim_hw_timer_fire, NULL);
+
+    return ESP_OK;
+}
+
+esp_err_t hw_timer_disarm(void)
+{
+    sim_event_cancel(&s_timer.ev);
+
+    return ESP_OK;
+}
+
+esp_err_t hw_timer_enable(bool en)
+{
+    if(!s_timer.init)
+    {
+        return ESP_FAIL;
+    }
+
+    if(!en)
+    {
+        sim_event_cancel(&s_timer.ev);
+    }
+    else if(!s_timer.ev.armed && 0 < s_timer.value_us)
+    {
+        sim_event_schedule(&s_timer.ev, sim_cycles() + (uint64_t)s_timer.value_us * SIM_CYCLES_PER_US,
+                           sim_hw_timer_fire, NULL);
+    }
+
+    return ESP_OK;
+}
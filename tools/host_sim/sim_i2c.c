@@ -0,0 +1,532 @@
+/**
+ * 主机仿真：IIC 总线、SDK 驱动与位级从机状态机，行为说明见 sim_i2c.h
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver/i2c.h"
+#include "driver/gpio.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+#include "sim_gpio.h"
+#include "sim_i2c.h"
+
+typedef enum {
+    SIM_I2C_OP_START = 0,
+    SIM_I2C_OP_WRITE,
+    SIM_I2C_OP_READ,
+    SIM_I2C_OP_STOP,
+} sim_i2c_op_type_t;
+
+typedef struct {
+    sim_i2c_op_type_t type;
+    uint8_t byte;                   /*!< i2c_master_write_byte() 的数据 */
+    const uint8_t *wdata;           /*!< i2c_master_write() 的数据，与 SDK 一样只保存指针 */
+    uint8_t *rdata;
+    size_t len;
+    bool ack_en;
+    i2c_ack_type_t ack;
+} sim_i2c_op_t;
+
+typedef struct {
+    sim_i2c_op_t *ops;
+    size_t num;
+    size_t cap;
+} sim_i2c_cmd_t;
+
+/* 位级状态机 */
+typedef enum {
+    SIM_I2C_BB_IDLE = 0,            /*!< 等待起始条件 */
+    SIM_I2C_BB_ADDR,
+    SIM_I2C_BB_WRITE,
+    SIM_I2C_BB_READ,
+    SIM_I2C_BB_IGNORE,              /*!< 未应答，等待下一个起始/停止条件 */
+} sim_i2c_bb_state_t;
+
+typedef struct {
+    bool installed;
+    bool configured;
+    gpio_num_t sda;
+    gpio_num_t scl;
+    sim_i2c_dev_t *devs;
+    uint32_t jam;                   /*!< 故障注入：剩余需要的 SCL 时钟数 */
+    uint32_t transfers;
+    uint32_t starts;
+
+    sim_i2c_bb_state_t state;
+    int sda_level;
+    int scl_level;
+    bool after_start;               /*!< 起始条件后的第一个 SCL 下降沿不是数据时钟 */
+    uint8_t bit;                    /*!< 本字节已经完成的时钟数，8 为 ACK 位 */
+    uint8_t shift;
+    uint8_t rbyte;
+    bool read;
+    bool acked;
+    bool master_ack;
+    bool drive_low;                 /*!< 从机拉低 SDA */
+    sim_i2c_dev_t *dev;
+} sim_i2c_bus_t;
+
+static sim_i2c_bus_t s_i2c = {
+    .sda_level = 1,
+    .scl_level = 1,
+};
+
+static sim_i2c_dev_t *sim_i2c_find(uint8_t addr)
+{
+    sim_i2c_dev_t *dev = NULL;
+
+    for(dev = s_i2c.devs; NULL != dev; dev = dev->next)
+    {
+        if(addr == dev->addr)
+        {
+            return dev;
+        }
+    }
+
+    return NULL;
+}
+
+void sim_i2c_attach(sim_i2c_dev_t *dev)
+{
+    dev->next = s_i2c.devs;
+    s_i2c.devs = dev;
+}
+
+void sim_i2c_jam(uint32_t clocks)
+{
+    s_i2c.jam = clocks;
+    s_i2c.state = SIM_I2C_BB_IDLE;
+    sim_gpio_update();
+}
+
+uint32_t sim_i2c_driver_transfers(void)
+{
+    return s_i2c.transfers;
+}
+
+uint32_t sim_i2c_bitbang_starts(void)
+{
+    return s_i2c.starts;
+}
+
+static void sim_i2c_end(void)
+{
+    if(NULL != s_i2c.dev && NULL != s_i2c.dev->stop)
+    {
+        s_i2c.dev->stop(s_i2c.dev->ctx);
+    }
+    s_i2c.dev = NULL;
+}
+
+/* 从机在 SCL 低电平时准备好要发送的数据位 */
+static void sim_i2c_present(void)
+{
+    s_i2c.drive_low = (0 == (s_i2c.rbyte & (0x80 >> s_i2c.bit)));
+}
+
+static void sim_i2c_scl_rise(void)
+{
+    if(0 < s_i2c.jam && 0 == --s_i2c.jam)
+    {
+        sim_gpio_update();
+    }
+
+    if(8 > s_i2c.bit && (SIM_I2C_BB_ADDR == s_i2c.state || SIM_I2C_BB_WRITE == s_i2c.state))
+    {
+        s_i2c.shift = (s_i2c.shift << 1) | (s_i2c.sda_level ? 1 : 0);
+    }
+    else if(8 == s_i2c.bit && SIM_I2C_BB_READ == s_i2c.state)
+    {
+        s_i2c.master_ack = (0 == s_i2c.sda_level);
+    }
+}
+
+static void sim_i2c_scl_fall(void)
+{
+    if(SIM_I2C_BB_IDLE == s_i2c.state || SIM_I2C_BB_IGNORE == s_i2c.state)
+    {
+        return;
+    }
+    if(s_i2c.after_start)
+    {
+        s_i2c.after_start = false;
+        return;
+    }
+
+    if(8 > s_i2c.bit)
+    {
+        // 字节的最后一位结束，从机应答或释放 SDA 等待主机应答
+        if(8 == ++s_i2c.bit)
+        {
+            if(SIM_I2C_BB_ADDR == s_i2c.state)
+            {
+                s_i2c.read = (0 != (s_i2c.shift & 0x01));
+                s_i2c.dev = sim_i2c_find(s_i2c.shift >> 1);
+                s_i2c.acked = (NULL != s_i2c.dev) && s_i2c.dev->start(s_i2c.dev->ctx, s_i2c.read);
+                if(!s_i2c.acked)
+                {
+                    s_i2c.dev = NULL;
+                }
+            }
+            else if(SIM_I2C_BB_WRITE == s_i2c.state)
+            {
+                s_i2c.acked = s_i2c.dev->write(s_i2c.dev->ctx, s_i2c.shift);
+            }
+            s_i2c.drive_low = (SIM_I2C_BB_READ != s_i2c.state) && s_i2c.acked;
+        }
+        else if(SIM_I2C_BB_READ == s_i2c.state)
+        {
+            sim_i2c_present();
+        }
+        return;
+    }
+
+    // ACK 位结束，开始下一个字节
+    s_i2c.bit = 0;
+    s_i2c.shift = 0;
+    s_i2c.drive_low = false;
+    if(SIM_I2C_BB_ADDR == s_i2c.state)
+    {
+        if(!s_i2c.acked)
+        {
+            s_i2c.state = SIM_I2C_BB_IGNORE;
+        }
+        else
+        {
+            s_i2c.state = s_i2c.read ? SIM_I2C_BB_READ : SIM_I2C_BB_WRITE;
+        }
+    }
+    else if(SIM_I2C_BB_WRITE == s_i2c.state && !s_i2c.acked)
+    {
+        s_i2c.state = SIM_I2C_BB_IGNORE;
+    }
+    else if(SIM_I2C_BB_READ == s_i2c.state && !s_i2c.master_ack)
+    {
+        // 主机 NACK，从机释放 SDA 等待停止条件
+        s_i2c.state = SIM_I2C_BB_IGNORE;
+    }
+
+    if(SIM_I2C_BB_READ == s_i2c.state)
+    {
+        s_i2c.rbyte = s_i2c.dev->read(s_i2c.dev->ctx);
+        sim_i2c_present();
+    }
+}
+
+static void sim_i2c_changed(void *ctx, gpio_num_t gpio_num, int level)
+{
+    bool drive_low = s_i2c.drive_low;
+
+    if(gpio_num == s_i2c.scl)
+    {
+        s_i2c.scl_level = level;
+        if(level)
+        {
+            sim_i2c_scl_rise();
+        }
+        else
+        {
+            sim_i2c_scl_fall();
+        }
+    }
+    else if(gpio_num == s_i2c.sda)
+    {
+        s_i2c.sda_level = level;
+        // SCL 高电平时 SDA 变化：下降沿为起始条件，上升沿为停止条件
+        if(s_i2c.scl_level && 0 == s_i2c.jam)
+        {
+            sim_i2c_end();
+            s_i2c.bit = 0;
+            s_i2c.shift = 0;
+            s_i2c.drive_low = false;
+            s_i2c.after_start = !level;
+            s_i2c.state = level ? SIM_I2C_BB_IDLE : SIM_I2C_BB_ADDR;
+            if(!level)
+            {
+                ++s_i2c.starts;
+            }
+        }
+    }
+
+    if(drive_low != s_i2c.drive_low)
+    {
+        sim_gpio_update();
+    }
+}
+
+static int sim_i2c_drive(void *ctx, gpio_num_t gpio_num)
+{
+    if(gpio_num == s_i2c.sda && (0 < s_i2c.jam || s_i2c.drive_low))
+    {
+        return 0;
+    }
+
+    return -1;
+}
+
+static const sim_gpio_ext_t s_i2c_ext = {
+    .drive = sim_i2c_drive,
+    .changed = sim_i2c_changed,
+    .ctx = NULL,
+};
+
+/* 驱动状态在 RAM 中，深度睡眠后需要重新安装；引脚与从机仍然接在总线上 */
+void sim_i2c_reset(void)
+{
+    s_i2c.installed = false;
+}
+
+esp_err_t i2c_driver_install(i2c_port_t i2c_num, i2c_mode_t mode)
+{
+    if(I2C_NUM_0 != i2c_num || I2C_MODE_MASTER != mode)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(s_i2c.installed)
+    {
+        return ESP_FAIL;
+    }
+
+    s_i2c.installed = true;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_driver_delete(i2c_port_t i2c_num)
+{
+    if(I2C_NUM_0 != i2c_num || !s_i2c.installed)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_i2c.installed = false;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_param_config(i2c_port_t i2c_num, const i2c_config_t *i2c_conf)
+{
+    gpio_config_t io_conf;
+
+    if(I2C_NUM_0 != i2c_num || !s_i2c.installed)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 与 SDK 一样把引脚配置为开漏输出并释放
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.mode = GPIO_MODE_OUTPUT_OD;
+    io_conf.pin_bit_mask = (1 << i2c_conf->sda_io_num) | (1 << i2c_conf->scl_io_num);
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    if(ESP_OK != gpio_config(&io_conf))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    gpio_set_level(i2c_conf->sda_io_num, 1);
+    gpio_set_level(i2c_conf->scl_io_num, 1);
+
+    if(!s_i2c.configured)
+    {
+        s_i2c.sda = i2c_conf->sda_io_num;
+        s_i2c.scl = i2c_conf->scl_io_num;
+        s_i2c.configured = true;
+        sim_gpio_attach(s_i2c.sda, &s_i2c_ext);
+        sim_gpio_attach(s_i2c.scl, &s_i2c_ext);
+    }
+
+    return ESP_OK;
+}
+
+i2c_cmd_handle_t i2c_cmd_link_create(void)
+{
+    return calloc(1, sizeof(sim_i2c_cmd_t));
+}
+
+void i2c_cmd_link_delete(i2c_cmd_handle_t cmd_handle)
+{
+    sim_i2c_cmd_t *cmd = cmd_handle;
+
+    if(NULL != cmd)
+    {
+        free(cmd->ops);
+        free(cmd);
+    }
+}
+
+static esp_err_t sim_i2c_cmd_add(i2c_cmd_handle_t cmd_handle, const sim_i2c_op_t *op)
+{
+    sim_i2c_cmd_t *cmd = cmd_handle;
+    sim_i2c_op_t *ops = NULL;
+
+    if(NULL == cmd)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(cmd->num == cmd->cap)
+    {
+        ops = realloc(cmd->ops, (cmd->cap + 8) * sizeof(sim_i2c_op_t));
+        if(NULL == ops)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        cmd->ops = ops;
+        cmd->cap += 8;
+    }
+    cmd->ops[cmd->num++] = *op;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_start(i2c_cmd_handle_t cmd_handle)
+{
+    sim_i2c_op_t op = { .type = SIM_I2C_OP_START };
+
+    return sim_i2c_cmd_add(cmd_handle, &op);
+}
+
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t cmd_handle, uint8_t data, bool ack_en)
+{
+    sim_i2c_op_t op = { .type = SIM_I2C_OP_WRITE, .byte = data, .len = 1, .ack_en = ack_en };
+
+    return sim_i2c_cmd_add(cmd_handle, &op);
+}
+
+esp_err_t i2c_master_write(i2c_cmd_handle_t cmd_handle, uint8_t *data, size_t data_len, bool ack_en)
+{
+    sim_i2c_op_t op = { .type = SIM_I2C_OP_WRITE, .wdata = data, .len = data_len, .ack_en = ack_en };
+
+    return sim_i2c_cmd_add(cmd_handle, &op);
+}
+
+esp_err_t i2c_master_read_byte(i2c_cmd_handle_t cmd_handle, uint8_t *data, i2c_ack_type_t ack)
+{
+    sim_i2c_op_t op = { .type = SIM_I2C_OP_READ, .rdata = data, .len = 1, .ack = ack };
+
+    return sim_i2c_cmd_add(cmd_handle, &op);
+}
+
+esp_err_t i2c_master_read(i2c_cmd_handle_t cmd_handle, uint8_t *data, size_t data_len, i2c_ack_type_t ack)
+{
+    sim_i2c_op_t op = { .type = SIM_I2C_OP_READ, .rdata = data, .len = data_len, .ack = ack };
+
+    if(0 == data_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return sim_i2c_cmd_add(cmd_handle, &op);
+}
+
+esp_err_t i2c_master_stop(i2c_cmd_handle_t cmd_handle)
+{
+    sim_i2c_op_t op = { .type = SIM_I2C_OP_STOP };
+
+    return sim_i2c_cmd_add(cmd_handle, &op);
+}
+
+/* 按 SCL 时钟数推进时间 */
+static void sim_i2c_clocks(uint32_t clocks)
+{
+    sim_advance_us(clocks * SIM_I2C_CLOCK_US);
+}
+
+esp_err_t i2c_master_cmd_begin(i2c_port_t i2c_num, i2c_cmd_handle_t cmd_handle, TickType_t ticks_to_wait)
+{
+    sim_i2c_cmd_t *cmd = cmd_handle;
+    const sim_i2c_op_t *op = NULL;
+    sim_i2c_dev_t *dev = NULL;
+    bool expect_addr = false;
+    bool read = false;
+    bool ack = false;
+    uint8_t data = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if(I2C_NUM_0 != i2c_num || !s_i2c.installed || NULL == cmd)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ++s_i2c.transfers;
+    sim_advance_us(SIM_I2C_BEGIN_US);
+
+    // SDA 被拉住时发不出起始条件，驱动等满超时时间
+    if(0 == sim_gpio_level(s_i2c.sda) || 0 == sim_gpio_level(s_i2c.scl))
+    {
+        sim_advance_cycles((uint64_t)ticks_to_wait * SIM_CYCLES_PER_TICK);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    for(i = 0; i < cmd->num; ++i)
+    {
+        op = &cmd->ops[i];
+        switch(op->type)
+        {
+            case SIM_I2C_OP_START:
+                if(NULL != dev && NULL != dev->stop)
+                {
+                    dev->stop(dev->ctx);
+                }
+                dev = NULL;
+                expect_addr = true;
+                sim_i2c_clocks(1);
+                break;
+
+            case SIM_I2C_OP_WRITE:
+                for(j = 0; j < op->len; ++j)
+                {
+                    data = (NULL != op->wdata) ? op->wdata[j] : op->byte;
+                    sim_i2c_clocks(9);
+                    if(expect_addr)
+                    {
+                        expect_addr = false;
+                        read = (0 != (data & 0x01));
+                        dev = sim_i2c_find(data >> 1);
+                        ack = (NULL != dev) && dev->start(dev->ctx, read);
+                        if(!ack)
+                        {
+                            dev = NULL;
+                        }
+                    }
+                    else
+                    {
+                        ack = (NULL != dev) && !read && dev->write(dev->ctx, data);
+                    }
+
+                    if(op->ack_en && !ack)
+                    {
+                        if(NULL != dev && NULL != dev->stop)
+                        {
+                            dev->stop(dev->ctx);
+                        }
+                        sim_i2c_clocks(1);
+                        return ESP_FAIL;
+                    }
+                }
+                break;
+
+            case SIM_I2C_OP_READ:
+                for(j = 0; j < op->len; ++j)
+                {
+                    sim_i2c_clocks(9);
+                    op->rdata[j] = (NULL != dev && read) ? dev->read(dev->ctx) : 0xFF;
+                }
+                break;
+
+            case SIM_I2C_OP_STOP:
+                if(NULL != dev && NULL != dev->stop)
+                {
+                    dev->stop(dev->ctx);
+                }
+                dev = NULL;
+                sim_i2c_clocks(1);
+                break;
+        }
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,53 @@
+/**
+ * 主机仿真：IIC 总线与 SDK 驱动模型
+ *
+ * 设备模型按字节实现 sim_i2c_dev_t 的回调，两种主机方式都会调用到：
+ * - SDK 驱动 (i2c_master_cmd_begin)：按命令连接逐条执行，每个 SCL 时钟 10us (约 100kHz)
+ * - 直接读写 GPIO 的软件 IIC：跟踪 SDA/SCL 电平变化识别 START/STOP、逐位收发
+ * 总线上所有设备共用一个位级状态机，SDA 由主机与应答/发送数据的从机线与
+ */
+#ifndef _SIM_I2C_H_
+#define _SIM_I2C_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* SDK 驱动每个 SCL 时钟的时间，高低电平各 5us */
+#define SIM_I2C_CLOCK_US            (10)
+/* SDK 驱动每次 i2c_master_cmd_begin() 的固定开销 */
+#define SIM_I2C_BEGIN_US            (15)
+
+typedef struct sim_i2c_dev {
+    uint8_t addr;                   /*!< 7 位地址 */
+    void *ctx;
+    /* 地址匹配后的起始条件，返回是否应答 */
+    bool (*start)(void *ctx, bool read);
+    /* 主机写一个字节，返回是否应答 */
+    bool (*write)(void *ctx, uint8_t data);
+    /* 主机读一个字节 */
+    uint8_t (*read)(void *ctx);
+    /* 停止条件，或重复起始条件结束了本次访问 */
+    void (*stop)(void *ctx);
+    struct sim_i2c_dev *next;
+} sim_i2c_dev_t;
+
+/**
+ * @brief  把设备模型挂到总线上，dev 需要在仿真期间一直有效
+ */
+void sim_i2c_attach(sim_i2c_dev_t *dev);
+
+/**
+ * @brief  故障注入：从机拉住 SDA，直到主机输出 clocks 个 SCL 时钟
+ *
+ * 期间 SDK 驱动的传输等满 ticks_to_wait 后返回 ESP_ERR_TIMEOUT；
+ * 软件 IIC 输出的时钟同样计数，传输开始前检查 SDA 才不会自己把卡死的总线放开
+ */
+void sim_i2c_jam(uint32_t clocks);
+
+/**
+ * @brief  SDK 驱动执行的传输次数与位级状态机识别到的起始条件次数
+ */
+uint32_t sim_i2c_driver_transfers(void);
+uint32_t sim_i2c_bitbang_starts(void);
+
+#endif /* _SIM_I2C_H_ */
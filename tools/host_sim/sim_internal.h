@@ -0,0 +1,101 @@
+/**
+ * 主机仿真内部接口：各模块之间使用，应用与设备模型不要包含
+ */
+#ifndef _SIM_INTERNAL_H_
+#define _SIM_INTERNAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim.h"
+
+/* esp_get_free_heap_size() 返回的固定值 */
+#define SIM_HEAP_SIZE               (80 * 1024)
+
+/**
+ * @brief  最早的事件到期时刻，没有事件时为 SIM_TIME_NEVER
+ */
+uint64_t sim_event_next(void);
+
+/**
+ * @brief  调度器上下文中推进时间到 when，执行期间到期的事件，不检查抢占
+ */
+void sim_advance_to(uint64_t when);
+
+/**
+ * @brief  时间推进后检查抢占：有更高优先级的任务就绪，或跨过节拍边界且有同优先级任务就绪时切换
+ */
+void sim_task_preempt(void);
+
+/**
+ * @brief  当前任务阻塞在 obj 上，直到 sim_task_wake_all(obj) 或到达 wake 时刻
+ *
+ * 返回后调用者需要重新检查等待的条件
+ */
+void sim_task_block(const void *obj, uint64_t wake);
+
+/**
+ * @brief  唤醒阻塞在 obj 上的所有任务，任务上下文中有更高优先级的任务被唤醒时立即切换
+ */
+void sim_task_wake_all(const void *obj);
+
+/**
+ * @brief  是否在任务上下文中，只有任务上下文可以阻塞
+ */
+bool sim_task_context(void);
+
+/**
+ * @brief  从现在起 ticks 个节拍后的时刻 (对齐到节拍边界)，portMAX_DELAY 为 SIM_TIME_NEVER
+ */
+uint64_t sim_tick_deadline(TickType_t ticks);
+
+/**
+ * @brief  把 GPIO 寄存器中尚未生效的写入作用到引脚上
+ */
+void sim_gpio_flush(void);
+
+/**
+ * @brief  本次启动的时刻 (周期)，节拍、CCOUNT 与日志时间戳从这里开始计
+ */
+uint64_t sim_boot_cycles(void);
+
+/**
+ * @brief  深度睡眠：当前任务切回调度器，调度器删除全部任务后调用 sim_sleep_wake()
+ */
+void sim_task_reboot(void);
+
+/**
+ * @brief  sim_run() 开始时调用：保存固件 RAM 的初值
+ */
+void sim_sleep_boot(void);
+
+/**
+ * @brief  在调度器上下文中复位芯片，推进时间到唤醒时刻，恢复固件 RAM 的初值
+ *
+ * @return 在 end 之前唤醒返回 true
+ */
+bool sim_sleep_wake(uint64_t end);
+
+/**
+ * @brief  深度睡眠唤醒后设置启动时刻
+ */
+void sim_boot_set(uint64_t boot);
+
+/**
+ * @brief  深度睡眠时复位芯片上的临界区、中断与外设状态，设备模型、跳线与仿真板的连接保持不变
+ */
+void sim_core_reset(void);
+void sim_gpio_reset(void);
+void sim_i2c_reset(void);
+void sim_hw_timer_reset(void);
+void sim_uart_reset(void);
+void sim_pwm_reset(void);
+
+/**
+ * @brief  PWM 与 hw_timer 共用 FRC1，另一方已初始化时结束仿真
+ */
+bool sim_hw_timer_in_use(void);
+bool sim_pwm_in_use(void);
+void sim_frc1_conflict(const char *who);
+
+#endif /* _SIM_INTERNAL_H_ */
@@ -0,0 +1,111 @@
+/**
+ * 主机仿真：外设行为模型
+ *
+ * - MPU6050：寄存器模型，上电睡眠 (PWR_MGMT_1 = 0x40)，唤醒后读数据时按当前运动状态与量程生成采样，
+ *   叠加零偏与偏移寄存器的修正，噪声由固定种子的伪随机数产生，结果可以复现；
+ *   打开 FIFO 后按采样率 (DLPF_CFG 与 SMPLRT_DIV) 在虚拟时间上写入 FIFO，满时覆盖最旧的数据
+ * - DS3231：寄存器模型，日历随虚拟时间走时，闹钟匹配时置位 A1F/A2F，中断使能时拉低 INT/SQW；
+ *   INTCN 清零时 INT/SQW 输出 RS 选择的方波，EN32kHz 置位时 32K 输出 32.768kHz，可以设置虚拟时钟相对 DS3231 的误差
+ * - AT24C32：4KB，2 字节地址，页写在页内回绕，STOP 后 5ms 写周期内不应答
+ * - AM2301：单总线时序模型，主机拉低至少 800us 后释放，模型按数据手册时序输出 40 位数据
+ */
+#ifndef _SIM_MODELS_H_
+#define _SIM_MODELS_H_
+
+#include <stdint.h>
+
+#include "driver/gpio.h"
+
+/* AT24C32 写周期 */
+#define SIM_AT24C32_WRITE_US        (5000)
+
+typedef struct sim_mpu6050 sim_mpu6050_t;
+typedef struct sim_ds3231 sim_ds3231_t;
+typedef struct sim_at24c32 sim_at24c32_t;
+typedef struct sim_am2301 sim_am2301_t;
+
+/**
+ * @brief  在 IIC 总线上创建 MPU6050，静止水平放置 (Z 轴 1g)，温度 25°C
+ */
+sim_mpu6050_t *sim_mpu6050_attach(uint8_t addr);
+
+/**
+ * @brief  设置运动状态，单位 mg 与 mdps
+ */
+void sim_mpu6050_set_motion(sim_mpu6050_t *mpu, const int32_t accel_mg[3], const int32_t gyro_mdps[3]);
+
+/**
+ * @brief  设置零偏 (偏移寄存器为出厂值时数据中的误差)，单位 mg 与 mdps，默认为 0
+ */
+void sim_mpu6050_set_bias(sim_mpu6050_t *mpu, const int32_t accel_mg[3], const int32_t gyro_mdps[3]);
+
+/**
+ * @brief  设置采样噪声的幅度 (LSB)，0 为无噪声
+ */
+void sim_mpu6050_set_noise(sim_mpu6050_t *mpu, uint16_t lsb);
+
+/**
+ * @brief  传感器复位 (例如电源跌落)：寄存器回到上电值 (睡眠，偏移寄存器为出厂值，FIFO 关闭并清空)
+ */
+void sim_mpu6050_power_reset(sim_mpu6050_t *mpu);
+
+/**
+ * @brief  在 IIC 总线上创建 DS3231，时间为 2000-01-01 00:00:00 星期六，温度 25.25°C
+ */
+sim_ds3231_t *sim_ds3231_attach(uint8_t addr);
+
+/**
+ * @brief  设置当前时间，year 为 2000~2099，wday 为 1~7
+ */
+void sim_ds3231_set_time(sim_ds3231_t *rtc, uint16_t year, uint8_t month, uint8_t date,
+                         uint8_t wday, uint8_t hour, uint8_t min, uint8_t sec);
+
+/**
+ * @brief  设置温度，单位 0.01°C，按 0.25°C 量化
+ */
+void sim_ds3231_set_temp(sim_ds3231_t *rtc, int32_t centi);
+
+/**
+ * @brief  INT/SQW 引脚的电平：INTCN 置位且闹钟标志与中断使能同时置位时为 0 (开漏拉低)，否则为 1；
+ *         INTCN 清零时为方波的电平
+ */
+int sim_ds3231_int_level(sim_ds3231_t *rtc);
+
+/**
+ * @brief  设置虚拟时钟 (ESP8266 的 CPU 周期) 相对 DS3231 的误差，十亿分之一，正值为 ESP8266 快，默认为 0
+ *
+ * DS3231 的日历与方波按 SIM_CPU_MHZ x (1 + ppb / 1e9) 个周期一秒计时
+ */
+void sim_ds3231_set_drift(sim_ds3231_t *rtc, int32_t ppb);
+
+/**
+ * @brief  INT/SQW 连接到引脚 (开漏)，方波的每个边沿改变引脚电平并触发 GPIO 中断
+ */
+void sim_ds3231_connect_sqw(sim_ds3231_t *rtc, gpio_num_t gpio_num);
+
+/**
+ * @brief  32K 连接到引脚 (开漏)，EN32kHz 置位时每秒 65536 个边沿，只适合短时间运行
+ */
+void sim_ds3231_connect_32k(sim_ds3231_t *rtc, gpio_num_t gpio_num);
+
+/**
+ * @brief  在 IIC 总线上创建 AT24C32，内容全部为 0xFF
+ */
+sim_at24c32_t *sim_at24c32_attach(uint8_t addr);
+
+/**
+ * @brief  直接访问存储内容，用于预置数据或检查写入结果
+ */
+uint8_t *sim_at24c32_mem(sim_at24c32_t *e2p);
+
+/**
+ * @brief  在引脚上创建 AM2301，湿度 50.0%RH，温度 25.0°C
+ */
+sim_am2301_t *sim_am2301_attach(gpio_num_t gpio_num);
+
+/**
+ * @brief  设置测量值，单位 0.1%RH 与 0.1°C
+ */
+void sim_am2301_set(sim_am2301_t *sensor, uint16_t humidity, int16_t temp);
+
+#endif /* _SIM_MODELS_H_ */
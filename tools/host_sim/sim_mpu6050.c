@@ -0,0 +1,345 @@
+/**
+ * 主机仿真：MPU6050 模型，行为说明见 sim_models.h
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_i2c.h"
+#include "sim_models.h"
+
+#define SIM_MPU6050_REG_NUM         (128)
+
+#define SIM_MPU6050_XA_OFFS_H       (0x06)
+#define SIM_MPU6050_XG_OFFS_USRH    (0x13)
+#define SIM_MPU6050_SMPLRT_DIV      (0x19)
+#define SIM_MPU6050_CONFIG          (0x1A)
+#define SIM_MPU6050_GYRO_CONFIG     (0x1B)
+#define SIM_MPU6050_ACCEL_CONFIG    (0x1C)
+#define SIM_MPU6050_FIFO_EN         (0x23)
+#define SIM_MPU6050_ACCEL_XOUT_H    (0x3B)
+#define SIM_MPU6050_USER_CTRL       (0x6A)
+#define SIM_MPU6050_PWR_MGMT_1      (0x6B)
+#define SIM_MPU6050_FIFO_COUNTH     (0x72)
+#define SIM_MPU6050_FIFO_R_W        (0x74)
+#define SIM_MPU6050_WHO_AM_I        (0x75)
+
+#define SIM_MPU6050_PWR_RESET       (0x80)
+#define SIM_MPU6050_PWR_SLEEP       (0x40)
+#define SIM_MPU6050_USER_FIFO_EN    (0x40)
+#define SIM_MPU6050_USER_FIFO_RESET (0x04)
+
+#define SIM_MPU6050_FIFO_SIZE       (1024)
+
+struct sim_mpu6050 {
+    sim_i2c_dev_t i2c;
+    uint8_t regs[SIM_MPU6050_REG_NUM];
+    uint8_t ptr;
+    bool ptr_set;                   /*!< 本次写访问已经收到寄存器地址 */
+    int32_t accel_mg[3];
+    int32_t gyro_mdps[3];
+    int32_t accel_bias_mg[3];
+    int32_t gyro_bias_mdps[3];
+    int16_t accel_factory[3];       /*!< 加速度偏移寄存器的出厂值，已经抵消了出厂时的零偏 */
+    int32_t temp_centi;
+    uint8_t fifo[SIM_MPU6050_FIFO_SIZE];
+    uint16_t fifo_head;             /*!< 最旧的字节 */
+    uint16_t fifo_count;
+    uint64_t fifo_next;             /*!< 下一次采样写入 FIFO 的时刻 */
+    uint16_t noise;
+    uint32_t seed;
+};
+
+static int16_t sim_mpu6050_get16(sim_mpu6050_t *mpu, uint8_t reg)
+{
+    return (int16_t)((mpu->regs[reg] << 8) | mpu->regs[reg + 1]);
+}
+
+static void sim_mpu6050_reset(sim_mpu6050_t *mpu)
+{
+    int i = 0;
+
+    memset(mpu->regs, 0, sizeof(mpu->regs));
+    for(i = 0; i < 3; ++i)
+    {
+        mpu->regs[SIM_MPU6050_XA_OFFS_H + 2 * i] = (uint8_t)((uint16_t)mpu->accel_factory[i] >> 8);
+        mpu->regs[SIM_MPU6050_XA_OFFS_H + 2 * i + 1] = (uint8_t)mpu->accel_factory[i];
+    }
+    mpu->regs[SIM_MPU6050_PWR_MGMT_1] = SIM_MPU6050_PWR_SLEEP;
+    mpu->regs[SIM_MPU6050_WHO_AM_I] = 0x68;
+    mpu->fifo_head = 0;
+    mpu->fifo_count = 0;
+}
+
+static int32_t sim_mpu6050_noise(sim_mpu6050_t *mpu)
+{
+    if(0 == mpu->noise)
+    {
+        return 0;
+    }
+
+    mpu->seed = mpu->seed * 1103515245 + 12345;
+
+    return (int32_t)((mpu->seed >> 16) % (2 * mpu->noise + 1)) - mpu->noise;
+}
+
+/* 按量程计算当前运动状态的一组采样：加速度 x/y/z，温度，角速度 x/y/z */
+static void sim_mpu6050_measure(sim_mpu6050_t *mpu, int32_t value[7])
+{
+    uint8_t afs = (mpu->regs[SIM_MPU6050_ACCEL_CONFIG] >> 3) & 0x03;
+    uint8_t fs = (mpu->regs[SIM_MPU6050_GYRO_CONFIG] >> 3) & 0x03;
+    int32_t accel_offs = 0;
+    int32_t gyro_offs = 0;
+    int i = 0;
+
+    // 加速度：16384 LSB/g >> AFS_SEL；角速度：131 LSB/(°/s) >> FS_SEL
+    // 偏移寄存器：加速度 2048 LSB/g (最低位不参与)，相对出厂值的变化叠加到数据上；角速度 32.8 LSB/(°/s)
+    for(i = 0; i < 3; ++i)
+    {
+        accel_offs = ((sim_mpu6050_get16(mpu, SIM_MPU6050_XA_OFFS_H + 2 * i) & ~1) - (mpu->accel_factory[i] & ~1))
+                     * (8 >> afs);
+        gyro_offs = sim_mpu6050_get16(mpu, SIM_MPU6050_XG_OFFS_USRH + 2 * i) * 4 / (1 << fs);
+        value[i] = (mpu->accel_mg[i] + mpu->accel_bias_mg[i]) * (16384 >> afs) / 1000 + accel_offs
+                   + sim_mpu6050_noise(mpu);
+        value[4 + i] = (int32_t)((int64_t)(mpu->gyro_mdps[i] + mpu->gyro_bias_mdps[i]) * 131 / (1000 << fs))
+                       + gyro_offs + sim_mpu6050_noise(mpu);
+    }
+    // 温度 = TEMP_OUT / 340 + 36.53
+    value[3] = (mpu->temp_centi - 3653) * 340 / 100;
+}
+
+static int16_t sim_mpu6050_sat(int32_t value)
+{
+    if(INT16_MAX < value)
+    {
+        return INT16_MAX;
+    }
+    if(INT16_MIN > value)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t)value;
+}
+
+static void sim_mpu6050_put(sim_mpu6050_t *mpu, uint8_t reg, int32_t value)
+{
+    mpu->regs[reg] = (uint8_t)((uint16_t)sim_mpu6050_sat(value) >> 8);
+    mpu->regs[reg + 1] = (uint8_t)sim_mpu6050_sat(value);
+}
+
+/* 把当前运动状态写入数据寄存器 */
+static void sim_mpu6050_sample(sim_mpu6050_t *mpu)
+{
+    int32_t value[7];
+    int i = 0;
+
+    if(0 != (mpu->regs[SIM_MPU6050_PWR_MGMT_1] & SIM_MPU6050_PWR_SLEEP))
+    {
+        return;
+    }
+
+    sim_mpu6050_measure(mpu, value);
+    for(i = 0; i < 7; ++i)
+    {
+        sim_mpu6050_put(mpu, SIM_MPU6050_ACCEL_XOUT_H + 2 * i, value[i]);
+    }
+}
+
+/* 采样周期：DLPF_CFG 为 0 或 7 时陀螺仪输出 8kHz，否则 1kHz，再按 SMPLRT_DIV 分频 */
+static uint64_t sim_mpu6050_period(sim_mpu6050_t *mpu)
+{
+    uint8_t dlpf = mpu->regs[SIM_MPU6050_CONFIG] & 0x07;
+    uint32_t rate = (0 == dlpf || 7 == dlpf) ? 8000 : 1000;
+
+    return (uint64_t)SIM_CYCLES_PER_US * 1000000 * (1 + mpu->regs[SIM_MPU6050_SMPLRT_DIV]) / rate;
+}
+
+static void sim_mpu6050_fifo_push(sim_mpu6050_t *mpu, int16_t value)
+{
+    int i = 0;
+
+    for(i = 0; i < 2; ++i)
+    {
+        // 满时覆盖最旧的数据
+        if(SIM_MPU6050_FIFO_SIZE == mpu->fifo_count)
+        {
+            mpu->fifo_head = (mpu->fifo_head + 1) % SIM_MPU6050_FIFO_SIZE;
+            --mpu->fifo_count;
+        }
+        mpu->fifo[(mpu->fifo_head + mpu->fifo_count) % SIM_MPU6050_FIFO_SIZE] =
+            (0 == i) ? (uint8_t)((uint16_t)value >> 8) : (uint8_t)value;
+        ++mpu->fifo_count;
+    }
+}
+
+/* 把到当前时刻为止的采样写入 FIFO：加速度、温度、角速度 x/y/z，按 FIFO_EN 选择 */
+static void sim_mpu6050_fifo_update(sim_mpu6050_t *mpu)
+{
+    uint8_t en = mpu->regs[SIM_MPU6050_FIFO_EN];
+    uint64_t now = sim_cycles();
+    uint64_t period = sim_mpu6050_period(mpu);
+    int32_t value[7];
+    int i = 0;
+
+    if(0 == (mpu->regs[SIM_MPU6050_USER_CTRL] & SIM_MPU6050_USER_FIFO_EN)
+       || 0 != (mpu->regs[SIM_MPU6050_PWR_MGMT_1] & SIM_MPU6050_PWR_SLEEP))
+    {
+        mpu->fifo_next = now + period;
+        return;
+    }
+
+    // 很久没有读取时只需要最后一个 FIFO 容量的采样
+    if(mpu->fifo_next + period * SIM_MPU6050_FIFO_SIZE < now)
+    {
+        mpu->fifo_next += (now - mpu->fifo_next) / period * period - period * SIM_MPU6050_FIFO_SIZE;
+    }
+    for(; mpu->fifo_next <= now; mpu->fifo_next += period)
+    {
+        sim_mpu6050_measure(mpu, value);
+        if(0 != (en & 0x08))
+        {
+            for(i = 0; i < 3; ++i)
+            {
+                sim_mpu6050_fifo_push(mpu, sim_mpu6050_sat(value[i]));
+            }
+        }
+        if(0 != (en & 0x80))
+        {
+            sim_mpu6050_fifo_push(mpu, sim_mpu6050_sat(value[3]));
+        }
+        for(i = 0; i < 3; ++i)
+        {
+            if(0 != (en & (0x40 >> i)))
+            {
+                sim_mpu6050_fifo_push(mpu, sim_mpu6050_sat(value[4 + i]));
+            }
+        }
+    }
+    mpu->regs[SIM_MPU6050_FIFO_COUNTH] = (uint8_t)(mpu->fifo_count >> 8);
+    mpu->regs[SIM_MPU6050_FIFO_COUNTH + 1] = (uint8_t)mpu->fifo_count;
+}
+
+static bool sim_mpu6050_start(void *ctx, bool read)
+{
+    sim_mpu6050_t *mpu = ctx;
+
+    mpu->ptr_set = false;
+    // 读访问开始时锁存一组采样，同一次突发读的数据来自同一时刻
+    if(read)
+    {
+        sim_mpu6050_fifo_update(mpu);
+        sim_mpu6050_sample(mpu);
+    }
+
+    return true;
+}
+
+static bool sim_mpu6050_write(void *ctx, uint8_t data)
+{
+    sim_mpu6050_t *mpu = ctx;
+
+    if(!mpu->ptr_set)
+    {
+        mpu->ptr = data & (SIM_MPU6050_REG_NUM - 1);
+        mpu->ptr_set = true;
+        return true;
+    }
+
+    if(SIM_MPU6050_PWR_MGMT_1 == mpu->ptr && 0 != (data & SIM_MPU6050_PWR_RESET))
+    {
+        sim_mpu6050_reset(mpu);
+    }
+    else if(SIM_MPU6050_USER_CTRL == mpu->ptr)
+    {
+        // 打开 FIFO 前先补上之前的采样，FIFO_RESET 自动清零
+        sim_mpu6050_fifo_update(mpu);
+        if(0 != (data & SIM_MPU6050_USER_FIFO_RESET))
+        {
+            mpu->fifo_head = 0;
+            mpu->fifo_count = 0;
+        }
+        mpu->regs[mpu->ptr] = data & ~SIM_MPU6050_USER_FIFO_RESET;
+        sim_mpu6050_fifo_update(mpu);
+    }
+    else if(SIM_MPU6050_WHO_AM_I != mpu->ptr)
+    {
+        mpu->regs[mpu->ptr] = data;
+    }
+    mpu->ptr = (mpu->ptr + 1) & (SIM_MPU6050_REG_NUM - 1);
+
+    return true;
+}
+
+static uint8_t sim_mpu6050_read(void *ctx)
+{
+    sim_mpu6050_t *mpu = ctx;
+    uint8_t data = mpu->regs[mpu->ptr];
+
+    // FIFO_R_W 地址不递增，连续读出 FIFO 中的字节，空时读出 0
+    if(SIM_MPU6050_FIFO_R_W == mpu->ptr)
+    {
+        data = 0;
+        if(0 < mpu->fifo_count)
+        {
+            data = mpu->fifo[mpu->fifo_head];
+            mpu->fifo_head = (mpu->fifo_head + 1) % SIM_MPU6050_FIFO_SIZE;
+            --mpu->fifo_count;
+        }
+        return data;
+    }
+
+    mpu->ptr = (mpu->ptr + 1) & (SIM_MPU6050_REG_NUM - 1);
+
+    return data;
+}
+
+sim_mpu6050_t *sim_mpu6050_attach(uint8_t addr)
+{
+    sim_mpu6050_t *mpu = calloc(1, sizeof(sim_mpu6050_t));
+
+    if(NULL == mpu)
+    {
+        return NULL;
+    }
+
+    // 出厂值按地址取不同的数，最低位有 0 有 1
+    mpu->accel_factory[0] = (int16_t)(-2500 + addr);
+    mpu->accel_factory[1] = (int16_t)(1200 + addr);
+    mpu->accel_factory[2] = (int16_t)(800 - addr);
+    sim_mpu6050_reset(mpu);
+    mpu->accel_mg[2] = 1000;
+    mpu->temp_centi = 2500;
+    mpu->seed = addr;
+
+    mpu->i2c.addr = addr;
+    mpu->i2c.ctx = mpu;
+    mpu->i2c.start = sim_mpu6050_start;
+    mpu->i2c.write = sim_mpu6050_write;
+    mpu->i2c.read = sim_mpu6050_read;
+    sim_i2c_attach(&mpu->i2c);
+
+    return mpu;
+}
+
+void sim_mpu6050_set_motion(sim_mpu6050_t *mpu, const int32_t accel_mg[3], const int32_t gyro_mdps[3])
+{
+    memcpy(mpu->accel_mg, accel_mg, sizeof(mpu->accel_mg));
+    memcpy(mpu->gyro_mdps, gyro_mdps, sizeof(mpu->gyro_mdps));
+}
+
+void sim_mpu6050_set_noise(sim_mpu6050_t *mpu, uint16_t lsb)
+{
+    mpu->noise = lsb;
+}
+
+void sim_mpu6050_set_bias(sim_mpu6050_t *mpu, const int32_t accel_mg[3], const int32_t gyro_mdps[3])
+{
+    memcpy(mpu->accel_bias_mg, accel_mg, sizeof(mpu->accel_bias_mg));
+    memcpy(mpu->gyro_bias_mdps, gyro_mdps, sizeof(mpu->gyro_bias_mdps));
+}
+
+void sim_mpu6050_power_reset(sim_mpu6050_t *mpu)
+{
+    sim_mpu6050_reset(mpu);
+}
@@ -0,0 +1,48 @@
+/**
+ * 主机仿真：PWM 驱动模型
+ *
+ * 模型行为 (按 ESP8266_RTOS_SDK 3.1 驱动预期行为的假设，没有模拟影子寄存器与 NMI 装载时机)：
+ * - pwm_set_xxx() 只修改参数
+ * - PWM 停止时 pwm_start() 立即从新周期开始输出
+ * - PWM 运行时 pwm_start() 计算新的通道表，在当前周期结束时切换
+ * - pwm_stop() 立即停止，输出指定电平
+ * - 通道 i 在周期内 ((t - phase) mod period) < duty 时输出高电平，反相通道取反
+ * - 与 hw_timer 共用 FRC1：hw_timer 已初始化时调用 pwm_init() 结束仿真
+ */
+#ifndef _SIM_PWM_H_
+#define _SIM_PWM_H_
+
+#include <stdint.h>
+
+#define SIM_PWM_CH_MAX              (8)
+
+typedef struct {
+    uint32_t period;
+    uint32_t duties[SIM_PWM_CH_MAX];
+    int16_t phases[SIM_PWM_CH_MAX];
+    uint16_t invert_mask;
+} sim_pwm_param_t;
+
+/**
+ * @brief  按参数计算通道在周期内 t 时刻的电平
+ */
+int sim_pwm_level(const sim_pwm_param_t *param, uint8_t channel, uint32_t t);
+
+/**
+ * @brief  前进 1us，返回本微秒所有通道的输出电平掩码
+ *
+ * @param  period_start  输出：本微秒是否为一个新周期的开始，可为 NULL
+ */
+uint32_t sim_pwm_step(int *period_start);
+
+/**
+ * @brief  当前输出使用的参数，PWM 停止时返回 NULL
+ */
+const sim_pwm_param_t *sim_pwm_running(void);
+
+/**
+ * @brief  pwm_start() 被调用的次数
+ */
+uint32_t sim_pwm_start_count(void);
+
+#endif /* _SIM_PWM_H_ */
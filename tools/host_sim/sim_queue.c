@@ -0,0 +1,180 @@
+/**
+ * 主机仿真：FreeRTOS 队列与信号量
+ *
+ * 环形缓冲区，满/空时阻塞在队列对象上，对方操作后唤醒所有等待者重新检查
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+
+struct sim_queue {
+    uint8_t *buf;
+    UBaseType_t length;
+    UBaseType_t item_size;          /*!< 0 为信号量 */
+    UBaseType_t count;
+    UBaseType_t head;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct sim_queue *queue = calloc(1, sizeof(struct sim_queue));
+
+    if(NULL == queue || 0 == length)
+    {
+        free(queue);
+        return NULL;
+    }
+    if(0 < item_size)
+    {
+        queue->buf = malloc(length * item_size);
+        if(NULL == queue->buf)
+        {
+            free(queue);
+            return NULL;
+        }
+    }
+    queue->length = length;
+    queue->item_size = item_size;
+
+    return queue;
+}
+
+QueueHandle_t sim_semaphore_create(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    struct sim_queue *queue = xQueueCreate(max_count, 0);
+
+    if(NULL != queue)
+    {
+        queue->count = initial_count;
+    }
+
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if(NULL != queue)
+    {
+        free(queue->buf);
+        free(queue);
+    }
+}
+
+static void sim_queue_put(QueueHandle_t queue, const void *item)
+{
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+
+    if(0 < queue->item_size)
+    {
+        memcpy(queue->buf + tail * queue->item_size, item, queue->item_size);
+    }
+    ++queue->count;
+}
+
+static void sim_queue_get(QueueHandle_t queue, void *item)
+{
+    if(0 < queue->item_size)
+    {
+        memcpy(item, queue->buf + queue->head * queue->item_size, queue->item_size);
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    --queue->count;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    uint64_t deadline = sim_tick_deadline(ticks);
+
+    while(queue->count >= queue->length)
+    {
+        if(0 == ticks || !sim_task_context() || sim_cycles() >= deadline)
+        {
+            return errQUEUE_FULL;
+        }
+        sim_task_block(queue, deadline);
+    }
+
+    sim_queue_put(queue, item);
+    sim_task_wake_all(queue);
+
+    return pdPASS;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    return xQueueSend(queue, item, ticks);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken)
+{
+    if(queue->count >= queue->length)
+    {
+        return errQUEUE_FULL;
+    }
+
+    sim_queue_put(queue, item);
+    sim_task_wake_all(queue);
+    if(NULL != woken)
+    {
+        *woken = pdTRUE;
+    }
+
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    uint64_t deadline = sim_tick_deadline(ticks);
+
+    while(0 == queue->count)
+    {
+        if(0 == ticks || !sim_task_context() || sim_cycles() >= deadline)
+        {
+            return pdFALSE;
+        }
+        sim_task_block(queue, deadline);
+    }
+
+    sim_queue_get(queue, item);
+    sim_task_wake_all(queue);
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *item, BaseType_t *woken)
+{
+    if(0 == queue->count)
+    {
+        return pdFALSE;
+    }
+
+    sim_queue_get(queue, item);
+    sim_task_wake_all(queue);
+    if(NULL != woken)
+    {
+        *woken = pdTRUE;
+    }
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    queue->count = 0;
+    queue->head = 0;
+    sim_task_wake_all(queue);
+
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue->count;
+}
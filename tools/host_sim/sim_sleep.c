@@ -0,0 +1,155 @@
+/**
+ * 主机仿真：深度睡眠、复位原因与 RTC 用户内存，行为说明见 sim_sleep.h
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_system.h"
+#include "esp_sleep.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+#include "sim_sleep.h"
+
+/* tools/sim_run 改名后的固件段，链接器生成起止符号；其他工具没有这些段，为 NULL */
+extern char __start_fw_data[] __attribute__((weak));
+extern char __stop_fw_data[] __attribute__((weak));
+extern char __start_fw_bss[] __attribute__((weak));
+extern char __stop_fw_bss[] __attribute__((weak));
+
+static uint32_t s_rtc_mem[SIM_RTC_MEM_SIZE / sizeof(uint32_t)];
+static char *s_fw_data_init = NULL;
+static esp_reset_reason_t s_reason = ESP_RST_POWERON;
+static uint64_t s_wake = SIM_TIME_NEVER;
+static uint64_t s_sleep_start = 0;
+static uint32_t s_sleeps = 0;
+static uint64_t s_slept_us = 0;
+static sim_sleep_rst_t s_rst = NULL;
+static void *s_rst_ctx = NULL;
+
+volatile uint32_t *sim_rtc_mem(void)
+{
+    return s_rtc_mem;
+}
+
+void sim_sleep_set_rst(sim_sleep_rst_t level, void *ctx)
+{
+    s_rst = level;
+    s_rst_ctx = ctx;
+}
+
+uint32_t sim_sleep_count(void)
+{
+    return s_sleeps;
+}
+
+uint64_t sim_sleep_total_us(void)
+{
+    return s_slept_us;
+}
+
+esp_reset_reason_t esp_reset_reason(void)
+{
+    return s_reason;
+}
+
+bool esp_deep_sleep_set_rf_option(uint8_t option)
+{
+    return true;
+}
+
+void esp_deep_sleep(uint32_t time_in_us)
+{
+    if(NULL == __start_fw_data || NULL == __start_fw_bss)
+    {
+        fprintf(stderr, "sim: deep sleep needs fw_data/fw_bss sections, see tools/sim_run/Makefile\n");
+        abort();
+    }
+
+    printf("sim: deep sleep %u us at %llu us\n", time_in_us, (unsigned long long)sim_time_us());
+    s_sleep_start = sim_cycles();
+    s_wake = (0 < time_in_us) ? s_sleep_start + (uint64_t)time_in_us * SIM_CYCLES_PER_US : SIM_TIME_NEVER;
+    sim_task_reboot();
+}
+
+void sim_sleep_boot(void)
+{
+    size_t size = __stop_fw_data - __start_fw_data;
+
+    if(NULL == __start_fw_data || NULL != s_fw_data_init)
+    {
+        return;
+    }
+    s_fw_data_init = malloc(size);
+    if(NULL == s_fw_data_init)
+    {
+        fprintf(stderr, "sim: out of memory\n");
+        abort();
+    }
+    memcpy(s_fw_data_init, __start_fw_data, size);
+}
+
+static int sim_sleep_rst_level(void)
+{
+    return (NULL != s_rst) ? s_rst(s_rst_ctx) : 1;
+}
+
+bool sim_sleep_wake(uint64_t end)
+{
+    uint64_t next = 0;
+    uint64_t boot = 0;
+    int last = 0;
+    int level = 0;
+    bool by_rst = false;
+
+    // 芯片上的外设先停下，睡眠期间只有设备模型的事件
+    sim_core_reset();
+    sim_gpio_reset();
+    sim_i2c_reset();
+    sim_hw_timer_reset();
+    sim_uart_reset();
+    sim_pwm_reset();
+
+    last = sim_sleep_rst_level();
+    while(sim_cycles() < s_wake)
+    {
+        if(sim_cycles() >= end)
+        {
+            return false;
+        }
+        next = sim_cycles() + (uint64_t)SIM_SLEEP_POLL_US * SIM_CYCLES_PER_US;
+        next = (next < s_wake) ? next : s_wake;
+        next = (next < end) ? next : end;
+        sim_advance_to(next);
+
+        level = sim_sleep_rst_level();
+        if(0 != last && 0 == level)
+        {
+            by_rst = true;
+            break;
+        }
+        last = level;
+    }
+
+    boot = (sim_cycles() + SIM_CYCLES_PER_TICK - 1) / SIM_CYCLES_PER_TICK * SIM_CYCLES_PER_TICK;
+    if(boot >= end)
+    {
+        sim_advance_to(end);
+        return false;
+    }
+    sim_advance_to(boot);
+
+    ++s_sleeps;
+    s_slept_us += (boot - s_sleep_start) / SIM_CYCLES_PER_US;
+    printf("sim: wake up by %s at %llu us\n", by_rst ? "rst" : "timer", (unsigned long long)sim_time_us());
+
+    // RAM 掉电：固件的全局变量恢复为初值
+    memcpy(__start_fw_data, s_fw_data_init, __stop_fw_data - __start_fw_data);
+    memset(__start_fw_bss, 0, __stop_fw_bss - __start_fw_bss);
+    sim_boot_set(boot);
+    s_reason = ESP_RST_DEEPSLEEP;
+    s_wake = SIM_TIME_NEVER;
+
+    return true;
+}
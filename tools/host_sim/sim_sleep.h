@@ -0,0 +1,41 @@
+/**
+ * 主机仿真：深度睡眠、复位原因与 RTC 用户内存
+ *
+ * esp_deep_sleep() 删除全部任务，复位芯片上的外设状态 (GPIO、IIC 驱动、hw_timer、UART、PWM)，
+ * 固件的全局变量恢复为初值 (tools/sim_run 把固件目标文件的 .data/.bss 改名为 fw_data/fw_bss，
+ * 启动前保存 fw_data 的内容)，虚拟时间推进到唤醒时刻后重新执行 app_main()，复位原因为 ESP_RST_DEEPSLEEP。
+ * 设备模型、跳线与仿真板的连接不受影响，睡眠期间照常随时间变化。
+ *
+ * 唤醒：定时器到期 (假定 GPIO16 接 RST)，或者仿真板登记的 RST 电平出现下降沿 (例如 DS3231 INT/SQW 经电容接 RST)，
+ * 睡眠期间每 1ms 检查一次 RST 电平；唤醒后从下一个节拍边界开始启动。
+ * RTC 用户内存 (512 字节) 在深度睡眠中保持，仿真开始时为 0。堆不回收，与目标上掉电不同。
+ */
+#ifndef _SIM_SLEEP_H_
+#define _SIM_SLEEP_H_
+
+#include <stdint.h>
+
+#define SIM_RTC_MEM_SIZE            (512)
+/* 睡眠期间检查 RST 电平的间隔 */
+#define SIM_SLEEP_POLL_US           (1000)
+
+/* RST 引脚上外部电路的电平：0 拉低，1 释放 */
+typedef int (*sim_sleep_rst_t)(void *ctx);
+
+/**
+ * @brief  把外部电路接到 RST，深度睡眠中出现下降沿时唤醒
+ */
+void sim_sleep_set_rst(sim_sleep_rst_t level, void *ctx);
+
+/**
+ * @brief  深度睡眠次数与累计睡眠时间
+ */
+uint32_t sim_sleep_count(void);
+uint64_t sim_sleep_total_us(void);
+
+/**
+ * @brief  RTC 用户内存，按 32 位字访问
+ */
+volatile uint32_t *sim_rtc_mem(void);
+
+#endif /* _SIM_SLEEP_H_ */
@@ -0,0 +1,474 @@
+/**
+ * 主机仿真：FreeRTOS 任务调度
+ *
+ * 每个任务一个 ucontext，调度器运行在 sim_run() 的上下文中。
+ * 任务阻塞或被抢占时切回调度器，调度器选出优先级最高的就绪任务，同优先级按上次运行的先后轮转；
+ * 没有就绪任务时虚拟时间直接跳到下一个唤醒时刻或事件
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+
+/* 主机上的任务栈，与任务创建时指定的大小无关 */
+#define SIM_TASK_STACK_SIZE         (256 * 1024)
+#define SIM_TASK_NAME_LEN           (16)
+/* 创建任务时用来填充栈的字节，高水位为从栈底开始没有被改写的长度 */
+#define SIM_TASK_STACK_FILL         (0xA5)
+/* 64 位主机上保存的寄存器与指针都是 8 字节，栈用量约为目标的 2 倍，按比例折算，只作参考 */
+#define SIM_TASK_STACK_SCALE        (2)
+
+/* app_main 所在任务的优先级与栈大小，与 SDK 的 ESP_TASK_MAIN_PRIO、CONFIG_MAIN_TASK_STACK_SIZE 默认值一致 */
+#define SIM_MAIN_TASK_PRIO          (1)
+#define SIM_MAIN_TASK_STACK         (3584)
+
+typedef enum {
+    SIM_TASK_READY = 0,
+    SIM_TASK_BLOCKED,
+    SIM_TASK_DELETED,
+} sim_task_state_t;
+
+struct sim_task {
+    ucontext_t ctx;
+    void *stack;
+    uint32_t stack_depth;           /*!< 创建时指定的栈大小，按字节计 */
+    char name[SIM_TASK_NAME_LEN];
+    UBaseType_t prio;
+    sim_task_state_t state;
+    uint64_t wake;                  /*!< 阻塞的超时时刻 */
+    const void *wait_obj;           /*!< 阻塞等待的对象，NULL 为延时 */
+    uint64_t run_seq;               /*!< 上次被调度的序号，同优先级轮转用 */
+    uint64_t slice_tick;            /*!< 本次开始运行的节拍 */
+    TaskFunction_t func;
+    void *arg;
+    struct sim_task *next;
+};
+
+static ucontext_t s_sched_ctx;
+static struct sim_task *s_tasks = NULL;
+static struct sim_task *s_current = NULL;
+static uint64_t s_seq = 0;
+static uint64_t s_end = 0;
+static bool s_stop = false;
+static bool s_resched = false;      /* 有任务被唤醒，下次推进时间时检查抢占 */
+static uint64_t s_next_tick = 0;    /* 下一个节拍边界，跨过时检查抢占 */
+static bool s_reboot = false;       /* 深度睡眠：删除全部任务，唤醒后重新执行 app_main */
+
+static bool sim_task_runnable(const struct sim_task *task)
+{
+    return SIM_TASK_READY == task->state
+           || (SIM_TASK_BLOCKED == task->state && task->wake <= sim_cycles());
+}
+
+/* 当前任务切回调度器，被再次调度时返回 */
+static void sim_task_switch_out(void)
+{
+    struct sim_task *self = s_current;
+
+    swapcontext(&self->ctx, &s_sched_ctx);
+}
+
+/* 是否有任务应当抢占当前任务 */
+static bool sim_task_should_yield(bool slice_end)
+{
+    struct sim_task *task = NULL;
+
+    for(task = s_tasks; NULL != task; task = task->next)
+    {
+        if(task == s_current || !sim_task_runnable(task))
+        {
+            continue;
+        }
+        if(task->prio > s_current->prio || (slice_end && task->prio == s_current->prio))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void sim_task_entry(void)
+{
+    struct sim_task *self = s_current;
+
+    self->func(self->arg);
+
+    // FreeRTOS 中任务函数不能返回，这里按删除自身处理
+    vTaskDelete(NULL);
+}
+
+bool sim_task_context(void)
+{
+    return NULL != s_current && !sim_in_isr();
+}
+
+uint64_t sim_tick_deadline(TickType_t ticks)
+{
+    if(portMAX_DELAY == ticks)
+    {
+        return SIM_TIME_NEVER;
+    }
+
+    return (sim_cycles() / SIM_CYCLES_PER_TICK + ticks) * SIM_CYCLES_PER_TICK;
+}
+
+void sim_task_preempt(void)
+{
+    uint64_t now = sim_cycles();
+    bool slice_end = false;
+
+    if(!sim_task_context())
+    {
+        return;
+    }
+
+    // 只在节拍边界或有任务被唤醒时检查，忙等待循环里每次读 CCOUNT 都会调用
+    if(now < s_next_tick && !s_resched)
+    {
+        return;
+    }
+    slice_end = (now / SIM_CYCLES_PER_TICK != s_current->slice_tick);
+    s_next_tick = (now / SIM_CYCLES_PER_TICK + 1) * SIM_CYCLES_PER_TICK;
+    s_resched = false;
+
+    // 仿真结束时切出忙等待的任务，sim_run() 才能返回
+    if(s_stop || now >= s_end || sim_task_should_yield(slice_end))
+    {
+        sim_task_switch_out();
+    }
+}
+
+void sim_task_block(const void *obj, uint64_t wake)
+{
+    if(!sim_task_context())
+    {
+        fprintf(stderr, "sim: blocking call outside of a task\n");
+        abort();
+    }
+
+    s_current->state = SIM_TASK_BLOCKED;
+    s_current->wait_obj = obj;
+    s_current->wake = wake;
+    sim_task_switch_out();
+}
+
+void sim_task_wake_all(const void *obj)
+{
+    struct sim_task *task = NULL;
+    bool higher = false;
+
+    for(task = s_tasks; NULL != task; task = task->next)
+    {
+        if(SIM_TASK_BLOCKED == task->state && NULL != task->wait_obj && obj == task->wait_obj)
+        {
+            task->state = SIM_TASK_READY;
+            task->wait_obj = NULL;
+            if(NULL != s_current && task->prio > s_current->prio)
+            {
+                higher = true;
+            }
+        }
+    }
+
+    // 中断中唤醒的任务在中断返回后 (下次推进时间时) 抢占
+    if(higher)
+    {
+        if(sim_task_context())
+        {
+            sim_task_switch_out();
+        }
+        else
+        {
+            s_resched = true;
+        }
+    }
+}
+
+BaseType_t xTaskCreate(TaskFunction_t func, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle)
+{
+    struct sim_task *task = calloc(1, sizeof(struct sim_task));
+    struct sim_task **pp = &s_tasks;
+
+    if(NULL == task)
+    {
+        return pdFAIL;
+    }
+    // 任务栈在目标上由 pvPortMalloc() 分配，不经过 malloc()，不计入 alloc_hook 的统计
+    task->stack = mmap(NULL, SIM_TASK_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(MAP_FAILED == task->stack)
+    {
+        free(task);
+        return pdFAIL;
+    }
+
+    memset(task->stack, SIM_TASK_STACK_FILL, SIM_TASK_STACK_SIZE);
+    task->stack_depth = stack_depth;
+
+    strncpy(task->name, (NULL != name) ? name : "", SIM_TASK_NAME_LEN - 1);
+    task->prio = (configMAX_PRIORITIES <= prio) ? configMAX_PRIORITIES - 1 : prio;
+    task->state = SIM_TASK_READY;
+    task->func = func;
+    task->arg = arg;
+
+    getcontext(&task->ctx);
+    task->ctx.uc_stack.ss_sp = task->stack;
+    task->ctx.uc_stack.ss_size = SIM_TASK_STACK_SIZE;
+    task->ctx.uc_link = &s_sched_ctx;
+    makecontext(&task->ctx, sim_task_entry, 0);
+
+    // 按创建顺序排在链表末尾，同优先级先创建的先运行
+    while(NULL != *pp)
+    {
+        pp = &(*pp)->next;
+    }
+    *pp = task;
+
+    if(NULL != handle)
+    {
+        *handle = task;
+    }
+
+    // 新任务优先级更高时立即切换
+    if(sim_task_context() && task->prio > s_current->prio)
+    {
+        sim_task_switch_out();
+    }
+
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if(NULL == task)
+    {
+        task = s_current;
+    }
+
+    task->state = SIM_TASK_DELETED;
+    if(task == s_current)
+    {
+        sim_task_switch_out();
+        // 不会再被调度
+        abort();
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if(0 == ticks)
+    {
+        taskYIELD();
+        return;
+    }
+
+    sim_task_block(NULL, sim_tick_deadline(ticks));
+}
+
+void vTaskDelayUntil(TickType_t *prev_wake, TickType_t increment)
+{
+    uint64_t wake = sim_boot_cycles() + (uint64_t)(*prev_wake + increment) * SIM_CYCLES_PER_TICK;
+
+    *prev_wake += increment;
+    if(wake > sim_cycles())
+    {
+        sim_task_block(NULL, wake);
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)((sim_cycles() - sim_boot_cycles()) / SIM_CYCLES_PER_TICK);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_current;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    return (NULL != task) ? task->prio : s_current->prio;
+}
+
+/* 主机上实际使用的栈折算后从创建时指定的大小中扣除 */
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    const uint8_t *stack = NULL;
+    uint32_t untouched = 0;
+    uint32_t used = 0;
+
+    if(NULL == task)
+    {
+        task = s_current;
+    }
+    stack = task->stack;
+    while(SIM_TASK_STACK_SIZE > untouched && SIM_TASK_STACK_FILL == stack[untouched])
+    {
+        ++untouched;
+    }
+
+    used = (SIM_TASK_STACK_SIZE - untouched) / SIM_TASK_STACK_SCALE;
+
+    return (used < task->stack_depth) ? task->stack_depth - used : 0;
+}
+
+const char *pcTaskGetTaskName(TaskHandle_t task)
+{
+    return (NULL != task) ? task->name : s_current->name;
+}
+
+void taskYIELD(void)
+{
+    if(sim_task_context())
+    {
+        sim_task_switch_out();
+    }
+}
+
+/* 选出下一个运行的任务：优先级最高，同优先级中最久没有运行的 */
+static struct sim_task *sim_task_pick(void)
+{
+    struct sim_task *best = NULL;
+    struct sim_task *task = NULL;
+
+    for(task = s_tasks; NULL != task; task = task->next)
+    {
+        if(!sim_task_runnable(task))
+        {
+            continue;
+        }
+        if(NULL == best || task->prio > best->prio
+           || (task->prio == best->prio && task->run_seq < best->run_seq))
+        {
+            best = task;
+        }
+    }
+
+    return best;
+}
+
+/* 下一个阻塞任务的超时时刻 */
+static uint64_t sim_task_next_wake(void)
+{
+    struct sim_task *task = NULL;
+    uint64_t wake = SIM_TIME_NEVER;
+
+    for(task = s_tasks; NULL != task; task = task->next)
+    {
+        if(SIM_TASK_BLOCKED == task->state && task->wake < wake)
+        {
+            wake = task->wake;
+        }
+    }
+
+    return wake;
+}
+
+static void sim_main_task(void *arg)
+{
+    void (*app_main)(void) = (void (*)(void))arg;
+
+    app_main();
+}
+
+void sim_task_reboot(void)
+{
+    if(!sim_task_context())
+    {
+        fprintf(stderr, "sim: deep sleep outside of a task\n");
+        abort();
+    }
+
+    s_reboot = true;
+    sim_task_switch_out();
+    // 任务已被删除，不会再被调度
+    abort();
+}
+
+/* 删除全部任务，释放任务栈；目标上 RAM 掉电，任务创建的队列等对象不再回收 */
+static void sim_task_free_all(void)
+{
+    struct sim_task *task = NULL;
+
+    while(NULL != s_tasks)
+    {
+        task = s_tasks;
+        s_tasks = task->next;
+        munmap(task->stack, SIM_TASK_STACK_SIZE);
+        free(task);
+    }
+}
+
+void sim_stop(void)
+{
+    s_stop = true;
+    s_resched = true;
+}
+
+uint64_t sim_run(void (*app_main)(void), uint64_t duration_us)
+{
+    struct sim_task *task = NULL;
+    uint64_t next = 0;
+
+    s_end = sim_cycles() + duration_us * SIM_CYCLES_PER_US;
+    s_stop = false;
+    sim_sleep_boot();
+    xTaskCreate(sim_main_task, "main", SIM_MAIN_TASK_STACK, (void *)app_main, SIM_MAIN_TASK_PRIO, NULL);
+
+    while(!s_stop && sim_cycles() < s_end)
+    {
+        task = sim_task_pick();
+        if(NULL == task)
+        {
+            // 所有任务阻塞：跳到下一个唤醒时刻或事件，都没有时提前结束
+            next = sim_task_next_wake();
+            if(sim_event_next() < next)
+            {
+                next = sim_event_next();
+            }
+            if(SIM_TIME_NEVER == next)
+            {
+                break;
+            }
+            sim_advance_to((next < s_end) ? next : s_end);
+            continue;
+        }
+
+        task->state = SIM_TASK_READY;
+        task->wait_obj = NULL;
+        task->run_seq = ++s_seq;
+        task->slice_tick = sim_cycles() / SIM_CYCLES_PER_TICK;
+        s_next_tick = (task->slice_tick + 1) * SIM_CYCLES_PER_TICK;
+        s_current = task;
+        swapcontext(&s_sched_ctx, &task->ctx);
+        s_current = NULL;
+
+        // 深度睡眠：复位芯片，等到唤醒后重新启动，结束时刻前没有唤醒时结束
+        if(s_reboot)
+        {
+            s_reboot = false;
+            sim_task_free_all();
+            if(!sim_sleep_wake(s_end))
+            {
+                break;
+            }
+            xTaskCreate(sim_main_task, "main", SIM_MAIN_TASK_STACK, (void *)app_main, SIM_MAIN_TASK_PRIO, NULL);
+        }
+    }
+
+    return sim_time_us();
+}
@@ -0,0 +1,330 @@
+/**
+ * 主机仿真：UART 驱动与发送模型，行为说明见 sim_uart.h
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "driver/uart.h"
+#include "esp8266/uart_struct.h"
+
+#include "sim.h"
+#include "sim_internal.h"
+#include "sim_uart.h"
+
+/* fifo.rw_byte 中没有待处理的写入 */
+#define SIM_UART_FIFO_IDLE          (0xFFFFFFFF)
+#define SIM_UART_DEFAULT_BAUD       (115200)
+
+typedef struct {
+    uart_dev_t regs;
+    uint32_t baud;
+    uint64_t byte_cycles;
+    uint8_t fifo[UART_FIFO_LEN];
+    uint64_t done[UART_FIFO_LEN];   /*!< 每个字节发完的时刻 */
+    uint32_t head;                  /*!< 最早写入的字节 */
+    uint32_t count;
+    bool tx_intr;
+    uint32_t thresh;
+    void (*isr)(void *);
+    void *isr_arg;
+    sim_event_t ev;
+    int fd;
+    sim_uart_rx_t rx;
+    void *rx_ctx;
+    uint64_t tx_bytes;
+} sim_uart_port_t;
+
+static sim_uart_port_t s_ports[UART_NUM_MAX];
+static bool s_init = false;
+
+static void sim_uart_set_baud(sim_uart_port_t *port, uint32_t baud)
+{
+    port->baud = baud;
+    port->byte_cycles = ((uint64_t)SIM_UART_BITS_PER_BYTE * SIM_CPU_MHZ * 1000000 + baud / 2) / baud;
+}
+
+static sim_uart_port_t *sim_uart_port(int uart_num)
+{
+    int i = 0;
+
+    if(!s_init)
+    {
+        for(i = 0; i < UART_NUM_MAX; ++i)
+        {
+            s_ports[i].regs.fifo.rw_byte = SIM_UART_FIFO_IDLE;
+            s_ports[i].fd = -1;
+            sim_uart_set_baud(&s_ports[i], SIM_UART_DEFAULT_BAUD);
+        }
+        s_init = true;
+    }
+    if(0 > uart_num || UART_NUM_MAX <= uart_num)
+    {
+        fprintf(stderr, "sim: invalid uart %d\n", uart_num);
+        abort();
+    }
+
+    return &s_ports[uart_num];
+}
+
+static void sim_uart_emit(sim_uart_port_t *port, uint8_t data)
+{
+    ssize_t ret = 0;
+
+    // 伪终端另一端读得慢时阻塞等待，不丢数据
+    while(0 <= port->fd)
+    {
+        ret = write(port->fd, &data, 1);
+        if(1 == ret)
+        {
+            break;
+        }
+        if(0 > ret && EINTR != errno)
+        {
+            fprintf(stderr, "sim: uart output error %d, closed\n", errno);
+            port->fd = -1;
+        }
+    }
+    if(NULL != port->rx)
+    {
+        port->rx(port->rx_ctx, &data, 1);
+    }
+    ++port->tx_bytes;
+}
+
+/* 发完的字节移出 FIFO，上一次写入 fifo 的字节放入 FIFO (已满时丢弃)，刷新寄存器 */
+static void sim_uart_update(sim_uart_port_t *port)
+{
+    uint64_t now = sim_cycles();
+    uint64_t start = now;
+    uint32_t tail = 0;
+
+    while(0 < port->count && port->done[port->head] <= now)
+    {
+        sim_uart_emit(port, port->fifo[port->head]);
+        port->head = (port->head + 1) % UART_FIFO_LEN;
+        --port->count;
+    }
+
+    if(SIM_UART_FIFO_IDLE != port->regs.fifo.rw_byte)
+    {
+        if(UART_FIFO_LEN > port->count)
+        {
+            tail = (port->head + port->count) % UART_FIFO_LEN;
+            if(0 < port->count && port->done[(tail + UART_FIFO_LEN - 1) % UART_FIFO_LEN] > start)
+            {
+                start = port->done[(tail + UART_FIFO_LEN - 1) % UART_FIFO_LEN];
+            }
+            port->fifo[tail] = (uint8_t)port->regs.fifo.rw_byte;
+            port->done[tail] = start + port->byte_cycles;
+            ++port->count;
+        }
+        port->regs.fifo.rw_byte = SIM_UART_FIFO_IDLE;
+    }
+
+    port->regs.status.txfifo_cnt = port->count;
+    port->regs.int_st.txfifo_empty = (port->tx_intr && port->count < port->thresh) ? 1 : 0;
+}
+
+static void sim_uart_fire(void *arg);
+
+/* 下一次需要处理的时刻：中断条件成立、下一个字节发完 (中断服务程序没有关闭中断)，或全部发完 */
+static void sim_uart_schedule(sim_uart_port_t *port)
+{
+    uint32_t idx = 0;
+
+    if(0 == port->count)
+    {
+        sim_event_cancel(&port->ev);
+        return;
+    }
+
+    if(port->tx_intr && port->count >= port->thresh)
+    {
+        idx = port->count - port->thresh;
+    }
+    else if(port->tx_intr)
+    {
+        idx = 0;
+    }
+    else
+    {
+        idx = port->count - 1;
+    }
+    sim_event_schedule(&port->ev, port->done[(port->head + idx) % UART_FIFO_LEN], sim_uart_fire, port);
+}
+
+/* 在中断上下文中执行 */
+static void sim_uart_fire(void *arg)
+{
+    sim_uart_port_t *port = arg;
+
+    sim_uart_update(port);
+    if(port->regs.int_st.txfifo_empty && NULL != port->isr)
+    {
+        port->isr(port->isr_arg);
+        sim_uart_update(port);
+    }
+    sim_uart_schedule(port);
+}
+
+uart_dev_t *sim_uart_regs(int uart_num)
+{
+    sim_uart_port_t *port = sim_uart_port(uart_num);
+
+    sim_uart_update(port);
+
+    return &port->regs;
+}
+
+void sim_uart_set_output(uart_port_t uart_num, int fd)
+{
+    sim_uart_port(uart_num)->fd = fd;
+}
+
+void sim_uart_set_rx(uart_port_t uart_num, sim_uart_rx_t rx, void *ctx)
+{
+    sim_uart_port_t *port = sim_uart_port(uart_num);
+
+    port->rx = rx;
+    port->rx_ctx = ctx;
+}
+
+uint64_t sim_uart_tx_bytes(uart_port_t uart_num)
+{
+    return sim_uart_port(uart_num)->tx_bytes;
+}
+
+/* FIFO 中没有发完的字节丢失，输出文件与接收回调保持 */
+void sim_uart_reset(void)
+{
+    sim_uart_port_t *port = NULL;
+    int i = 0;
+
+    for(i = 0; i < UART_NUM_MAX; ++i)
+    {
+        port = sim_uart_port(i);
+        sim_uart_update(port);
+        sim_event_cancel(&port->ev);
+        port->regs.fifo.rw_byte = SIM_UART_FIFO_IDLE;
+        port->count = 0;
+        port->tx_intr = false;
+        port->thresh = 0;
+        port->isr = NULL;
+        port->isr_arg = NULL;
+        sim_uart_set_baud(port, SIM_UART_DEFAULT_BAUD);
+        sim_uart_update(port);
+    }
+}
+
+esp_err_t uart_param_config(uart_port_t uart_num, uart_config_t *uart_conf)
+{
+    if(UART_NUM_MAX <= uart_num || NULL == uart_conf || 0 >= uart_conf->baud_rate)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sim_uart_set_baud(sim_uart_port(uart_num), uart_conf->baud_rate);
+
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t uart_num, uint32_t baudrate)
+{
+    if(UART_NUM_MAX <= uart_num || 0 == baudrate)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sim_uart_set_baud(sim_uart_port(uart_num), baudrate);
+
+    return ESP_OK;
+}
+
+esp_err_t uart_get_baudrate(uart_port_t uart_num, uint32_t *baudrate)
+{
+    if(UART_NUM_MAX <= uart_num || NULL == baudrate)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *baudrate = sim_uart_port(uart_num)->baud;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_isr_register(uart_port_t uart_num, void (*fn)(void *), void *arg)
+{
+    sim_uart_port_t *port = NULL;
+
+    if(UART_NUM_MAX <= uart_num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    port = sim_uart_port(uart_num);
+    sim_critical_enter();
+    port->isr = fn;
+    port->isr_arg = arg;
+    sim_critical_exit();
+
+    return ESP_OK;
+}
+
+esp_err_t uart_enable_tx_intr(uart_port_t uart_num, int enable, int thresh)
+{
+    sim_uart_port_t *port = NULL;
+
+    if(UART_NUM_MAX <= uart_num || 0 > thresh || UART_FIFO_LEN <= thresh)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    port = sim_uart_port(uart_num);
+    port->tx_intr = (0 != enable);
+    port->thresh = thresh;
+    sim_uart_update(port);
+    if(port->regs.int_st.txfifo_empty)
+    {
+        // 条件已经成立，立即进入中断 (临界区内推迟到退出临界区)
+        sim_isr_run(sim_uart_fire, port);
+    }
+    else
+    {
+        sim_uart_schedule(port);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t uart_disable_tx_intr(uart_port_t uart_num)
+{
+    sim_uart_port_t *port = NULL;
+
+    if(UART_NUM_MAX <= uart_num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    port = sim_uart_port(uart_num);
+    port->tx_intr = false;
+    sim_uart_update(port);
+    sim_uart_schedule(port);
+
+    return ESP_OK;
+}
+
+esp_err_t uart_clear_intr_status(uart_port_t uart_num, uint32_t clr_mask)
+{
+    if(UART_NUM_MAX <= uart_num)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // TX FIFO 空为电平条件，清除后只要条件仍然成立就会再次置位
+    sim_uart_update(sim_uart_port(uart_num));
+
+    return ESP_OK;
+}
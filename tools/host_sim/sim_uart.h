@@ -0,0 +1,39 @@
+/**
+ * 主机仿真：UART 发送模型
+ *
+ * 128 字节发送 FIFO，每字节 10 位 (8N1)，按波特率在虚拟时间中逐字节发出。
+ * TX FIFO 空中断：使能后 FIFO 中的字节数低于门限时执行 uart_isr_register() 登记的中断服务程序，
+ * 中断服务程序返回后条件仍然成立时，在下一个字节发完时再次执行。
+ * 发出的字节写入文件/伪终端 (sim_main 的 -u 选项)，并交给仿真板登记的接收回调。
+ * 只模拟发送，日志仍然直接输出到 stdout，不经过本模型。
+ */
+#ifndef _SIM_UART_H_
+#define _SIM_UART_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "driver/uart.h"
+
+/* 每字节的位数：起始位 + 8 位数据 + 停止位 */
+#define SIM_UART_BITS_PER_BYTE      (10)
+
+/* 收到发出的字节 */
+typedef void (*sim_uart_rx_t)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief  发出的字节写入文件描述符，-1 为不写入
+ */
+void sim_uart_set_output(uart_port_t uart_num, int fd);
+
+/**
+ * @brief  仿真板接收发出的字节，例如接上解码器检查数据
+ */
+void sim_uart_set_rx(uart_port_t uart_num, sim_uart_rx_t rx, void *ctx);
+
+/**
+ * @brief  已发出的字节数
+ */
+uint64_t sim_uart_tx_bytes(uart_port_t uart_num);
+
+#endif /* _SIM_UART_H_ */
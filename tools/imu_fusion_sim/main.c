@@ -0,0 +1,569 @@
+/**
+ * 说明:
+ * 姿态解算 (imu_fusion 组件) 的主机端精度检查
+ *
+ * 同一段 MPU6050 原始数据分别输入定点数实现与按同样公式编写的双精度浮点参考实现，逐个采样比较：
+ * 1. 定点 - 浮点：两个四元数之间的夹角，以及横滚/俯仰/航向角之差的最大值与均方根 (°)
+ * 2. 合成数据时还与真实姿态比较 (算法本身的误差，定点与浮点应当相近)
+ *
+ * 数据来源：
+ * - 默认合成：横滚/俯仰/航向按不同频率的正弦摆动，由真实姿态算出机体角速度与重力方向，
+ *   按 MPU6050 的灵敏度 (+/-2g，+/-2000dps) 量化并加入噪声与陀螺仪零偏
+ * - 记录的数据：CSV，第一行为列名，需要 accel_x/accel_y/accel_z/gyro_x/gyro_y/gyro_z 列
+ *   (例如 tools/sample_decode 的输出)，采样率由 -r 指定
+ *
+ * 使用:
+ * $ ./imu_fusion_sim [-r 采样率Hz] [-s 合成时长s] [-a 加速度噪声LSB] [-g 角速度噪声LSB] [-b 零偏LSB]
+ *                    [-t 阈值°] [trace.csv]
+ *
+ * 任一算法定点与浮点夹角的均方根超过阈值 (默认 0.1°) 时返回 1。不用最大值判断：Madgwick 每个采样的修正幅度
+ * 固定为 beta * dt，收敛后梯度接近 0，两种实现的来回修正可能错开一个采样，单个采样的差值可达 2 * beta * dt
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+
+#include "imu_fusion.h"
+
+#define SIM_LINE_LEN                (1024)
+#define SIM_GYRO_LSB_PER_DPS        (16.4)
+#define SIM_ACCEL_LSB_PER_G         (16384.0)
+
+typedef struct {
+    uint32_t num;
+    int16_t (*accel)[3];
+    int16_t (*gyro)[3];
+    double (*truth)[4];             /*!< 合成数据的真实姿态，记录的数据为 NULL */
+} sim_trace_t;
+
+/* 浮点参考实现，与 imu_fusion.c 的公式相同 */
+typedef struct {
+    imu_fusion_algo_t algo;
+    double dt;
+    double gyro_scale;              /*!< rad/s 每 LSB */
+    double gain;
+    double gain_i;
+    bool started;
+    double q[4];
+    double integral[3];
+    double euler[3];
+} ref_fusion_t;
+
+typedef struct {
+    double max;
+    double sum2;
+    uint32_t n;
+} sim_err_t;
+
+static const char *s_algo_names[] = { "complementary", "mahony", "madgwick" };
+
+static void ref_from_euler(const double e[3], double q[4])
+{
+    double cr = cos(e[0] / 2), sr = sin(e[0] / 2);
+    double cp = cos(e[1] / 2), sp = sin(e[1] / 2);
+    double cy = cos(e[2] / 2), sy = sin(e[2] / 2);
+
+    q[0] = cr * cp * cy + sr * sp * sy;
+    q[1] = sr * cp * cy - cr * sp * sy;
+    q[2] = cr * sp * cy + sr * cp * sy;
+    q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+static void ref_to_euler(const double q[4], double e[3])
+{
+    double sinp = 2 * (q[0] * q[2] - q[3] * q[1]);
+
+    e[0] = atan2(2 * (q[0] * q[1] + q[2] * q[3]), 1 - 2 * (q[1] * q[1] + q[2] * q[2]));
+    e[1] = asin(fmax(-1.0, fmin(1.0, sinp)));
+    e[2] = atan2(2 * (q[0] * q[3] + q[1] * q[2]), 1 - 2 * (q[2] * q[2] + q[3] * q[3]));
+}
+
+static void ref_normalize(double *v, int n)
+{
+    double norm = 0;
+    int i = 0;
+
+    for(i = 0; i < n; ++i)
+    {
+        norm += v[i] * v[i];
+    }
+    norm = sqrt(norm);
+    if(0 == norm)
+    {
+        return;
+    }
+    for(i = 0; i < n; ++i)
+    {
+        v[i] /= norm;
+    }
+}
+
+static double ref_wrap(double angle)
+{
+    return angle - 2 * M_PI * floor((angle + M_PI) / (2 * M_PI));
+}
+
+static void ref_init(ref_fusion_t *ref, const imu_fusion_config_t *config)
+{
+    memset(ref, 0, sizeof(ref_fusion_t));
+    ref->algo = config->algo;
+    ref->dt = 1.0 / config->sample_hz;
+    ref->gyro_scale = M_PI / 180.0 / SIM_GYRO_LSB_PER_DPS;
+    ref->gain = config->gain / 65536.0;
+    ref->gain_i = config->gain_i / 65536.0;
+    ref->q[0] = 1;
+}
+
+static void ref_update(ref_fusion_t *ref, const int16_t accel[3], const int16_t gyro[3])
+{
+    double a[3] = { accel[0], accel[1], accel[2] };
+    double g[3];
+    double *q = ref->q;
+    double v[3], e[3], qd[4], s[4];
+    double qa, qb, qc;
+    double k = 0;
+    bool valid = 0 != accel[0] || 0 != accel[1] || 0 != accel[2];
+    double acc_roll = atan2(a[1], a[2]);
+    double acc_pitch = atan2(-a[0], sqrt(a[1] * a[1] + a[2] * a[2]));
+    int i = 0;
+
+    if(!ref->started)
+    {
+        if(valid)
+        {
+            ref->euler[0] = acc_roll;
+            ref->euler[1] = acc_pitch;
+            ref->euler[2] = 0;
+            ref_from_euler(ref->euler, q);
+            ref->started = true;
+        }
+        return;
+    }
+
+    for(i = 0; i < 3; ++i)
+    {
+        g[i] = gyro[i] * ref->gyro_scale;
+    }
+    ref_normalize(a, 3);
+
+    switch(ref->algo)
+    {
+        case IMU_FUSION_COMPLEMENTARY:
+            for(i = 0; i < 3; ++i)
+            {
+                ref->euler[i] = ref_wrap(ref->euler[i] + g[i] * ref->dt);
+            }
+            if(valid)
+            {
+                k = fmin(1.0, ref->gain * ref->dt);
+                ref->euler[0] = ref_wrap(ref->euler[0] + ref_wrap(acc_roll - ref->euler[0]) * k);
+                ref->euler[1] = ref_wrap(ref->euler[1] + ref_wrap(acc_pitch - ref->euler[1]) * k);
+            }
+            ref_from_euler(ref->euler, q);
+            break;
+
+        case IMU_FUSION_MAHONY:
+            if(valid)
+            {
+                v[0] = q[1] * q[3] - q[0] * q[2];
+                v[1] = q[0] * q[1] + q[2] * q[3];
+                v[2] = q[0] * q[0] - 0.5 + q[3] * q[3];
+                e[0] = a[1] * v[2] - a[2] * v[1];
+                e[1] = a[2] * v[0] - a[0] * v[2];
+                e[2] = a[0] * v[1] - a[1] * v[0];
+                for(i = 0; i < 3; ++i)
+                {
+                    if(0 < ref->gain_i)
+                    {
+                        ref->integral[i] += ref->gain_i * e[i] * ref->dt;
+                        g[i] += ref->integral[i];
+                    }
+                    g[i] += ref->gain * e[i];
+                }
+            }
+            for(i = 0; i < 3; ++i)
+            {
+                g[i] *= 0.5 * ref->dt;
+            }
+            qa = q[0];
+            qb = q[1];
+            qc = q[2];
+            q[0] += -qb * g[0] - qc * g[1] - q[3] * g[2];
+            q[1] += qa * g[0] + qc * g[2] - q[3] * g[1];
+            q[2] += qa * g[1] - qb * g[2] + q[3] * g[0];
+            q[3] += qa * g[2] + qb * g[1] - qc * g[0];
+            ref_normalize(q, 4);
+            break;
+
+        case IMU_FUSION_MADGWICK:
+            qd[0] = 0.5 * (-q[1] * g[0] - q[2] * g[1] - q[3] * g[2]);
+            qd[1] = 0.5 * (q[0] * g[0] + q[2] * g[2] - q[3] * g[1]);
+            qd[2] = 0.5 * (q[0] * g[1] - q[1] * g[2] + q[3] * g[0]);
+            qd[3] = 0.5 * (q[0] * g[2] + q[1] * g[1] - q[2] * g[0]);
+            if(valid)
+            {
+                s[0] = 4 * q[0] * q[2] * q[2] + 2 * q[2] * a[0] + 4 * q[0] * q[1] * q[1] - 2 * q[1] * a[1];
+                s[1] = 4 * q[1] * q[3] * q[3] - 2 * q[3] * a[0] + 4 * q[0] * q[0] * q[1] - 2 * q[0] * a[1] - 4 * q[1]
+                       + 8 * q[1] * q[1] * q[1] + 8 * q[1] * q[2] * q[2] + 4 * q[1] * a[2];
+                s[2] = 4 * q[0] * q[0] * q[2] + 2 * q[0] * a[0] + 4 * q[2] * q[3] * q[3] - 2 * q[3] * a[1] - 4 * q[2]
+                       + 8 * q[2] * q[1] * q[1] + 8 * q[2] * q[2] * q[2] + 4 * q[2] * a[2];
+                s[3] = 4 * q[1] * q[1] * q[3] - 2 * q[1] * a[0] + 4 * q[2] * q[2] * q[3] - 2 * q[2] * a[1];
+                ref_normalize(s, 4);
+                for(i = 0; i < 4; ++i)
+                {
+                    qd[i] -= ref->gain * s[i];
+                }
+            }
+            for(i = 0; i < 4; ++i)
+            {
+                q[i] += qd[i] * ref->dt;
+            }
+            ref_normalize(q, 4);
+            break;
+    }
+}
+
+static void ref_get(const ref_fusion_t *ref, double e[3])
+{
+    if(IMU_FUSION_COMPLEMENTARY == ref->algo)
+    {
+        memcpy(e, ref->euler, sizeof(ref->euler));
+        return;
+    }
+    ref_to_euler(ref->q, e);
+}
+
+/* 两个姿态之间的夹角 (°) */
+static double sim_angle(const double a[4], const double b[4])
+{
+    double dot = fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+
+    return 2 * acos(fmin(1.0, dot)) * 180.0 / M_PI;
+}
+
+static void sim_err_add(sim_err_t *err, double value)
+{
+    value = fabs(value);
+    if(value > err->max)
+    {
+        err->max = value;
+    }
+    err->sum2 += value * value;
+    err->n++;
+}
+
+static double sim_err_rms(const sim_err_t *err)
+{
+    return (0 == err->n) ? 0.0 : sqrt(err->sum2 / err->n);
+}
+
+static double sim_gauss(void)
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+static int16_t sim_clamp(double v)
+{
+    v = round(v);
+
+    return (int16_t)((32767 < v) ? 32767 : ((-32768 > v) ? -32768 : v));
+}
+
+static void sim_truth(double t, double q[4])
+{
+    double e[3];
+
+    e[0] = 40.0 * M_PI / 180.0 * sin(2 * M_PI * 0.21 * t);
+    e[1] = 25.0 * M_PI / 180.0 * sin(2 * M_PI * 0.13 * t + 1.0);
+    e[2] = 120.0 * M_PI / 180.0 * sin(2 * M_PI * 0.05 * t);
+    ref_from_euler(e, q);
+}
+
+/* 合成数据：机体角速度 ω = 2 q* ⊗ dq/dt，重力方向为参考系 z 轴在机体系中的坐标 */
+static int sim_synth(sim_trace_t *trace, uint16_t hz, double seconds, double accel_noise, double gyro_noise,
+                     double bias)
+{
+    const double h = 1e-5;
+    double q[4], qp[4], qm[4], qd[4], w[3];
+    double t = 0;
+    uint32_t k = 0;
+    int i = 0;
+
+    trace->num = (uint32_t)(seconds * hz);
+    trace->accel = calloc(trace->num, sizeof(*trace->accel));
+    trace->gyro = calloc(trace->num, sizeof(*trace->gyro));
+    trace->truth = calloc(trace->num, sizeof(*trace->truth));
+    if(NULL == trace->accel || NULL == trace->gyro || NULL == trace->truth)
+    {
+        return -1;
+    }
+
+    srand(1);
+    for(k = 0; k < trace->num; ++k)
+    {
+        t = (double)k / hz;
+        sim_truth(t, q);
+        sim_truth(t + h, qp);
+        sim_truth(t - h, qm);
+        for(i = 0; i < 4; ++i)
+        {
+            qd[i] = (qp[i] - qm[i]) / (2 * h);
+        }
+        w[0] = 2 * (q[0] * qd[1] - q[1] * qd[0] - q[2] * qd[3] + q[3] * qd[2]);
+        w[1] = 2 * (q[0] * qd[2] + q[1] * qd[3] - q[2] * qd[0] - q[3] * qd[1]);
+        w[2] = 2 * (q[0] * qd[3] - q[1] * qd[2] + q[2] * qd[1] - q[3] * qd[0]);
+
+        trace->accel[k][0] = sim_clamp(2 * (q[1] * q[3] - q[0] * q[2]) * SIM_ACCEL_LSB_PER_G + accel_noise * sim_gauss());
+        trace->accel[k][1] = sim_clamp(2 * (q[0] * q[1] + q[2] * q[3]) * SIM_ACCEL_LSB_PER_G + accel_noise * sim_gauss());
+        trace->accel[k][2] = sim_clamp((q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]) * SIM_ACCEL_LSB_PER_G
+                                       + accel_noise * sim_gauss());
+        for(i = 0; i < 3; ++i)
+        {
+            trace->gyro[k][i] = sim_clamp(w[i] * 180.0 / M_PI * SIM_GYRO_LSB_PER_DPS + bias + gyro_noise * sim_gauss());
+        }
+        memcpy(trace->truth[k], q, sizeof(q));
+    }
+
+    return 0;
+}
+
+/* 读取 CSV，按列名找到加速度与角速度 */
+static int sim_load_csv(const char *path, sim_trace_t *trace)
+{
+    static const char *names[6] = { "accel_x", "accel_y", "accel_z", "gyro_x", "gyro_y", "gyro_z" };
+    static char line[SIM_LINE_LEN];
+    int cols[6] = { -1, -1, -1, -1, -1, -1 };
+    uint32_t size = 0;
+    char *field = NULL;
+    char *save = NULL;
+    int col = 0;
+    int found = 0;
+    int i = 0;
+    FILE *fp = fopen(path, "r");
+
+    if(NULL == fp)
+    {
+        perror(path);
+        return -1;
+    }
+    if(NULL == fgets(line, sizeof(line), fp))
+    {
+        fclose(fp);
+        return -1;
+    }
+    line[strcspn(line, "\r\n")] = '\0';
+    for(field = strtok_r(line, ",", &save), col = 0; NULL != field; field = strtok_r(NULL, ",", &save), ++col)
+    {
+        for(i = 0; i < 6; ++i)
+        {
+            if(0 == strcmp(field, names[i]))
+            {
+                cols[i] = col;
+                found++;
+            }
+        }
+    }
+    if(6 != found)
+    {
+        fprintf(stderr, "%s: need columns accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z\n", path);
+        fclose(fp);
+        return -1;
+    }
+
+    trace->num = 0;
+    trace->truth = NULL;
+    while(NULL != fgets(line, sizeof(line), fp))
+    {
+        if(trace->num == size)
+        {
+            size = (0 == size) ? 1024 : size * 2;
+            trace->accel = realloc(trace->accel, size * sizeof(*trace->accel));
+            trace->gyro = realloc(trace->gyro, size * sizeof(*trace->gyro));
+            if(NULL == trace->accel || NULL == trace->gyro)
+            {
+                fclose(fp);
+                return -1;
+            }
+        }
+        for(field = strtok_r(line, ",", &save), col = 0; NULL != field; field = strtok_r(NULL, ",", &save), ++col)
+        {
+            for(i = 0; i < 6; ++i)
+            {
+                if(cols[i] == col)
+                {
+                    if(3 > i)
+                    {
+                        trace->accel[trace->num][i] = sim_clamp(strtod(field, NULL));
+                    }
+                    else
+                    {
+                        trace->gyro[trace->num][i - 3] = sim_clamp(strtod(field, NULL));
+                    }
+                }
+            }
+        }
+        trace->num++;
+    }
+    fclose(fp);
+
+    return (int)trace->num;
+}
+
+static double sim_elapsed_ns(const struct timespec *t0, const struct timespec *t1)
+{
+    return (double)(t1->tv_sec - t0->tv_sec) * 1e9 + (double)(t1->tv_nsec - t0->tv_nsec);
+}
+
+/* 运行一种算法，返回定点与浮点夹角的均方根 */
+static double sim_run(const sim_trace_t *trace, imu_fusion_algo_t algo, uint16_t hz)
+{
+    imu_fusion_config_t config = IMU_FUSION_DEFAULT_CONFIG(algo);
+    imu_fusion_t fusion;
+    imu_fusion_attitude_t att;
+    ref_fusion_t ref;
+    sim_err_t q_err = { 0 };
+    sim_err_t euler_err = { 0 };
+    sim_err_t fixed_truth = { 0 };
+    sim_err_t float_truth = { 0 };
+    double qf[4], ef[3], er[3];
+    struct timespec t0, t1;
+    double fixed_ns = 0;
+    double float_ns = 0;
+    uint32_t k = 0;
+    int i = 0;
+
+    config.sample_hz = hz;
+    config.gyro_scale = IMU_FUSION_GYRO_SCALE(SIM_GYRO_LSB_PER_DPS);
+    imu_fusion_init(&fusion, &config);
+    ref_init(&ref, &config);
+
+    for(k = 0; k < trace->num; ++k)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        imu_fusion_update(&fusion, trace->accel[k], trace->gyro[k]);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        fixed_ns += sim_elapsed_ns(&t0, &t1);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        ref_update(&ref, trace->accel[k], trace->gyro[k]);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        float_ns += sim_elapsed_ns(&t0, &t1);
+
+        imu_fusion_get(&fusion, &att);
+        for(i = 0; i < 4; ++i)
+        {
+            qf[i] = att.q[i] / (double)IMU_FUSION_Q30_ONE;
+        }
+        ef[0] = att.roll / 100.0;
+        ef[1] = att.pitch / 100.0;
+        ef[2] = att.yaw / 100.0;
+        ref_get(&ref, er);
+
+        sim_err_add(&q_err, sim_angle(qf, ref.q));
+        for(i = 0; i < 3; ++i)
+        {
+            sim_err_add(&euler_err, ref_wrap((ef[i] - er[i] * 180.0 / M_PI) * M_PI / 180.0) * 180.0 / M_PI);
+        }
+        // 与真实姿态比较时跳过第一秒的收敛过程
+        if(NULL != trace->truth && k >= hz)
+        {
+            sim_err_add(&fixed_truth, sim_angle(qf, trace->truth[k]));
+            sim_err_add(&float_truth, sim_angle(ref.q, trace->truth[k]));
+        }
+    }
+
+    printf("%-14s %8.4f %8.4f %8.4f %8.4f", s_algo_names[algo], q_err.max, sim_err_rms(&q_err),
+           euler_err.max, sim_err_rms(&euler_err));
+    if(NULL != trace->truth)
+    {
+        printf(" %8.3f %8.3f %8.3f %8.3f", fixed_truth.max, sim_err_rms(&fixed_truth),
+               float_truth.max, sim_err_rms(&float_truth));
+    }
+    printf(" %8.1f %8.1f\n", fixed_ns / trace->num, float_ns / trace->num);
+
+    return sim_err_rms(&q_err);
+}
+
+int main(int argc, char *argv[])
+{
+    static sim_trace_t trace;
+    uint16_t hz = 100;
+    double seconds = 120;
+    double accel_noise = 40;
+    double gyro_noise = 3;
+    double bias = 0;
+    double threshold = 0.1;
+    int fail = 0;
+    int opt = 0;
+    int algo = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "r:s:a:g:b:t:")))
+    {
+        switch(opt)
+        {
+            case 'r': hz = (uint16_t)strtoul(optarg, NULL, 10); break;
+            case 's': seconds = strtod(optarg, NULL); break;
+            case 'a': accel_noise = strtod(optarg, NULL); break;
+            case 'g': gyro_noise = strtod(optarg, NULL); break;
+            case 'b': bias = strtod(optarg, NULL); break;
+            case 't': threshold = strtod(optarg, NULL); break;
+            default:
+                fprintf(stderr, "usage: %s [-r hz] [-s seconds] [-a accel_noise] [-g gyro_noise] [-b gyro_bias] "
+                                "[-t threshold_deg] [trace.csv]\n", argv[0]);
+                return 2;
+        }
+    }
+    if(0 == hz)
+    {
+        return 2;
+    }
+
+    if(optind < argc)
+    {
+        if(0 >= sim_load_csv(argv[optind], &trace))
+        {
+            return 2;
+        }
+        printf("trace: %s, %u samples at %u Hz\n", argv[optind], trace.num, hz);
+    }
+    else
+    {
+        if(0 != sim_synth(&trace, hz, seconds, accel_noise, gyro_noise, bias))
+        {
+            return 2;
+        }
+        printf("synthetic: %u samples at %u Hz, accel noise %.1f LSB, gyro noise %.1f LSB, gyro bias %.1f LSB\n",
+               trace.num, hz, accel_noise, gyro_noise, bias);
+    }
+
+    printf("%-14s %17s %17s", "", "fixed-float q(°)", "fixed-float rpy(°)");
+    if(NULL != trace.truth)
+    {
+        printf(" %17s %17s", "fixed-truth q(°)", "float-truth q(°)");
+    }
+    printf(" %17s\n", "ns/update (host)");
+    printf("%-14s %8s %8s %8s %8s", "algo", "max", "rms", "max", "rms");
+    if(NULL != trace.truth)
+    {
+        printf(" %8s %8s %8s %8s", "max", "rms", "max", "rms");
+    }
+    printf(" %8s %8s\n", "fixed", "float");
+
+    for(algo = IMU_FUSION_COMPLEMENTARY; algo <= IMU_FUSION_MADGWICK; ++algo)
+    {
+        if(sim_run(&trace, (imu_fusion_algo_t)algo, hz) > threshold)
+        {
+            fail = 1;
+        }
+    }
+    printf("%s (fixed-float q rms threshold %.3f°)\n", fail ? "FAIL" : "ok", threshold);
+
+    return fail;
+}
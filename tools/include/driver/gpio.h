@@ -0,0 +1,110 @@
+/**
+ * 主机端替代头文件：driver/gpio.h
+ *
+ * 接口与 ESP8266_RTOS_SDK 3.1 一致，实现见 tools/host_sim/sim_gpio.c
+ */
+#ifndef _HOST_DRIVER_GPIO_H_
+#define _HOST_DRIVER_GPIO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+#define GPIO_Pin_0                  (1UL << 0)
+#define GPIO_Pin_1                  (1UL << 1)
+#define GPIO_Pin_2                  (1UL << 2)
+#define GPIO_Pin_3                  (1UL << 3)
+#define GPIO_Pin_4                  (1UL << 4)
+#define GPIO_Pin_5                  (1UL << 5)
+#define GPIO_Pin_6                  (1UL << 6)
+#define GPIO_Pin_7                  (1UL << 7)
+#define GPIO_Pin_8                  (1UL << 8)
+#define GPIO_Pin_9                  (1UL << 9)
+#define GPIO_Pin_10                 (1UL << 10)
+#define GPIO_Pin_11                 (1UL << 11)
+#define GPIO_Pin_12                 (1UL << 12)
+#define GPIO_Pin_13                 (1UL << 13)
+#define GPIO_Pin_14                 (1UL << 14)
+#define GPIO_Pin_15                 (1UL << 15)
+#define GPIO_Pin_16                 (1UL << 16)
+#define GPIO_Pin_All                (0x1FFFF)
+
+typedef enum {
+    GPIO_NUM_0 = 0,
+    GPIO_NUM_1,
+    GPIO_NUM_2,
+    GPIO_NUM_3,
+    GPIO_NUM_4,
+    GPIO_NUM_5,
+    GPIO_NUM_6,
+    GPIO_NUM_7,
+    GPIO_NUM_8,
+    GPIO_NUM_9,
+    GPIO_NUM_10,
+    GPIO_NUM_11,
+    GPIO_NUM_12,
+    GPIO_NUM_13,
+    GPIO_NUM_14,
+    GPIO_NUM_15,
+    GPIO_NUM_16,
+    GPIO_NUM_MAX,
+} gpio_num_t;
+
+typedef enum {
+    GPIO_INTR_DISABLE = 0,
+    GPIO_INTR_POSEDGE,
+    GPIO_INTR_NEGEDGE,
+    GPIO_INTR_ANYEDGE,
+    GPIO_INTR_LOW_LEVEL,
+    GPIO_INTR_HIGH_LEVEL,
+    GPIO_INTR_MAX,
+} gpio_int_type_t;
+
+typedef enum {
+    GPIO_MODE_DISABLE = 0,
+    GPIO_MODE_INPUT,
+    GPIO_MODE_OUTPUT,
+    GPIO_MODE_OUTPUT_OD,
+} gpio_mode_t;
+
+typedef enum {
+    GPIO_PULLUP_ONLY,
+    GPIO_PULLDOWN_ONLY,
+    GPIO_FLOATING,
+} gpio_pull_mode_t;
+
+typedef enum {
+    GPIO_PULLUP_DISABLE = 0,
+    GPIO_PULLUP_ENABLE,
+} gpio_pullup_t;
+
+typedef enum {
+    GPIO_PULLDOWN_DISABLE = 0,
+    GPIO_PULLDOWN_ENABLE,
+} gpio_pulldown_t;
+
+typedef struct {
+    uint32_t pin_bit_mask;
+    gpio_mode_t mode;
+    gpio_pullup_t pull_up_en;
+    gpio_pulldown_t pull_down_en;
+    gpio_int_type_t intr_type;
+} gpio_config_t;
+
+typedef void (*gpio_isr_t)(void *arg);
+
+#define GPIO_IS_VALID_GPIO(gpio_num)        ((gpio_num) < GPIO_NUM_MAX)
+
+esp_err_t gpio_config(const gpio_config_t *gpio_cfg);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+int gpio_get_level(gpio_num_t gpio_num);
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode);
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull);
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type);
+esp_err_t gpio_install_isr_service(int no_use);
+void gpio_uninstall_isr_service(void);
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args);
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num);
+
+#endif /* _HOST_DRIVER_GPIO_H_ */
@@ -0,0 +1,22 @@
+/**
+ * 主机端替代头文件：driver/hw_timer.h
+ *
+ * 接口与 ESP8266_RTOS_SDK 3.1 一致，实现见 tools/host_sim/sim_hw_timer.c
+ */
+#ifndef _HOST_DRIVER_HW_TIMER_H_
+#define _HOST_DRIVER_HW_TIMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+typedef void (*hw_timer_callback_t)(void *arg);
+
+esp_err_t hw_timer_init(hw_timer_callback_t callback, void *arg);
+esp_err_t hw_timer_deinit(void);
+esp_err_t hw_timer_alarm_us(uint32_t value, bool reload);
+esp_err_t hw_timer_disarm(void);
+esp_err_t hw_timer_enable(bool en);
+
+#endif /* _HOST_DRIVER_HW_TIMER_H_ */
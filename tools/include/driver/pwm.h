@@ -0,0 +1,29 @@
+/**
+ * 主机端替代头文件：driver/pwm.h
+ *
+ * 接口与 ESP8266_RTOS_SDK 3.1 一致，实现见 tools/host_sim/pwm.c
+ */
+#ifndef _HOST_DRIVER_PWM_H_
+#define _HOST_DRIVER_PWM_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+esp_err_t pwm_init(uint32_t period, uint32_t *duties, uint8_t channel_num, const uint32_t *pin_num);
+esp_err_t pwm_deinit(void);
+esp_err_t pwm_set_duty(uint8_t channel_num, uint32_t duty);
+esp_err_t pwm_get_duty(uint8_t channel_num, uint32_t *duty_p);
+esp_err_t pwm_set_period(uint32_t period);
+esp_err_t pwm_get_period(uint32_t *period_p);
+esp_err_t pwm_start(void);
+esp_err_t pwm_stop(uint32_t stop_level_mask);
+esp_err_t pwm_set_duties(uint32_t *duties);
+esp_err_t pwm_set_phase(uint8_t channel_num, int16_t phase);
+esp_err_t pwm_set_phases(int16_t *phases);
+esp_err_t pwm_get_phase(uint8_t channel_num, uint16_t *phase_p);
+esp_err_t pwm_set_period_duties(uint32_t period, uint32_t *duties);
+esp_err_t pwm_set_channel_invert(uint16_t channel_mask);
+esp_err_t pwm_clear_channel_invert(uint16_t channel_mask);
+
+#endif /* _HOST_DRIVER_PWM_H_ */
@@ -0,0 +1,29 @@
+/**
+ * 主机端替代头文件：esp8266/gpio_struct.h
+ *
+ * 寄存器字段与 SDK 一致。GPIO 展开为函数调用：每次访问寄存器之前，先把上一次写入
+ * W1TS/W1TC 的值作用到引脚上，并刷新 in，这样连续的寄存器写入按顺序生效，读 in 时能看到引脚电平
+ */
+#ifndef _HOST_ESP8266_GPIO_STRUCT_H_
+#define _HOST_ESP8266_GPIO_STRUCT_H_
+
+#include <stdint.h>
+
+typedef volatile struct {
+    uint32_t out;
+    uint32_t out_w1ts;
+    uint32_t out_w1tc;
+    uint32_t enable;
+    uint32_t enable_w1ts;
+    uint32_t enable_w1tc;
+    uint32_t in;
+    uint32_t status;
+    uint32_t status_w1ts;
+    uint32_t status_w1tc;
+} gpio_dev_t;
+
+gpio_dev_t *sim_gpio_regs(void);
+
+#define GPIO                        (*sim_gpio_regs())
+
+#endif /* _HOST_ESP8266_GPIO_STRUCT_H_ */
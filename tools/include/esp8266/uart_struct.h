@@ -0,0 +1,40 @@
+/**
+ * 主机端替代头文件：esp8266/uart_struct.h
+ *
+ * 只有用到的寄存器，字段名与 SDK 一致。uart0/uart1 展开为函数调用：每次访问寄存器之前，
+ * 先把上一次写入 fifo 的字节放入发送 FIFO 模型，并按虚拟时间刷新 status 与 int_st
+ */
+#ifndef _HOST_ESP8266_UART_STRUCT_H_
+#define _HOST_ESP8266_UART_STRUCT_H_
+
+#include <stdint.h>
+
+typedef volatile struct {
+    struct {
+        uint32_t rw_byte;           /*!< 目标上为 8 位，主机上用其余的值表示没有写入 */
+    } fifo;
+    union {
+        struct {
+            uint32_t rxfifo_full: 1;
+            uint32_t txfifo_empty: 1;
+            uint32_t reserved2: 30;
+        };
+        uint32_t val;
+    } int_st;
+    union {
+        struct {
+            uint32_t rxfifo_cnt: 8;
+            uint32_t reserved8: 8;
+            uint32_t txfifo_cnt: 8;
+            uint32_t reserved24: 8;
+        };
+        uint32_t val;
+    } status;
+} uart_dev_t;
+
+uart_dev_t *sim_uart_regs(int uart_num);
+
+#define uart0                       (*sim_uart_regs(0))
+#define uart1                       (*sim_uart_regs(1))
+
+#endif /* _HOST_ESP8266_UART_STRUCT_H_ */
@@ -0,0 +1,38 @@
+/**
+ * 主机端替代头文件：esp_err.h
+ *
+ * 只保留组件中用到的错误码，数值与 ESP8266_RTOS_SDK 一致
+ */
+#ifndef _HOST_ESP_ERR_H_
+#define _HOST_ESP_ERR_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef int32_t esp_err_t;
+
+#define ESP_OK                      0
+#define ESP_FAIL                    -1
+
+#define ESP_ERR_NO_MEM              0x101
+#define ESP_ERR_INVALID_ARG         0x102
+#define ESP_ERR_INVALID_STATE       0x103
+#define ESP_ERR_INVALID_SIZE        0x104
+#define ESP_ERR_NOT_FOUND           0x105
+#define ESP_ERR_NOT_SUPPORTED       0x106
+#define ESP_ERR_TIMEOUT             0x107
+#define ESP_ERR_INVALID_RESPONSE    0x108
+#define ESP_ERR_INVALID_CRC         0x109
+
+/* 与 SDK 一致：出错时打印位置并终止，主机仿真以非 0 退出码结束 */
+#define ESP_ERROR_CHECK(x) do {                                                 \
+        esp_err_t __err_rc = (x);                                               \
+        if(ESP_OK != __err_rc) {                                                \
+            printf("ESP_ERROR_CHECK failed: esp_err_t 0x%x at %s:%d\n",         \
+                   (int)__err_rc, __FILE__, __LINE__);                          \
+            abort();                                                            \
+        }                                                                       \
+    } while(0)
+
+#endif /* _HOST_ESP_ERR_H_ */
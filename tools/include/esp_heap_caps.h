@@ -0,0 +1,20 @@
+/**
+ * 主机端替代头文件：esp_heap_caps.h
+ *
+ * 只有用到的部分，实现见 tools/host_sim/sim_core.c，堆没有碎片，最大空闲块等于空闲堆
+ */
+#ifndef _HOST_ESP_HEAP_CAPS_H_
+#define _HOST_ESP_HEAP_CAPS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MALLOC_CAP_32BIT            (1 << 1)
+#define MALLOC_CAP_8BIT             (1 << 2)
+
+/**
+ * @brief  具有指定能力的堆中最大的空闲块
+ */
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+#endif /* _HOST_ESP_HEAP_CAPS_H_ */
@@ -0,0 +1,23 @@
+/**
+ * 主机端替代头文件：esp_log.h
+ *
+ * 输出格式与 SDK 相同："I (毫秒) 标签: 内容"，时间为仿真的虚拟时间。DEBUG/VERBOSE 级别不输出
+ */
+#ifndef _HOST_ESP_LOG_H_
+#define _HOST_ESP_LOG_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+uint32_t esp_log_timestamp(void);
+
+#define ESP_LOG_PRINT(level, tag, format, ...) \
+    printf(level " (%u) %s: " format "\n", esp_log_timestamp(), tag, ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, format, ...)  ESP_LOG_PRINT("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  ESP_LOG_PRINT("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  ESP_LOG_PRINT("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  do { } while(0)
+#define ESP_LOGV(tag, format, ...)  do { } while(0)
+
+#endif /* _HOST_ESP_LOG_H_ */
@@ -0,0 +1,26 @@
+/**
+ * 主机端替代头文件：esp_sleep.h
+ *
+ * 只有用到的部分，接口与 ESP8266_RTOS_SDK 3.1 一致，实现见 tools/host_sim/sim_sleep.c
+ */
+#ifndef _HOST_ESP_SLEEP_H_
+#define _HOST_ESP_SLEEP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+/**
+ * @brief  进入深度睡眠，time_in_us 后唤醒 (GPIO16 需要接 RST)，0 为只由 RST 唤醒；不返回
+ */
+void esp_deep_sleep(uint32_t time_in_us);
+
+/**
+ * @brief  下次唤醒后的射频设置，在 esp_deep_sleep() 之前调用
+ *
+ * option: 0 按 init 数据第 108 字节决定是否校准，1 校准，2 不校准，4 不打开射频 (电流最小)
+ */
+bool esp_deep_sleep_set_rf_option(uint8_t option);
+
+#endif /* _HOST_ESP_SLEEP_H_ */
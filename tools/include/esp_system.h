@@ -0,0 +1,35 @@
+/**
+ * 主机端替代头文件：esp_system.h
+ */
+#ifndef _HOST_ESP_SYSTEM_H_
+#define _HOST_ESP_SYSTEM_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef enum {
+    ESP_RST_UNKNOWN = 0,            /*!< 无法确定 */
+    ESP_RST_POWERON,                /*!< 上电 */
+    ESP_RST_EXT,                    /*!< 外部引脚 */
+    ESP_RST_SW,                     /*!< esp_restart() */
+    ESP_RST_PANIC,                  /*!< 异常 */
+    ESP_RST_INT_WDT,                /*!< 中断看门狗 */
+    ESP_RST_TASK_WDT,               /*!< 任务看门狗 */
+    ESP_RST_WDT,                    /*!< 其他看门狗 */
+    ESP_RST_DEEPSLEEP,              /*!< 深度睡眠唤醒 */
+    ESP_RST_BROWNOUT,               /*!< 欠压 */
+    ESP_RST_SDIO,                   /*!< SDIO */
+} esp_reset_reason_t;
+
+const char *esp_get_idf_version(void);
+esp_reset_reason_t esp_reset_reason(void);
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+void esp_restart(void);
+
+/* 忙等待，推进虚拟时间 */
+void os_delay_us(uint16_t us);
+void ets_delay_us(uint32_t us);
+
+#endif /* _HOST_ESP_SYSTEM_H_ */
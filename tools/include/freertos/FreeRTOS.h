@@ -0,0 +1,48 @@
+/**
+ * 主机端替代头文件：freertos/FreeRTOS.h
+ *
+ * 实现见 tools/host_sim：任务为协作式调度的用户态上下文，按虚拟时间运行，
+ * 节拍边界上按优先级抢占。临界区内推迟执行中断 (hw_timer 等) 回调
+ */
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+
+#define pdFALSE                     ((BaseType_t)0)
+#define pdTRUE                      ((BaseType_t)1)
+#define pdPASS                      pdTRUE
+#define pdFAIL                      pdFALSE
+
+/* 与 SDK 相同，由 sdkconfig 中的 CONFIG_FREERTOS_HZ 决定 */
+#ifndef configTICK_RATE_HZ
+#ifdef CONFIG_FREERTOS_HZ
+#define configTICK_RATE_HZ          (CONFIG_FREERTOS_HZ)
+#else
+#define configTICK_RATE_HZ          (100)
+#endif
+#endif
+#define configMAX_PRIORITIES        (15)
+
+#define portMAX_DELAY               ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS          ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portTICK_RATE_MS            portTICK_PERIOD_MS
+
+void sim_critical_enter(void);
+void sim_critical_exit(void);
+bool sim_in_isr(void);
+
+#define portENTER_CRITICAL()        sim_critical_enter()
+#define portEXIT_CRITICAL()         sim_critical_exit()
+#define taskENTER_CRITICAL()        portENTER_CRITICAL()
+#define taskEXIT_CRITICAL()         portEXIT_CRITICAL()
+#define portYIELD_FROM_ISR()        do { } while(0)
+#define xPortInIsrContext()         sim_in_isr()
+
+#endif /* _HOST_FREERTOS_H_ */
@@ -0,0 +1,26 @@
+/**
+ * 主机端替代头文件：freertos/semphr.h
+ *
+ * 信号量与 FreeRTOS 一样由长度为 N、元素大小为 0 的队列实现，互斥量没有优先级继承
+ */
+#ifndef _HOST_FREERTOS_SEMPHR_H_
+#define _HOST_FREERTOS_SEMPHR_H_
+
+#include "freertos/queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+typedef QueueHandle_t xSemaphoreHandle;
+
+QueueHandle_t sim_semaphore_create(UBaseType_t max_count, UBaseType_t initial_count);
+
+#define xSemaphoreCreateBinary()            sim_semaphore_create(1, 0)
+#define xSemaphoreCreateMutex()             sim_semaphore_create(1, 1)
+#define xSemaphoreCreateCounting(max, init) sim_semaphore_create((max), (init))
+#define vSemaphoreDelete(sem)               vQueueDelete(sem)
+#define xSemaphoreTake(sem, ticks)          xQueueReceive((sem), NULL, (ticks))
+#define xSemaphoreGive(sem)                 xQueueSend((sem), NULL, 0)
+#define xSemaphoreTakeFromISR(sem, woken)   xQueueReceiveFromISR((sem), NULL, (woken))
+#define xSemaphoreGiveFromISR(sem, woken)   xQueueSendFromISR((sem), NULL, (woken))
+#define uxSemaphoreGetCount(sem)            uxQueueMessagesWaiting(sem)
+
+#endif /* _HOST_FREERTOS_SEMPHR_H_ */
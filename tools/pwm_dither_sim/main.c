@@ -0,0 +1,191 @@
+/**
+ * 说明:
+ * PWM 占空比时间抖动 (pwm_dither 组件) 的主机端仿真
+ *
+ * 对每一种小数位数，扫描低亮度区间内所有高分辨率占空比，按更新频率逐次运行 pwm_dither_step()：
+ * 1. 平均占空比误差：N 次更新的平均输出与目标值之差，单位为高分辨率 LSB
+ * 2. 闪烁频谱：对输出序列做 DFT，统计低于闪烁阈值频率的分量中最大的调制深度
+ *    (分量幅值 / 平均占空比)
+ *
+ * 更新频率默认为 1000Hz，即 breath_led 按最高节拍频率更新 (PWM 与 hw_timer 共用 FRC1，不能按 PWM 周期更新)，
+ * allowed 列标出 pwm_dither_max_frac_bits() 允许的小数位数。
+ *
+ * 使用:
+ * $ ./pwm_dither_sim [-p 周期us] [-u 更新频率Hz] [-b 最大小数位数] [-n 仿真更新次数] [-l 扫描上限us] [-f 闪烁阈值Hz] [-d 调制深度阈值%]
+ *
+ * 任一小数位数的平均误差超过 1 LSB，或允许的小数位数出现可见闪烁时返回 1
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "pwm_dither.h"
+
+typedef struct {
+    uint32_t period_us;             /*!< PWM 周期 */
+    uint32_t update_hz;             /*!< 占空比更新频率 */
+    uint32_t max_bits;              /*!< 仿真的最大小数位数 */
+    uint32_t periods;               /*!< 每个占空比仿真的更新次数 */
+    uint32_t sweep_us;              /*!< 扫描 0 ~ sweep_us 的低亮度区间 */
+    double flicker_hz;              /*!< 低于此频率的分量视为可见闪烁 */
+    double depth_pct;               /*!< 可接受的最大调制深度 */
+} sim_config_t;
+
+typedef struct {
+    double max_err_lsb;             /*!< 最大平均误差，高分辨率 LSB */
+    double worst_depth_pct;         /*!< 最大低频调制深度 */
+    double worst_duty_us;           /*!< 出现最大调制深度的占空比 */
+    double worst_freq_hz;           /*!< 出现最大调制深度的频率 */
+} sim_result_t;
+
+static void sim_run(const sim_config_t *cfg, uint8_t frac_bits, uint32_t *out,
+                    const double *cos_tab, const double *sin_tab, sim_result_t *res)
+{
+    pwm_dither_t dither;
+    uint32_t max_bin = 0;
+    uint32_t duty = 0;
+    uint32_t n = 0;
+    uint32_t k = 0;
+    double sum = 0;
+    double mean = 0;
+    double err = 0;
+    double re = 0;
+    double im = 0;
+    double amp = 0;
+
+    memset(res, 0, sizeof(sim_result_t));
+
+    // 只统计严格低于闪烁阈值且不超过奈奎斯特频率的分量
+    while(max_bin < cfg->periods / 2 && (double)(max_bin + 1) * cfg->update_hz < cfg->flicker_hz * cfg->periods)
+    {
+        ++max_bin;
+    }
+
+    for(duty = 1; duty <= (cfg->sweep_us << frac_bits); ++duty)
+    {
+        pwm_dither_init(&dither, 1, frac_bits);
+        pwm_dither_set(&dither, 0, duty);
+
+        sum = 0;
+        for(n = 0; n < cfg->periods; ++n)
+        {
+            out[n] = pwm_dither_step(&dither, 0);
+            sum += out[n];
+        }
+
+        mean = sum / cfg->periods;
+        err = fabs(mean * (1 << frac_bits) - duty);
+        if(err > res->max_err_lsb)
+        {
+            res->max_err_lsb = err;
+        }
+
+        // 不含小数部分时输出恒定，没有闪烁
+        if(0 == (dither.frac_mask & 0x1))
+        {
+            continue;
+        }
+
+        for(k = 1; k <= max_bin; ++k)
+        {
+            re = 0;
+            im = 0;
+            for(n = 0; n < cfg->periods; ++n)
+            {
+                re += out[n] * cos_tab[(uint64_t)k * n % cfg->periods];
+                im -= out[n] * sin_tab[(uint64_t)k * n % cfg->periods];
+            }
+            amp = 2 * sqrt(re * re + im * im) / cfg->periods;
+            // 忽略浮点舍入误差
+            if(1e-9 < amp && 100 * amp / mean > res->worst_depth_pct)
+            {
+                res->worst_depth_pct = 100 * amp / mean;
+                res->worst_duty_us = (double)duty / (1 << frac_bits);
+                res->worst_freq_hz = (double)k * cfg->update_hz / cfg->periods;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    sim_config_t cfg = { 500, 1000, 8, 2048, 8, 100.0, 1.0 };
+    sim_result_t res;
+    uint32_t *out = NULL;
+    double *cos_tab = NULL;
+    double *sin_tab = NULL;
+    uint32_t n = 0;
+    uint8_t bits = 0;
+    uint8_t allowed = 0;
+    int visible = 0;
+    int fail = 0;
+    int opt = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "p:u:b:n:l:f:d:")))
+    {
+        switch(opt)
+        {
+            case 'p': cfg.period_us = strtoul(optarg, NULL, 0); break;
+            case 'u': cfg.update_hz = strtoul(optarg, NULL, 0); break;
+            case 'b': cfg.max_bits = strtoul(optarg, NULL, 0); break;
+            case 'n': cfg.periods = strtoul(optarg, NULL, 0); break;
+            case 'l': cfg.sweep_us = strtoul(optarg, NULL, 0); break;
+            case 'f': cfg.flicker_hz = strtod(optarg, NULL); break;
+            case 'd': cfg.depth_pct = strtod(optarg, NULL); break;
+            default:
+                fprintf(stderr, "usage: %s [-p period_us] [-u update_hz] [-b max_bits] [-n updates] [-l sweep_us] [-f flicker_hz] [-d depth_pct]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if(0 == cfg.period_us || 0 == cfg.update_hz || 0 == cfg.periods || PWM_DITHER_FRAC_BITS_MAX < cfg.max_bits)
+    {
+        fprintf(stderr, "invalid arguments\n");
+        return 2;
+    }
+
+    out = malloc(cfg.periods * sizeof(uint32_t));
+    cos_tab = malloc(cfg.periods * sizeof(double));
+    sin_tab = malloc(cfg.periods * sizeof(double));
+    if(NULL == out || NULL == cos_tab || NULL == sin_tab)
+    {
+        return 2;
+    }
+
+    // DFT 旋转因子表
+    for(n = 0; n < cfg.periods; ++n)
+    {
+        cos_tab[n] = cos(2 * M_PI * n / cfg.periods);
+        sin_tab[n] = sin(2 * M_PI * n / cfg.periods);
+    }
+
+    allowed = pwm_dither_max_frac_bits(cfg.update_hz);
+
+    printf("PWM period %u us (%.0f Hz), update %u Hz, %u updates per duty, sweep 0 ~ %u us, flicker < %.0f Hz\n\n",
+           cfg.period_us, 1000000.0 / cfg.period_us, cfg.update_hz, cfg.periods, cfg.sweep_us, cfg.flicker_hz);
+    printf("frac  eff_bits  min_dither_hz  max_err_lsb  worst_depth  @duty_us  @freq_hz  flicker  allowed\n");
+
+    for(bits = 0; bits <= cfg.max_bits; ++bits)
+    {
+        sim_run(&cfg, bits, out, cos_tab, sin_tab, &res);
+        visible = res.worst_depth_pct > cfg.depth_pct;
+        printf("%4u  %8.2f  %13.1f  %11.4f  %10.2f%%  %8.4f  %8.1f  %-7s  %s\n",
+               bits, log2((double)cfg.period_us * (1 << bits)),
+               (double)cfg.update_hz / (1 << bits),
+               res.max_err_lsb, res.worst_depth_pct, res.worst_duty_us, res.worst_freq_hz,
+               visible ? "VISIBLE" : "ok", bits <= allowed ? "yes" : "no");
+
+        if(1.0 < res.max_err_lsb || (bits <= allowed && visible))
+        {
+            fail = 1;
+        }
+    }
+
+    free(out);
+    free(cos_tab);
+    free(sin_tab);
+
+    return fail;
+}
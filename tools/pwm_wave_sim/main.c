@@ -0,0 +1,267 @@
+/**
+ * 说明:
+ * PWM 运行中重新配置的波形仿真
+ *
+ * 使用 tools/host_sim 的 PWM 驱动模型，按 project/pwm 的 4 通道配置输出，
+ * 在随机时刻修改周期、占空比、相位或反相掩码，对比两种方式：
+ * 1. naive: pwm_stop() -> pwm_set_xxx() -> pwm_start()，即 project/pwm 原来的做法
+ * 2. batch: pwm_batch 组件暂存修改，pwm_batch_commit() 在周期边界切换
+ *
+ * 把输出波形按 PWM 周期切分，每个周期的波形必须与某一份完整配置渲染出的波形完全一致，
+ * 否则记为一次毛刺 (半个旧周期 + 半个新周期、pwm_stop() 强制电平、被截断的周期等)。
+ *
+ * 注意：host_sim 的 PWM 模型假设运行中的 pwm_start() 在当前周期结束时整体切换 (见 sim_pwm.h)，
+ * 没有模拟真实驱动的影子寄存器与 NMI 中断装载新通道表的时机，因此 batch 方式在模型中必然没有毛刺。
+ * 本工具只用来演示两种方式在预期驱动行为下的差别，不能证明硬件上的输出没有毛刺，
+ * 真实输出需要用示波器或逻辑分析仪确认。
+ *
+ * 使用:
+ * $ ./pwm_wave_sim [-n 修改次数] [-s 随机种子]
+ *
+ * batch 方式出现毛刺时返回 1 (只说明 pwm_batch 没有调用 pwm_stop() 或分多次 pwm_start())
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "driver/pwm.h"
+
+#include "pwm_batch.h"
+#include "sim_pwm.h"
+
+#define CH_NUM                      (4)
+#define HISTORY_MAX                 (4096)
+#define WAVE_MAX                    (4 * 1024 * 1024)
+
+typedef enum {
+    MODE_NAIVE = 0,
+    MODE_BATCH,
+} wave_mode_t;
+
+typedef struct {
+    uint32_t periods;               /*!< 完整周期数 */
+    uint32_t glitches;              /*!< 与任何配置都不一致的周期数 */
+    uint32_t starts;                /*!< pwm_start() 调用次数 */
+} wave_result_t;
+
+static const uint32_t s_pins[CH_NUM] = { 12, 13, 14, 15 };
+
+static sim_pwm_param_t s_history[HISTORY_MAX];
+static uint32_t s_history_num = 0;
+static uint8_t s_wave[WAVE_MAX];
+static uint8_t s_start[WAVE_MAX];
+static uint32_t s_seed = 1;
+
+/* 固定种子的线性同余随机数，结果可复现 */
+static uint32_t wave_rand(uint32_t max)
+{
+    s_seed = s_seed * 1103515245 + 12345;
+
+    return (s_seed >> 16) % max;
+}
+
+static void history_add(const sim_pwm_param_t *param)
+{
+    if(HISTORY_MAX > s_history_num)
+    {
+        s_history[s_history_num++] = *param;
+    }
+}
+
+/* 随机修改一项参数 */
+static void wave_mutate(sim_pwm_param_t *param)
+{
+    static const uint32_t periods[] = { 400, 500, 1000 };
+    uint8_t ch = wave_rand(CH_NUM);
+    uint8_t i = 0;
+
+    switch(wave_rand(4))
+    {
+        case 0:
+            param->period = periods[wave_rand(3)];
+            for(i = 0; i < CH_NUM; ++i)
+            {
+                param->duties[i] = param->duties[i] % param->period;
+            }
+            break;
+        case 1:
+            param->duties[ch] = wave_rand(param->period);
+            break;
+        case 2:
+            param->phases[ch] = (int16_t)wave_rand(param->period) - (int16_t)(param->period / 2);
+            break;
+        default:
+            param->invert_mask ^= (0x1 << ch);
+            break;
+    }
+}
+
+static void wave_apply(wave_mode_t mode, const sim_pwm_param_t *param)
+{
+    pwm_batch_config_t config;
+
+    if(MODE_BATCH == mode)
+    {
+        memset(&config, 0, sizeof(config));
+        config.period = param->period;
+        memcpy(config.duties, param->duties, sizeof(param->duties));
+        memcpy(config.phases, param->phases, sizeof(param->phases));
+        config.invert_mask = param->invert_mask;
+        pwm_batch_set_config(&config);
+        pwm_batch_commit();
+        return;
+    }
+
+    // project/pwm 的做法：先停止，修改后再启动
+    pwm_stop(0x3);
+    pwm_set_period_duties(param->period, (uint32_t *)param->duties);
+    pwm_set_phases((int16_t *)param->phases);
+    pwm_clear_channel_invert(0xFF);
+    pwm_set_channel_invert(param->invert_mask);
+    pwm_start();
+}
+
+static int wave_match(const sim_pwm_param_t *param, uint32_t offset, uint32_t len)
+{
+    uint32_t t = 0;
+    uint32_t expect = 0;
+    uint8_t i = 0;
+
+    if(len != param->period)
+    {
+        return 0;
+    }
+
+    for(t = 0; t < len; ++t)
+    {
+        expect = 0;
+        for(i = 0; i < CH_NUM; ++i)
+        {
+            expect |= (uint32_t)sim_pwm_level(param, i, t) << i;
+        }
+        if(expect != s_wave[offset + t])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void wave_run(wave_mode_t mode, uint32_t changes, uint32_t seed, wave_result_t *res)
+{
+    sim_pwm_param_t param = { 500, { 250, 250, 250, 250 }, { 0, 0, 50, -50 }, 0x1 };
+    uint32_t len = 0;
+    uint32_t seg = 0;
+    uint32_t gap = 0;
+    uint32_t n = 0;
+    uint32_t t = 0;
+    uint32_t h = 0;
+    int period_start = 0;
+
+    memset(res, 0, sizeof(wave_result_t));
+    s_history_num = 0;
+    s_seed = seed;
+
+    // 与 project/pwm 相同的初始配置
+    pwm_batch_init(param.period, param.duties, CH_NUM, s_pins);
+    if(MODE_BATCH == mode)
+    {
+        wave_apply(mode, &param);
+    }
+    else
+    {
+        pwm_set_channel_invert(param.invert_mask);
+        pwm_set_phases(param.phases);
+        pwm_start();
+    }
+    history_add(&param);
+
+    for(n = 0; n < changes && WAVE_MAX > len + 4000; ++n)
+    {
+        // 随机运行 0.3 ~ 3ms 后修改一次参数
+        gap = 300 + wave_rand(2700);
+        for(t = 0; t < gap; ++t, ++len)
+        {
+            s_wave[len] = (uint8_t)sim_pwm_step(&period_start);
+            s_start[len] = (uint8_t)period_start;
+        }
+
+        wave_mutate(&param);
+        wave_apply(mode, &param);
+        history_add(&param);
+    }
+
+    // 再运行 2 个最长周期，让最后的修改生效
+    for(t = 0; t < 2000; ++t, ++len)
+    {
+        s_wave[len] = (uint8_t)sim_pwm_step(&period_start);
+        s_start[len] = (uint8_t)period_start;
+    }
+
+    // 按周期起点切分波形，最后一段不完整，不检查
+    for(t = 1, seg = 0; t < len; ++t)
+    {
+        if(0 == s_start[t])
+        {
+            continue;
+        }
+        if(0 != s_start[seg])
+        {
+            ++res->periods;
+            for(h = 0; h < s_history_num; ++h)
+            {
+                if(1 == wave_match(&s_history[h], seg, t - seg))
+                {
+                    break;
+                }
+            }
+            if(h == s_history_num)
+            {
+                ++res->glitches;
+            }
+        }
+        else
+        {
+            // 波形开头或 pwm_stop() 之后的非周期段
+            ++res->glitches;
+        }
+        seg = t;
+    }
+
+    res->starts = sim_pwm_start_count();
+    pwm_deinit();
+}
+
+int main(int argc, char *argv[])
+{
+    wave_result_t naive;
+    wave_result_t batch;
+    uint32_t changes = 500;
+    uint32_t seed = 1;
+    int opt = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "n:s:")))
+    {
+        switch(opt)
+        {
+            case 'n': changes = strtoul(optarg, NULL, 0); break;
+            case 's': seed = strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-n changes] [-s seed]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    wave_run(MODE_NAIVE, changes, seed, &naive);
+    wave_run(MODE_BATCH, changes, seed, &batch);
+
+    printf("%u runtime changes, seed %u\n", changes, seed);
+    printf("model: running pwm_start() switches at the period boundary (assumed, not a hardware check)\n\n");
+    printf("mode   periods  glitches  pwm_start\n");
+    printf("naive  %7u  %8u  %9u\n", naive.periods, naive.glitches, naive.starts);
+    printf("batch  %7u  %8u  %9u\n", batch.periods, batch.glitches, batch.starts);
+
+    return (0 == batch.glitches) ? 0 : 1;
+}
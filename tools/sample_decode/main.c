@@ -0,0 +1,570 @@
+/**
+ * 说明:
+ * sample_codec 组件 (project/components/sample_codec) 的主机端解码/编码工具
+ *
+ * 解码：读取块数据流 (AT24C32 导出或串口接收的二进制)，或 -x 时读取日志中 "rec:" 之后的十六进制块，
+ * 按 CSV 输出：timestamp_ms,通道 1,通道 2,...，数值按通道描述的小数位数输出。
+ * -s 时在 stderr 输出统计：块数、CRC 错误、采样数、编码后字节数，与原始数据 (u32 时间戳 + 每通道 i32) 的压缩比，
+ * 以及时间戳与每个通道平均每个采样占用的字节数。
+ *
+ * 编码：-e 读取 CSV (格式与解码输出相同，每列的小数位数取该列中最多的位数)，
+ * 按 -b 字节的块编码后写入 stdout，在 stderr 输出压缩比与每个采样的编码耗时 (主机)，
+ * 并把输出重新解码与输入比较。
+ *
+ * 使用:
+ * $ ./sample_decode [-x] [-s] [文件]         (没有文件时读取 stdin)
+ * $ ./sample_decode -e [-b 块大小] trace.csv > trace.bin
+ *
+ * 有 CRC 错误、找不到通道描述，或编码后重新解码的结果与输入不同时返回 1
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "sample_codec.h"
+
+#define TOOL_LINE_LEN               (4096)
+#define TOOL_HEX_MARKER             "rec:"
+/* 编码输入的最大采样数 */
+#define TOOL_SAMPLES_MAX            (1 << 20)
+
+/* 按编码规则重新计算每个字段占用的字节数 */
+typedef struct {
+    bool first;                     /*!< 下一个采样是块中的第一个 */
+    uint32_t samples;
+    uint32_t last_ms;
+    int32_t last[SAMPLE_CODEC_CHANNEL_MAX];
+    uint64_t ts_bytes;
+    uint64_t channel_bytes[SAMPLE_CODEC_CHANNEL_MAX];
+} tool_stats_t;
+
+typedef struct {
+    sample_codec_schema_t schema;
+    bool have_schema;
+    bool stats;
+    uint32_t blocks;
+    uint32_t schema_blocks;
+    uint32_t crc_errors;
+    uint32_t unknown;               /*!< 没有对应通道描述的数据块 */
+    uint64_t bytes;
+    tool_stats_t fields;
+} tool_decoder_t;
+
+typedef struct {
+    sample_codec_schema_t schema;
+    uint32_t num;
+    uint32_t *timestamps;
+    int32_t *values;                /*!< num x schema.num */
+    uint32_t checked;               /*!< 重新解码时已比较的采样数 */
+    uint32_t mismatch;
+    tool_stats_t fields;
+} tool_trace_t;
+
+static uint32_t tool_varint_len(uint32_t value)
+{
+    uint32_t n = 1;
+
+    while(0x80 <= value)
+    {
+        value >>= 7;
+        ++n;
+    }
+
+    return n;
+}
+
+static uint32_t tool_zigzag(uint32_t delta)
+{
+    return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+static void tool_print_value(int32_t value, int8_t decimals)
+{
+    int64_t v = value;
+    int64_t scale = 1;
+    int i = 0;
+
+    if(0 >= decimals)
+    {
+        for(i = 0; i < -decimals; ++i)
+        {
+            v *= 10;
+        }
+        printf("%lld", (long long)v);
+        return;
+    }
+
+    for(i = 0; i < decimals; ++i)
+    {
+        scale *= 10;
+    }
+    printf("%s%lld.%0*lld", (0 > v) ? "-" : "", (long long)(llabs(v) / scale), decimals, (long long)(llabs(v) % scale));
+}
+
+static void tool_print_header(const sample_codec_schema_t *schema)
+{
+    uint8_t i = 0;
+
+    printf("timestamp_ms");
+    for(i = 0; i < schema->num; ++i)
+    {
+        printf(",%s", schema->channels[i].name);
+    }
+    printf("\n");
+}
+
+/* 块中第一个采样为绝对值，之后为差值 */
+static void tool_account(tool_stats_t *stats, uint32_t timestamp_ms, const int32_t *values, uint8_t num)
+{
+    uint8_t i = 0;
+
+    stats->ts_bytes += tool_varint_len(stats->first ? timestamp_ms : timestamp_ms - stats->last_ms);
+    for(i = 0; i < num; ++i)
+    {
+        stats->channel_bytes[i] += tool_varint_len(tool_zigzag(stats->first ? (uint32_t)values[i]
+                                                               : (uint32_t)values[i] - (uint32_t)stats->last[i]));
+    }
+    stats->first = false;
+    stats->last_ms = timestamp_ms;
+    memcpy(stats->last, values, num * sizeof(int32_t));
+    stats->samples++;
+}
+
+static void tool_sample(uint32_t timestamp_ms, const int32_t *values, uint8_t num, void *arg)
+{
+    tool_decoder_t *dec = arg;
+    uint8_t i = 0;
+
+    tool_account(&dec->fields, timestamp_ms, values, num);
+
+    printf("%u", timestamp_ms);
+    for(i = 0; i < num; ++i)
+    {
+        printf(",");
+        tool_print_value(values[i], dec->schema.channels[i].decimals);
+    }
+    printf("\n");
+}
+
+/* 从 buf 中解码尽可能多的块，返回已处理的字节数 */
+static size_t tool_decode(tool_decoder_t *dec, const uint8_t *buf, size_t len)
+{
+    size_t pos = 0;
+    size_t block_len = 0;
+    esp_err_t ret = ESP_OK;
+
+    while(pos < len)
+    {
+        ret = sample_codec_block_check(&buf[pos], len - pos, &block_len);
+        if(ESP_ERR_INVALID_SIZE == ret)
+        {
+            break;
+        }
+        if(ESP_OK != ret)
+        {
+            // 类型或 CRC 错误：跳过 1 字节重新同步
+            if(ESP_ERR_INVALID_CRC == ret)
+            {
+                dec->crc_errors++;
+            }
+            pos++;
+            continue;
+        }
+
+        dec->blocks++;
+        dec->bytes += block_len;
+        if(SAMPLE_CODEC_TYPE_SCHEMA == buf[pos])
+        {
+            dec->schema_blocks++;
+            if(ESP_OK == sample_codec_schema_unpack(&buf[pos], block_len, &dec->schema))
+            {
+                dec->have_schema = true;
+                tool_print_header(&dec->schema);
+            }
+        }
+        else
+        {
+            dec->fields.first = true;
+            if(!dec->have_schema
+               || ESP_OK != sample_codec_data_decode(&buf[pos], block_len, &dec->schema, tool_sample, dec))
+            {
+                dec->unknown++;
+            }
+        }
+        pos += block_len;
+    }
+
+    return pos;
+}
+
+static int tool_hex(int c)
+{
+    if(isdigit(c))
+    {
+        return c - '0';
+    }
+    c = tolower(c);
+
+    return ('a' <= c && 'f' >= c) ? c - 'a' + 10 : -1;
+}
+
+static void tool_decode_file(tool_decoder_t *dec, FILE *fp, bool hex)
+{
+    static uint8_t buf[TOOL_LINE_LEN * 2];
+    static char line[TOOL_LINE_LEN];
+    size_t len = 0;
+    size_t used = 0;
+    size_t n = 0;
+    char *p = NULL;
+    int hi = 0;
+    int lo = 0;
+
+    if(hex)
+    {
+        // 每行一个块，行中 "rec:" 之后为十六进制
+        while(NULL != fgets(line, sizeof(line), fp))
+        {
+            p = strstr(line, TOOL_HEX_MARKER);
+            if(NULL == p)
+            {
+                continue;
+            }
+            p += strlen(TOOL_HEX_MARKER);
+            while(' ' == *p)
+            {
+                ++p;
+            }
+            len = 0;
+            while(0 <= (hi = tool_hex(p[0])) && 0 <= (lo = tool_hex(p[1])) && len < sizeof(buf))
+            {
+                buf[len++] = (uint8_t)(hi << 4 | lo);
+                p += 2;
+            }
+            if(len != tool_decode(dec, buf, len))
+            {
+                dec->crc_errors++;
+            }
+        }
+        return;
+    }
+
+    while(0 < (n = fread(&buf[len], 1, sizeof(buf) - len, fp)))
+    {
+        len += n;
+        used = tool_decode(dec, buf, len);
+        memmove(buf, &buf[used], len - used);
+        len -= used;
+    }
+    // 结尾不完整的块
+    if(0 != len)
+    {
+        dec->crc_errors++;
+    }
+}
+
+static void tool_report(const sample_codec_schema_t *schema, uint64_t bytes, const tool_stats_t *fields)
+{
+    uint32_t samples = fields->samples;
+    uint64_t raw = (uint64_t)samples * (4 + 4 * schema->num);
+    uint8_t i = 0;
+
+    if(0 == samples)
+    {
+        return;
+    }
+
+    fprintf(stderr, "samples: %u x %u channel(s), encoded: %llu bytes (%.2f bytes/sample)\n", samples, schema->num,
+            (unsigned long long)bytes, (double)bytes / samples);
+    fprintf(stderr, "raw (u32 timestamp + i32 per channel): %llu bytes, ratio %.2f\n",
+            (unsigned long long)raw, (double)raw / bytes);
+    fprintf(stderr, "%-12s %s\n", "field", "bytes/sample");
+    fprintf(stderr, "%-12s %.2f\n", "timestamp", (double)fields->ts_bytes / samples);
+    for(i = 0; i < schema->num; ++i)
+    {
+        fprintf(stderr, "%-12s %.2f\n", schema->channels[i].name, (double)fields->channel_bytes[i] / samples);
+    }
+}
+
+/* 读取 CSV，小数位数取每列中最多的位数 */
+static int tool_load_csv(FILE *fp, tool_trace_t *trace)
+{
+    static char line[TOOL_LINE_LEN];
+    static double values[SAMPLE_CODEC_CHANNEL_MAX];
+    double *all = NULL;
+    double scaled = 0.0;
+    char *field = NULL;
+    char *save = NULL;
+    char *dot = NULL;
+    sample_codec_schema_t *schema = &trace->schema;
+    int col = 0;
+    uint32_t k = 0;
+    int d = 0;
+    int i = 0;
+
+    memset(schema, 0, sizeof(sample_codec_schema_t));
+    if(NULL == fgets(line, sizeof(line), fp))
+    {
+        return -1;
+    }
+    line[strcspn(line, "\r\n")] = '\0';
+    for(field = strtok_r(line, ",", &save), col = 0; NULL != field; field = strtok_r(NULL, ",", &save), ++col)
+    {
+        // 第一列为时间戳
+        if(0 == col)
+        {
+            continue;
+        }
+        if(SAMPLE_CODEC_CHANNEL_MAX < col)
+        {
+            fprintf(stderr, "too many channels\n");
+            return -1;
+        }
+        strncpy(schema->channels[col - 1].name, field, SAMPLE_CODEC_NAME_MAX);
+    }
+    schema->num = col - 1;
+    if(0 == schema->num)
+    {
+        return -1;
+    }
+
+    // 先读出全部数值并确定小数位数，再统一换算成整数
+    trace->timestamps = calloc(TOOL_SAMPLES_MAX, sizeof(uint32_t));
+    trace->values = calloc((size_t)TOOL_SAMPLES_MAX * schema->num, sizeof(int32_t));
+    all = calloc((size_t)TOOL_SAMPLES_MAX * schema->num, sizeof(double));
+    if(NULL == trace->timestamps || NULL == trace->values || NULL == all)
+    {
+        free(all);
+        return -1;
+    }
+
+    trace->num = 0;
+    while(TOOL_SAMPLES_MAX > trace->num && NULL != fgets(line, sizeof(line), fp))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if('\0' == line[0])
+        {
+            continue;
+        }
+        for(field = strtok_r(line, ",", &save), col = 0; NULL != field && col <= schema->num;
+            field = strtok_r(NULL, ",", &save), ++col)
+        {
+            if(0 == col)
+            {
+                trace->timestamps[trace->num] = (uint32_t)strtoul(field, NULL, 10);
+                continue;
+            }
+            values[col - 1] = strtod(field, NULL);
+            dot = strchr(field, '.');
+            d = (NULL == dot) ? 0 : (int)strspn(dot + 1, "0123456789");
+            if(d > schema->channels[col - 1].decimals)
+            {
+                schema->channels[col - 1].decimals = d;
+            }
+        }
+        if(col != schema->num + 1)
+        {
+            fprintf(stderr, "line %u: expected %u columns\n", trace->num + 2, schema->num + 1);
+            free(all);
+            return -1;
+        }
+        memcpy(&all[(size_t)trace->num * schema->num], values, schema->num * sizeof(double));
+        trace->num++;
+    }
+
+    for(k = 0; k < trace->num; ++k)
+    {
+        for(i = 0; i < schema->num; ++i)
+        {
+            scaled = all[(size_t)k * schema->num + i];
+            for(d = 0; d < schema->channels[i].decimals; ++d)
+            {
+                scaled *= 10;
+            }
+            trace->values[(size_t)k * schema->num + i] = (int32_t)((0 > scaled) ? scaled - 0.5 : scaled + 0.5);
+        }
+    }
+    free(all);
+
+    return (int)trace->num;
+}
+
+static void tool_verify(uint32_t timestamp_ms, const int32_t *values, uint8_t num, void *arg)
+{
+    tool_trace_t *trace = arg;
+    uint32_t k = trace->checked++;
+
+    if(k >= trace->num || timestamp_ms != trace->timestamps[k]
+       || 0 != memcmp(values, &trace->values[(size_t)k * num], num * sizeof(int32_t)))
+    {
+        trace->mismatch++;
+    }
+    tool_account(&trace->fields, timestamp_ms, values, num);
+}
+
+static int tool_encode(FILE *fp, size_t block_size)
+{
+    static tool_trace_t trace;
+    static uint8_t schema_block[SAMPLE_CODEC_BLOCK_MAX];
+    uint8_t *out = NULL;
+    size_t out_len = 0;
+    size_t out_size = 0;
+    size_t schema_len = 0;
+    size_t len = 0;
+    size_t pos = 0;
+    sample_codec_enc_t enc;
+    struct timespec t0;
+    struct timespec t1;
+    uint32_t blocks = 0;
+    uint32_t k = 0;
+    double ns = 0.0;
+
+    if(0 >= tool_load_csv(fp, &trace))
+    {
+        fprintf(stderr, "no samples\n");
+        return 1;
+    }
+
+    // 最坏情况每个采样单独一块
+    out_size = SAMPLE_CODEC_BLOCK_MAX + (size_t)trace.num * (SAMPLE_CODEC_BLOCK_HEADER + 2
+               + SAMPLE_CODEC_SAMPLE_MAX(trace.schema.num) + SAMPLE_CODEC_BLOCK_CRC);
+    out = malloc(out_size);
+    if(NULL == out)
+    {
+        return 1;
+    }
+
+    schema_len = sample_codec_schema_pack(&trace.schema, schema_block, sizeof(schema_block));
+    if(0 == schema_len)
+    {
+        fprintf(stderr, "invalid schema\n");
+        return 1;
+    }
+    memcpy(out, schema_block, schema_len);
+    out_len = schema_len;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if(ESP_OK != sample_codec_enc_begin(&enc, &trace.schema, &out[out_len], block_size))
+    {
+        fprintf(stderr, "block size %u too small\n", (unsigned)block_size);
+        return 1;
+    }
+    for(k = 0; k < trace.num; ++k)
+    {
+        if(ESP_OK != sample_codec_enc_add(&enc, trace.timestamps[k], &trace.values[(size_t)k * trace.schema.num]))
+        {
+            out_len += sample_codec_enc_finish(&enc);
+            blocks++;
+            sample_codec_enc_begin(&enc, &trace.schema, &out[out_len], block_size);
+            sample_codec_enc_add(&enc, trace.timestamps[k], &trace.values[(size_t)k * trace.schema.num]);
+        }
+    }
+    len = sample_codec_enc_finish(&enc);
+    if(0 != len)
+    {
+        out_len += len;
+        blocks++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+
+    fwrite(out, 1, out_len, stdout);
+
+    // 重新解码，与输入比较，同时统计各字段的长度
+    for(pos = schema_len; pos < out_len; pos += len)
+    {
+        trace.fields.first = true;
+        if(ESP_OK != sample_codec_block_check(&out[pos], out_len - pos, &len)
+           || ESP_OK != sample_codec_data_decode(&out[pos], len, &trace.schema, tool_verify, &trace))
+        {
+            trace.mismatch++;
+            break;
+        }
+    }
+
+    fprintf(stderr, "blocks: %u data + 1 schema (%u bytes), block size %u\n", blocks, (unsigned)schema_len,
+            (unsigned)block_size);
+    tool_report(&trace.schema, out_len, &trace.fields);
+    fprintf(stderr, "encode: %.1f ns/sample (host)\n", ns / trace.num);
+    if(0 != trace.mismatch || trace.checked != trace.num)
+    {
+        fprintf(stderr, "round trip FAILED: %u of %u sample(s) differ\n", trace.mismatch + trace.num - trace.checked,
+                trace.num);
+        return 1;
+    }
+    fprintf(stderr, "round trip ok\n");
+
+    return 0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-x] [-s] [file]\n"
+                    "       %s -e [-b block_size] trace.csv > trace.bin\n", name, name);
+}
+
+int main(int argc, char *argv[])
+{
+    static tool_decoder_t dec;
+    FILE *fp = stdin;
+    bool hex = false;
+    bool encode = false;
+    size_t block_size = 128;
+    int ret = 0;
+    int opt = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "xseb:")))
+    {
+        switch(opt)
+        {
+            case 'x': hex = true; break;
+            case 's': dec.stats = true; break;
+            case 'e': encode = true; break;
+            case 'b': block_size = strtoul(optarg, NULL, 0); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if(1 < argc - optind)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    if(1 == argc - optind)
+    {
+        fp = fopen(argv[optind], hex || encode ? "r" : "rb");
+        if(NULL == fp)
+        {
+            perror(argv[optind]);
+            return 2;
+        }
+    }
+
+    if(encode)
+    {
+        ret = tool_encode(fp, block_size);
+    }
+    else
+    {
+        tool_decode_file(&dec, fp, hex);
+        if(dec.stats)
+        {
+            fprintf(stderr, "blocks: %u (schema %u), crc errors: %u, unknown schema: %u\n", dec.blocks,
+                    dec.schema_blocks, dec.crc_errors, dec.unknown);
+            tool_report(&dec.schema, dec.bytes, &dec.fields);
+        }
+        ret = (0 != dec.crc_errors || 0 != dec.unknown || !dec.have_schema) ? 1 : 0;
+    }
+
+    if(stdin != fp)
+    {
+        fclose(fp);
+    }
+
+    return ret;
+}
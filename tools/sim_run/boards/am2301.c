@@ -0,0 +1,11 @@
+/**
+ * am2301 实例的仿真板：AM2301 数据线接在 GPIO4，温度设为零下，检查符号位
+ */
+#include "sim_models.h"
+
+void sim_board_setup(void)
+{
+    sim_am2301_t *sensor = sim_am2301_attach(GPIO_NUM_4);
+
+    sim_am2301_set(sensor, 652, -41);
+}
@@ -0,0 +1,9 @@
+/**
+ * at24c32 实例的仿真板：DS3231 模块上的 AT24C32 (A0~A2 接高电平) 接在 GPIO14/GPIO2
+ */
+#include "sim_models.h"
+
+void sim_board_setup(void)
+{
+    sim_at24c32_attach(0x57);
+}
@@ -0,0 +1,11 @@
+/**
+ * bench 实例的仿真板：MPU6050 (0x68)、AT24C32 (0x57) 接在 GPIO14/GPIO2，AM2301 接在 GPIO4
+ */
+#include "sim_models.h"
+
+void sim_board_setup(void)
+{
+    sim_mpu6050_attach(0x68);
+    sim_at24c32_attach(0x57);
+    sim_am2301_attach(GPIO_NUM_4);
+}
@@ -0,0 +1,40 @@
+/**
+ * clock_calib 实例的仿真板：DS3231 接在 GPIO14/GPIO2，INT/SQW 接 GPIO12
+ *
+ * 虚拟时钟 (ESP8266) 比 DS3231 快 23.5ppm，实例测得的误差应为 +23.500 ppm
+ *
+ * 5 秒时注入一次总线卡死 (从机拉住 SDA，9 个时钟后释放)，10 秒时读取温度发现并恢复总线，
+ * ds3231_init() 重新执行后 1Hz 方波应当保持，GPIO12 的边沿数与没有卡死时相同
+ */
+#include <stdio.h>
+
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_i2c.h"
+#include "sim_models.h"
+
+#define BOARD_DRIFT_PPB             (23500)
+#define BOARD_JAM_US                (5000000)
+#define BOARD_JAM_CLOCKS            (9)
+
+static sim_event_t s_jam_event;
+
+static void board_jam(void *arg)
+{
+    sim_i2c_jam(BOARD_JAM_CLOCKS);
+}
+
+void sim_board_setup(void)
+{
+    sim_ds3231_t *rtc = sim_ds3231_attach(0x68);
+
+    sim_ds3231_set_drift(rtc, BOARD_DRIFT_PPB);
+    sim_ds3231_connect_sqw(rtc, GPIO_NUM_12);
+
+    sim_event_schedule(&s_jam_event, (uint64_t)BOARD_JAM_US * SIM_CYCLES_PER_US, board_jam, NULL);
+}
+
+void sim_board_report(void)
+{
+    printf("sim: drift %d ppb, GPIO12 edges: %u\n", BOARD_DRIFT_PPB, sim_gpio_edges(GPIO_NUM_12));
+}
@@ -0,0 +1,86 @@
+/**
+ * deep_sleep 实例的仿真板：MPU6050 (AD0 接高电平)、DS3231 模块 (DS3231 与 AT24C32) 接在 GPIO14/GPIO2，
+ * DS3231 INT/SQW 接 RST
+ *
+ * 设备模型在深度睡眠中保持。结束时读出 AT24C32 中的记录 (地址 0 为通道描述块，之后为 64 字节的数据块) 并解码
+ */
+#include <stdio.h>
+
+#include "sim.h"
+#include "sim_models.h"
+#include "sim_sleep.h"
+
+#include "sample_codec.h"
+
+#define BOARD_LOG_SCHEMA_ADDR       (0)
+#define BOARD_LOG_DATA_ADDR         (128)
+#define BOARD_LOG_BLOCK_SIZE        (64)
+#define BOARD_LOG_BLOCKS            ((4096 - 32 - BOARD_LOG_DATA_ADDR) / BOARD_LOG_BLOCK_SIZE)
+
+typedef struct {
+    uint32_t samples;
+    uint32_t first_ms;
+    uint32_t last_ms;
+} board_log_t;
+
+static sim_ds3231_t *s_rtc;
+static sim_at24c32_t *s_e2p;
+
+static int board_rst_level(void *ctx)
+{
+    return sim_ds3231_int_level(ctx);
+}
+
+static void board_sample(uint32_t timestamp_ms, const int32_t *values, uint8_t num, void *arg)
+{
+    board_log_t *log = arg;
+
+    if(0 == log->samples)
+    {
+        log->first_ms = timestamp_ms;
+    }
+    log->last_ms = timestamp_ms;
+    ++log->samples;
+}
+
+void sim_board_setup(void)
+{
+    sim_mpu6050_t *mpu = sim_mpu6050_attach(0x69);
+
+    sim_mpu6050_set_noise(mpu, 8);
+    s_rtc = sim_ds3231_attach(0x68);
+    sim_ds3231_set_time(s_rtc, 2020, 6, 30, 2, 15, 48, 0);
+    s_e2p = sim_at24c32_attach(0x57);
+
+    sim_sleep_set_rst(board_rst_level, s_rtc);
+}
+
+void sim_board_report(void)
+{
+    const uint8_t *mem = sim_at24c32_mem(s_e2p);
+    sample_codec_schema_t schema;
+    board_log_t log = { 0 };
+    uint32_t blocks = 0;
+    uint32_t i = 0;
+
+    printf("sleep: %u times, %llu us\n", sim_sleep_count(), (unsigned long long)sim_sleep_total_us());
+
+    if(ESP_OK != sample_codec_block_check(&mem[BOARD_LOG_SCHEMA_ADDR], BOARD_LOG_DATA_ADDR, NULL)
+       || ESP_OK != sample_codec_schema_unpack(&mem[BOARD_LOG_SCHEMA_ADDR], BOARD_LOG_DATA_ADDR, &schema))
+    {
+        printf("at24c32 log: no schema\n");
+        return;
+    }
+    for(i = 0; i < BOARD_LOG_BLOCKS; ++i)
+    {
+        const uint8_t *block = &mem[BOARD_LOG_DATA_ADDR + i * BOARD_LOG_BLOCK_SIZE];
+
+        if(ESP_OK == sample_codec_block_check(block, BOARD_LOG_BLOCK_SIZE, NULL)
+           && ESP_OK == sample_codec_data_decode(block, BOARD_LOG_BLOCK_SIZE, &schema, board_sample, &log))
+        {
+            ++blocks;
+        }
+    }
+    printf("at24c32 log: %u channels, %u blocks, %u samples, %u ~ %u ms\n", schema.num, blocks, log.samples,
+           log.first_ms, log.last_ms);
+}
@@ -0,0 +1,13 @@
+/**
+ * ds3231 实例的仿真板：DS3231 接在 GPIO14/GPIO2
+ *
+ * 时间设在实例闹钟 1 (星期二 15:48:05) 之前 5 秒，运行中可以看到闹钟标志置位
+ */
+#include "sim_models.h"
+
+void sim_board_setup(void)
+{
+    sim_ds3231_t *rtc = sim_ds3231_attach(0x68);
+
+    sim_ds3231_set_time(rtc, 2020, 6, 30, 2, 15, 48, 0);
+}
@@ -0,0 +1,17 @@
+/**
+ * gpio 实例的仿真板：GPIO15 跳线到 GPIO4，GPIO16 跳线到 GPIO5
+ */
+#include <stdio.h>
+
+#include "sim_gpio.h"
+
+void sim_board_setup(void)
+{
+    sim_gpio_connect(GPIO_NUM_15, GPIO_NUM_4);
+    sim_gpio_connect(GPIO_NUM_16, GPIO_NUM_5);
+}
+
+void sim_board_report(void)
+{
+    printf("sim: GPIO4 edges: %u, GPIO5 edges: %u\n", sim_gpio_edges(GPIO_NUM_4), sim_gpio_edges(GPIO_NUM_5));
+}
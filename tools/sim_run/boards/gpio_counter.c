@@ -0,0 +1,67 @@
+/**
+ * gpio_counter 实例的仿真板：GPIO15 跳线到 GPIO4，GPIO16 跳线到 GPIO5，GPIO12 (PWM) 跳线到 GPIO13
+ *
+ * PWM 模型不驱动引脚，GPIO13 上的外部驱动按 PWM 通道 0 的周期与占空比在每个跳变时刻改变电平，
+ * 实例测得的应为 1000.000 Hz、占空比 25.00%
+ */
+#include <stdio.h>
+
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_pwm.h"
+
+/* PWM 停止时检查的间隔 */
+#define BOARD_PWM_POLL_US           (1000)
+
+static sim_event_t s_pwm_event;
+static int s_pwm_level = 0;
+
+static int board_pwm_drive(void *ctx, gpio_num_t gpio_num)
+{
+    return s_pwm_level;
+}
+
+static const sim_gpio_ext_t s_pwm_ext = {
+    .drive = board_pwm_drive,
+    .changed = NULL,
+    .ctx = NULL,
+};
+
+/* 按当前时刻计算 PWM 通道 0 的电平，并在下一个跳变时刻再次执行 */
+static void board_pwm_edge(void *arg)
+{
+    const sim_pwm_param_t *param = sim_pwm_running();
+    uint64_t now = sim_cycles();
+    uint64_t period = 0;
+    uint64_t duty = 0;
+    uint64_t pos = 0;
+
+    if(NULL == param)
+    {
+        s_pwm_level = 0;
+        sim_gpio_update();
+        sim_event_schedule(&s_pwm_event, now + (uint64_t)BOARD_PWM_POLL_US * SIM_CYCLES_PER_US, board_pwm_edge, NULL);
+        return;
+    }
+
+    period = (uint64_t)param->period * SIM_CYCLES_PER_US;
+    duty = (uint64_t)param->duties[0] * SIM_CYCLES_PER_US;
+    pos = now % period;
+    s_pwm_level = (pos < duty) ? 1 : 0;
+    sim_gpio_update();
+    sim_event_schedule(&s_pwm_event, now - pos + ((pos < duty) ? duty : period), board_pwm_edge, NULL);
+}
+
+void sim_board_setup(void)
+{
+    sim_gpio_connect(GPIO_NUM_15, GPIO_NUM_4);
+    sim_gpio_connect(GPIO_NUM_16, GPIO_NUM_5);
+    sim_gpio_attach(GPIO_NUM_13, &s_pwm_ext);
+    board_pwm_edge(NULL);
+}
+
+void sim_board_report(void)
+{
+    printf("sim: GPIO4 edges: %u, GPIO5 edges: %u, GPIO13 edges: %u\n", sim_gpio_edges(GPIO_NUM_4),
+           sim_gpio_edges(GPIO_NUM_5), sim_gpio_edges(GPIO_NUM_13));
+}
@@ -0,0 +1,11 @@
+/**
+ * hw_timer 实例的仿真板：统计 GPIO15 输出的翻转次数
+ */
+#include <stdio.h>
+
+#include "sim_gpio.h"
+
+void sim_board_report(void)
+{
+    printf("sim: GPIO15 edges: %u\n", sim_gpio_edges(GPIO_NUM_15));
+}
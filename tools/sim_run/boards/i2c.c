@@ -0,0 +1,49 @@
+/**
+ * i2c 实例的仿真板：MPU6050 (AD0 接低电平) 与 DS3231 模块上的 AT24C32 接在 GPIO14/GPIO2
+ *
+ * 传感器带零偏，前 2 秒静止水平放置，用于冷启动标定 (AT24C32 为空)；
+ * 之后横滚 30° 并绕竖直轴以 9°/s 转动：重力在机体系中为 (0, sin30°, cos30°)，
+ * 机体角速度为 (0, 9 sin30°, 9 cos30°) °/s
+ *
+ * 6.5 秒时 MPU6050 复位并拉住 SDA (9 个时钟后释放)，模拟 FIFO 采样过程中的电源跌落：
+ * 总线恢复后 mpu6050_init() 应恢复 1kHz FIFO 与标定的偏移，之后的采样数与姿态不受影响
+ */
+#include "sim.h"
+#include "sim_i2c.h"
+#include "sim_models.h"
+
+#define BOARD_MOTION_US             (2000000)
+#define BOARD_RESET_US              (6500000)
+#define BOARD_JAM_CLOCKS            (9)
+
+static sim_mpu6050_t *s_mpu;
+static sim_event_t s_motion_event;
+static sim_event_t s_reset_event;
+
+static void board_reset(void *arg)
+{
+    sim_mpu6050_power_reset(s_mpu);
+    sim_i2c_jam(BOARD_JAM_CLOCKS);
+}
+
+static void board_motion(void *arg)
+{
+    const int32_t accel_mg[3] = { 0, 500, 866 };
+    const int32_t gyro_mdps[3] = { 0, 4500, 7794 };
+
+    sim_mpu6050_set_motion(s_mpu, accel_mg, gyro_mdps);
+}
+
+void sim_board_setup(void)
+{
+    const int32_t accel_bias_mg[3] = { 30, -20, 45 };
+    const int32_t gyro_bias_mdps[3] = { 1500, -2500, 800 };
+
+    s_mpu = sim_mpu6050_attach(0x68);
+    sim_mpu6050_set_bias(s_mpu, accel_bias_mg, gyro_bias_mdps);
+    sim_mpu6050_set_noise(s_mpu, 8);
+    sim_at24c32_attach(0x57);
+
+    sim_event_schedule(&s_motion_event, (uint64_t)BOARD_MOTION_US * SIM_CYCLES_PER_US, board_motion, NULL);
+    sim_event_schedule(&s_reset_event, (uint64_t)BOARD_RESET_US * SIM_CYCLES_PER_US, board_reset, NULL);
+}
@@ -0,0 +1,33 @@
+/**
+ * i2c_multi 实例的仿真板：MPU6050 (AD0 接高电平)、DS3231 模块 (含 AT24C32) 共用 GPIO14/GPIO2
+ *
+ * 6.5 秒时在两次传输之间注入一次总线卡死 (从机拉住 SDA，9 个时钟后释放)：
+ * 下一次传输发现 SDA 为低电平，不输出时钟直接返回超时，由总线恢复输出的时钟释放，
+ * 检查恢复确实执行，之后各任务继续正常工作
+ */
+#include "sim.h"
+#include "sim_i2c.h"
+#include "sim_models.h"
+
+#define BOARD_JAM_US                (6500000)
+#define BOARD_JAM_CLOCKS            (9)
+
+static sim_event_t s_jam_event;
+
+static void board_jam(void *arg)
+{
+    sim_i2c_jam(BOARD_JAM_CLOCKS);
+}
+
+void sim_board_setup(void)
+{
+    sim_mpu6050_t *mpu = sim_mpu6050_attach(0x69);
+    sim_ds3231_t *rtc = sim_ds3231_attach(0x68);
+
+    sim_mpu6050_set_noise(mpu, 8);
+    // 运行中跨过闰年 2 月 29 日
+    sim_ds3231_set_time(rtc, 2024, 2, 28, 3, 23, 59, 55);
+    sim_at24c32_attach(0x57);
+
+    sim_event_schedule(&s_jam_event, (uint64_t)BOARD_JAM_US * SIM_CYCLES_PER_US, board_jam, NULL);
+}
@@ -0,0 +1,11 @@
+/**
+ * pwm 实例的仿真板：统计 pwm_start() 的调用次数
+ */
+#include <stdio.h>
+
+#include "sim_pwm.h"
+
+void sim_board_report(void)
+{
+    printf("sim: pwm_start count: %u\n", sim_pwm_start_count());
+}
@@ -0,0 +1,15 @@
+/**
+ * sensors 实例的仿真板：MPU6050 (AD0 接高电平)、DS3231 接在 GPIO14/GPIO2，AM2301 接在 GPIO4
+ */
+#include "sim_models.h"
+
+void sim_board_setup(void)
+{
+    sim_mpu6050_t *mpu = sim_mpu6050_attach(0x69);
+    sim_ds3231_t *rtc = sim_ds3231_attach(0x68);
+    sim_am2301_t *sensor = sim_am2301_attach(GPIO_NUM_4);
+
+    sim_mpu6050_set_noise(mpu, 8);
+    sim_ds3231_set_time(rtc, 2024, 6, 1, 7, 12, 0, 0);
+    sim_am2301_set(sensor, 481, 236);
+}
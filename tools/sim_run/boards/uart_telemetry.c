@@ -0,0 +1,112 @@
+/**
+ * uart_telemetry 实例的仿真板：MPU6050 (AD0 接低电平) 接在 GPIO14/GPIO12，UART0 接主机端解码器
+ *
+ * 传感器 2 秒后开始转动。解码器与 tools/uart_capture 相同：COBS 分帧、CRC 与序号检查，
+ * 记录帧按 sample_codec 解码，检查采样时间戳连续 (1kHz，每个采样 1ms)
+ */
+#include <stdio.h>
+
+#include "sim.h"
+#include "sim_models.h"
+#include "sim_uart.h"
+
+#include "sample_codec.h"
+#include "uart_link.h"
+
+#define BOARD_MOTION_US             (2000000)
+
+typedef struct {
+    uart_link_dec_t dec;
+    sample_codec_schema_t schema;
+    bool have_schema;
+    uint32_t text_frames;
+    uint32_t record_frames;
+    uint32_t samples;
+    uint32_t gaps;                  /*!< 时间戳不连续的次数 */
+    uint32_t last_ms;
+    uint64_t first_frame_us;
+    uint64_t last_frame_us;
+} board_rx_t;
+
+static sim_mpu6050_t *s_mpu;
+static sim_event_t s_motion_event;
+static board_rx_t s_rx;
+
+static void board_motion(void *arg)
+{
+    const int32_t accel_mg[3] = { 0, 500, 866 };
+    const int32_t gyro_mdps[3] = { 0, 4500, 7794 };
+
+    sim_mpu6050_set_motion(s_mpu, accel_mg, gyro_mdps);
+}
+
+static void board_sample(uint32_t timestamp_ms, const int32_t *values, uint8_t num, void *arg)
+{
+    board_rx_t *rx = arg;
+
+    if(0 < rx->samples && timestamp_ms != rx->last_ms + 1)
+    {
+        ++rx->gaps;
+    }
+    rx->last_ms = timestamp_ms;
+    ++rx->samples;
+}
+
+static void board_frame(uint8_t type, uint16_t seq, const uint8_t *payload, size_t len, void *arg)
+{
+    board_rx_t *rx = arg;
+
+    if(1 == rx->dec.frames)
+    {
+        rx->first_frame_us = sim_time_us();
+    }
+    rx->last_frame_us = sim_time_us();
+
+    if(UART_LINK_TYPE_TEXT == type)
+    {
+        ++rx->text_frames;
+        printf("uart0 text: %.*s\n", (int)len, (const char *)payload);
+        return;
+    }
+    if(UART_LINK_TYPE_RECORD != type || ESP_OK != sample_codec_block_check(payload, len, NULL))
+    {
+        return;
+    }
+
+    ++rx->record_frames;
+    if(SAMPLE_CODEC_TYPE_SCHEMA == payload[0])
+    {
+        rx->have_schema = (ESP_OK == sample_codec_schema_unpack(payload, len, &rx->schema));
+    }
+    else if(rx->have_schema)
+    {
+        sample_codec_data_decode(payload, len, &rx->schema, board_sample, rx);
+    }
+}
+
+static void board_uart_rx(void *ctx, const uint8_t *data, size_t len)
+{
+    uart_link_dec_feed(ctx, data, len);
+}
+
+void sim_board_setup(void)
+{
+    s_mpu = sim_mpu6050_attach(0x68);
+    sim_mpu6050_set_noise(s_mpu, 8);
+
+    uart_link_dec_init(&s_rx.dec, board_frame, &s_rx);
+    sim_uart_set_rx(UART_NUM_0, board_uart_rx, &s_rx.dec);
+
+    sim_event_schedule(&s_motion_event, (uint64_t)BOARD_MOTION_US * SIM_CYCLES_PER_US, board_motion, NULL);
+}
+
+void sim_board_report(void)
+{
+    uint64_t us = s_rx.last_frame_us - s_rx.first_frame_us;
+
+    printf("uart0 rx: %llu bytes, frames %u (text %u, record %u), crc errors %u, framing errors %u, lost %u\n",
+           (unsigned long long)s_rx.dec.bytes, s_rx.dec.frames, s_rx.text_frames, s_rx.record_frames,
+           s_rx.dec.crc_errors, s_rx.dec.framing_errors, s_rx.dec.lost);
+    printf("uart0 rx: samples %u, timestamp gaps %u, %llu bytes/s\n", s_rx.samples, s_rx.gaps,
+           (0 < us) ? (unsigned long long)(s_rx.dec.bytes * 1000000 / us) : 0ULL);
+}
@@ -0,0 +1,83 @@
+/**
+ * 主机仿真入口：按虚拟时间运行一个实例工程的 app_main()
+ *
+ * 用法：<工程> [-t 秒] [-u 文件]，默认运行 10 秒虚拟时间
+ * -u 把 UART0 发出的字节写入文件或伪终端 (例如 tools/uart_capture -p 创建的)，日志仍然输出到 stdout
+ * 外设模型在 boards/<工程>.c 的 sim_board_setup() 中创建，运行结束后 sim_board_report() 输出检查用的统计
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "sim.h"
+#include "sim_uart.h"
+
+#define SIM_DEFAULT_SECONDS         (10)
+
+void app_main(void);
+
+void sim_board_setup(void) __attribute__((weak));
+void sim_board_report(void) __attribute__((weak));
+
+int main(int argc, char **argv)
+{
+    uint64_t seconds = SIM_DEFAULT_SECONDS;
+    uint64_t end_us = 0;
+    struct termios tio;
+    int fd = -1;
+    int i = 0;
+
+    for(i = 1; i < argc; ++i)
+    {
+        if(0 == strcmp(argv[i], "-t") && i + 1 < argc)
+        {
+            seconds = strtoull(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "-u") && i + 1 < argc && 0 > fd)
+        {
+            fd = open(argv[++i], O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644);
+            if(0 > fd)
+            {
+                perror(argv[i]);
+                return 2;
+            }
+            // 终端按原始字节传输，不转换换行
+            if(0 == tcgetattr(fd, &tio))
+            {
+                cfmakeraw(&tio);
+                tcsetattr(fd, TCSANOW, &tio);
+            }
+            sim_uart_set_output(UART_NUM_0, fd);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-t seconds] [-u uart0_output]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // 输出按行刷新，与仿真中的日志顺序一致
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if(NULL != sim_board_setup)
+    {
+        sim_board_setup();
+    }
+
+    end_us = sim_run(app_main, seconds * 1000000);
+
+    if(NULL != sim_board_report)
+    {
+        sim_board_report();
+    }
+    printf("sim: end at %llu us\n", (unsigned long long)end_us);
+    if(0 <= fd)
+    {
+        close(fd);
+    }
+
+    return 0;
+}
@@ -0,0 +1,376 @@
+/**
+ * 说明:
+ * 滚动统计 (stats_window 组件) 的主机端检查
+ *
+ * 合成多通道采样：随机游走、大偏置上的小噪声 (检查平方和相减的精度)、偶发尖峰、正弦，
+ * 时间戳带抖动 (可能相同)，中途有一段短于最长窗口和一段长于最长窗口的中断。
+ * 同时配置 1s、10s 翻滚窗口与 60s/5s、600s/60s 滑动窗口，每条输出的记录与保存全部采样后
+ * 按 [start_ms, end_ms) 暴力计算的结果比较：
+ * - 采样数、最小值、最大值完全相同
+ * - 均值、标准差与双精度计算 x100 后相差不超过 1 (四舍五入/开方取整)
+ * - 每个有采样的窗口恰好输出一次，按结束时间递增
+ * 然后比较组件的内存与直接保存最长窗口内全部采样的内存，最后测量主机上每个采样的耗时。
+ *
+ * 使用:
+ * $ ./stats_window_sim [-r 采样率Hz] [-c 通道数] [-s 时长s] [-j 抖动ms] [-S 随机种子]
+ *
+ * 任一记录与参考不符或窗口缺少/重复时返回 1
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+
+#include "stats_window.h"
+
+#define SIM_WIN_NUM                 (4)
+/* 起始时间，不从 0 开始，第一个窗口只有部分采样 */
+#define SIM_START_MS                (123457)
+/* 吞吐量测量重复处理整段数据的次数 */
+#define SIM_SPEED_ROUNDS            (5)
+
+static const stats_window_spec_t s_specs[SIM_WIN_NUM] = {
+    { 1000, 0 },
+    { 10000, 0 },
+    { 60000, 5000 },
+    { 600000, 60000 },
+};
+
+typedef struct {
+    double rate;
+    uint8_t num;
+    double seconds;
+    uint32_t jitter_ms;
+    unsigned int seed;
+} sim_opts_t;
+
+typedef struct {
+    uint32_t *ts;
+    int32_t *values;                /*!< [n][num] */
+    size_t n;
+    uint8_t num;
+    uint32_t records[SIM_WIN_NUM];
+    uint32_t last_end[SIM_WIN_NUM];
+    uint32_t order_errors;
+    uint32_t exact_errors;          /*!< 采样数、最小值、最大值不同 */
+    int32_t mean_err;               /*!< 最大误差 x100 */
+    int32_t std_err;
+} sim_data_t;
+
+static double sim_now_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (double)t.tv_sec * 1e9 + (double)t.tv_nsec;
+}
+
+static double sim_noise(void)
+{
+    return (double)rand() / RAND_MAX * 2.0 - 1.0;
+}
+
+static void sim_synth(sim_data_t *d, const sim_opts_t *o)
+{
+    uint32_t period_ms = (uint32_t)(1000.0 / o->rate);
+    uint64_t end_ms = SIM_START_MS + (uint64_t)(o->seconds * 1000);
+    uint64_t t = SIM_START_MS;
+    uint32_t ts = 0;
+    uint32_t prev = 0;
+    double walk = 0;
+    size_t i = 0;
+    uint8_t c = 0;
+    int32_t *v = NULL;
+
+    srand(o->seed);
+    d->n = 0;
+    while(t < end_ms)
+    {
+        // 1/3 处中断 45 秒，2/3 处中断 700 秒 (长于最长的窗口)
+        if(t < SIM_START_MS + (end_ms - SIM_START_MS) / 3 && t + period_ms >= SIM_START_MS + (end_ms - SIM_START_MS) / 3)
+        {
+            t += 45000;
+        }
+        if(t < SIM_START_MS + (end_ms - SIM_START_MS) * 2 / 3
+           && t + period_ms >= SIM_START_MS + (end_ms - SIM_START_MS) * 2 / 3)
+        {
+            t += 700000;
+        }
+
+        // 抖动不让时间戳回退
+        ts = (uint32_t)t + (0 < o->jitter_ms ? (uint32_t)(rand() % (o->jitter_ms + 1)) : 0);
+        if(0 < i && ts < prev)
+        {
+            ts = prev;
+        }
+        prev = ts;
+
+        d->ts[i] = ts;
+        v = &d->values[i * d->num];
+        walk += sim_noise() * 50;
+        for(c = 0; c < d->num; ++c)
+        {
+            switch(c % 4)
+            {
+                case 0: v[c] = (int32_t)lrint(walk); break;
+                case 1: v[c] = 20000 + (int32_t)lrint(sim_noise() * 3); break;
+                case 2: v[c] = (0 == rand() % 500) ? 30000 : -1200 + (int32_t)lrint(sim_noise() * 20); break;
+                default: v[c] = (int32_t)lrint(1000 * sin(2 * M_PI * ts / 7000.0 + c)); break;
+            }
+        }
+        ++i;
+        t += period_ms;
+    }
+    d->n = i;
+}
+
+/* 第一个时间戳不小于 ms 的采样 */
+static size_t sim_lower(const sim_data_t *d, uint32_t ms)
+{
+    size_t lo = 0;
+    size_t hi = d->n;
+    size_t mid = 0;
+
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(d->ts[mid] < ms)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static void sim_check_record(const stats_window_record_t *record, void *arg)
+{
+    sim_data_t *d = arg;
+    size_t first = sim_lower(d, record->start_ms);
+    size_t last = sim_lower(d, record->end_ms);
+    size_t i = 0;
+    uint8_t c = 0;
+    int32_t min = 0;
+    int32_t max = 0;
+    int32_t x = 0;
+    double sum = 0;
+    double m2 = 0;
+    double mean = 0;
+    double std = 0;
+    int32_t err = 0;
+
+    ++d->records[record->window];
+    if(record->end_ms <= d->last_end[record->window])
+    {
+        ++d->order_errors;
+    }
+    d->last_end[record->window] = record->end_ms;
+
+    if(record->num != d->num || last - first != record->count)
+    {
+        ++d->exact_errors;
+        return;
+    }
+
+    for(c = 0; c < d->num; ++c)
+    {
+        sum = 0;
+        min = INT32_MAX;
+        max = INT32_MIN;
+        for(i = first; i < last; ++i)
+        {
+            x = d->values[i * d->num + c];
+            sum += x;
+            min = (x < min) ? x : min;
+            max = (x > max) ? x : max;
+        }
+        mean = sum / record->count;
+        m2 = 0;
+        for(i = first; i < last; ++i)
+        {
+            m2 += (d->values[i * d->num + c] - mean) * (d->values[i * d->num + c] - mean);
+        }
+        std = (1 < record->count) ? sqrt(m2 / (record->count - 1)) : 0;
+
+        if(min != record->stats[c].min || max != record->stats[c].max)
+        {
+            ++d->exact_errors;
+        }
+        err = abs(record->stats[c].mean - (int32_t)lrint(mean * STATS_WINDOW_SCALE));
+        d->mean_err = (err > d->mean_err) ? err : d->mean_err;
+        err = abs(record->stats[c].std - (int32_t)lrint(std * STATS_WINDOW_SCALE));
+        d->std_err = (err > d->std_err) ? err : d->std_err;
+    }
+}
+
+/* 有采样的窗口数：段 p 中的采样属于结束段为 p ~ p + K - 1 的窗口 */
+static uint32_t sim_expect_records(const sim_data_t *d, const stats_window_spec_t *spec)
+{
+    uint32_t hop = (0 == spec->hop_ms) ? spec->length_ms : spec->hop_ms;
+    uint32_t panes = spec->length_ms / hop;
+    uint64_t covered = 0;
+    uint64_t p = 0;
+    uint32_t count = 0;
+    size_t i = 0;
+
+    for(i = 0; i < d->n; ++i)
+    {
+        p = d->ts[i] / hop;
+        if(p + panes > covered)
+        {
+            count += (uint32_t)(p + panes - ((p > covered) ? p : covered));
+            covered = p + panes;
+        }
+    }
+
+    return count;
+}
+
+static void sim_null_cb(const stats_window_record_t *record, void *arg)
+{
+    ++*(uint32_t *)arg;
+}
+
+/* 组件的参数检查与时间戳回退 */
+static int sim_check_args(void)
+{
+    const stats_window_spec_t bad_ratio = { 60000, 7000 };
+    const stats_window_spec_t bad_panes = { 3600000, 10000 };
+    const stats_window_spec_t ok = { 1000, 0 };
+    const int32_t values[1] = { 1 };
+    stats_window_handle_t handle = NULL;
+    uint32_t count = 0;
+    int fail = 0;
+
+    fail |= (ESP_ERR_INVALID_ARG != stats_window_create(1, &bad_ratio, 1, sim_null_cb, &count, &handle));
+    fail |= (ESP_ERR_INVALID_ARG != stats_window_create(1, &bad_panes, 1, sim_null_cb, &count, &handle));
+    fail |= (ESP_ERR_INVALID_ARG != stats_window_create(STATS_WINDOW_CHANNEL_MAX + 1, &ok, 1, sim_null_cb, &count,
+                                                        &handle));
+    if(ESP_OK != stats_window_create(1, &ok, 1, sim_null_cb, &count, &handle))
+    {
+        return 1;
+    }
+    fail |= (ESP_OK != stats_window_add(handle, 5500, values));
+    fail |= (ESP_OK != stats_window_add(handle, 5000, values));
+    fail |= (ESP_ERR_INVALID_ARG != stats_window_add(handle, 4999, values));
+    fail |= (0 != count);
+    stats_window_advance(handle, 6000);
+    fail |= (1 != count);
+    stats_window_delete(handle);
+
+    return fail;
+}
+
+int main(int argc, char *argv[])
+{
+    sim_opts_t o = { .rate = 10, .num = 4, .seconds = 7200, .jitter_ms = 20, .seed = 1 };
+    stats_window_handle_t handle = NULL;
+    sim_data_t d;
+    uint32_t expect = 0;
+    uint32_t count = 0;
+    size_t naive = 0;
+    size_t i = 0;
+    double ns = 0;
+    int fail = 0;
+    int opt = 0;
+    int w = 0;
+    int r = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "r:c:s:j:S:")))
+    {
+        switch(opt)
+        {
+            case 'r': o.rate = strtod(optarg, NULL); break;
+            case 'c': o.num = (uint8_t)strtoul(optarg, NULL, 10); break;
+            case 's': o.seconds = strtod(optarg, NULL); break;
+            case 'j': o.jitter_ms = strtoul(optarg, NULL, 10); break;
+            case 'S': o.seed = strtoul(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "usage: %s [-r hz] [-c channels] [-s seconds] [-j jitter_ms] [-S seed]\n", argv[0]);
+                return 2;
+        }
+    }
+    if(0 >= o.rate || 1000 < o.rate || 0 == o.num || STATS_WINDOW_CHANNEL_MAX < o.num || 0 >= o.seconds)
+    {
+        fprintf(stderr, "invalid arguments\n");
+        return 2;
+    }
+
+    memset(&d, 0, sizeof(d));
+    d.num = o.num;
+    d.n = (size_t)(o.rate * o.seconds) + 1;
+    d.ts = calloc(d.n, sizeof(uint32_t));
+    d.values = calloc(d.n * o.num, sizeof(int32_t));
+    if(NULL == d.ts || NULL == d.values)
+    {
+        return 2;
+    }
+    sim_synth(&d, &o);
+    printf("synthetic: %zu samples x %u channels at %g Hz, jitter %u ms, gaps 45 s and 700 s\n",
+           d.n, o.num, o.rate, o.jitter_ms);
+
+    if(ESP_OK != stats_window_create(o.num, s_specs, SIM_WIN_NUM, sim_check_record, &d, &handle))
+    {
+        fprintf(stderr, "stats_window_create failed\n");
+        return 2;
+    }
+    for(i = 0; i < d.n; ++i)
+    {
+        if(ESP_OK != stats_window_add(handle, d.ts[i], &d.values[i * o.num]))
+        {
+            ++d.order_errors;
+        }
+    }
+    // 输出最后一个采样所在的全部窗口
+    stats_window_advance(handle, d.ts[d.n - 1] + s_specs[SIM_WIN_NUM - 1].length_ms);
+
+    for(w = 0; w < SIM_WIN_NUM; ++w)
+    {
+        expect = sim_expect_records(&d, &s_specs[w]);
+        fail |= (expect != d.records[w]);
+        printf("window %d (%u ms, hop %u ms): %u records, expected %u\n", w, s_specs[w].length_ms,
+               (0 == s_specs[w].hop_ms) ? s_specs[w].length_ms : s_specs[w].hop_ms, d.records[w], expect);
+    }
+    fail |= (0 != d.order_errors) || (0 != d.exact_errors) || (1 < d.mean_err) || (1 < d.std_err);
+    printf("count/min/max mismatches %u, order errors %u, max error x%d: mean %d, std %d\n",
+           d.exact_errors, d.order_errors, STATS_WINDOW_SCALE, d.mean_err, d.std_err);
+
+    r = sim_check_args();
+    fail |= r;
+    printf("argument checks: %s\n", r ? "failed" : "passed");
+
+    // 直接保存最长窗口内全部采样 (时间戳 + 各通道值) 所需的内存
+    naive = (size_t)(o.rate * s_specs[SIM_WIN_NUM - 1].length_ms / 1000) * (sizeof(uint32_t) + o.num * sizeof(int32_t));
+    printf("memory: %zu bytes for %d windows, raw samples of the %u s window %zu bytes\n",
+           stats_window_mem_size(handle), SIM_WIN_NUM, s_specs[SIM_WIN_NUM - 1].length_ms / 1000, naive);
+    stats_window_delete(handle);
+
+    // 吞吐量：回调只计数
+    ns = sim_now_ns();
+    for(r = 0; r < SIM_SPEED_ROUNDS; ++r)
+    {
+        stats_window_create(o.num, s_specs, SIM_WIN_NUM, sim_null_cb, &count, &handle);
+        for(i = 0; i < d.n; ++i)
+        {
+            stats_window_add(handle, d.ts[i], &d.values[i * o.num]);
+        }
+        stats_window_delete(handle);
+    }
+    ns = (sim_now_ns() - ns) / SIM_SPEED_ROUNDS / d.n;
+    printf("host: %.1f ns per sample (%u channels, %d windows)\n", ns, o.num, SIM_WIN_NUM);
+    printf("%s\n", fail ? "FAIL" : "ok");
+
+    free(d.ts);
+    free(d.values);
+
+    return fail;
+}
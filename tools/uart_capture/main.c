@@ -0,0 +1,429 @@
+/**
+ * 说明:
+ * uart_link 组件 (project/components/uart_link) 的主机端接收工具
+ *
+ * 从串口、伪终端或文件读取 COBS 分帧的数据流，检查 CRC 与序号：
+ * - 记录帧 (sample_codec 块) 解码为 CSV 输出到 stdout：timestamp_ms,通道 1,通道 2,...
+ * - -o 时把记录帧的负载按顺序写入文件，格式与 tools/sample_decode 的二进制输入相同
+ * - 文本帧输出到 stderr
+ * 结束时在 stderr 输出字节数、帧数、CRC/分帧错误、丢帧数 (序号间隔)、采样数与接收速率。
+ *
+ * 串口按原始模式打开，-b 设置波特率 (默认 921600，最高 4000000)。
+ * 从串口/伪终端中途开始接收时，第一个 0x00 之前的不完整帧直接丢弃，不算错误。
+ * -p 创建伪终端，从主设备读取，在 stderr 输出从设备的路径，供 sim_run 的 -u 选项写入：
+ *
+ * 使用:
+ * $ ./uart_capture -b 921600 /dev/ttyUSB0 > imu.csv           (Ctrl+C 结束)
+ * $ ./uart_capture -p -i 2 -o imu.bin > imu.csv               (2 秒没有数据后结束)
+ * $ ./uart_capture uart0.bin > imu.csv                        (sim_run -u 保存的文件)
+ *
+ * 有 CRC/分帧错误、丢帧或没有收到任何帧时返回 1
+ */
+/* posix_openpt() 等伪终端函数 */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sample_codec.h"
+#include "uart_link.h"
+
+#define TOOL_READ_LEN               (4096)
+#define TOOL_DEFAULT_BAUD           (921600)
+/* 没有数据时检查结束条件的间隔 */
+#define TOOL_POLL_MS                (100)
+
+typedef struct {
+    uint32_t baud;
+    speed_t speed;
+} tool_baud_t;
+
+typedef struct {
+    uart_link_dec_t dec;
+    sample_codec_schema_t schema;
+    bool have_schema;
+    FILE *payload_fp;
+    uint32_t text_frames;
+    uint32_t record_frames;
+    uint32_t other_frames;
+    uint32_t bad_blocks;            /*!< 记录帧中的负载不是正确的 sample_codec 块 */
+    uint32_t unknown;               /*!< 没有对应通道描述的数据块 */
+    uint32_t samples;
+} tool_capture_t;
+
+static const tool_baud_t s_bauds[] = {
+    { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+    { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 }, { 500000, B500000 },
+    { 921600, B921600 }, { 1000000, B1000000 }, { 1500000, B1500000 }, { 2000000, B2000000 },
+    { 3000000, B3000000 }, { 4000000, B4000000 },
+};
+
+static volatile sig_atomic_t s_stop = 0;
+
+static void tool_signal(int sig)
+{
+    s_stop = 1;
+}
+
+static double tool_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void tool_print_value(int32_t value, int8_t decimals)
+{
+    int64_t v = value;
+    int64_t scale = 1;
+    int i = 0;
+
+    if(0 >= decimals)
+    {
+        for(i = 0; i < -decimals; ++i)
+        {
+            v *= 10;
+        }
+        printf("%lld", (long long)v);
+        return;
+    }
+
+    for(i = 0; i < decimals; ++i)
+    {
+        scale *= 10;
+    }
+    printf("%s%lld.%0*lld", (0 > v) ? "-" : "", (long long)(llabs(v) / scale), decimals, (long long)(llabs(v) % scale));
+}
+
+static void tool_sample(uint32_t timestamp_ms, const int32_t *values, uint8_t num, void *arg)
+{
+    tool_capture_t *cap = arg;
+    uint8_t i = 0;
+
+    printf("%u", timestamp_ms);
+    for(i = 0; i < num; ++i)
+    {
+        printf(",");
+        tool_print_value(values[i], cap->schema.channels[i].decimals);
+    }
+    printf("\n");
+    cap->samples++;
+}
+
+static void tool_record(tool_capture_t *cap, const uint8_t *payload, size_t len)
+{
+    sample_codec_schema_t schema;
+    uint8_t i = 0;
+
+    if(ESP_OK != sample_codec_block_check(payload, len, NULL))
+    {
+        cap->bad_blocks++;
+        return;
+    }
+
+    cap->record_frames++;
+    if(NULL != cap->payload_fp)
+    {
+        fwrite(payload, 1, len, cap->payload_fp);
+    }
+
+    if(SAMPLE_CODEC_TYPE_SCHEMA == payload[0])
+    {
+        // 通道描述周期性重发，变化时才输出新的表头
+        if(ESP_OK != sample_codec_schema_unpack(payload, len, &schema))
+        {
+            cap->bad_blocks++;
+            return;
+        }
+        if(!cap->have_schema || schema.id != cap->schema.id)
+        {
+            cap->schema = schema;
+            cap->have_schema = true;
+            printf("timestamp_ms");
+            for(i = 0; i < schema.num; ++i)
+            {
+                printf(",%s", schema.channels[i].name);
+            }
+            printf("\n");
+        }
+        return;
+    }
+
+    if(!cap->have_schema || ESP_OK != sample_codec_data_decode(payload, len, &cap->schema, tool_sample, cap))
+    {
+        cap->unknown++;
+    }
+}
+
+static void tool_frame(uint8_t type, uint16_t seq, const uint8_t *payload, size_t len, void *arg)
+{
+    tool_capture_t *cap = arg;
+
+    switch(type)
+    {
+        case UART_LINK_TYPE_TEXT:
+            cap->text_frames++;
+            fprintf(stderr, "text [%u]: %.*s\n", seq, (int)len, (const char *)payload);
+            break;
+        case UART_LINK_TYPE_RECORD:
+            tool_record(cap, payload, len);
+            break;
+        default:
+            cap->other_frames++;
+            break;
+    }
+}
+
+static int tool_open_tty(const char *path, uint32_t baud)
+{
+    struct termios tio;
+    size_t i = 0;
+    int fd = -1;
+
+    for(i = 0; i < sizeof(s_bauds) / sizeof(s_bauds[0]); ++i)
+    {
+        if(baud == s_bauds[i].baud)
+        {
+            break;
+        }
+    }
+    if(sizeof(s_bauds) / sizeof(s_bauds[0]) == i)
+    {
+        fprintf(stderr, "unsupported baud rate %u\n", baud);
+        return -1;
+    }
+
+    fd = open(path, O_RDONLY | O_NOCTTY);
+    if(0 > fd)
+    {
+        perror(path);
+        return -1;
+    }
+    if(0 != tcgetattr(fd, &tio))
+    {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, s_bauds[i].speed);
+    cfsetospeed(&tio, s_bauds[i].speed);
+    if(0 != tcsetattr(fd, TCSANOW, &tio))
+    {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIFLUSH);
+
+    return fd;
+}
+
+/* 创建伪终端，返回主设备；从设备保持打开，写入者关闭后不会读到 EIO，也保留原始模式 */
+static int tool_open_pty(int *slave)
+{
+    struct termios tio;
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if(0 > fd || 0 != grantpt(fd) || 0 != unlockpt(fd))
+    {
+        perror("pty");
+        return -1;
+    }
+
+    *slave = open(ptsname(fd), O_RDWR | O_NOCTTY);
+    if(0 > *slave || 0 != tcgetattr(*slave, &tio))
+    {
+        perror(ptsname(fd));
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(*slave, TCSANOW, &tio);
+
+    fprintf(stderr, "pty: %s\n", ptsname(fd));
+
+    return fd;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-b baud] [-o payload.bin] [-t seconds] [-i idle_seconds] device|file\n"
+                    "       %s -p [-o payload.bin] [-t seconds] [-i idle_seconds]\n", name, name);
+}
+
+int main(int argc, char *argv[])
+{
+    static tool_capture_t cap;
+    static uint8_t buf[TOOL_READ_LEN];
+    struct pollfd pfd;
+    uint32_t baud = TOOL_DEFAULT_BAUD;
+    const char *payload_path = NULL;
+    double seconds = 0;
+    double idle = 0;
+    double start = 0;
+    double first = 0;
+    double last = 0;
+    bool pty = false;
+    bool sync = false;
+    bool tty = false;
+    int slave = -1;
+    int fd = -1;
+    ssize_t n = 0;
+    ssize_t skip = 0;
+    int ret = 0;
+    int opt = 0;
+
+    while(-1 != (opt = getopt(argc, argv, "b:po:t:i:")))
+    {
+        switch(opt)
+        {
+            case 'b': baud = strtoul(optarg, NULL, 0); break;
+            case 'p': pty = true; break;
+            case 'o': payload_path = optarg; break;
+            case 't': seconds = atof(optarg); break;
+            case 'i': idle = atof(optarg); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if((pty && argc != optind) || (!pty && 1 != argc - optind))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if(pty)
+    {
+        fd = tool_open_pty(&slave);
+        tty = true;
+    }
+    else
+    {
+        fd = open(argv[optind], O_RDONLY | O_NOCTTY);
+        if(0 <= fd && isatty(fd))
+        {
+            close(fd);
+            fd = tool_open_tty(argv[optind], baud);
+            tty = true;
+        }
+        else if(0 > fd)
+        {
+            perror(argv[optind]);
+        }
+    }
+    if(0 > fd)
+    {
+        return 2;
+    }
+
+    if(NULL != payload_path)
+    {
+        cap.payload_fp = fopen(payload_path, "wb");
+        if(NULL == cap.payload_fp)
+        {
+            perror(payload_path);
+            return 2;
+        }
+    }
+
+    signal(SIGINT, tool_signal);
+    signal(SIGTERM, tool_signal);
+    uart_link_dec_init(&cap.dec, tool_frame, &cap);
+    // 文件与新建的伪终端从头开始，串口从第一个帧结束符之后开始
+    sync = !tty || pty;
+
+    start = tool_now();
+    while(!s_stop)
+    {
+        if(0 < seconds && tool_now() - start >= seconds)
+        {
+            break;
+        }
+        if(0 < idle && 0 < first && tool_now() - last >= idle)
+        {
+            break;
+        }
+
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        if(0 >= poll(&pfd, 1, TOOL_POLL_MS))
+        {
+            continue;
+        }
+
+        n = read(fd, buf, sizeof(buf));
+        if(0 > n && EINTR == errno)
+        {
+            continue;
+        }
+        if(0 >= n)
+        {
+            break;
+        }
+
+        last = tool_now();
+        if(0 == first)
+        {
+            first = last;
+        }
+
+        skip = 0;
+        if(!sync)
+        {
+            while(skip < n && 0 != buf[skip])
+            {
+                ++skip;
+            }
+            if(skip == n)
+            {
+                continue;
+            }
+            sync = true;
+        }
+        uart_link_dec_feed(&cap.dec, &buf[skip], n - skip);
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "bytes: %llu, frames: %u (record %u, text %u, other %u), crc errors: %u, framing errors: %u, "
+            "lost: %u\n", (unsigned long long)cap.dec.bytes, cap.dec.frames, cap.record_frames, cap.text_frames,
+            cap.other_frames, cap.dec.crc_errors, cap.dec.framing_errors, cap.dec.lost);
+    fprintf(stderr, "samples: %u, bad blocks: %u, unknown schema: %u\n", cap.samples, cap.bad_blocks, cap.unknown);
+    if(tty && last > first)
+    {
+        fprintf(stderr, "rate: %.0f bytes/s, %.0f samples/s over %.1f s\n", cap.dec.bytes / (last - first),
+                cap.samples / (last - first), last - first);
+    }
+
+    ret = (0 != cap.dec.crc_errors || 0 != cap.dec.framing_errors || 0 != cap.dec.lost || 0 != cap.bad_blocks
+           || 0 == cap.dec.frames) ? 1 : 0;
+
+    if(NULL != cap.payload_fp)
+    {
+        fclose(cap.payload_fp);
+    }
+    if(0 <= slave)
+    {
+        close(slave);
+    }
+    close(fd);
+
+    return ret;
+}